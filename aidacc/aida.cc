@@ -1728,17 +1728,85 @@ private:
 };
 
 // == EventDispatcher ==
+// Process-wide registry of event types, interned once so emissions compare integers.
+struct EventTypeRegistry {
+  std::mutex                                         mutex;
+  std::vector<std::pair<String,EventDispatcher::EventId>> types;   // (type, general_id), indexed by EventId
+  std::unordered_map<String,EventDispatcher::EventId> ids;
+  EventTypeRegistry()
+  {
+    types.push_back ({ "", 0 });        // EventId 0 is the empty type
+    ids[""] = 0;
+  }
+  static EventTypeRegistry&
+  instance()
+  {
+    static EventTypeRegistry *const registry = new EventTypeRegistry();
+    return *registry;
+  }
+};
+
+/// Intern `eventtype` and yield its EventId, `newly_interned` is set if the type was unknown.
+EventDispatcher::EventId
+EventDispatcher::event_id (const String &eventtype, bool *newly_interned)
+{
+  EventTypeRegistry &registry = EventTypeRegistry::instance();
+  std::lock_guard<std::mutex> locker (registry.mutex);
+  auto it = registry.ids.find (eventtype);
+  if (newly_interned)
+    *newly_interned = it == registry.ids.end();
+  if (it != registry.ids.end())
+    return it->second;
+  const size_t colon = eventtype.find (':');
+  EventId general = 0;
+  if (colon != String::npos)
+    {
+      const String general_type = eventtype.substr (0, colon);
+      auto git = registry.ids.find (general_type);
+      if (git != registry.ids.end())
+        general = git->second;
+      else
+        {
+          general = registry.types.size();
+          registry.types.push_back ({ general_type, general });
+          registry.ids[general_type] = general;
+        }
+    }
+  const EventId id = registry.types.size();
+  registry.types.push_back ({ eventtype, colon != String::npos ? general : id });
+  registry.ids[eventtype] = id;
+  return id;
+}
+
+/// Yield the EventId of the type part before ':' of `event_id`, or `event_id` itself.
+EventDispatcher::EventId
+EventDispatcher::general_id (EventId event_id)
+{
+  EventTypeRegistry &registry = EventTypeRegistry::instance();
+  std::lock_guard<std::mutex> locker (registry.mutex);
+  return event_id < registry.types.size() ? registry.types[event_id].second : 0;
+}
+
+/// Yield the event type string interned as `event_id`.
+String
+EventDispatcher::event_type (EventId event_id)
+{
+  EventTypeRegistry &registry = EventTypeRegistry::instance();
+  std::lock_guard<std::mutex> locker (registry.mutex);
+  return event_id < registry.types.size() ? registry.types[event_id].first : "";
+}
+
 struct EventDispatcher::ConnectionImpl final {
-  const std::string  selector_;
+  const EventId      selector_;
   EventHandlerF      handler_;
   DispatcherImpl    &o_;
   ConnectionImpl (DispatcherImpl &edispatcher, const String &eventselector, EventHandlerF handler) :
-    selector_ (eventselector), handler_ (handler), o_ (edispatcher)
+    selector_ (event_id (eventselector)), handler_ (handler), o_ (edispatcher)
   {}
   bool          connected       () const  { return NULL != handler_; }
   void          disconnect      ();
   void
-  emit (const Event &event, const std::string &event_type, const std::string &general_type)
+  emit (const Event &event, EventId event_type, EventId general_type)
   {
     if (connected() &&
         (selector_ == event_type || selector_ == general_type))
@@ -1765,17 +1833,15 @@ struct EventDispatcher::DispatcherImpl final {
         connections.erase (connections.begin() + i);
   }
   void
-  emit (const Event &event)
+  emit (const Event &event, EventId event_type)
   {
-    const std::string event_type = event["type"].get<std::string>();
-    if (event_type.empty())
+    if (!event_type)
       return;
     in_emission++;
     {
-      const char *const ctype = event_type.c_str(), *const colon = strchr (ctype, ':');
-      const std::string general_type = colon ? event_type.substr (0, colon - ctype) : event_type;
-      for (auto &conp : connections)
-        conp->emit (event, event_type, general_type);
+      const EventId general_type = general_id (event_type);
+      for (size_t i = 0; i < connections.size(); i++)   // handlers may attach() during emission
+        connections[i]->emit (event, event_type, general_type);
     }
     in_emission--;
     if (in_emission == 0 && needs_purging)
@@ -1842,7 +1908,15 @@ void
 EventDispatcher::emit (const Event &event)
 {
   if (o_)
-    o_->emit (event);
+    o_->emit (event, event_id (event["type"].get<std::string>()));
+}
+
+/// Emit `event` with its type pre-interned as `event_id`, avoids type string lookups.
+void
+EventDispatcher::emit (const Event &event, EventId event_id)
+{
+  if (o_)
+    o_->emit (event, event_id);
 }
 
 // == PropertyAccessor ==
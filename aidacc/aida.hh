@@ -297,6 +297,7 @@ class EventDispatcher {
   DispatcherImpl *o_ = NULL;
   struct ConnectionImpl;
 public:
+  using EventId = uint32_t;     ///< Interned event type, 0 denotes the empty type.
   struct EventConnection : private std::weak_ptr<EventDispatcher::ConnectionImpl> {
     friend              class EventDispatcher;
     bool                connected       () const;
@@ -305,7 +306,11 @@ public:
   /*dtor*/             ~EventDispatcher ();
   void                  reset           ();
   void                  emit            (const Event &event);
+  void                  emit            (const Event &event, EventId event_id);
   EventConnection       attach          (const String &eventselector, EventHandlerF handler);
+  static EventId        event_id        (const String &eventtype, bool *newly_interned = nullptr);
+  static EventId        general_id      (EventId event_id);
+  static String         event_type      (EventId event_id);
 };
 using IfaceEventConnection = EventDispatcher::EventConnection;
 
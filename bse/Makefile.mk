@@ -14,6 +14,12 @@ bse/BeastSoundEngine.gensources ::= $>/bse/bse_jsonipc_stub1.cc $>/bse/bse_jsoni
 bse/BeastSoundEngine.objects	::= $(call BUILDDIR_O, $(bse/BeastSoundEngine.sources)) $(bse/BeastSoundEngine.gensources:.cc=.o)
 bse/all: $(lib/BeastSoundEngine)
 
+# == BseLadspaProbe definitions ==
+lib/BseLadspaProbe		::= $>/lib/BseLadspaProbe-$(VERSION_M.M.M)
+bse/BseLadspaProbe.sources	::= bse/ladspaprobe.cc
+bse/BseLadspaProbe.objects	::= $(call BUILDDIR_O, $(bse/BseLadspaProbe.sources))
+bse/all: $(lib/BseLadspaProbe)
+
 # == libbsejack.so definitions ==
 bse/libbsejack.sources		::= bse/driver-jack.cc
 lib/libbsejack.so		::= $>/lib/libbse-jack-$(VERSION_M.M.M).so
@@ -23,7 +29,7 @@ ifneq ('','$(BSE_JACK_LIBS)')
 endif
 
 # == libbse.so definitions ==
-bse/libbse.exclude      ::= $(bse/BeastSoundEngine.sources) $(bse/libbsejack.sources)
+bse/libbse.exclude      ::= $(bse/BeastSoundEngine.sources) $(bse/BseLadspaProbe.sources) $(bse/libbsejack.sources)
 bse/libbse.csources     ::= $(sort $(filter-out %.inc.c, $(wildcard bse/*.c)))
 bse/libbse.sources      ::= $(sort $(filter-out $(bse/libbse.exclude) %.inc.cc, $(bse/libbse.csources) $(wildcard bse/*.cc)))
 bse/libbse.headers      ::= $(sort $(filter-out $(bse/BeastSoundEngine.headers) %.inc.hh, $(wildcard bse/*.hh)))
@@ -300,6 +306,17 @@ $(call BUILD_PROGRAM, \
 	../lib)
 $(call INSTALL_BIN_RULE, $(basename $(lib/BeastSoundEngine)), $(DESTDIR)$(pkglibdir)/lib, $(lib/BeastSoundEngine))
 
+# == BseLadspaProbe ==
+$(bse/BseLadspaProbe.objects): $(bse/libbse.deps)
+$(bse/BseLadspaProbe.objects): EXTRA_INCLUDES ::= -I$> $(BSEDEPS_CFLAGS)
+$(call BUILD_PROGRAM, \
+	$(lib/BseLadspaProbe), \
+	$(bse/BseLadspaProbe.objects), \
+	$(lib/libbse.so), \
+	-lbse-$(VERSION_MAJOR) $(BSEDEPS_LIBS), \
+	../lib)
+$(call INSTALL_BIN_RULE, $(basename $(lib/BseLadspaProbe)), $(DESTDIR)$(pkglibdir)/lib, $(lib/BseLadspaProbe))
+
 # == bse/clean ==
 bse/clean: FORCE
 	rm -f -r $(bse/cleandirs)
@@ -170,10 +170,30 @@ ws_close (websocketpp::connection_hdl hdl)
 
 static websocketpp::connection_hdl *bse_current_websocket_hdl = NULL;
 
+// Apply binary parameter changes directly from the IPC thread, records are { int32 shmoffset; float32 normalized; }
+static void
+ws_binary_message (const std::string &message)
+{
+  struct ParamRecord { int32_t shmoffset; float normalized; };
+  static_assert (sizeof (ParamRecord) == 8);
+  for (size_t i = 0; i + sizeof (ParamRecord) <= message.size(); i += sizeof (ParamRecord))
+    {
+      ParamRecord record;
+      memcpy (&record, message.data() + i, sizeof (record));
+      Bse::AudioSignal::Processor::param_send_shm_mt (record.shmoffset, record.normalized);
+    }
+}
+
 static void
 ws_message (websocketpp::connection_hdl hdl, server::message_ptr msg)
 {
   const std::string &message = msg->get_payload();
+  if (msg->get_opcode() == websocketpp::frame::opcode::binary)
+    {
+      // parameter changes bypass the BSE thread
+      ws_binary_message (message);
+      return;
+    }
   // send message to BSE thread and block until its been handled
   Bse::jobs += [&message, &hdl] () {
     bse_current_websocket_hdl = &hdl;
@@ -343,6 +363,47 @@ http_request (websocketpp::connection_hdl hdl)
 
 class EventHub {
   static ssize_t new_id () { static ssize_t idgen = -1000000; return --idgen; }
+  // Events queued per websocket connection, sent as one "Bse/EventHub/events" batch per main loop iteration
+  using EventBatch = std::vector<std::pair<ssize_t, Aida::AnyRec>>;
+  using OutboxMap = std::map<websocketpp::connection_hdl, EventBatch, std::owner_less<websocketpp::connection_hdl>>;
+  static OutboxMap& outbox() { static OutboxMap omap; return omap; }
+  static void
+  flush_outbox ()
+  {
+    OutboxMap omap;
+    omap.swap (outbox());
+    for (auto &pair : omap)
+      {
+        websocketpp::lib::error_code ec;
+        ServerEndpoint::connection_ptr con = websocket_server.get_con_from_hdl (pair.first, ec);
+        if (ec || !con)
+          continue;
+        rapidjson::Document d (rapidjson::kObjectType);
+        auto &a = d.GetAllocator();
+        d.AddMember ("method", "Bse/EventHub/events", a);
+        Jsonipc::JsonValue jbatch (rapidjson::kArrayType);
+        for (const auto &idevent : pair.second)
+          {
+            Jsonipc::JsonValue jpair (rapidjson::kArrayType);
+            jpair.PushBack (Jsonipc::to_json<ssize_t> (idevent.first, a).Move(), a);
+            jpair.PushBack (ConvertAny::record_to_json_object (idevent.second, a).Move(), a);
+            jbatch.PushBack (jpair, a); // move-semantics!
+          }
+        Jsonipc::JsonValue jarray (rapidjson::kArrayType);
+        jarray.PushBack (jbatch, a);
+        d.AddMember ("params", jarray, a);
+        rapidjson::StringBuffer buffer;
+        rapidjson::Writer<rapidjson::StringBuffer> writer (buffer);
+        d.Accept (writer);
+        std::string message { buffer.GetString(), buffer.GetSize() };
+        websocket_server.send (pair.first, message, websocketpp::frame::opcode::text);
+        if (verbose)
+          {
+            const ptrdiff_t conid = ptrdiff_t (con.get());
+            Bse::printerr ("%p: NOTIFY:  %s\n", conid, message);
+          }
+      }
+  }
   struct EventHandler {
     websocketpp::connection_hdl weak_hdl;       // connection weak_ptr
     Bse::NotifierIfaceW         weak_obj;       // NotifierIface weak_ptr
@@ -372,23 +433,10 @@ class EventHub {
         }
       if (obj && con)
         {
-          rapidjson::Document d (rapidjson::kObjectType);
-          auto &a = d.GetAllocator();
-          d.AddMember ("method", "Bse/EventHub/event", a);
-          Jsonipc::JsonValue jarray (rapidjson::kArrayType);
-          jarray.PushBack (Jsonipc::to_json<ssize_t> (handler_id, a).Move(), a);
-          jarray.PushBack (ConvertAny::record_to_json_object (event.fields(), a).Move(), a);
-          d.AddMember ("params", jarray, a); // move-semantics!
-          rapidjson::StringBuffer buffer;
-          rapidjson::Writer<rapidjson::StringBuffer> writer (buffer);
-          d.Accept (writer);
-          std::string message { buffer.GetString(), buffer.GetSize() };
-          websocket_server.send (weak_hdl, message, websocketpp::frame::opcode::text);
-          if (verbose)
-            {
-              const ptrdiff_t conid = ptrdiff_t (con.get());
-              Bse::printerr ("%p: NOTIFY:  %s\n", conid, message);
-            }
+          OutboxMap &omap = outbox();
+          if (omap.empty())
+            Bse::exec_now (flush_outbox);
+          omap[weak_hdl].push_back ({ handler_id, event.fields() });
         }
     }
   };
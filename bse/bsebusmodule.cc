@@ -28,7 +28,9 @@ class BusModule : public BusModuleBase {
           if (level1 == 1.0)
             ostream_set (OCHANNEL_AUDIO_OUT1, audio_in);
           else if (level1 == 0.0)
-            ostream_set (OCHANNEL_AUDIO_OUT1, const_values (0.0));
+            ostream_set_const (OCHANNEL_AUDIO_OUT1, 0.0);
+          else if (istream (ICHANNEL_AUDIO_IN1).constant)
+            ostream_fill_const (OCHANNEL_AUDIO_OUT1, level1 * audio_in[0], n_values);
           else
             {
               float *audio_out = ostream (OCHANNEL_AUDIO_OUT1).values;
@@ -43,7 +45,9 @@ class BusModule : public BusModuleBase {
           if (level2 == 1.0)
             ostream_set (OCHANNEL_AUDIO_OUT2, audio_in);
           else if (level2 == 0.0)
-            ostream_set (OCHANNEL_AUDIO_OUT2, const_values (0.0));
+            ostream_set_const (OCHANNEL_AUDIO_OUT2, 0.0);
+          else if (istream (ICHANNEL_AUDIO_IN2).constant)
+            ostream_fill_const (OCHANNEL_AUDIO_OUT2, level2 * audio_in[0], n_values);
           else
             {
               float *audio_out = ostream (OCHANNEL_AUDIO_OUT2).values;
@@ -251,7 +251,7 @@ constant_process (BseModule *module,
   guint i;
   for (i = 0; i < BSE_CONSTANT_N_OUTPUTS; i++)
     if (BSE_MODULE_OSTREAM (module, i).connected)
-      BSE_MODULE_OSTREAM (module, i).values = bse_engine_const_values (cmod->constants[i]);
+      bse_module_const_ostream (module, i, cmod->constants[i]);
 }
 static void
 bse_constant_context_create (BseSource *source,
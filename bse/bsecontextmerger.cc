@@ -112,7 +112,7 @@ context_merger_process (BseModule    *module,
 	uint j, n_cons = BSE_MODULE_JSTREAM (module, i).n_connections;
 
 	if (!n_cons)
-	  module->ostreams[i].values = bse_engine_const_values (0);
+	  bse_module_const_ostream (module, i, 0);
 	else if (n_cons == 1)
 	  module->ostreams[i].values = (float*) BSE_MODULE_JBUFFER (module, i, 0);
 	else
@@ -88,11 +88,15 @@ SynthesisModule::set_module (BseModule *engine_module)
   static_assert (sizeof (((IStream*)0)->values)    == sizeof (((BseIStream*)0)->values), "");
   static_assert (offsetof (IStream, connected)     == offsetof (BseIStream, connected), "");
   static_assert (sizeof (((IStream*)0)->connected) == sizeof (((BseIStream*)0)->connected), "");
+  static_assert (offsetof (IStream, constant)      == offsetof (BseIStream, constant), "");
+  static_assert (sizeof (((IStream*)0)->constant)  == sizeof (((BseIStream*)0)->constant), "");
   static_assert (sizeof   (OStream)                == sizeof   (BseOStream), "");
   static_assert (offsetof (OStream, values)        == offsetof (BseOStream, values), "");
   static_assert (sizeof (((OStream*)0)->values)    == sizeof (((BseOStream*)0)->values), "");
   static_assert (offsetof (OStream, connected)     == offsetof (BseOStream, connected), "");
   static_assert (sizeof (((OStream*)0)->connected) == sizeof (((BseOStream*)0)->connected), "");
+  static_assert (offsetof (OStream, constant)      == offsetof (BseOStream, constant), "");
+  static_assert (sizeof (((OStream*)0)->constant)  == sizeof (((BseOStream*)0)->constant), "");
 }
 void
 SynthesisModule::ostream_set (uint         ostream_index,
@@ -102,6 +106,21 @@ SynthesisModule::ostream_set (uint         ostream_index,
   m->ostreams[ostream_index].values = const_cast<float*> (values);
 }
 
+void
+SynthesisModule::ostream_set_const (uint  ostream_index,
+                                    float value)
+{
+  bse_module_const_ostream (engine_module(), ostream_index, value);
+}
+
+void
+SynthesisModule::ostream_fill_const (uint  ostream_index,
+                                     float value,
+                                     uint  n_values)
+{
+  bse_module_fill_const_ostream (engine_module(), ostream_index, n_values, value);
+}
+
 const float*
 SynthesisModule::const_values (float value)
 {
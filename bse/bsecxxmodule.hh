@@ -30,6 +30,8 @@ public:
   inline const JStream&     jstream         (uint jstream_index) const  { return intern_module->jstreams[jstream_index]; }
   inline const OStream&     ostream         (uint ostream_index) const  { return intern_module->ostreams[ostream_index]; }
   void                      ostream_set     (uint ostream_index, const float *values);
+  void                      ostream_set_const (uint ostream_index, float value);
+  void                      ostream_fill_const (uint ostream_index, float value, uint n_values);
   const float*              const_values    (float  value);
   inline const uint         mix_freq        () const;
   inline const uint         block_size      () const;
@@ -37,7 +37,7 @@ Module::Module (const BseModuleClass &_klass) :
   this->jinputs = BSE_MODULE_N_JSTREAMS (this) ? sfi_new_struct0 (Bse::EngineJInput*, BSE_MODULE_N_JSTREAMS (this)) : NULL;
   this->outputs = BSE_MODULE_N_OSTREAMS (this) ? sfi_new_struct0 (Bse::EngineOutput, BSE_MODULE_N_OSTREAMS (this)) : NULL;
   for (size_t i = 0; i < BSE_MODULE_N_OSTREAMS (this); i++)
-    this->outputs[i].buffer = this->ostreams[i].values;
+    this->outputs[i].block = this->outputs[i].buffer = this->ostreams[i].values;
   assert_return (_klass.n_istreams <= 255);
   assert_return (_klass.n_jstreams <= 255);
   assert_return (_klass.n_ostreams <= 255);
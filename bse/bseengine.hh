@@ -66,10 +66,12 @@ struct JStream {
 struct IStream {
   const float *values;
   bool         connected;       // scheduler update
+  bool         constant;        // all values are equal for the current block
 };
 struct OStream {
   float *values;
   bool   connected;
+  bool   constant;              // set by bse_module_const_ostream() and bse_module_fill_const_ostream()
 };
 
 } // Bse
@@ -166,6 +168,13 @@ void       bse_transact                 (BseJob               *job,
 
 /* --- module utilities (EngineThread functions) --- */
 float*     bse_engine_const_values      (float value);
+void       bse_module_const_ostream     (BseModule            *module,
+                                         uint                  ostream,
+                                         float                 value);
+void       bse_module_fill_const_ostream (BseModule           *module,
+                                          uint                 ostream,
+                                          uint                 n_values,
+                                          float                value);
 
 /* --- initialization & main loop --- */
 void       bse_engine_init              ();
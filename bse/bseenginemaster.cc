@@ -708,10 +708,14 @@ master_take_probes (Bse::Module   *node,
       tjob->probe.ostreams = ostreams;
       for (i = 0; i < BSE_MODULE_N_OSTREAMS (node); i++)
         {
+          /* probes take over the real ostream buffer, so fetch redirected values */
+          if (node->outputs[i].buffer != node->outputs[i].block)
+            bse_block_copy_float (n_values, node->outputs[i].block, node->outputs[i].buffer);
           /* restore real ostream buffer pointers */
-          ostreams[i].values = node->outputs[i].buffer;
+          ostreams[i].values = node->outputs[i].block;
           /* store real ostream buffer pointers */
-          node->outputs[i].buffer = node->ostreams[i].values;
+          node->outputs[i].block = node->outputs[i].buffer = node->ostreams[i].values;
+          node->outputs[i].constant = false;
           /* preserve connection flags */
           node->ostreams[i].connected = ostreams[i].connected;
         }
@@ -799,10 +803,14 @@ master_process_locked_node (Bse::Module *node,
 		master_process_locked_node (inode, final_counter - node->counter);
 	      node->istreams[i].values = inode->outputs[node->inputs[i].real_stream].buffer;
 	      node->istreams[i].values += diff;
+	      node->istreams[i].constant = inode->outputs[node->inputs[i].real_stream].constant;
 	      inode->unlock();
 	    }
 	  else
-	    node->istreams[i].values = bse_engine_const_zeros (BSE_ENGINE_MAX_BLOCK_SIZE);
+	    {
+	      node->istreams[i].values = bse_engine_const_zeros (BSE_ENGINE_MAX_BLOCK_SIZE);
+	      node->istreams[i].constant = true;
+	    }
 	}
       /* ensure all jstream inputs have n_values available */
       for (j = 0; j < BSE_MODULE_N_JSTREAMS (node); j++)
@@ -819,10 +827,13 @@ master_process_locked_node (Bse::Module *node,
 	  }
       /* update obuffer pointer (FIXME: need this before flow job callbacks?) */
       for (i = 0; i < BSE_MODULE_N_OSTREAMS (node); i++)
-        node->ostreams[i].values = node->outputs[i].buffer + diff;
+        {
+          node->ostreams[i].values = node->outputs[i].block + diff;
+          node->ostreams[i].constant = false;
+        }
       if (diff && needs_probe_reset)
         for (i = 0; i < BSE_MODULE_N_OSTREAMS (node); i++)
-          bse_block_fill_float (diff, node->outputs[i].buffer, 0.0);
+          bse_block_fill_float (diff, node->outputs[i].block, 0.0);
       needs_probe_reset = false;
       /* process() node */
       if (UNLIKELY (BSE_MODULE_IS_SUSPENDED (node, node->counter)))
@@ -830,18 +841,39 @@ master_process_locked_node (Bse::Module *node,
 	  /* suspended node processing behaviour */
 	  for (i = 0; i < BSE_MODULE_N_OSTREAMS (node); i++)
 	    if (node->ostreams[i].connected)
-	      node->ostreams[i].values = bse_engine_const_zeros (BSE_ENGINE_MAX_BLOCK_SIZE);
+	      bse_module_const_ostream (node, i, 0.0);
           node->needs_reset = TRUE;
 	}
       else
         node->process (new_counter - node->counter);
       /* catch obuffer pointer changes */
+      const bool whole_block = diff == 0 && new_counter == current_stamp + bse_engine_block_size();
       for (i = 0; i < BSE_MODULE_N_OSTREAMS (node); i++)
 	{
-	  /* FIXME: this takes the worst possible performance hit to support obuffer pointer virtualization */
-	  if (node->ostreams[i].connected &&
-              node->ostreams[i].values != node->outputs[i].buffer + diff)
-            bse_block_copy_float (new_counter - node->counter, node->outputs[i].buffer + diff, node->ostreams[i].values);
+          Bse::EngineOutput &output = node->outputs[i];
+          const BseOStream &ostream = node->ostreams[i];
+	  if (ostream.values == output.block + diff)
+            {
+              output.buffer = output.block;
+              output.constant = ostream.constant && whole_block;  /* filled by bse_module_fill_const_ostream() */
+            }
+          else if (whole_block)
+            {
+              /* obuffer pointer virtualization, consumers read redirected values directly */
+              output.buffer = ostream.values;
+              output.constant = ostream.constant;
+              for (j = 0; j < BSE_MODULE_N_ISTREAMS (node) && !output.constant; j++)
+                if (ostream.values == node->istreams[j].values)
+                  output.constant = node->istreams[j].constant;    /* passed through input */
+            }
+          else
+            {
+              /* partial blocks need contiguous values */
+              if (ostream.connected)
+                bse_block_copy_float (new_counter - node->counter, output.block + diff, ostream.values);
+              output.buffer = output.block;
+              output.constant = false;
+            }
 	}
       /* update node counter */
       node->counter = new_counter;
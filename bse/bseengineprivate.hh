@@ -140,7 +140,9 @@ struct EngineJInput {
   uint    real_stream;	/* ostream of real_node */
 };
 struct EngineOutput {
-  float *buffer;
+  float *buffer;        // values of the last block, may point to redirected or constant values
+  float *block;         // memory owned by the module ostream
+  bool   constant;      // all values in buffer are equal
   uint	 n_outputs;
 };
 
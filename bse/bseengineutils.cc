@@ -626,6 +626,28 @@ bse_engine_const_values (float value)
   return const_cast<float*> (block);
 }
 
+/// Let output `ostream` of `module` provide `value` for the current block.
+/// In contrast to assigning bse_engine_const_values() to the ostream, consumers
+/// are informed about the constant via IStream.constant to use scalar code paths.
+void
+bse_module_const_ostream (BseModule *module, uint ostream, float value)
+{
+  assert_return (ostream < BSE_MODULE_N_OSTREAMS (module));
+  module->ostreams[ostream].values = bse_engine_const_values (value);
+  module->ostreams[ostream].constant = true;
+}
+
+/// Fill the own block of output `ostream` of `module` with `n_values` times `value`.
+/// Unlike bse_module_const_ostream(), `value` is not interned, so it may change
+/// from block to block. Consumers see IStream.constant if the whole block was filled.
+void
+bse_module_fill_const_ostream (BseModule *module, uint ostream, uint n_values, float value)
+{
+  assert_return (ostream < BSE_MODULE_N_OSTREAMS (module));
+  bse_block_fill_float (n_values, module->ostreams[ostream].values, value);
+  module->ostreams[ostream].constant = true;
+}
+
 float*
 bse_engine_const_zeros (uint smaller_than_MAX_BLOCK_SIZE)
 {
@@ -4,7 +4,15 @@
 #include "bsecategories.hh"
 #include "bse/internal.hh"
 #include <bse/sfi.hh>
+#include "path.hh"
 #include <string.h>
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <spawn.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
 #include "ladspa.hh"
 
 #define LDEBUG(...)     Bse::debug ("ladspa", __VA_ARGS__)
@@ -23,6 +31,22 @@ static const gchar*	ladspa_plugin_reinit_type_ids (BseLadspaPlugin           *se
 						       LADSPA_Descriptor_Function ldf);
 
 
+/* --- LADSPA discovery cache --- */
+struct LadspaTypeDesc {
+  std::string label, name;      // name as assembled by bse_ladspa_info_assemble()
+  bool        broken = true;
+};
+struct LadspaFileInfo {
+  int64                       mtime = 0, size = 0;
+  std::string                 error;
+  bool                        retry = false;    // probe crashed or timed out, not cached
+  std::vector<LadspaTypeDesc> types;
+};
+using LadspaFileMap = std::map<std::string, LadspaFileInfo>;
+static const char ladspa_cache_header[] = "# BEAST LADSPA Cache 1\n";
+static constexpr int LADSPA_PROBE_TIMEOUT_MS = 15000;
+
+
 /* --- variables --- */
 static GSList *ladspa_plugins = NULL;
 
@@ -187,13 +211,13 @@ ladspa_plugin_reinit_type_ids (BseLadspaPlugin           *self,
 }
 
 static const gchar*
-ladspa_plugin_init_type_ids (BseLadspaPlugin           *self,
-			     LADSPA_Descriptor_Function ldf)
+ladspa_plugin_init_type_ids (BseLadspaPlugin                   *self,
+			     const std::vector<LadspaTypeDesc> &descs)
 {
   gchar *prefix = NULL, *error = NULL;
   guint i;
   /* check for multi module plugins */
-  if (ldf (0) && ldf (1))
+  if (descs.size() >= 2)
     {
       guint k, was_char = FALSE;
       prefix = strrchr (self->fname, '/');
@@ -210,29 +234,25 @@ ladspa_plugin_init_type_ids (BseLadspaPlugin           *self,
 	else
 	  was_char = FALSE;
     }
-  for (i = 0; ; i++)
+  for (i = 0; i < descs.size(); i++)
     {
-      const LADSPA_Descriptor *cld = ldf (i);
+      const LadspaTypeDesc &desc = descs[i];
       guint j;
-      if (!cld)
-	break;
       j = self->n_types++;
       self->types = (BseLadspaTypeInfo*) g_realloc (self->types, self->n_types * sizeof (self->types[0]));
       self->types[j].type = 0;
-      self->types[j].info = bse_ladspa_info_assemble (self->fname, cld);
-      if (!self->types[j].info->broken)
+      self->types[j].info = NULL; /* assembled by ladspa_plugin_use() */
+      if (!desc.broken)
 	{
 	  gchar *string, *name;
 	  guint k;
-	  name = g_strconcat (LADSPA_TYPE_NAME, cld->Label, NULL);
+	  name = g_strconcat (LADSPA_TYPE_NAME, desc.label.c_str(), NULL);
 	  for (k = 0; name[k]; k++)
 	    if (!is_alnum (name[k]))
 	      name[k] = '_';
           LDEBUG ("%s: registering plugin named: %s", self->fname, name);
 	  if (g_type_from_name (name) != 0)
 	    {
-	      bse_ladspa_info_free (self->types[j].info);
-	      self->types[j].info = NULL;
               LDEBUG ("%s: ignoring duplicate plugin type: %s",  self->fname, name);
 	      g_free (name);
 	      continue;
@@ -240,7 +260,7 @@ ladspa_plugin_init_type_ids (BseLadspaPlugin           *self,
 	  self->types[j].type = bse_type_register_dynamic (BSE_TYPE_LADSPA_MODULE, name,
                                                            G_TYPE_PLUGIN (self));
 	  g_free (name);
-	  string = g_strdup (self->types[j].info->name);
+	  string = g_strdup (desc.name.c_str());
 	  for (k = 0; string[k]; k++)
 	    if (string[k] == '_')
 	      string[k] = '-';
@@ -254,11 +274,6 @@ ladspa_plugin_init_type_ids (BseLadspaPlugin           *self,
 	  bse_categories_register (name, NULL, self->types[j].type, NULL);
 	  g_free (name);
 	}
-      else
-	{
-	  bse_ladspa_info_free (self->types[j].info);
-	  self->types[j].info = NULL;
-	}
     }
   g_free (prefix);
   return error;
@@ -461,6 +476,7 @@ bse_ladspa_info_assemble (const gchar  *file_path,
     bli->copyright = cld->Copyright;
   bli->interactive = (cld->Properties & LADSPA_PROPERTY_REALTIME) != 0;
   bli->rt_capable = (cld->Properties & LADSPA_PROPERTY_HARD_RT_CAPABLE) != 0;
+  bli->inplace_broken = (cld->Properties & LADSPA_PROPERTY_INPLACE_BROKEN) != 0;
 
   if (!cld->PortCount)
     {
@@ -591,38 +607,232 @@ ladspa_plugin_find (const gchar *fname)
   return NULL;
 }
 
-const gchar*
-bse_ladspa_plugin_check_load (const gchar *file_name)
+static std::string
+ladspa_cache_file ()
 {
-  BseLadspaPlugin *self;
-  const gchar *error;
-  GModule *gmodule;
+  return Bse::Path::join (Bse::Path::cache_home(), "beast", "ladspa-plugins.txt");
+}
 
-  assert_return (file_name != NULL, "Internal Error");
+static std::string
+ladspa_sanitize (const char *string)
+{
+  std::string s = string ? string : "";
+  for (char &c : s)
+    if (c == '\t' || c == '\n' || c == '\r')
+      c = ' ';
+  return s;
+}
 
-  if (ladspa_plugin_find (file_name))
-    return "Plugin already registered";
+static bool
+ladspa_file_stat (const std::string &file_name, LadspaFileInfo &finfo)
+{
+  struct stat st;
+  if (stat (file_name.c_str(), &st) != 0)
+    return false;
+  finfo.mtime = st.st_mtim.tv_sec * int64 (1000000000) + st.st_mtim.tv_nsec;
+  finfo.size = st.st_size;
+  return true;
+}
 
-  /* load module once */
-  gmodule = g_module_open (file_name, GModuleFlags (G_MODULE_BIND_LOCAL | G_MODULE_BIND_LAZY));
-  if (!gmodule)
-    return g_module_error ();
-  /* check whether this is a LADSPA module */
-  LADSPA_Descriptor_Function ldf = NULL;
-  if (!g_module_symbol (gmodule, "ladspa_descriptor", (void**) &ldf) || !ldf)
+/* Parse probe results and cache entries, i.e. lines of the form:
+ * P <mtime> <size> <file_name>         - starts a file entry (cache only)
+ * E <error>                            - file failed to load
+ * D <broken> <label>\t<name>           - one line per ladspa_descriptor() index
+ */
+static void
+ladspa_parse_lines (const std::string &data, LadspaFileMap &fmap, LadspaFileInfo *probed)
+{
+  LadspaFileInfo *finfo = probed;
+  size_t pos = 0;
+  while (pos < data.size())
     {
-      g_module_close (gmodule);
-      return "Plugin without ladspa_descriptor";
+      const size_t eol = std::min (data.find ('\n', pos), data.size());
+      const std::string line = data.substr (pos, eol - pos);
+      pos = eol + 1;
+      if (line.size() < 2 || line[1] != ' ')
+        continue;
+      if (line[0] == 'P' && !probed)
+        {
+          const Bse::StringVector parts = Bse::string_split (line.substr (2), " ", 2);
+          finfo = parts.size() == 3 ? &fmap[parts[2]] : NULL;
+          if (finfo)
+            {
+              finfo->mtime = Bse::string_to_int (parts[0]);
+              finfo->size = Bse::string_to_int (parts[1]);
+            }
+        }
+      else if (line[0] == 'E' && finfo)
+        finfo->error = line.substr (2);
+      else if (line[0] == 'D' && finfo && line.size() >= 4)
+        {
+          const size_t tab = line.find ('\t', 4);
+          LadspaTypeDesc desc;
+          desc.broken = line[2] != '0';
+          desc.label = line.substr (4, tab == std::string::npos ? std::string::npos : tab - 4);
+          desc.name = tab == std::string::npos ? "" : line.substr (tab + 1);
+          finfo->types.push_back (desc);
+        }
     }
+}
 
-  /* create plugin and register types */
-  self = (BseLadspaPlugin*) bse_object_new (BSE_TYPE_LADSPA_PLUGIN, NULL);
-  self->fname = g_strdup (file_name);
-  self->gmodule = gmodule;
-  error = ladspa_plugin_init_type_ids (self, ldf);
+static std::string
+ladspa_format_lines (const LadspaFileInfo &finfo)
+{
+  std::string data;
+  if (!finfo.error.empty())
+    data += "E " + ladspa_sanitize (finfo.error.c_str()) + "\n";
+  for (const LadspaTypeDesc &desc : finfo.types)
+    data += Bse::string_format ("D %d %s\t%s\n", desc.broken, desc.label, desc.name);
+  return data;
+}
+
+/// Load `file_name` and describe its LADSPA types in the probe result format.
+/// This runs in the BseLadspaProbe helper process, plugin code may crash or hang without affecting BSE.
+std::string
+bse_ladspa_plugin_probe (const std::string &file_name)
+{
+  LadspaFileInfo finfo;
+  void *handle = dlopen (file_name.c_str(), RTLD_LAZY | RTLD_LOCAL);
+  LADSPA_Descriptor_Function ldf = handle ? (LADSPA_Descriptor_Function) dlsym (handle, "ladspa_descriptor") : NULL;
+  if (!handle)
+    finfo.error = dlerror();
+  else if (!ldf)
+    finfo.error = "Plugin without ladspa_descriptor";
+  for (guint i = 0; ldf; i++)
+    {
+      const LADSPA_Descriptor *cld = ldf (i);
+      if (!cld)
+        break;
+      BseLadspaInfo *bli = bse_ladspa_info_assemble (file_name.c_str(), cld);
+      LadspaTypeDesc desc;
+      desc.broken = bli->broken;
+      desc.label = ladspa_sanitize (cld->Label);
+      desc.name = ladspa_sanitize (bli->name);
+      finfo.types.push_back (desc);
+      bse_ladspa_info_free (bli);
+    }
+  return ladspa_format_lines (finfo);
+}
 
+static std::string
+ladspa_probe_helper ()
+{
+  return Bse::string_format ("%s/lib/BseLadspaProbe-%u.%u.%u", Bse::runpath (Bse::RPath::INSTALLDIR),
+                             BSE_MAJOR_VERSION, BSE_MINOR_VERSION, BSE_MICRO_VERSION);
+}
+
+/* Probe `files` in parallel helper processes, at most one per CPU.
+ * The helper is started via posix_spawn(), forking this multithreaded process and loading
+ * plugins in the child could deadlock on locks held by other threads at fork time.
+ */
+static void
+ladspa_probe_files (const Bse::StringVector &files, LadspaFileMap &fmap)
+{
+  struct Child {
+    std::string file_name, output;
+    pid_t       pid = -1;
+    int         fd = -1;
+    uint64      start = 0;
+  };
+  const std::string helper = ladspa_probe_helper();
+  const size_t n_parallel = CLAMP (size_t (Bse::this_thread_online_cpus()), size_t (1), size_t (16));
+  std::vector<Child> children;
+  size_t next = 0;
+  while (next < files.size() || children.size())
+    {
+      // spawn probes
+      while (next < files.size() && children.size() < n_parallel)
+        {
+          Child child;
+          child.file_name = files[next++];
+          int pipefds[2];
+          if (pipe2 (pipefds, O_CLOEXEC) != 0)
+            {
+              fmap[child.file_name].error = strerror (errno);
+              fmap[child.file_name].retry = true;
+              continue;
+            }
+          posix_spawn_file_actions_t actions;
+          posix_spawn_file_actions_init (&actions);
+          posix_spawn_file_actions_adddup2 (&actions, pipefds[1], 1);    // clears O_CLOEXEC on stdout
+          char *const argv[] = { const_cast<char*> (helper.c_str()), const_cast<char*> (child.file_name.c_str()), NULL };
+          const int err = posix_spawn (&child.pid, helper.c_str(), &actions, NULL, argv, environ);
+          posix_spawn_file_actions_destroy (&actions);
+          close (pipefds[1]);
+          if (err)
+            {
+              close (pipefds[0]);
+              fmap[child.file_name].error = Bse::string_format ("%s: %s", helper, strerror (err));
+              fmap[child.file_name].retry = true;
+              continue;
+            }
+          child.fd = pipefds[0];
+          child.start = Bse::timestamp_realtime();
+          children.push_back (child);
+        }
+      // collect output
+      std::vector<struct pollfd> pfds;
+      for (const Child &child : children)
+        pfds.push_back ({ child.fd, POLLIN, 0 });
+      const int n_ready = poll (pfds.data(), pfds.size(), 250);
+      for (size_t i = children.size() - 1; i < children.size(); i--)
+        {
+          Child &child = children[i];
+          bool done = false;
+          if (n_ready > 0 && (pfds[i].revents & (POLLIN | POLLHUP | POLLERR)))
+            {
+              char buffer[4096];
+              const ssize_t l = read (child.fd, buffer, sizeof (buffer));
+              if (l > 0)
+                child.output.append (buffer, l);
+              done = l == 0 || (l < 0 && errno != EINTR && errno != EAGAIN);
+            }
+          const bool timeout = !done && Bse::timestamp_realtime() > child.start + LADSPA_PROBE_TIMEOUT_MS * 1000;
+          if (!done && !timeout)
+            continue;
+          if (timeout)
+            kill (child.pid, SIGKILL);
+          int status = 0;
+          while (waitpid (child.pid, &status, 0) < 0 && errno == EINTR)
+            ;
+          close (child.fd);
+          LadspaFileInfo &finfo = fmap[child.file_name];
+          finfo.types.clear();
+          finfo.retry = timeout || WIFSIGNALED (status);
+          if (timeout)
+            finfo.error = "Plugin probe timed out";
+          else if (WIFSIGNALED (status))
+            finfo.error = Bse::string_format ("Plugin probe crashed: %s", strsignal (WTERMSIG (status)));
+          else if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+            finfo.error = "Plugin probe failed";
+          else
+            ladspa_parse_lines (child.output, fmap, &finfo);
+          LDEBUG ("%s: probed %u types: %s", child.file_name, finfo.types.size(), finfo.error);
+          children.erase (children.begin() + i);
+        }
+    }
+}
+
+static std::string
+ladspa_format_cache (const LadspaFileMap &fmap)
+{
+  std::string data = ladspa_cache_header;
+  for (const auto &pair : fmap)
+    if (pair.first.find ('\n') == std::string::npos && !pair.second.retry)
+      data += Bse::string_format ("P %d %d %s\n", pair.second.mtime, pair.second.size, pair.first) +
+              ladspa_format_lines (pair.second);
+  return data;
+}
+
+static void
+ladspa_plugin_register (const gchar *file_name, const LadspaFileInfo &finfo)
+{
+  /* create plugin and register types, the module is only opened by ladspa_plugin_use() */
+  BseLadspaPlugin *self = (BseLadspaPlugin*) bse_object_new (BSE_TYPE_LADSPA_PLUGIN, NULL);
+  self->fname = g_strdup (file_name);
+  self->gmodule = NULL;
+  ladspa_plugin_init_type_ids (self, finfo.types);
   /* keep plugin if types were successfully registered */
-  ladspa_plugin_unload (self);
   if (self->n_types)
     {
       ladspa_plugins = g_slist_prepend (ladspa_plugins, self);
@@ -630,8 +840,67 @@ bse_ladspa_plugin_check_load (const gchar *file_name)
     }
   else
     g_object_unref (self);
+}
 
-  return error;
+/// Register the LADSPA plugin types of `files`, returns (file, error) pairs for failing plugins.
+/// Plugin metadata is cached by path, mtime and size, cache misses are probed in helper processes.
+/// Probes that crashed or timed out are not cached, so these plugins are probed again next time.
+std::vector<Bse::StringPair>
+bse_ladspa_plugin_check_load_files (const Bse::StringVector &files)
+{
+  LadspaFileMap cache, current;
+  const std::string cache_data = Bse::Path::stringread (ladspa_cache_file());
+  if (Bse::string_startswith (cache_data, ladspa_cache_header))
+    ladspa_parse_lines (cache_data, cache, NULL);
+  Bse::StringVector misses;
+  for (const std::string &file_name : files)
+    {
+      LadspaFileInfo finfo;
+      if (ladspa_plugin_find (file_name.c_str()) || !ladspa_file_stat (file_name, finfo))
+        continue;
+      auto it = cache.find (file_name);
+      if (it != cache.end() && it->second.mtime == finfo.mtime && it->second.size == finfo.size)
+        current[file_name] = it->second;
+      else
+        {
+          current[file_name] = finfo;
+          misses.push_back (file_name);
+        }
+    }
+  if (misses.size())
+    {
+      ladspa_probe_files (misses, current);
+      if (!Bse::Path::stringwrite (ladspa_cache_file(), ladspa_format_cache (current), true))
+        LDEBUG ("%s: failed to write cache: %s", ladspa_cache_file(), strerror (errno));
+    }
+  LDEBUG ("%u plugins, %u probed", current.size(), misses.size());
+  std::vector<Bse::StringPair> errors;
+  for (const std::string &file_name : files)
+    {
+      auto it = current.find (file_name);
+      if (it == current.end())
+        continue;
+      if (!it->second.error.empty())
+        errors.push_back ({ file_name, it->second.error });
+      else
+        ladspa_plugin_register (file_name.c_str(), it->second);
+    }
+  return errors;
+}
+
+const gchar*
+bse_ladspa_plugin_check_load (const gchar *file_name)
+{
+  assert_return (file_name != NULL, "Internal Error");
+
+  if (ladspa_plugin_find (file_name))
+    return "Plugin already registered";
+  const std::vector<Bse::StringPair> errors = bse_ladspa_plugin_check_load_files ({ file_name });
+  if (errors.empty())
+    return NULL;
+  static std::string last_error;
+  last_error = errors[0].second;
+  return last_error.c_str();
 }
 
 Bse::StringVector
@@ -689,3 +958,57 @@ ladspa_test_load (const gchar *file)
     g_module_close (gmodule);
 }
 #endif
+
+// == Testing ==
+#include "testing.hh"
+
+namespace { // Anon
+
+BSE_INTEGRITY_TEST (bse_test_ladspa_cache);
+static void
+bse_test_ladspa_cache()
+{
+  // cache entries survive a round trip, crashed or timed out probes are not cached
+  const std::string good_so = "/usr/lib/ladspa/good.so", failed_so = "/usr/lib/ladspa/failed.so";
+  LadspaFileMap fmap, parsed;
+  LadspaFileInfo &good = fmap[good_so];
+  good.mtime = 1234567890123456789;
+  good.size = 4711;
+  good.types.resize (2);
+  good.types[0].label = "amp";
+  good.types[0].name = "Amplifier";
+  good.types[0].broken = false;
+  good.types[1].label = "bad";
+  LadspaFileInfo &failed = fmap[failed_so];
+  failed.error = "undefined symbol: foo";
+  LadspaFileInfo &crashed = fmap["/usr/lib/ladspa/crashed.so"];
+  crashed.error = "Plugin probe crashed: Segmentation fault";
+  crashed.retry = true;
+  const std::string data = ladspa_format_cache (fmap);
+  TASSERT (Bse::string_startswith (data, ladspa_cache_header));
+  ladspa_parse_lines (data, parsed, NULL);
+  TCMP (parsed.size(), ==, 2);
+  TCMP (parsed[good_so].mtime, ==, good.mtime);
+  TCMP (parsed[good_so].size, ==, good.size);
+  TCMP (parsed[good_so].error, ==, "");
+  TCMP (parsed[good_so].types.size(), ==, 2);
+  TCMP (parsed[good_so].types[0].label, ==, "amp");
+  TCMP (parsed[good_so].types[0].name, ==, "Amplifier");
+  TCMP (parsed[good_so].types[0].broken, ==, false);
+  TCMP (parsed[good_so].types[1].label, ==, "bad");
+  TCMP (parsed[good_so].types[1].broken, ==, true);
+  TCMP (parsed[failed_so].error, ==, failed.error);
+  TCMP (parsed[failed_so].types.size(), ==, 0);
+  // files that are not shared objects fail to load in the probe helper, that failure is cached
+  const std::string broken_so = Bse::Path::join (Bse::Path::cache_home(), "beast", Bse::string_format ("ladspa-test-%u.so", getpid()));
+  TASSERT (Bse::Path::stringwrite (broken_so, "not a shared object\n", true));
+  LadspaFileMap probed;
+  ladspa_probe_files ({ broken_so }, probed);
+  unlink (broken_so.c_str());
+  TCMP (probed.size(), ==, 1);
+  TASSERT (!probed[broken_so].error.empty());
+  TCMP (probed[broken_so].types.size(), ==, 0);
+  TCMP (probed[broken_so].retry, ==, false);
+}
+
+} // Anon
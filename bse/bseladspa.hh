@@ -56,6 +56,7 @@ struct BseLadspaInfo {
   guint	         broken : 1;
   guint	         interactive : 1;	/* low-latency request */
   guint	         rt_capable : 1;	/* hard realtime capability */
+  guint	         inplace_broken : 1;	/* inputs must not alias outputs */
   guint	         n_cports;
   BseLadspaPort *cports;
   guint	         n_aports;
@@ -77,6 +78,8 @@ BseLadspaInfo*	bse_ladspa_info_assemble	  (const gchar		*file_path,
 						   gconstpointer	 ladspa_descriptor);
 void		bse_ladspa_info_free		  (BseLadspaInfo	*bli);
 const gchar*    bse_ladspa_plugin_check_load      (const gchar		*file_name);
+std::vector<Bse::StringPair> bse_ladspa_plugin_check_load_files (const Bse::StringVector &files);
+std::string     bse_ladspa_plugin_probe           (const std::string &file_name);
 gchar*		bse_ladspa_info_port_2str	  (BseLadspaPort	*port);
 
 Bse::StringVector bse_ladspa_plugin_path_list_files (void);
@@ -321,6 +321,7 @@ typedef struct
   void          *handle;
   uint	         activated : 1;
   float	        *ibuffers;
+  float	       **aport_locations;	/* currently connected audio port buffers */
   float          cvalues[1];	/* flexible array */
 } LadspaData;
 #define	LADSPA_DATA_SIZE(bli)	  (sizeof (LadspaData) + (MAX (bli->n_cports, 1) - 1) * sizeof (float))
@@ -378,6 +379,32 @@ ladspa_module_reset (BseModule *module)
     }
 }
 
+static inline void
+ladspa_module_connect_aport (LadspaData *ldata,
+                             uint        aport,
+                             float      *location)
+{
+  if (ldata->aport_locations[aport] != location)
+    {
+      ldata->aport_locations[aport] = location;
+      ldata->bli->connect_port (ldata->handle, ldata->bli->aports[aport].port_index, location);
+    }
+}
+
+static bool
+ladspa_module_aliases_obuffer (BseModule   *module,
+                               const float *ibuffer,
+                               uint         n_values)
+{
+  for (uint i = 0; i < BSE_MODULE_N_OSTREAMS (module); i++)
+    {
+      const float *obuffer = BSE_MODULE_OBUFFER (module, i);
+      if (ibuffer < obuffer + n_values && obuffer < ibuffer + n_values)
+        return true;
+    }
+  return false;
+}
+
 static void
 ladspa_module_process (BseModule *module,
 		       uint       n_values)
@@ -385,14 +412,13 @@ ladspa_module_process (BseModule *module,
   LadspaData *ldata = (LadspaData*) module->user_data;
   BseLadspaInfo *bli = ldata->bli;
   uint i, nis = 0, nos = 0;
-  /* connect audio ports and copy audio buffers */
+  /* connect output ports directly to our ostream buffers */
   for (i = 0; i < bli->n_aports; i++)
     if (bli->aports[i].output)
-      {
-	bli->connect_port (ldata->handle, bli->aports[i].port_index, BSE_MODULE_OBUFFER (module, nos));
-	nos++;
-      }
-    else
+      ladspa_module_connect_aport (ldata, i, BSE_MODULE_OBUFFER (module, nos++));
+  /* connect input ports to the upstream buffers, copy only for scaling or in-place conflicts */
+  for (i = 0; i < bli->n_aports; i++)
+    if (!bli->aports[i].output)
       {
 	float *ibuffer = ldata->ibuffers + nis * BSE_ENGINE_MAX_BLOCK_SIZE;
 	const float *srcbuf = BSE_MODULE_IBUFFER (module, nis);
@@ -400,20 +426,26 @@ ladspa_module_process (BseModule *module,
 	if (bli->aports[i].rate_relative)
 	  for (j = 0; j < n_values; j++)
 	    ibuffer[j] = srcbuf[j] * BSE_SIGNAL_TO_FREQ_FACTOR;
-	else
+	else if (UNLIKELY (bli->inplace_broken) && ladspa_module_aliases_obuffer (module, srcbuf, n_values))
 	  memcpy (ibuffer, srcbuf, sizeof (ibuffer[0]) * n_values);
+	else
+	  ibuffer = const_cast<float*> (srcbuf); /* LADSPA plugins must not write to input ports */
+	ladspa_module_connect_aport (ldata, i, ibuffer);
 	nis++;
       }
   /* process ladspa plugin */
   ldata->bli->run (ldata->handle, n_values);
   /* adjust rate_relative output buffers */
   for (i = 0, nos = 0; i < bli->n_aports; i++)
-    if (bli->aports[i].output && bli->aports[i].rate_relative)
+    if (bli->aports[i].output)
       {
-	float *obuf = BSE_MODULE_OBUFFER (module, nos);
-	uint j;
-	for (j = 0; j < n_values; j++)
-	  obuf[j] *= BSE_SIGNAL_FROM_FREQ_FACTOR;
+        if (bli->aports[i].rate_relative)
+          {
+            float *obuf = BSE_MODULE_OBUFFER (module, nos);
+            uint j;
+            for (j = 0; j < n_values; j++)
+              obuf[j] *= BSE_SIGNAL_FROM_FREQ_FACTOR;
+          }
 	nos++;
       }
 }
@@ -430,6 +462,7 @@ ladspa_module_free_data (void                 *data,
   ldata->bli->cleanup (ldata->handle);
   ldata->handle = NULL;
   g_free (ldata->ibuffers);
+  g_free (ldata->aport_locations);
 }
 
 static void
@@ -477,10 +510,11 @@ ladspa_derived_context_create (BseSource *source,
   bse_block_copy_float (LADSPA_CVALUES_COUNT (bli), ldata->cvalues, self->cvalues);
   /* allocate input audio buffers */
   ldata->ibuffers = g_new (float, klass->gsl_class->n_istreams * BSE_ENGINE_MAX_BLOCK_SIZE);
-  /* connect input audio ports */
+  ldata->aport_locations = g_new0 (float*, bli->n_aports);
+  /* connect input audio ports, ladspa_module_process() rebinds them to upstream buffers */
   for (i = 0, nis = 0; i < bli->n_aports; i++)
     if (bli->aports[i].input)
-      bli->connect_port (ldata->handle, bli->aports[i].port_index, ldata->ibuffers + nis++ * BSE_ENGINE_MAX_BLOCK_SIZE);
+      ladspa_module_connect_aport (ldata, i, ldata->ibuffers + nis++ * BSE_ENGINE_MAX_BLOCK_SIZE);
 
   module = bse_module_new (klass->gsl_class, ldata);
   bse_trans_add (trans, bse_job_integrate (module));
@@ -532,7 +532,7 @@ midi_control_module_process_U (BseModule *module, /* vswitch->smodule */
 
   for (i = 0; i < BSE_MODULE_N_OSTREAMS (module); i++)
     if (module->ostreams[i].connected)
-      module->ostreams[i].values = bse_engine_const_values (cdata->values[i]);
+      bse_module_const_ostream (module, i, cdata->values[i]);
 }
 
 static BseModule*
@@ -693,13 +693,13 @@ voice_input_module_process_U (BseModule *module,
   VoiceInput *vinput = (VoiceInput*) module->user_data;
 
   if (BSE_MODULE_OSTREAM (module, 0).connected)
-    BSE_MODULE_OSTREAM (module, 0).values = bse_engine_const_values (vinput->freq_value);
+    bse_module_const_ostream (module, 0, vinput->freq_value);
   if (BSE_MODULE_OSTREAM (module, 1).connected)
-    BSE_MODULE_OSTREAM (module, 1).values = bse_engine_const_values (vinput->gate);
+    bse_module_const_ostream (module, 1, vinput->gate);
   if (BSE_MODULE_OSTREAM (module, 2).connected)
-    BSE_MODULE_OSTREAM (module, 2).values = bse_engine_const_values (vinput->velocity);
+    bse_module_const_ostream (module, 2, vinput->velocity);
   if (BSE_MODULE_OSTREAM (module, 3).connected)
-    BSE_MODULE_OSTREAM (module, 3).values = bse_engine_const_values (vinput->aftertouch);
+    bse_module_const_ostream (module, 3, vinput->aftertouch);
 }
 
 typedef struct {
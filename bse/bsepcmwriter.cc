@@ -2,7 +2,9 @@
 #include "bsepcmwriter.hh"
 #include "bseserver.hh"
 #include "gsldatautils.hh"
+#include "bseengine.hh"
 #include "bse/internal.hh"
+#include <FLAC/stream_encoder.h>
 #include <errno.h>
 #include <unistd.h>
 #include <sys/types.h>
@@ -19,6 +21,19 @@ static std::atomic<uint64> atomic_trigger_tick {-uint64 (1)};
 static gpointer parent_class = NULL;
 
 // == functions ==
+static gboolean
+bsethread_halt_recording (gpointer data)
+{
+  BsePcmWriter *self = BSE_PCM_WRITER (data);
+  BseServer *server = bse_server_get();
+  if (self == server->pcm_writer)
+    bse_server_stop_recording (server);         // the master recording ends playback
+  else if (self->open)
+    bse_pcm_writer_close (self);                // stems reaching their maximum just finish their file
+  g_object_unref (self);
+  return false;
+}
+
 BSE_BUILTIN_TYPE (BsePcmWriter)
 {
   static const GTypeInfo pcm_writer_info = {
@@ -49,7 +64,8 @@ bse_pcm_writer_class_init (BsePcmWriterClass *klass)
 static void
 bse_pcm_writer_init (BsePcmWriter *self)
 {
-  new (&self->mutex) std::mutex();
+  new (&self->stream) std::atomic<Bse::PcmWriterStream*> (nullptr);
+  new (&self->n_writers) std::atomic<Bse::uint32> (0);
 }
 
 static void
@@ -63,79 +79,272 @@ bse_pcm_writer_finalize (GObject *object)
     }
   /* chain parent class' handler */
   G_OBJECT_CLASS (parent_class)->finalize (object);
-  self->mutex.~mutex();
 }
 
+namespace Bse {
+
+// == PcmWriterStream ==
+/* Recording stream, the engine thread pushes values into a preallocated single-producer
+ * single-consumer ring buffer, a separate I/O thread converts and writes them to disk.
+ * That way, disk stalls cannot cause engine xruns, at worst a long stall drops values.
+ * Offline rendering is not bound to real-time, so there the engine waits for ring space.
+ */
+class PcmWriterStream {
+  static constexpr uint   RING_SECONDS = 4;
+  static constexpr size_t IO_FRAMES = 4096;
+  const uint            n_channels_, n_bits_;
+  const bool            flac_;
+  const uint64          recorded_maximum_;      // in values, 0 for unlimited
+  const bool            offline_;
+  BsePcmWriter         *const writer_;
+  size_t                ring_mask_ = 0;
+  float                *ring_ = nullptr;
+  std::atomic<uint64>   write_pos_ { 0 }, read_pos_ { 0 }, n_dropped_ { 0 };
+  std::atomic<bool>     quit_ { false }, broken_ { false }, producer_waiting_ { false }, io_idle_ { false };
+  int                   fd_ = -1;
+  FLAC__StreamEncoder  *flac_encoder_ = nullptr;
+  uint64                n_bytes_ = 0;           // I/O thread
+  std::vector<int32>    io_buffer_;             // I/O thread conversion buffer
+  std::mutex            mutex_;
+  std::condition_variable cond_, space_cond_;
+  std::thread           thread_;
+  void
+  io_thread ()
+  {
+    Bse::this_thread_set_name ("PcmWriter");
+    const size_t chunk = IO_FRAMES * n_channels_;
+    bool halted = false;
+    for (;;)
+      {
+        const uint64 rpos = read_pos_.load (std::memory_order_relaxed);
+        const uint64 wpos = write_pos_.load (std::memory_order_acquire);
+        if (rpos == wpos)
+          {
+            if (quit_)
+              break;
+            if (!halted && recorded_maximum_ && rpos >= recorded_maximum_)
+              {
+                halted = true;
+                bse_idle_next (bsethread_halt_recording, g_object_ref (writer_));
+              }
+            std::unique_lock<std::mutex> lock (mutex_);
+            io_idle_ = true;
+            if (write_pos_.load() == rpos)
+              cond_.wait_for (lock, std::chrono::milliseconds (20));    // only offline producers notify
+            io_idle_ = false;
+            continue;
+          }
+        const size_t offset = rpos & ring_mask_;
+        const size_t n = std::min (std::min (size_t (wpos - rpos), chunk), ring_mask_ + 1 - offset);
+        if (!broken_)
+          write_values (ring_ + offset, n);
+        read_pos_.store (rpos + n);
+        if (producer_waiting_)
+          {
+            std::lock_guard<std::mutex> lock (mutex_);
+            space_cond_.notify_all();
+          }
+      }
+  }
+  void
+  write_values (const float *values, size_t n_values)
+  {
+    if (flac_encoder_)
+      {
+        int32 *dest = io_buffer_.data();
+        if (n_bits_ == 24)
+          gsl_conv_from_float_clip (GSL_WAVE_FORMAT_SIGNED_24_PAD4, G_BYTE_ORDER, values, dest, n_values);
+        else
+          for (size_t i = 0; i < n_values; i++)
+            dest[i] = CLAMP (bse_ftoi (values[i] * 32768.f), -32768, 32767);
+        if (!FLAC__stream_encoder_process_interleaved (flac_encoder_, dest, n_values / n_channels_))
+          {
+            Bse::info ("failed to encode %zu values to FLAC file: %s", n_values,
+                       FLAC__StreamEncoderStateString[FLAC__stream_encoder_get_state (flac_encoder_)]);
+            broken_ = true;
+          }
+        return;
+      }
+    const GslWaveFormatType format = n_bits_ == 32 ? GSL_WAVE_FORMAT_FLOAT :
+                                     n_bits_ == 24 ? GSL_WAVE_FORMAT_SIGNED_24 : GSL_WAVE_FORMAT_SIGNED_16;
+    const uint n_bytes = gsl_conv_from_float_clip (format, G_LITTLE_ENDIAN, values, io_buffer_.data(), n_values);
+    const uint8 *bytes = (const uint8*) io_buffer_.data();
+    ssize_t l = 0;
+    for (size_t done = 0; done < n_bytes; done += l)
+      {
+        do
+          l = write (fd_, bytes + done, n_bytes - done);
+        while (l < 0 && errno == EINTR);
+        if (l <= 0)
+          {
+            Bse::info ("failed to write %u bytes to WAV file: %s", n_bytes, g_strerror (l < 0 ? errno : EIO));
+            broken_ = true;
+            return;
+          }
+        n_bytes_ += l;
+      }
+  }
+public:
+  explicit
+  PcmWriterStream (BsePcmWriter *writer, uint n_channels, uint n_bits, bool flac, uint64 recorded_maximum, bool offline) :
+    n_channels_ (n_channels), n_bits_ (flac ? MIN (n_bits, 24) : n_bits), flac_ (flac), recorded_maximum_ (recorded_maximum),
+    offline_ (offline), writer_ (writer)
+  {}
+  ~PcmWriterStream()
+  {
+    assert_return (!thread_.joinable());
+    delete[] ring_;
+  }
+  Error
+  open (const char *file, uint sample_freq)
+  {
+    if (flac_)
+      {
+        flac_encoder_ = FLAC__stream_encoder_new();
+        if (!flac_encoder_)
+          return Error::NO_MEMORY;
+        FLAC__stream_encoder_set_channels (flac_encoder_, n_channels_);
+        FLAC__stream_encoder_set_bits_per_sample (flac_encoder_, n_bits_);
+        FLAC__stream_encoder_set_sample_rate (flac_encoder_, sample_freq);
+        FLAC__stream_encoder_set_compression_level (flac_encoder_, 5);
+        if (FLAC__stream_encoder_init_file (flac_encoder_, file, NULL, NULL) != FLAC__STREAM_ENCODER_INIT_STATUS_OK)
+          {
+            const int saved_errno = errno;
+            FLAC__stream_encoder_delete (flac_encoder_);
+            flac_encoder_ = nullptr;
+            return bse_error_from_errno (saved_errno, Error::FILE_OPEN_FAILED);
+          }
+      }
+    else
+      {
+        fd_ = ::open (file, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd_ < 0)
+          return bse_error_from_errno (errno, Error::FILE_OPEN_FAILED);
+        errno = bse_wave_file_dump_header (fd_, 0x7fff0000, n_bits_, n_channels_, sample_freq);
+        if (errno)
+          {
+            const int saved_errno = errno;
+            ::close (fd_);
+            fd_ = -1;
+            return bse_error_from_errno (saved_errno, Error::FILE_OPEN_FAILED);
+          }
+      }
+    // all memory is allocated upfront, so the engine thread never allocates
+    const size_t ring_size = 1 << g_bit_storage (RING_SECONDS * sample_freq * n_channels_);
+    ring_mask_ = ring_size - 1;
+    ring_ = new float[ring_size] ();
+    io_buffer_.resize (IO_FRAMES * n_channels_);
+    thread_ = std::thread (&PcmWriterStream::io_thread, this);
+    return Error::NONE;
+  }
+  // EngineThread, allocation free and lock-free unless offline, returns the number of values accepted
+  size_t
+  push (const float *values, size_t n_values)
+  {
+    const uint64 wpos = write_pos_.load (std::memory_order_relaxed);
+    size_t space = ring_mask_ + 1 - (wpos - read_pos_.load (std::memory_order_acquire));
+    if (space < n_values && offline_)
+      {
+        std::unique_lock<std::mutex> lock (mutex_);
+        producer_waiting_ = true;
+        while (!broken_ && (space = ring_mask_ + 1 - (wpos - read_pos_.load())) < n_values)
+          space_cond_.wait (lock);
+        producer_waiting_ = false;
+      }
+    const size_t n_accepted = std::min (n_values, space) / n_channels_ * n_channels_;
+    n_dropped_ += n_values - n_accepted;
+    const size_t offset = wpos & ring_mask_;
+    const size_t n1 = std::min (n_accepted, ring_mask_ + 1 - offset);
+    std::copy (values, values + n1, ring_ + offset);
+    std::copy (values + n1, values + n_accepted, ring_);
+    write_pos_.store (wpos + n_accepted);
+    if (offline_ && io_idle_)
+      {
+        std::lock_guard<std::mutex> lock (mutex_);
+        cond_.notify_all();
+      }
+    return n_accepted;
+  }
+  void
+  close ()
+  {
+    quit_ = true;
+    cond_.notify_all();
+    if (thread_.joinable())
+      thread_.join();
+    if (n_dropped_)
+      Bse::info ("PCM recording dropped %llu values due to slow disk I/O", (long long unsigned) n_dropped_);
+    if (flac_encoder_)
+      {
+        FLAC__stream_encoder_finish (flac_encoder_);
+        FLAC__stream_encoder_delete (flac_encoder_);
+        flac_encoder_ = nullptr;
+      }
+    if (fd_ >= 0)
+      {
+        bse_wave_file_patch_length (fd_, MIN (n_bytes_, 0x7fff0000));
+        ::close (fd_);
+        fd_ = -1;
+      }
+  }
+  bool broken () const { return broken_; }
+};
+
+} // Bse
+
 Bse::Error
 bse_pcm_writer_open (BsePcmWriter *self,
 		     const gchar  *file,
 		     guint         n_channels,
 		     guint         sample_freq,
-                     uint64        recorded_maximum)
+                     uint64        recorded_maximum,
+                     guint         n_bits)
 {
-  gint fd;
   assert_return (BSE_IS_PCM_WRITER (self), Bse::Error::INTERNAL);
   assert_return (!self->open, Bse::Error::INTERNAL);
   assert_return (file != NULL, Bse::Error::INTERNAL);
   assert_return (n_channels > 0, Bse::Error::INTERNAL);
   assert_return (sample_freq >= 1000, Bse::Error::INTERNAL);
-  self->mutex.lock();
-  self->n_bytes = 0;
-  self->recorded_maximum = recorded_maximum;
-  self->start_tick = atomic_trigger_tick;
-  fd = open (file, O_WRONLY | O_CREAT | O_TRUNC, 0666);
-  if (fd < 0)
+  assert_return (n_bits == 16 || n_bits == 24 || n_bits == 32, Bse::Error::INTERNAL);
+  const bool flac = Bse::string_endswith (Bse::string_tolower (file), ".flac");
+  const bool offline = BSE_SERVER.offline_rendering();
+  auto stream = new Bse::PcmWriterStream (self, n_channels, n_bits, flac, recorded_maximum, offline);
+  const Bse::Error error = stream->open (file, sample_freq);
+  if (error != 0)
     {
-      self->mutex.unlock();
-      return bse_error_from_errno (errno, Bse::Error::FILE_OPEN_FAILED);
+      delete stream;
+      return error;
     }
-
-  errno = bse_wave_file_dump_header (fd, 0x7fff0000, 16, n_channels, sample_freq);
-  if (errno)
-    {
-      close (fd);
-      self->mutex.unlock();
-      return bse_error_from_errno (errno, Bse::Error::FILE_OPEN_FAILED);
-    }
-  self->fd = fd;
+  self->n_values = 0;
+  self->recorded_maximum = recorded_maximum;
+  self->start_tick = atomic_trigger_tick;
+  self->broken = false;
   self->open = TRUE;
-  self->broken = FALSE;
-  self->mutex.unlock();
+  self->stream.store (stream, std::memory_order_release); // engine threads see the above once they see the stream
   return Bse::Error::NONE;
 }
+
 void
 bse_pcm_writer_close (BsePcmWriter *self)
 {
   assert_return (BSE_IS_PCM_WRITER (self));
   assert_return (self->open);
-  self->mutex.lock();
-  bse_wave_file_patch_length (self->fd, self->n_bytes);
-  close (self->fd);
-  self->fd = -1;
+  Bse::PcmWriterStream *stream = self->stream.exchange (nullptr);
   self->open = FALSE;
-  self->mutex.unlock();
+  // wait for engine threads that picked up the stream before it was withdrawn
+  while (self->n_writers.load() > 0)
+    std::this_thread::yield();
+  stream->close();
+  delete stream;
   errno = 0;
 }
 
-static gboolean
-bsethread_halt_recording (gpointer data)
-{
-  bse_server_stop_recording (bse_server_get());
-  return false;
-}
-
-void
-bse_pcm_writer_write (BsePcmWriter *self, size_t n_values, const float *values, uint64 start_stamp)
+static void
+pcm_writer_write_stream (BsePcmWriter *self, Bse::PcmWriterStream *stream, size_t n_values, const float *values, uint64 start_stamp)
 {
-  assert_return (BSE_IS_PCM_WRITER (self));
-  assert_return (self->open);
-  return_unless (n_values);
-  assert_return (values != NULL);
   if (UNLIKELY (start_stamp + n_values <= self->start_tick))
     {
-      self->mutex.lock();
       self->start_tick = atomic_trigger_tick;
-      self->mutex.unlock();
       if (start_stamp + n_values <= self->start_tick)
         return; // writer not yet activated
     }
@@ -146,36 +355,91 @@ bse_pcm_writer_write (BsePcmWriter *self, size_t n_values, const float *values,
       values += delta;
       start_stamp += delta;
     }
-  self->mutex.lock();
-  const uint bw = 2; /* 16bit */
-  if (!self->broken && (!self->recorded_maximum || self->n_bytes < bw * self->recorded_maximum))
+  if (self->recorded_maximum)
+    n_values = MIN (n_values, self->recorded_maximum - MIN (self->n_values, self->recorded_maximum));
+  if (UNLIKELY (stream->broken()))
+    self->broken = true;
+  if (n_values && !self->broken)
+    self->n_values += stream->push (values, n_values);
+}
+
+void
+bse_pcm_writer_write (BsePcmWriter *self, size_t n_values, const float *values, uint64 start_stamp)
+{
+  assert_return (BSE_IS_PCM_WRITER (self));
+  return_unless (n_values);
+  assert_return (values != NULL);
+  // announce the access before picking up the stream, bse_pcm_writer_close() waits for it before deleting the stream
+  self->n_writers.fetch_add (1);
+  Bse::PcmWriterStream *stream = self->stream.load();
+  if (stream)
+    pcm_writer_write_stream (self, stream, n_values, values, start_stamp);
+  self->n_writers.fetch_sub (1, std::memory_order_release);
+}
+
+// == PCM writer tap module ==
+struct PcmWriterTapData {
+  BsePcmWriter *writer = nullptr;
+  float         buffer[BSE_ENGINE_MAX_BLOCK_SIZE * 2] = { 0, };
+};
+
+static void
+pcm_writer_tap_process (BseModule *module, guint n_values)
+{
+  PcmWriterTapData *tdata = (PcmWriterTapData*) module->user_data;
+  assert_return (n_values <= BSE_ENGINE_MAX_BLOCK_SIZE);
+  for (uint c = 0; c < 2; c++)
     {
-      guint j;
-      guint8 *dest = g_new (guint8, n_values * bw);
-      uint n_bytes = gsl_conv_from_float_clip (GSL_WAVE_FORMAT_SIGNED_16,
-                                               G_BYTE_ORDER,
-                                               values,
-                                               dest,
-                                               n_values);
-      if (self->recorded_maximum)
-        n_bytes = bw * MIN (n_bytes / bw, self->recorded_maximum - self->n_bytes / bw);
-      do
-	j = write (self->fd, dest, n_bytes);
-      while (j < 0 && errno == EINTR);
-      if (j > 0)
+      float *d = tdata->buffer + c, *const b = tdata->buffer + 2 * n_values;
+      do { *d = 0; d += 2; } while (d < b);
+      for (uint i = 0; i < BSE_MODULE_JSTREAM (module, c).n_connections; i++)
         {
-          self->n_bytes += j;
-          if (self->recorded_maximum && self->n_bytes >= bw * self->recorded_maximum)
-            bse_idle_next (bsethread_halt_recording, NULL);
+          const float *src = BSE_MODULE_JBUFFER (module, c, i);
+          d = tdata->buffer + c;
+          do { *d += *src++; d += 2; } while (d < b);
         }
-      g_free (dest);
-      if (j < 0 && errno)
-	{
- 	  Bse::info ("failed to write %u bytes to WAV file: %s", n_bytes, g_strerror (errno));
-	  self->broken = TRUE;
-	}
     }
-  self->mutex.unlock();
+  bse_pcm_writer_write (tdata->writer, n_values * 2, tdata->buffer, bse_module_tick_stamp (module));
+}
+
+static void
+pcm_writer_tap_free (gpointer data, const BseModuleClass *klass)        /* UserThread */
+{
+  PcmWriterTapData *tdata = (PcmWriterTapData*) data;
+  g_object_unref (tdata->writer);
+  delete tdata;
+}
+
+BseModule*
+bse_pcm_writer_tap_insert (BsePcmWriter *self, BseModule *omodule, guint ostream_left, guint ostream_right, BseTrans *trans)
+{
+  static const BseModuleClass pcm_writer_tap_class = {
+    0,				/* n_istreams */
+    2,                          /* n_jstreams */
+    0,				/* n_ostreams */
+    pcm_writer_tap_process,	/* process */
+    NULL,                       /* process_defer */
+    NULL,                       /* reset */
+    pcm_writer_tap_free,	/* free */
+    Bse::ModuleFlag::CHEAP,	/* cost */
+  };
+  assert_return (BSE_IS_PCM_WRITER (self), NULL);
+  assert_return (omodule != NULL && trans != NULL, NULL);
+  PcmWriterTapData *tdata = new PcmWriterTapData();
+  tdata->writer = (BsePcmWriter*) g_object_ref (self);
+  BseModule *tap = bse_module_new (&pcm_writer_tap_class, tdata);
+  bse_trans_add (trans, bse_job_integrate (tap));
+  bse_trans_add (trans, bse_job_set_consumer (tap, TRUE));
+  bse_trans_add (trans, bse_job_jconnect (omodule, ostream_left, tap, 0));
+  bse_trans_add (trans, bse_job_jconnect (omodule, ostream_right, tap, 1));
+  return tap;
+}
+
+void
+bse_pcm_writer_tap_remove (BseModule *tap, BseTrans *trans)
+{
+  assert_return (tap != NULL && trans != NULL);
+  bse_trans_add (trans, bse_job_discard (tap));
 }
 
 namespace Bse {
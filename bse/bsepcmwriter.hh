@@ -14,24 +14,30 @@
 
 
 /* --- BsePcmWriter  --- */
+namespace Bse { class PcmWriterStream; }
 struct BsePcmWriter : BseItem {
-  std::mutex	mutex;
-  guint		open : 1;
-  guint		broken : 1;
-  gint		fd;
-  Bse::uint64	n_bytes;
+  guint		open : 1;               // UserThread
+  bool          broken;                 // EngineThread
+  Bse::uint64   n_values;               // EngineThread, values handed to the I/O thread
   Bse::uint64   recorded_maximum;
-  Bse::uint64   start_tick;
+  Bse::uint64   start_tick;             // EngineThread
+  std::atomic<Bse::PcmWriterStream*> stream;    // published by the UserThread after setup
+  std::atomic<Bse::uint32>           n_writers; // EngineThreads inside bse_pcm_writer_write()
 };
 struct BsePcmWriterClass : BseItemClass
 {};
 
+/* n_bits: 16, 24 or 32 (float, WAV only), files ending in ".flac" are FLAC encoded */
 Bse::Error bse_pcm_writer_open	(BsePcmWriter *pdev, const gchar *file, guint n_channels,
-                                 guint sample_freq, Bse::uint64 recorded_maximum);
+                                 guint sample_freq, Bse::uint64 recorded_maximum, guint n_bits = 16);
 void	   bse_pcm_writer_close	(BsePcmWriter *pdev);
-/* writing is lock protected */
+/* writing is lock-free and does not allocate, disk I/O happens in a separate thread */
 void	   bse_pcm_writer_write	(BsePcmWriter *pdev, size_t n_values,
                                  const float *values, Bse::uint64 start_stamp);
+/* record the stereo output of an engine module (e.g. a track or bus stem) */
+BseModule* bse_pcm_writer_tap_insert (BsePcmWriter *pdev, BseModule *omodule, guint ostream_left, guint ostream_right,
+                                      BseTrans *trans);
+void       bse_pcm_writer_tap_remove (BseModule *tap, BseTrans *trans);
 
 namespace Bse {
 
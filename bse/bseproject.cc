@@ -160,6 +160,7 @@ bse_project_init (BseProject *self,
   self->in_undo = FALSE;
   self->in_redo = FALSE;
   self->may_auto_stop = true;
+  self->offline_render = false;
   self->undo_stack = bse_undo_stack_new (self, undo_notify);
   self->redo_stack = bse_undo_stack_new (self, redo_notify);
   self->deactivate_usecs = 3 * 1000000;
@@ -435,6 +436,8 @@ bse_project_store_bse (BseProject *self, BseSuper *super, const char *bsefilenam
   if (self_contained)
     flags |= BSE_STORAGE_SELF_CONTAINED;
   bse_storage_prepare_write (bse_storage, BseStorageMode (flags));
+  if (FEATURE_XML_PROJECT)
+    bse_storage_set_zip_storage (bse_storage, &zip_storage);
   GSList *slist = g_slist_prepend (NULL, super ? (void*) super : (void*) self);
   while (slist)
     {
@@ -453,10 +456,18 @@ bse_project_store_bse (BseProject *self, BseSuper *super, const char *bsefilenam
   Bse::Error error = bse_storage_flush_fd (bse_storage, fd);
   if (close (fd) < 0 && error == Bse::Error::NONE)
     error = bse_error_from_errno (errno, Bse::Error::FILE_WRITE_FAILED);
+  const std::vector<std::string> sample_entries = bse_storage->data.zip_entries;
   bse_storage_reset (bse_storage);
   g_object_unref (bse_storage);
+  auto rm_sample_entries = [&] () {
+    for (const auto &entry : sample_entries)
+      zip_storage.rm_file (entry);
+  };
   if (error != Bse::Error::NONE)
-    return error;
+    {
+      rm_sample_entries();
+      return error;
+    }
 
   // project.xml serialization
   if (FEATURE_XML_PROJECT)
@@ -469,11 +480,15 @@ bse_project_store_bse (BseProject *self, BseSuper *super, const char *bsefilenam
   // create .bse file from container
   if (FEATURE_XML_PROJECT && !zip_storage.export_as (bsefilename))
     {
+      const int saved_errno = errno;
+      rm_sample_entries();
+      errno = saved_errno;
       if (errno || !Bse::Path::check (bsefilename, "w"))
         return bse_error_from_errno (errno, Bse::Error::FILE_WRITE_FAILED);
       return Bse::Error::FILE_WRITE_FAILED;
     }
   zip_storage.rm_file ("bse_storage.scm");
+  rm_sample_entries();
   return Bse::Error::NONE;
 }
 
@@ -765,7 +780,7 @@ bse_project_activate (BseProject *self)
 }
 
 void
-bse_project_start_playback (BseProject *self)
+bse_project_start_playback (BseProject *self, int exact_start_tick)
 {
   BseTrans *trans;
   GSList *slist;
@@ -799,6 +814,8 @@ bse_project_start_playback (BseProject *self)
     }
   if (!songs) // start pcm-writer ASAP if no songs are present
     Bse::PcmWriterImpl::trigger_tick (Bse::TickStamp::current());
+  /* record stems if requested, taps start in sync with the song via the pcm-writer trigger tick */
+  BSE_SERVER.attach_stem_writers (self, trans);
   /* enfore MasterThread roundtrip */
   bse_trans_add (trans, bse_job_nop());
   bse_trans_commit (trans);
@@ -808,6 +825,13 @@ bse_project_start_playback (BseProject *self)
   if (seen_synth || songs)
     bse_project_state_changed (self, Bse::ProjectState::PLAYING);
   /* then, start the sequencer */
+  if (exact_start_tick >= 0 && songs)
+    {
+      std::vector<BseSong*> song_vector;
+      while (songs)
+        song_vector.push_back ((BseSong*) sfi_ring_pop_head (&songs));
+      Bse::Sequencer::instance().start_songs_exact (song_vector, exact_start_tick);
+    }
   while (songs) // start_song will synchronize PcmWriterImpl::trigger_tick
     Bse::Sequencer::instance().start_song ((BseSong*) sfi_ring_pop_head (&songs), 0);
 }
@@ -825,6 +849,7 @@ bse_project_stop_playback (BseProject *self)
   assert_return (BSE_SOURCE_PREPARED (self) == TRUE);
 
   trans = bse_trans_open ();
+  BSE_SERVER.detach_stem_writers (self, trans);
   for (slist = self->supers; slist; slist = slist->next)
     {
       BseSuper *super = BSE_SUPER (slist->data);
@@ -842,7 +867,9 @@ bse_project_stop_playback (BseProject *self)
   bse_trans_commit (trans);
   /* wait until after all modules have actually been dismissed */
   bse_engine_wait_on_trans ();
+  BSE_SERVER.close_stem_writers (self);
   /* update state */
+  self->offline_render = false;
   bse_project_state_changed (self, Bse::ProjectState::ACTIVE);
 }
 
@@ -851,7 +878,8 @@ bse_project_check_auto_stop (BseProject *self)
 {
   assert_return (BSE_IS_PROJECT (self));
 
-  if (self->state == Bse::ProjectState::PLAYING && self->may_auto_stop)
+  if (self->state == Bse::ProjectState::PLAYING && self->may_auto_stop &&
+      !self->offline_render)    // offline rendering stops with the recording, to include the tail
     {
       GSList *slist;
       for (slist = self->supers; slist; slist = slist->next)
@@ -1098,6 +1126,49 @@ ProjectImpl::auto_deactivate (int msec_delay)
   self->deactivate_usecs = msec_delay < 0 ? -1 : msec_delay * 1000;
 }
 
+Error
+ProjectImpl::render_offline (const String &wave_file, int start_tick, int end_tick, double tail_seconds)
+{
+  BseProject *self = as<BseProject*>();
+  BseServer *server = bse_server_get();
+  if (self->state != Bse::ProjectState::INACTIVE || server->dev_use_count)
+    return Error::DEVICE_BUSY;
+  // determine the number of samples needed for the longest song within the tick range
+  const uint mix_freq = bse_engine_sample_freq();
+  double n_stamps = 0;
+  start_tick = MAX (start_tick, 0);
+  for (GSList *slist = self->supers; slist; slist = slist->next)
+    if (BSE_IS_SONG (slist->data))
+      {
+        BseSong *song = BSE_SONG (slist->data);
+        int last_tick = end_tick;
+        if (last_tick <= 0)
+          for (SfiRing *ring = song->tracks_SL; ring; ring = sfi_ring_walk (ring, song->tracks_SL))
+            last_tick = MAX (last_tick, int (bse_track_get_last_tick ((BseTrack*) ring->data)));
+        Bse::SongTiming timing;
+        bse_song_get_timing (song, start_tick, &timing);
+        if (last_tick > start_tick && timing.stamp_ticks > 0)
+          n_stamps = MAX (n_stamps, (last_tick - start_tick) / timing.stamp_ticks);
+      }
+  if (n_stamps <= 0)
+    return Error::INVALID_DURATION;
+  // activate with the free-wheeling offline driver and record until the tail has been rendered
+  ServerImpl &server_impl = ServerImpl::instance();
+  server_impl.offline_rendering (true);
+  bse_server_start_recording (server, wave_file.c_str(), n_stamps / mix_freq + MAX (tail_seconds, 0));
+  Error error = bse_project_activate (self);
+  if (error != 0)
+    {
+      server_impl.offline_rendering (false);
+      bse_server_stop_recording (server);
+      return error;
+    }
+  bse_project_push_undo_silent_deactivate (self);
+  self->offline_render = true;
+  bse_project_start_playback (self, start_tick);
+  return Error::NONE;
+}
+
 int
 ProjectImpl::undo_depth ()
 {
@@ -1254,6 +1325,12 @@ ProjectImpl::restore_from_file (const String &file_name)
         {
           BseStorage *storage = (BseStorage*) bse_object_new (BSE_TYPE_STORAGE, NULL);
           error = bse_storage_input_file (storage, scm_filename.c_str());
+          if (error == 0 && scm_filename != file_name)
+            bse_storage_set_zip_storage (storage, &zip_storage); // sample files are zip entries
+          storage->data.load_progress = [this] (size_t n_done, size_t n_total) {
+            using namespace Aida::KeyValueArgs;
+            emit_event ("loadprogress", "done"_v = int64 (n_done), "total"_v = int64 (n_total));
+          };
           if (error == 0)
             error = bse_project_restore (self, storage);
           bse_storage_reset (storage);
@@ -21,6 +21,7 @@ struct BseProject : BseContainer {
   guint               in_undo : 1;
   guint               in_redo : 1;
   guint               may_auto_stop : 1;
+  guint               offline_render : 1;
   BseUndoStack       *undo_stack;
   BseUndoStack       *redo_stack;
   Bse::ProjectState   state;
@@ -33,7 +34,8 @@ struct BseProjectClass : BseContainerClass
 {};
 
 Bse::Error	bse_project_activate		(BseProject	*project);
-void		bse_project_start_playback	(BseProject	*project);
+void		bse_project_start_playback	(BseProject	*project,
+                                                 int             exact_start_tick = -1);
 void		bse_project_stop_playback	(BseProject	*project);
 void		bse_project_check_auto_stop	(BseProject	*project);
 void		bse_project_deactivate		(BseProject	*project);
@@ -92,6 +94,7 @@ public:
   virtual void               stop                () override;
   virtual void               auto_stop           (bool maystop) override;
   virtual void               auto_deactivate     (int msec_delay) override;
+  virtual Error              render_offline      (const String &wave_file, int start_tick, int end_tick, double tail_seconds) override;
   virtual int                undo_depth          () override;
   virtual void               undo                () override;
   virtual int                redo_depth          () override;
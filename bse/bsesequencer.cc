@@ -234,25 +234,20 @@ Sequencer::pool_poll_Lm (gint timeout_ms)
 }
 
 void
-Sequencer::start_song (BseSong *song, uint64 start_stamp)
+Sequencer::queue_song_SL (BseSong *song, uint64 start_request, bool exact_start, uint start_tick)
 {
   assert_return (BSE_IS_SONG (song));
   assert_return (BSE_SOURCE_PREPARED (song));
   assert_return (song->sequencer_start_request_SL == 0);
   assert_return (song->sequencer_owns_refcount_SL == false);
-  start_stamp = MAX (start_stamp, 1);
-
-  // synchornize pcm-writer output with song start
-  PcmWriterImpl::trigger_tick (start_stamp);
-
   g_object_ref (song);
-  BSE_SEQUENCER_LOCK();
   song->sequencer_owns_refcount_SL = true;
-  song->sequencer_start_request_SL = start_stamp <= 1 ? stamp_ : start_stamp;
+  song->sequencer_exact_start_SL = exact_start;
+  song->sequencer_start_request_SL = start_request;
   song->sequencer_start_SL = 0;
   song->sequencer_done_SL = 0;
   song->delta_stamp_SL = 0;
-  *song->tick_SL = 0;
+  *song->tick_SL = start_tick;
   SfiRing *ring;
   for (ring = song->tracks_SL; ring; ring = sfi_ring_walk (ring, song->tracks_SL))
     {
@@ -260,8 +255,36 @@ Sequencer::start_song (BseSong *song, uint64 start_stamp)
       track->track_done_SL = FALSE;
     }
   songs_ = sfi_ring_append (songs_, song);
+}
+
+void
+Sequencer::start_song (BseSong *song, uint64 start_stamp)
+{
+  assert_return (BSE_IS_SONG (song));
+  start_stamp = MAX (start_stamp, 1);
+
+  // synchornize pcm-writer output with song start
+  PcmWriterImpl::trigger_tick (start_stamp);
+
+  BSE_SEQUENCER_LOCK();
+  queue_song_SL (song, start_stamp <= 1 ? stamp_ : start_stamp, false, 0);
+  BSE_SEQUENCER_UNLOCK();
+  wakeup();
+}
+
+/// Start @a songs at @a start_tick with a common, sample accurate start stamp (for offline rendering).
+uint64
+Sequencer::start_songs_exact (const std::vector<BseSong*> &songs, uint start_tick)
+{
+  BSE_SEQUENCER_LOCK();
+  // while the sequencer lags, the offline engine cannot render beyond stamp_, so this stamp is still ahead
+  const uint64 start_stamp = stamp_ + bse_engine_block_size();
+  PcmWriterImpl::trigger_tick (start_stamp);
+  for (BseSong *song : songs)
+    queue_song_SL (song, start_stamp, true, start_tick);
   BSE_SEQUENCER_UNLOCK();
   wakeup();
+  return start_stamp;
 }
 
 void
@@ -327,6 +350,16 @@ Sequencer::thread_lagging (uint n_blocks)
   return lagging;
 }
 
+/// Wait up to @a timeout_ms until the sequencer is ahead for @a n_blocks future stamps, returns whether it is.
+bool
+Sequencer::wait_ahead (uint n_blocks, uint timeout_ms)
+{
+  const uint64 next_stamp = Bse::TickStamp::current() + n_blocks * bse_engine_block_size();
+  std::unique_lock<std::mutex> sequencer_guard (sequencer_mutex_);
+  return stamp_cond_.wait_for (sequencer_guard, std::chrono::milliseconds (timeout_ms),
+                               [&] () { return stamp_ >= next_stamp; });
+}
+
 static std::atomic<bool> sequencer_thread_running { false };
 
 void
@@ -348,7 +381,12 @@ Sequencer::sequencer_thread ()
 	{
           BseSong *song = BSE_SONG (ring->data);
           bool forced_ticks = 0;
-          if (!song->sequencer_start_SL && song->sequencer_start_request_SL <= next_stamp + bse_engine_block_size())
+          if (!song->sequencer_start_SL && song->sequencer_exact_start_SL)
+            {
+              if (song->sequencer_start_request_SL <= next_stamp)
+                song->sequencer_start_SL = MAX (song->sequencer_start_request_SL, cur_stamp);
+            }
+          else if (!song->sequencer_start_SL && song->sequencer_start_request_SL <= next_stamp + bse_engine_block_size())
             {
               song->sequencer_start_SL = next_stamp;
               forced_ticks = bse_engine_block_size();
@@ -386,6 +424,7 @@ Sequencer::sequencer_thread ()
 	    }
 	}
       stamp_ = next_stamp;
+      stamp_cond_.notify_all();                         // wake up threads in wait_ahead()
       wakeup->awake_after (cur_stamp + bse_engine_block_size ());
     }
   while (pool_poll_Lm (-1) && sequencer_thread_running);
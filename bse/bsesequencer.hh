@@ -15,6 +15,7 @@ class Sequencer {
   uint64     stamp_;            // sequencer time (ahead of real time)
   SfiRing   *songs_;
   std::condition_variable watch_cond_;
+  std::condition_variable stamp_cond_;  // signals advances of stamp_
   PollPool  *poll_pool_;
   EventFd    event_fd_;
   std::thread thread_;
@@ -30,6 +31,7 @@ private:
                                   double stamps_per_tick, BseMidiReceiver *midi_receiver);
   void          process_song_SL  (BseSong *song, uint n_ticks);
   bool          process_song_unlooped_SL (BseSong *song, uint n_ticks, bool force_active_tracks);
+  void          queue_song_SL    (BseSong *song, uint64 start_request, bool exact_start, uint start_tick);
   explicit      Sequencer       ();
 protected:
   static void   _init_threaded  ();
@@ -37,8 +39,10 @@ public:
   void          add_io_watch    (uint n_pfds, const GPollFD *pfds, BseIOWatch watch_func, void *watch_data);
   void          remove_io_watch (BseIOWatch watch_func, void *watch_data);
   void          start_song	(BseSong *song, uint64 start_stamp);
+  uint64        start_songs_exact (const std::vector<BseSong*> &songs, uint start_tick);
   void          remove_song	(BseSong *song);
   bool          thread_lagging  (uint n_blocks);
+  bool          wait_ahead      (uint n_blocks, uint timeout_ms);
   void          wakeup          ()      { event_fd_.wakeup(); }
   static std::mutex& sequencer_mutex () { return sequencer_mutex_; }
   static Sequencer&  instance        () { return *singleton_; }
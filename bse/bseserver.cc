@@ -5,6 +5,9 @@
 #include "gslcommon.hh"
 #include "bsemain.hh"		/* threads enter/leave */
 #include "bsepcmwriter.hh"
+#include "bsesong.hh"
+#include "bsetrack.hh"
+#include "bsebus.hh"
 #include "bsecxxplugin.hh"
 #include "gsldatahandle-mad.hh"
 #include "gslvorbis-enc.hh"
@@ -108,6 +111,9 @@ bse_server_init (BseServer *self)
 
   self->dev_use_count = 0;
   self->pcm_writer = NULL;
+  self->wave_bits = 16;
+  self->stem_directory = NULL;
+  self->stem_per_bus = false;
 
   /* keep the server singleton alive */
   bse_item_use (BSE_ITEM (self));
@@ -253,6 +259,8 @@ bse_server_stop_recording (BseServer *self)
   self->wave_seconds = 0;
   g_free (self->wave_file);
   self->wave_file = NULL;
+  g_free (self->stem_directory);
+  self->stem_directory = NULL;
   auto impl = self->as<Bse::ServerImpl*>();
   impl->notify ("wave_file");
 }
@@ -311,7 +319,8 @@ bse_server_open_devices (BseServer *self)
           const uint n_channels = 2;
 	  error = bse_pcm_writer_open (self->pcm_writer, self->wave_file,
                                        n_channels, bse_engine_sample_freq (),
-                                       n_channels * bse_engine_sample_freq() * self->wave_seconds);
+                                       n_channels * bse_engine_sample_freq() * self->wave_seconds,
+                                       self->wave_bits);
 	  if (error != 0)
 	    {
               UserMessage umsg;
@@ -391,6 +400,7 @@ bse_server_close_devices (BseServer *self)
 	}
       impl->close_pcm_driver();
       impl->close_midi_driver();
+      impl->offline_rendering (false);
       Bse::global_prefs->unlock();
       ServerImpl::instance().enginechange (false);
     }
@@ -705,6 +715,21 @@ ServerImpl::wave_file (const String& filename)
   bse_server_start_recording (self, filename.c_str(), 0);
 }
 
+int
+ServerImpl::wave_bits() const
+{
+  BseServer *self = const_cast<ServerImpl*> (this)->as<BseServer*>();
+  return self->wave_bits;
+}
+
+void
+ServerImpl::wave_bits (int bits)
+{
+  BseServer *self = as<BseServer*>();
+  const uint n_bits = bits > 16 ? (bits > 24 ? 32 : 24) : 16;
+  APPLY_IDL_PROPERTY (self->wave_bits, n_bits);
+}
+
 void
 ServerImpl::enginechange (bool active)
 {
@@ -871,13 +896,9 @@ ServerImpl::load_ladspa ()
   static bool done_once = false;
   return_unless (!done_once);
   done_once = true;
-  // load LADSPA plugins
-  for (const std::string &ladspa_so : bse_ladspa_plugin_path_list_files ())
-    {
-      const char *error = bse_ladspa_plugin_check_load (ladspa_so.c_str());
-      if (error)
-        printerr ("%s: Bse LADSPA plugin registration failed: %s\n", ladspa_so, error);
-    }
+  // load LADSPA plugins, uncached plugins are probed in parallel child processes
+  for (const auto &file_error : bse_ladspa_plugin_check_load_files (bse_ladspa_plugin_path_list_files()))
+    printerr ("%s: Bse LADSPA plugin registration failed: %s\n", file_error.first, file_error.second);
 }
 
 void
@@ -887,6 +908,90 @@ ServerImpl::start_recording (const String &wave_file, double n_seconds)
   bse_server_start_recording (server, wave_file.c_str(), n_seconds);
 }
 
+void
+ServerImpl::start_stem_recording (const String &directory, bool per_bus)
+{
+  BseServer *server = as<BseServer*>();
+  g_free (server->stem_directory);
+  server->stem_directory = directory.empty() ? NULL : g_strdup (directory.c_str());
+  server->stem_per_bus = per_bus;
+}
+
+/// Insert writer taps for all track or bus stems of the songs in @a project, which must have playback contexts.
+void
+ServerImpl::attach_stem_writers (BseProject *project, BseTrans *trans)
+{
+  BseServer *server = as<BseServer*>();
+  return_unless (server->stem_directory != NULL);
+  const bool flac = server->wave_file && string_endswith (string_tolower (server->wave_file), ".flac");
+  const uint n_channels = 2;
+  for (GSList *slist = project->supers; slist; slist = slist->next)
+    {
+      BseSuper *super = BSE_SUPER (slist->data);
+      if (!BSE_IS_SONG (super) || super->context_handle == ~uint (0))
+        continue;
+      BseSong *song = BSE_SONG (super);
+      std::vector<BseSource*> stems;
+      if (server->stem_per_bus)
+        for (SfiRing *ring = song->busses; ring; ring = sfi_ring_walk (ring, song->busses))
+          stems.push_back (BSE_SOURCE (ring->data));
+      else
+        for (SfiRing *ring = song->tracks_SL; ring; ring = sfi_ring_walk (ring, song->tracks_SL))
+          stems.push_back (BSE_SOURCE (ring->data));
+      for (BseSource *source : stems)
+        {
+          BseModule *omodule = BSE_SOURCE_N_OCHANNELS (source) >= 2 ?
+                               bse_source_get_context_omodule (source, super->context_handle) : NULL;
+          if (!omodule)
+            continue;
+          const String filename = Path::join (server->stem_directory,
+                                              string_format ("%s-%s%s", BSE_OBJECT_UNAME (song), BSE_OBJECT_UNAME (source),
+                                                             flac ? ".flac" : ".wav"));
+          BsePcmWriter *writer = (BsePcmWriter*) bse_object_new (BSE_TYPE_PCM_WRITER, NULL);
+          const Error error = bse_pcm_writer_open (writer, filename.c_str(), n_channels, bse_engine_sample_freq(),
+                                                   n_channels * bse_engine_sample_freq() * server->wave_seconds,
+                                                   server->wave_bits);
+          if (error != 0)
+            {
+              Bse::info ("%s: failed to open stem recording: %s", filename, bse_error_blurb (error));
+              g_object_unref (writer);
+              continue;
+            }
+          BseModule *tap = bse_pcm_writer_tap_insert (writer, omodule, 0, 1, trans);
+          stem_taps_.push_back ({ project, writer, tap });
+        }
+    }
+}
+
+/// Remove stem writer taps of @a project, must happen before its playback contexts are dismissed.
+void
+ServerImpl::detach_stem_writers (BseProject *project, BseTrans *trans)
+{
+  for (auto &stem : stem_taps_)
+    if (stem.project == project && stem.tap)
+      {
+        bse_pcm_writer_tap_remove (stem.tap, trans);
+        stem.tap = NULL;
+      }
+}
+
+/// Finish stem files of @a project, after the engine processed detach_stem_writers().
+void
+ServerImpl::close_stem_writers (BseProject *project)
+{
+  for (size_t i = 0; i < stem_taps_.size();)
+    if (stem_taps_[i].project == project && !stem_taps_[i].tap)
+      {
+        BsePcmWriter *writer = stem_taps_[i].writer;
+        if (writer->open)
+          bse_pcm_writer_close (writer);
+        g_object_unref (writer);
+        stem_taps_.erase (stem_taps_.begin() + i);
+      }
+    else
+      i++;
+}
+
 bool
 ServerImpl::can_load (const String &file_name)
 {
@@ -1324,7 +1429,7 @@ ServerImpl::open_midi_driver()
 {
   assert_return (midi_driver_ == nullptr, Error::INTERNAL);
   Error error = Error::UNKNOWN;
-  midi_driver_ = MidiDriver::open (get_prefs().midi_driver, Driver::READONLY, &error);
+  midi_driver_ = MidiDriver::open (offline_rendering_ ? "null" : get_prefs().midi_driver, Driver::READONLY, &error);
   if (!midi_driver_)
     {
       UserMessage umsg;
@@ -1370,7 +1475,11 @@ ServerImpl::open_pcm_driver (uint mix_freq, uint latency, uint *block_size)
   config.mix_freq = mix_freq;
   config.latency_ms = latency;
   config.block_length = *block_size;
-  pcm_driver_ = PcmDriver::open (get_prefs().pcm_driver, Driver::READWRITE, Driver::WRITEONLY, config, &error);
+  // offline rendering uses the free-wheeling null driver, so the engine runs as fast as the CPU allows
+  String devid = offline_rendering_ ? "null=offline" : get_prefs().pcm_driver;
+  if (!offline_rendering_ && devid == "null=offline")
+    devid = "null";
+  pcm_driver_ = PcmDriver::open (devid, Driver::READWRITE, Driver::WRITEONLY, config, &error);
   if (pcm_driver_)
     *block_size = pcm_driver_->block_length();
   else // !pcm_driver_
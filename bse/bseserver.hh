@@ -16,6 +16,9 @@ struct BseServer : BseContainer {
   GSList	  *children;
   gchar		  *wave_file;
   double           wave_seconds;
+  guint            wave_bits;
+  gchar           *stem_directory;
+  bool             stem_per_bus;
   guint		   dev_use_count;
   BseModule       *pcm_imodule;
   BseModule       *pcm_omodule;
@@ -55,10 +58,13 @@ class ServerImpl : public virtual ServerIface, public virtual ContainerImpl {
   int32              tc_ = 0;
   bool               log_messages_ = true;
   bool               pcm_input_checked_ = false;
+  bool               offline_rendering_ = false;
   PcmDriverP         pcm_driver_;
   MidiDriverP        midi_driver_;
   AudioSignal::Engine     *engine_ = nullptr;
   AudioSignal::ProcessorP  midi_proc_;
+  struct StemTap { BseProject *project; BsePcmWriter *writer; BseModule *tap; };
+  std::vector<StemTap>     stem_taps_;
 protected:
   virtual             ~ServerImpl            ();
 public:
@@ -77,6 +83,11 @@ public:
   void                close_midi_driver     ();
   PcmDriverP          pcm_driver            () const { return pcm_driver_; }
   Error               open_pcm_driver       (uint mix_freq, uint latency, uint *block_size);
+  void                offline_rendering     (bool offline) { offline_rendering_ = offline; }
+  void                attach_stem_writers   (BseProject *project, BseTrans *trans);
+  void                detach_stem_writers   (BseProject *project, BseTrans *trans);
+  void                close_stem_writers    (BseProject *project);
+  bool                offline_rendering     () const { return offline_rendering_; }
   void                require_pcm_input     ();
   void                close_pcm_driver      ();
   void                add_pcm_output_processor (AudioSignal::ProcessorP procp);
@@ -87,6 +98,8 @@ public:
   virtual void             log_messages     (bool val) override;
   virtual String           wave_file        () const override;
   virtual void             wave_file        (const String& val) override;
+  virtual int              wave_bits        () const override;
+  virtual void             wave_bits        (int val) override;
   virtual bool             engine_active    () override;
   virtual LegacyObjectIfaceP    from_proxy       (int64_t proxyid) override;
   virtual SharedMemory  get_shared_memory   () override;
@@ -104,6 +117,7 @@ public:
   virtual String        get_custom_instrument_dir () override;
   virtual void   purge_stale_cachedirs   () override;
   virtual void   start_recording         (const String &wave_file, double n_seconds) override;
+  virtual void   start_stem_recording    (const String &directory, bool per_bus) override;
   virtual void   load_assets             () override;
   virtual void   load_ladspa             () override;
   virtual bool   can_load                (const String &file_name) override;
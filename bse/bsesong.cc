@@ -361,6 +361,7 @@ bse_song_prepare (BseSource *source)
 
   bse_object_lock (BSE_OBJECT (self));
   self->sequencer_underrun_detected_SL = FALSE;
+  self->sequencer_exact_start_SL = FALSE;
 
   /* chain parent class' handler */
   BSE_SOURCE_CLASS (parent_class)->prepare (source);
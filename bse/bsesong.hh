@@ -47,6 +47,7 @@ struct BseSong : BseSNet {
   uint		   *tick_SL;		/* tick at stamp_SL */
   guint             sequencer_owns_refcount_SL : 1;
   guint             sequencer_underrun_detected_SL : 1;
+  guint             sequencer_exact_start_SL : 1; /* start exactly at sequencer_start_request_SL */
   guint		    loop_enabled_SL : 1;
   SfiInt	    loop_left_SL;	/* left loop tick */
   SfiInt	    loop_right_SL;	/* left loop tick */
@@ -28,6 +28,13 @@
  * For each track, there is one fluid_synth_t instance (one BseSoundFontOsc),
  * which renders the audio for that track without using fluidsynth effects.
  * Effects can be added using our mixer.
+ *
+ * Each track module is scheduled as an independent, expensive engine node, so
+ * thread_process_nodes() can render several soundfont tracks concurrently on the
+ * DSP threads. Every track synth loads the soundfont file itself, fluidsynth
+ * renders its voices in the calling thread with the default synth.cpu-cores
+ * setting and needs no API locking, as each synth is only ever accessed by the
+ * engine thread processing its module.
  *------------------------------------------------------------------------------------------------
  */
 
@@ -397,7 +404,7 @@ sound_font_osc_process (BseModule *module,
       else
 	flmod->n_silence_samples = 0;
       float done = (flmod->n_silence_samples > flmod->config.silence_bound && flmod->fluid_events == NULL) ? 1.0 : 0.0;
-      BSE_MODULE_OSTREAM (module, BSE_SOUND_FONT_OSC_OCHANNEL_DONE_OUT).values = bse_engine_const_values (done);
+      bse_module_const_ostream (module, BSE_SOUND_FONT_OSC_OCHANNEL_DONE_OUT, done);
     }
 }
 
@@ -516,6 +523,36 @@ sound_font_osc_free_data (void                 *data,
   flmod->fluid_events = fluid_events;
 }
 
+fluid_synth_t*
+bse_sound_font_osc_new_track_synth (const std::string &filename,
+                                    uint               mix_freq,
+                                    fluid_settings_t **fluid_settings_p,
+                                    int               *sfont_id_p)
+{
+  assert_return (fluid_settings_p != NULL, NULL);
+  fluid_settings_t *fluid_settings = new_fluid_settings();
+
+  fluid_settings_setnum (fluid_settings, "synth.sample-rate", mix_freq);
+  /* soundfont instruments should be as loud as beast synthesis network instruments */
+  fluid_settings_setnum (fluid_settings, "synth.gain", 1.0);
+  fluid_settings_setint (fluid_settings, "synth.midi-channels", 16);
+  fluid_settings_setint (fluid_settings, "synth.audio-channels", 1);
+  fluid_settings_setint (fluid_settings, "synth.audio-groups", 1);
+  fluid_settings_setint (fluid_settings, "synth.reverb.active", 0);
+  fluid_settings_setint (fluid_settings, "synth.chorus.active", 0);
+  /* we ensure that our fluid_synth instance is only used by one thread at a time
+   *  => we can disable automated locks that protect all fluid synth API calls
+   */
+  fluid_settings_setint (fluid_settings, "synth.threadsafe-api", 0);
+
+  fluid_synth_t *fluid_synth = new_fluid_synth (fluid_settings);
+  const int sfont_id = fluid_synth_sfload (fluid_synth, filename.c_str(), 0);
+  if (sfont_id_p)
+    *sfont_id_p = sfont_id;
+  *fluid_settings_p = fluid_settings;
+  return fluid_synth;
+}
+
 static void
 bse_sound_font_osc_context_create (BseSource *source,
 				   guint      context_handle,
@@ -529,7 +566,7 @@ bse_sound_font_osc_context_create (BseSource *source,
     NULL,			    /* process_defer */
     sound_font_osc_reset,	    /* reset */
     (BseModuleFreeFunc) sound_font_osc_free_data,  /* free */
-    Bse::ModuleFlag::CHEAP,	    /* flags */
+    Bse::ModuleFlag::EXPENSIVE,	    /* flags */
   };
   SoundFontOscModule *sound_font_osc = g_new0 (SoundFontOscModule, 1);
   BseModule *module;
@@ -576,24 +613,10 @@ bse_sound_font_osc_context_create (BseSource *source,
       if (self->data.cached_fluid_settings)
         delete_fluid_settings (self->data.cached_fluid_settings);
 
-      fluid_settings_t *fluid_settings = self->data.cached_fluid_settings = new_fluid_settings();
-
-      fluid_settings_setnum (fluid_settings, "synth.sample-rate", mix_freq);
-      /* soundfont instruments should be as loud as beast synthesis network instruments */
-      fluid_settings_setnum (fluid_settings, "synth.gain", 1.0);
-      fluid_settings_setint (fluid_settings, "synth.midi-channels", 16);
-      fluid_settings_setint (fluid_settings, "synth.audio-channels", 1);
-      fluid_settings_setint (fluid_settings, "synth.audio-groups", 1);
-      fluid_settings_setint (fluid_settings, "synth.reverb.active", 0);
-      fluid_settings_setint (fluid_settings, "synth.chorus.active", 0);
-      /* we ensure that our fluid_synth instance is only used by one thread at a time
-       *  => we can disable automated locks that protect all fluid synth API calls
-       */
-      fluid_settings_setint (fluid_settings, "synth.threadsafe-api", 0);
-
       self->data.cached_filename = self->data.filename;
-      self->data.cached_fluid_synth = new_fluid_synth (fluid_settings);
-      self->data.cached_sfont_id = fluid_synth_sfload (self->data.cached_fluid_synth, self->data.filename.c_str(), 0);
+      self->data.cached_fluid_synth = bse_sound_font_osc_new_track_synth (self->data.filename, mix_freq,
+                                                                          &self->data.cached_fluid_settings,
+                                                                          &self->data.cached_sfont_id);
       self->data.cached_mix_freq = mix_freq;
     }
   sound_font_osc->fluid_synth = self->data.cached_fluid_synth;
@@ -49,4 +49,10 @@ struct BseSoundFontOsc : BseSource {
 struct BseSoundFontOscClass : BseSourceClass
 {};
 
+/* --- prototypes --- */
+fluid_synth_t* bse_sound_font_osc_new_track_synth (const std::string &filename,
+                                                   uint               mix_freq,
+                                                   fluid_settings_t **fluid_settings_p,
+                                                   int               *sfont_id_p);
+
 #endif /* __BSE_SOUND_FONT_OSC_HH__ */
@@ -52,19 +52,6 @@ static void	bse_standard_osc_update_modules	(BseStandardOsc		*standard_osc,
 
 /* --- variables --- */
 static gpointer	    parent_class = NULL;
-static const gfloat osc_table_freqs[] = {
-  /* FIXME */
-  BSE_KAMMER_FREQUENCY,
-  BSE_KAMMER_FREQUENCY / 2.0,
-  BSE_KAMMER_FREQUENCY / 4.0,
-  BSE_KAMMER_FREQUENCY / 8.0,
-  BSE_KAMMER_FREQUENCY / 16.0,
-  BSE_KAMMER_FREQUENCY * 2.0,
-  BSE_KAMMER_FREQUENCY * 4.0,
-  BSE_KAMMER_FREQUENCY * 8.0,
-  BSE_KAMMER_FREQUENCY * 16.0
-};
-
 
 /* --- functions --- */
 BSE_BUILTIN_TYPE (BseStandardOsc)
@@ -340,9 +327,7 @@ bse_standard_osc_prepare (BseSource *source)
 
   self->config.table = gsl_osc_table_create (bse_engine_sample_freq (),
 					     GslOscWaveForm (self->wave),
-					     bse_window_blackman,
-					     G_N_ELEMENTS (osc_table_freqs),
-					     osc_table_freqs);
+					     bse_window_blackman);
   self->config.transpose_factor = bse_transpose_factor (bse_source_prepared_musical_tuning (BSE_SOURCE (self)), self->transpose);
 
   /* chain parent class' handler */
@@ -396,9 +381,7 @@ bse_standard_osc_update_modules (BseStandardOsc *self,
 	  cdata.old_osc_table = self->config.table;
 	  self->config.table = gsl_osc_table_create (bse_engine_sample_freq (),
 						     GslOscWaveForm (self->wave),
-						     bse_window_blackman,
-						     G_N_ELEMENTS (osc_table_freqs),
-						     osc_table_freqs);
+						     bse_window_blackman);
 	  cdata.config.table = self->config.table;
 	}
       else
@@ -16,7 +16,10 @@
 #include <string.h>
 #include <errno.h>
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <signal.h>
+#include <condition_variable>
+#include <thread>
 
 using Bse::Flac1Handle;
 using Bse::String;
@@ -26,15 +29,6 @@ using Bse::String;
 #define peek_or_return  sfi_scanner_peek_or_return
 
 /* --- typedefs --- */
-struct _BseStorageDBlock
-{
-  gulong         id;
-  GslDataHandle *dhandle;
-  guint          n_channels : 16;
-  guint          needs_close : 1;
-  gfloat         mix_freq;
-  gfloat         osc_freq;
-};
 struct _BseStorageItemLink
 {
   BseItem              *from_item;
@@ -76,6 +70,7 @@ static GQuark   quark_blob_id = 0;
 static GQuark   quark_vorbis_data_handle = 0;
 static GQuark   quark_flac_data_handle = 0;
 static GQuark   quark_dblock_data_handle = 0;
+static GQuark   quark_zip_data_handle = 0;
 static GQuark   quark_bse_storage_binary_v0 = 0;
 
 
@@ -113,6 +108,7 @@ bse_storage_class_init (BseStorageClass *klass)
   quark_vorbis_data_handle = g_quark_from_static_string ("vorbis-data-handle");
   quark_flac_data_handle = g_quark_from_static_string ("flac-data-handle");
   quark_dblock_data_handle = g_quark_from_static_string ("dblock-data-handle");
+  quark_zip_data_handle = g_quark_from_static_string ("zip-data-handle");
   quark_bse_storage_binary_v0 = g_quark_from_static_string ("BseStorageBinaryV0");
   quark_blob = g_quark_from_string ("blob");
   quark_blob_id = g_quark_from_string ("blob-id");
@@ -133,8 +129,6 @@ bse_storage_init (BseStorage *self)
   self->item_links = NULL;
   self->restorable_objects = NULL;
   /* misc */
-  self->dblocks = NULL;
-  self->n_dblocks = 0;
   self->free_me = NULL;
 
   new (&self->data) BseStorage::Data();
@@ -159,10 +153,9 @@ void
 bse_storage_turn_readable (BseStorage  *self,
                            const gchar *storage_name)
 {
-  BseStorageDBlock *dblocks;
   const gchar *cmem;
   gchar *text;
-  guint n_dblocks, l;
+  guint l;
 
   assert_return (BSE_IS_STORAGE (self));
   assert_return (BSE_STORAGE_DBLOCK_CONTAINED (self));
@@ -175,26 +168,21 @@ bse_storage_turn_readable (BseStorage  *self,
 
   cmem = sfi_wstore_peek_text (self->wstore, &l);
   text = (char*) g_memdup (cmem, l + 1);
-  dblocks = self->dblocks;
-  n_dblocks = self->n_dblocks;
-  self->dblocks = NULL;
-  self->n_dblocks = 0;
-  auto blobs = self->data.blobs;
+  auto dblocks = std::move (self->data.dblocks);
+  self->data.dblocks.clear();
+  auto blobs = std::move (self->data.blobs);
   self->data.blobs.clear();
 
   bse_storage_input_text (self, text, storage_name);
   self->free_me = text;
-  self->dblocks = dblocks;
-  self->n_dblocks = n_dblocks;
-  self->data.blobs = blobs;
+  self->data.dblocks = std::move (dblocks);
+  self->data.blobs = std::move (blobs);
   self->set_flag (BSE_STORAGE_DBLOCK_CONTAINED);
 }
 
 void
 bse_storage_reset (BseStorage *self)
 {
-  guint i;
-
   assert_return (BSE_IS_STORAGE (self));
 
   if (self->rstore)
@@ -223,18 +211,21 @@ bse_storage_reset (BseStorage *self)
   self->minor_version = BSE_MINOR_VERSION;
   self->micro_version = BSE_MICRO_VERSION;
 
-  for (i = 0; i < self->n_dblocks; i++)
+  for (auto &it : self->data.dblocks)
     {
-      bse_id_free (self->dblocks[i].id);
-      if (self->dblocks[i].needs_close)
-        gsl_data_handle_close (self->dblocks[i].dhandle);
-      gsl_data_handle_unref (self->dblocks[i].dhandle);
+      BseStorageDBlock &dblock = it.second;
+      bse_id_free (dblock.id);
+      if (dblock.needs_close)
+        gsl_data_handle_close (dblock.dhandle);
+      gsl_data_handle_unref (dblock.dhandle);
     }
-  g_free (self->dblocks);
-  self->dblocks = NULL;
-  self->n_dblocks = 0;
+  self->data.dblocks.clear();
 
   self->data.blobs.clear();
+  self->data.zip_storage = nullptr;
+  self->data.zip_entries.clear();
+  self->data.dhandle_jobs.clear();
+  self->data.load_progress = nullptr;
 
   g_free (self->free_me);
   self->free_me = NULL;
@@ -246,41 +237,38 @@ static gulong
 bse_storage_add_dblock (BseStorage    *self,
                         GslDataHandle *dhandle)
 {
-  guint i = self->n_dblocks++;
-  self->dblocks = g_renew (BseStorageDBlock, self->dblocks, self->n_dblocks);
-  self->dblocks[i].id = bse_id_alloc ();
-  self->dblocks[i].dhandle = gsl_data_handle_ref (dhandle);
+  BseStorageDBlock dblock;
+  dblock.id = bse_id_alloc ();
+  dblock.dhandle = gsl_data_handle_ref (dhandle);
   if (GSL_DATA_HANDLE_OPENED (dhandle))
     {
       /* keep data handles opened to protect against rewrites */
       gsl_data_handle_open (dhandle);
-      self->dblocks[i].needs_close = TRUE;
+      dblock.needs_close = TRUE;
     }
   else
-    self->dblocks[i].needs_close = FALSE;
-  self->dblocks[i].n_channels = gsl_data_handle_n_channels (dhandle);
-  self->dblocks[i].mix_freq = gsl_data_handle_mix_freq (dhandle);
-  self->dblocks[i].osc_freq = gsl_data_handle_osc_freq (dhandle);
-  return self->dblocks[i].id;
+    dblock.needs_close = FALSE;
+  dblock.n_channels = gsl_data_handle_n_channels (dhandle);
+  dblock.mix_freq = gsl_data_handle_mix_freq (dhandle);
+  dblock.osc_freq = gsl_data_handle_osc_freq (dhandle);
+  self->data.dblocks[dblock.id] = dblock;
+  return dblock.id;
 }
 
 static gulong
 bse_storage_add_blob (BseStorage       *self,
                       BseStorage::BlobP blob)
 {
-  self->data.blobs.push_back (blob);
-  return self->data.blobs.back()->id();
+  self->data.blobs[blob->id()] = blob;
+  return blob->id();
 }
 
 static BseStorageDBlock*
 bse_storage_get_dblock (BseStorage    *self,
                         gulong         id)
 {
-  guint i;
-  for (i = 0; i < self->n_dblocks; i++)
-    if (id == self->dblocks[i].id)
-      return self->dblocks + i;
-  return NULL;
+  auto it = self->data.dblocks.find (id);
+  return it != self->data.dblocks.end() ? &it->second : NULL;
 }
 
 void
@@ -301,6 +289,16 @@ bse_storage_prepare_write (BseStorage    *self,
   bse_storage_printf (self, "(bse-version \"%u.%u.%u\")\n\n", BSE_MAJOR_VERSION, BSE_MINOR_VERSION, BSE_MICRO_VERSION);
 }
 
+/// Write raw sample data as separate entries into @a zip_storage, next to the storage text, or read them from there.
+void
+bse_storage_set_zip_storage (BseStorage   *self,
+                             Bse::Storage *zip_storage)
+{
+  assert_return (BSE_IS_STORAGE (self));
+  assert_return (self->wstore || self->rstore);
+  self->data.zip_storage = self->wstore && BSE_STORAGE_DBLOCK_CONTAINED (self) ? nullptr : zip_storage;
+}
+
 void
 bse_storage_input_text (BseStorage  *self,
                         const gchar *text,
@@ -424,6 +422,8 @@ bse_storage_finish_parsing (BseStorage *self)
   assert_return (BSE_IS_STORAGE (self));
   assert_return (self->rstore != NULL);
 
+  storage_run_data_handle_jobs (self);
+
   while (self->item_links)
     {
       BseStorageItemLink *ilink = (BseStorageItemLink*) sfi_ring_pop_head (&self->item_links);
@@ -1511,6 +1511,56 @@ wstore_data_handle_reader (gpointer data,
   return gsl_conv_from_float_clip (GslWaveFormatType (wh->format), wh->byte_order, (const float*) buffer, buffer, n);
 }
 
+static bool
+zip_storage_write_data_handle (BseStorage       *self,
+                               GslDataHandle    *dhandle,
+                               GslWaveFormatType format,
+                               String           &entry)
+{
+  Bse::Storage *zip_storage = self->data.zip_storage;
+  for (size_t i = self->data.zip_entries.size() + 1; entry.empty() || zip_storage->has_file (entry); i++)
+    entry = Bse::string_format ("sample-%u.pcm", i);
+  const int fd = zip_storage->store_file_fd (entry);
+  if (fd < 0)
+    return false;
+  constexpr size_t BLOCK_SIZE = 8192;
+  float buffer[BLOCK_SIZE];
+  const int64 length = gsl_data_handle_length (dhandle);
+  bool success = true;
+  for (int64 pos = 0; success && pos < length; )
+    {
+      int64 n;
+      do
+        n = gsl_data_handle_read (dhandle, pos, MIN (length - pos, int64 (BLOCK_SIZE)), buffer);
+      while (n < 0 && errno == EINTR);
+      if (n <= 0)
+        {
+          bse_storage_error (self, "failed to read from data handle");
+          success = false;
+          break;
+        }
+      pos += n;
+      const int64 nbytes = gsl_conv_from_float_clip (format, G_LITTLE_ENDIAN, buffer, buffer, n);
+      for (int64 j = 0; success && j < nbytes; )
+        {
+          const ssize_t l = write (fd, ((const char*) buffer) + j, nbytes - j);
+          if (l > 0)
+            j += l;
+          else if (l < 0 && errno != EINTR)
+            success = false;
+        }
+    }
+  if (close (fd) < 0)
+    success = false;
+  if (!success)
+    {
+      zip_storage->rm_file (entry);
+      return false;
+    }
+  self->data.zip_entries.push_back (entry);
+  return true;
+}
+
 void
 bse_storage_put_data_handle (BseStorage    *self,
                              guint          significant_bits,
@@ -1572,6 +1622,23 @@ bse_storage_put_data_handle (BseStorage    *self,
         format = GSL_WAVE_FORMAT_SIGNED_8;
       else
         format = GSL_WAVE_FORMAT_SIGNED_16;
+      String entry;
+      if (self->data.zip_storage && zip_storage_write_data_handle (self, dhandle, format, entry))
+        {
+          /* sample data lives in a separate zip entry, streamed from disk on load */
+          bse_storage_break (self);
+          bse_storage_printf (self, "(%s \"%s\" %u %s %s",
+                              g_quark_to_string (quark_zip_data_handle), entry.c_str(),
+                              gsl_data_handle_n_channels (dhandle),
+                              gsl_wave_format_to_string (format),
+                              gsl_byte_order_to_string (G_LITTLE_ENDIAN));
+          bse_storage_puts (self, " ");
+          bse_storage_putf (self, gsl_data_handle_mix_freq (dhandle));
+          bse_storage_puts (self, " ");
+          bse_storage_putf (self, gsl_data_handle_osc_freq (dhandle));
+          bse_storage_putc (self, ')');
+          return;
+        }
       bse_storage_break (self);
       bse_storage_printf (self,
                           "(%s %u %s %s",
@@ -1661,13 +1728,103 @@ parse_raw_data_handle (BseStorage     *self,
   return G_TOKEN_NONE;
 }
 
+static GTokenType
+parse_zip_data_handle (BseStorage     *self,
+                       GslDataHandle **data_handle_p,
+                       guint          *n_channels_p,
+                       gfloat         *mix_freq_p,
+                       gfloat         *osc_freq_p)
+{
+  GScanner *scanner = bse_storage_get_scanner (self);
+  guint n_channels, byte_order;
+  gfloat mix_freq, osc_freq;
+  parse_or_return (scanner, G_TOKEN_STRING);
+  const String entry = scanner->value.v_string;
+  if (entry.empty() || entry.find ('/') != String::npos || entry[0] == '.')
+    return bse_storage_warn_skip (self, "invalid sample file name: %s", entry.c_str());
+  parse_or_return (scanner, G_TOKEN_INT);
+  n_channels = scanner->value.v_int64;
+  if (n_channels <= 0 || n_channels > 256)
+    return bse_storage_warn_skip (self, "invalid number of channels: %u", n_channels);
+  parse_or_return (scanner, G_TOKEN_IDENTIFIER);
+  GslWaveFormatType format = gsl_wave_format_from_string (scanner->value.v_identifier);
+  if (format == GSL_WAVE_FORMAT_NONE)
+    return bse_storage_warn_skip (self, "unknown format for data handle: %s", scanner->value.v_identifier);
+  parse_or_return (scanner, G_TOKEN_IDENTIFIER);
+  byte_order = gsl_byte_order_from_string (scanner->value.v_identifier);
+  if (!byte_order)
+    return bse_storage_warn_skip (self, "unknown byte-order for data handle: %s", scanner->value.v_identifier);
+  g_scanner_get_next_token (scanner);
+  if (scanner->token == G_TOKEN_INT)
+    mix_freq = scanner->value.v_int64;
+  else if (scanner->token == G_TOKEN_FLOAT)
+    mix_freq = scanner->value.v_float;
+  else
+    return G_TOKEN_FLOAT;
+  g_scanner_get_next_token (scanner);
+  if (scanner->token == G_TOKEN_INT)
+    osc_freq = scanner->value.v_int64;
+  else if (scanner->token == G_TOKEN_FLOAT)
+    osc_freq = scanner->value.v_float;
+  else
+    return G_TOKEN_FLOAT;
+  if (osc_freq <= 0 || mix_freq < 4000 || osc_freq >= mix_freq / 2)
+    return bse_storage_warn_skip (self, "invalid oscillating/mixing frequencies: %.7g/%.7g", osc_freq, mix_freq);
+  parse_or_return (scanner, ')');
+  // sample files are extracted from the zip storage, move them out of the way of later imports and stream from there
+  Bse::Storage *zip_storage = self->data.zip_storage;
+  const String tmpentry = zip_storage ? zip_storage->move_to_temporary (entry) : "";
+  const String filename = tmpentry.empty() ? "" : zip_storage->fetch_file (tmpentry);
+  struct stat st;
+  int64 length = 0;
+  if (filename.empty() || stat (filename.c_str(), &st) < 0)
+    {
+      bse_storage_warn (self, "failed to access sample file: %s: %s", entry.c_str(), g_strerror (errno));
+      *data_handle_p = NULL;
+    }
+  else if ((length = st.st_size / gsl_wave_format_byte_width (format)) < 1)
+    {
+      bse_storage_warn (self, "encountered empty data handle");
+      *data_handle_p = NULL;
+    }
+  else
+    *data_handle_p = gsl_wave_handle_new (filename.c_str(),
+                                          n_channels, format, byte_order,
+                                          mix_freq, osc_freq,
+                                          0, length, NULL);
+  if (n_channels_p)
+    *n_channels_p = n_channels;
+  if (mix_freq_p)
+    *mix_freq_p = mix_freq;
+  if (osc_freq_p)
+    *osc_freq_p = osc_freq;
+  return G_TOKEN_NONE;
+}
+
+static GslDataHandle*
+open_vorbis_or_flac_data_handle (GQuark       quark,
+                                 const gchar *file_name,
+                                 gfloat       osc_freq,
+                                 SfiNum       offset,
+                                 SfiNum       length,
+                                 guint       *n_channels_p,
+                                 gfloat      *mix_freq_p)
+{
+  if (quark == quark_vorbis_data_handle)
+    return gsl_data_handle_new_ogg_vorbis_zoffset (file_name, osc_freq, offset, length, n_channels_p, mix_freq_p);
+  if (quark == quark_flac_data_handle)
+    return bse_data_handle_new_flac_zoffset (file_name, osc_freq, offset, length, n_channels_p, mix_freq_p);
+  return NULL;
+}
+
 static GTokenType
 parse_vorbis_or_flac_data_handle (BseStorage     *self,
                                   GQuark          quark,
                                   GslDataHandle **data_handle_p,
                                   guint          *n_channels_p,
                                   gfloat         *mix_freq_p,
-                                  gfloat         *osc_freq_p)
+                                  gfloat         *osc_freq_p,
+                                  BseStorage::DHandleJob *job = NULL)
 {
   GScanner *scanner = bse_storage_get_scanner (self);
   GTokenType token;
@@ -1693,23 +1850,19 @@ parse_vorbis_or_flac_data_handle (BseStorage     *self,
       bse_storage_warn (self, "encountered empty data handle");
       *data_handle_p = NULL;
     }
+  else if (job)
+    {
+      /* decoding the stream headers is deferred to bse_storage_finish_parsing() */
+      const String file_name = self->rstore->fname;
+      job->pending = true;
+      job->open = [quark, file_name, osc_freq, offset, length] (guint *n_channels_p, gfloat *mix_freq_p) {
+        return open_vorbis_or_flac_data_handle (quark, file_name.c_str(), osc_freq, offset, length, n_channels_p, mix_freq_p);
+      };
+    }
   else
     {
-      gfloat mix_freq;
-      if (quark == quark_vorbis_data_handle)
-        {
-          *data_handle_p = gsl_data_handle_new_ogg_vorbis_zoffset (self->rstore->fname, osc_freq,
-                                                                   offset, length, n_channels_p, &mix_freq);
-        }
-      else if (quark == quark_flac_data_handle)
-        {
-          *data_handle_p = bse_data_handle_new_flac_zoffset (self->rstore->fname, osc_freq,
-                                                             offset, length, n_channels_p, &mix_freq);
-        }
-      else
-        {
-          return bse_storage_warn_skip (self, "unknown compressed data handle type in parse_vorbis_or_flac_data_handle");
-        }
+      gfloat mix_freq = 0;
+      *data_handle_p = open_vorbis_or_flac_data_handle (quark, self->rstore->fname, osc_freq, offset, length, n_channels_p, &mix_freq);
       if (osc_freq <= 0 || mix_freq < 4000 || osc_freq >= mix_freq / 2)
         return bse_storage_warn_skip (self, "invalid oscillating/mixing frequencies: %.7g/%.7g", osc_freq, mix_freq);
       if (mix_freq_p)
@@ -1726,6 +1879,7 @@ bse_storage_match_data_handle (BseStorage *self,
       quark == quark_dblock_data_handle)
     return TRUE;
   if (quark == quark_raw_data_handle ||
+      quark == quark_zip_data_handle ||
       quark == quark_vorbis_data_handle ||
       quark == quark_flac_data_handle)
     return TRUE;
@@ -1757,6 +1911,8 @@ parse_data_handle_trampoline (BseStorage     *self,
     return parse_dblock_data_handle (self, data_handle_p, n_channels_p, mix_freq_p, osc_freq_p);
   if (quark == quark_raw_data_handle)
     return parse_raw_data_handle (self, data_handle_p, n_channels_p, mix_freq_p, osc_freq_p);
+  else if (quark == quark_zip_data_handle)
+    return parse_zip_data_handle (self, data_handle_p, n_channels_p, mix_freq_p, osc_freq_p);
   else if (quark == quark_vorbis_data_handle || quark == quark_flac_data_handle)
     return parse_vorbis_or_flac_data_handle (self, quark, data_handle_p, n_channels_p, mix_freq_p, osc_freq_p);
   if (BSE_STORAGE_COMPAT (self, 0, 5, 1) && quark == quark_bse_storage_binary_v0)
@@ -1791,6 +1947,121 @@ bse_storage_parse_data_handle_rest (BseStorage     *self,
   return parse_data_handle_trampoline (self, TRUE, data_handle_p, n_channels_p, mix_freq_p, osc_freq_p);
 }
 
+/// Like bse_storage_parse_data_handle_rest(), but compressed data handles are opened later by a worker thread.
+GTokenType
+bse_storage_parse_data_handle_job (BseStorage              *self,
+                                   BseStorage::DHandleJobP &job)
+{
+  assert_return (BSE_IS_STORAGE (self), G_TOKEN_ERROR);
+  assert_return (self->rstore, G_TOKEN_ERROR);
+  GScanner *scanner = bse_storage_get_scanner (self);
+  job = std::make_shared<BseStorage::DHandleJob>();
+  GQuark quark = 0;
+  if (g_scanner_peek_next_token (scanner) == G_TOKEN_IDENTIFIER)
+    quark = g_quark_try_string (scanner->next_value.v_identifier);
+  if (quark == quark_vorbis_data_handle || quark == quark_flac_data_handle)
+    {
+      g_scanner_get_next_token (scanner); /* eat identifier */
+      return parse_vorbis_or_flac_data_handle (self, quark, &job->dhandle, &job->n_channels, &job->mix_freq, &job->osc_freq, job.get());
+    }
+  return parse_data_handle_trampoline (self, TRUE, &job->dhandle, &job->n_channels, &job->mix_freq, &job->osc_freq);
+}
+
+/// Hand @a job back to the storage once its `done` handler is set up, the handler is called in parsing order.
+void
+bse_storage_commit_data_handle_job (BseStorage             *self,
+                                    BseStorage::DHandleJobP job)
+{
+  assert_return (BSE_IS_STORAGE (self));
+  assert_return (job != nullptr);
+  if (job->pending)
+    {
+      self->data.dhandle_jobs.push_back (job);
+      return;
+    }
+  if (job->done)
+    job->done (job->dhandle, job->n_channels, job->mix_freq, job->osc_freq);
+  if (job->dhandle)
+    gsl_data_handle_unref (job->dhandle);
+  job->dhandle = NULL;
+}
+
+/* Open all pending data handles on a pool of worker threads, while this thread only waits
+ * and reports progress. Completion handlers are then run in parsing order.
+ */
+static void
+storage_run_data_handle_jobs (BseStorage *self)
+{
+  std::vector<BseStorage::DHandleJobP> jobs;
+  std::swap (jobs, self->data.dhandle_jobs);
+  const size_t n_jobs = jobs.size();
+  if (!n_jobs)
+    return;
+  std::mutex mutex;
+  std::condition_variable cond;
+  std::atomic<size_t> next_job { 0 };
+  size_t n_done = 0;
+  auto worker = [&] () {
+    Bse::this_thread_set_name ("BseStorage-Load");
+    for (size_t i = next_job++; i < n_jobs; i = next_job++)
+      {
+        BseStorage::DHandleJob &job = *jobs[i];
+        job.dhandle = job.open (&job.n_channels, &job.mix_freq);
+        /* keep the handle opened, so completion does not need to decode the headers again */
+        if (job.dhandle && gsl_data_handle_open (job.dhandle) != Bse::Error::NONE)
+          {
+            gsl_data_handle_unref (job.dhandle);
+            job.dhandle = NULL;
+          }
+        std::lock_guard<std::mutex> locker (mutex);
+        n_done++;
+        cond.notify_one();
+      }
+  };
+  const size_t n_threads = CLAMP (size_t (Bse::this_thread_online_cpus()), size_t (1), n_jobs);
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < n_threads; i++)
+    threads.push_back (std::thread (worker));
+  auto &progress = self->data.load_progress;
+  size_t n_reported = 0;
+  if (progress)
+    progress (0, n_jobs);
+  std::unique_lock<std::mutex> locker (mutex);
+  while (n_done < n_jobs)
+    {
+      cond.wait_for (locker, std::chrono::milliseconds (50));
+      if (progress && n_done != n_reported)
+        {
+          n_reported = n_done;
+          locker.unlock();
+          progress (n_reported, n_jobs);
+          locker.lock();
+        }
+    }
+  locker.unlock();
+  for (auto &thread : threads)
+    thread.join();
+  if (progress && n_reported != n_jobs)
+    progress (n_jobs, n_jobs);
+  for (auto &job : jobs)
+    {
+      GslDataHandle *dhandle = job->dhandle;
+      if (dhandle && (job->mix_freq < 4000 || job->osc_freq >= job->mix_freq / 2))
+        {
+          bse_storage_warn (self, "invalid oscillating/mixing frequencies: %.7g/%.7g", job->osc_freq, job->mix_freq);
+          dhandle = NULL;
+        }
+      if (job->done)
+        job->done (dhandle, job->n_channels, job->mix_freq, job->osc_freq);
+      if (job->dhandle)
+        {
+          gsl_data_handle_close (job->dhandle);
+          gsl_data_handle_unref (job->dhandle);
+        }
+      job->dhandle = NULL;
+    }
+}
+
 // == blobs ==
 
 BseStorage::Blob::Blob (const std::string& file_name, bool is_temp_file) :
@@ -1970,13 +2241,8 @@ bse_storage_parse_blob (BseStorage             *self,
       gulong id;
       parse_or_return (scanner, G_TOKEN_INT);
       id = scanner->value.v_int64;
-      blob_out = NULL;
-      for (auto blob : self->data.blobs)
-	{
-	  if (blob->id() == id)
-	    blob_out = blob;
-;
-	}
+      auto it = self->data.blobs.find (id);
+      blob_out = it != self->data.blobs.end() ? it->second : NULL;
       if (!blob_out)
 	{
 	  Bse::warning ("failed to lookup storage blob with id=%ld\n", id);
@@ -37,6 +37,16 @@ typedef enum    /*< skip >*/
 /* --- BseStorage --- */
 typedef struct _BseStorageDBlock   BseStorageDBlock;
 typedef struct _BseStorageItemLink BseStorageItemLink;
+namespace Bse { class Storage; }
+struct _BseStorageDBlock
+{
+  gulong         id;
+  GslDataHandle *dhandle;
+  guint          n_channels : 16;
+  guint          needs_close : 1;
+  gfloat         mix_freq;
+  gfloat         osc_freq;
+};
 typedef void (*BseStorageRestoreLink)   (gpointer        data,
                                          BseStorage     *storage,
                                          BseItem        *from_item,
@@ -56,8 +66,6 @@ struct BseStorage : BseObject {
   SfiRing               *item_links;
   SfiPPool              *restorable_objects;
   /* internal data */
-  guint                  n_dblocks;
-  BseStorageDBlock      *dblocks;
   gchar                 *free_me;
   /* compat */ // VERSION-FIXME: needed only for <= 0.5.1
   gfloat                 mix_freq;
@@ -86,9 +94,25 @@ struct BseStorage : BseObject {
 
   typedef std::shared_ptr<Blob> BlobP;
 
+  /* data handle that is opened on a worker thread during bse_storage_finish_parsing() */
+  struct DHandleJob {
+    std::function<GslDataHandle* (guint *n_channels_p, gfloat *mix_freq_p)> open;      // worker thread
+    std::function<void (GslDataHandle*, guint n_channels, gfloat mix_freq, gfloat osc_freq)> done; // BSE thread
+    GslDataHandle *dhandle = nullptr;
+    guint          n_channels = 0;
+    gfloat         mix_freq = 0, osc_freq = 0;
+    bool           pending = false;
+  };
+  typedef std::shared_ptr<DHandleJob> DHandleJobP;
+
   /* C++ allocated data */
   struct Data {
-    std::vector<BlobP> blobs;
+    std::unordered_map<gulong, BseStorageDBlock> dblocks;       // undo data handles, keyed by id
+    std::unordered_map<gulong, BlobP>            blobs;         // undo blobs, keyed by id
+    Bse::Storage                                *zip_storage = nullptr;
+    std::vector<std::string>                     zip_entries;   // sample files written to zip_storage
+    std::vector<DHandleJobP>                     dhandle_jobs;  // pending data handles, in parsing order
+    std::function<void (size_t n_done, size_t n_total)> load_progress;
   } data;
 };
 struct BseStorageClass : BseObjectClass
@@ -110,6 +134,8 @@ void         bse_storage_compat_dhchannels      (BseStorage             *self,
 void         bse_storage_reset                  (BseStorage             *self);
 void         bse_storage_prepare_write          (BseStorage             *self,
                                                  BseStorageMode          mode);
+void         bse_storage_set_zip_storage        (BseStorage             *self,
+                                                 Bse::Storage           *zip_storage);
 void         bse_storage_turn_readable          (BseStorage             *self,
                                                  const gchar            *storage_name);
 Bse::Error bse_storage_input_file             (BseStorage             *self,
@@ -180,6 +206,10 @@ GTokenType   bse_storage_parse_data_handle_rest (BseStorage             *self,
                                                  guint                  *n_channels_p,
                                                  gfloat                 *mix_freq_p,
                                                  gfloat                 *osc_freq_p);
+GTokenType   bse_storage_parse_data_handle_job  (BseStorage             *self,
+                                                 BseStorage::DHandleJobP &job);
+void         bse_storage_commit_data_handle_job (BseStorage             *self,
+                                                 BseStorage::DHandleJobP job);
 GTokenType   bse_storage_parse_xinfos           (BseStorage             *self,
                                                  gchar                ***xinfosp);
 GTokenType   bse_storage_parse_rest             (BseStorage             *self,
@@ -1472,13 +1472,25 @@ TrackImpl::update_clip()
   const double bpm = song ? song->bpm() : 110;
   const AudioSignal::ParamId BPM = midi_in_->BPM;
   MidiLib::MidiInputIfaceP midiin = midi_in_;
-  ClipImpl::OrderedEventsP cevp = clips_.size() ? clips_[0]->tick_events() : nullptr;
+  // play all clips that contain notes back to back, clips without a range play whole bars
+  const int64_t bar_ticks = song ? song->tpqn() * 4 * song->numerator() / song->denominator() : 4 * 384;
+  MidiLib::ClipScheduleP schedule = std::make_shared<MidiLib::ClipSchedule>();
+  for (ClipImplP clip : clips_)
+    {
+      ClipImpl::OrderedEventsP cevp = clip->tick_events();
+      if (!cevp || cevp->empty())
+        continue;
+      int64_t start = clip->start_tick(), stop = clip->stop_tick();
+      if (stop <= start)
+        stop = std::max ((clip->end_tick() + bar_ticks - 1) / bar_ticks * bar_ticks, start + bar_ticks);
+      schedule->add_clip (cevp, start, stop);
+    }
   const double nbpm = midiin->value_to_normalized (BPM, bpm);
-  struct PtrCopy { mutable MidiLib::ClipEventVectorP cevp; };
-  PtrCopy pc { cevp }; // use ClipEventVectorP copy to defer dtor to user thread
+  struct PtrCopy { mutable MidiLib::ClipScheduleP schedule; };
+  PtrCopy pc { schedule }; // use ClipScheduleP copy to defer dtor to user thread
   auto lambda = [midiin, BPM, nbpm, pc] () {
     midiin->set_normalized (BPM, nbpm);
-    midiin->swap_event_vector (pc.cevp);
+    midiin->swap_clip_schedule (pc.schedule);
   };
   BSE_SERVER.commit_job (lambda);
 }
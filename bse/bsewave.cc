@@ -27,6 +27,7 @@ typedef struct
   guint          wh_n_channels;
   gfloat         wh_mix_freq;
   gfloat         wh_osc_freq;
+  BseStorage::DHandleJobP job;
 } ParsedWaveChunk;
 
 
@@ -424,25 +425,22 @@ parse_wave_chunk (BseWave         *wave,
   else if (bse_storage_match_data_handle (storage, quark))
     {
       GTokenType expected_token;
-      if (pwchunk->data_handle)
+      if (pwchunk->data_handle || pwchunk->job)
 	return bse_storage_warn_skip (storage, "duplicate wave data reference");
-      expected_token = bse_storage_parse_data_handle_rest (storage,
-                                                           &pwchunk->data_handle,
-                                                           &pwchunk->wh_n_channels,
-                                                           &pwchunk->wh_mix_freq,
-                                                           &pwchunk->wh_osc_freq);
+      /* compressed data handles are opened in parallel by bse_storage_finish_parsing() */
+      expected_token = bse_storage_parse_data_handle_job (storage, pwchunk->job);
       if (expected_token != G_TOKEN_NONE)
 	return expected_token;
-      if (!pwchunk->data_handle)
+      if (!pwchunk->job->pending && !pwchunk->job->dhandle)
         bse_storage_warn (storage, "invalid wave data reference");
-      /* closing brace already parsed by bse_storage_parse_data_handle_rest() */
+      /* closing brace already parsed by bse_storage_parse_data_handle_job() */
       return G_TOKEN_NONE;
     }
   else if (BSE_STORAGE_COMPAT (storage, 0, 5, 1) && quark == quark_wave_handle)
     {
       GTokenType expected_token;
       g_scanner_get_next_token (scanner); /* eat identifier */
-      if (pwchunk->data_handle)
+      if (pwchunk->data_handle || pwchunk->job)
 	return bse_storage_warn_skip (storage, "duplicate wave data reference");
       expected_token = bse_storage_parse_data_handle (storage,
                                                       &pwchunk->data_handle,
@@ -479,6 +477,47 @@ parse_wave_chunk (BseWave         *wave,
   return g_scanner_get_next_token (scanner) == ')' ? G_TOKEN_NONE : GTokenType (')');
 }
 
+static void
+wave_restore_chunk (BseWave       *wave,
+                    BseStorage    *storage,
+                    GslDataHandle *data_handle,
+                    guint          n_channels,
+                    gfloat         mix_freq,
+                    gfloat         osc_freq,
+                    gchar        **xinfos)
+{
+  if (xinfos)
+    data_handle = gsl_data_handle_new_add_xinfos (data_handle, xinfos);
+  else
+    data_handle = gsl_data_handle_ref (data_handle);
+  GslDataCache *dcache = gsl_data_cache_from_dhandle (data_handle, BSE_WAVE_CHUNK_PADDING * n_channels);
+  gsl_data_handle_unref (data_handle);
+  const gchar *ltype = bse_xinfos_get_value (xinfos, "loop-type");
+  GslWaveLoopType loop_type = ltype ? gsl_wave_loop_type_from_string (ltype) : GSL_WAVE_LOOP_NONE;
+  SfiNum loop_start = bse_xinfos_get_num (xinfos, "loop-start");
+  SfiNum loop_end = bse_xinfos_get_num (xinfos, "loop-end");
+  SfiNum loop_count = bse_xinfos_get_num (xinfos, "loop-count");
+  if (loop_end <= loop_start)
+    {
+      loop_start = loop_end = 0;
+      loop_type = GSL_WAVE_LOOP_NONE;
+      loop_count = 0;
+    }
+  GslWaveChunk *wchunk = gsl_wave_chunk_new (dcache, mix_freq, osc_freq,
+                                             loop_type, loop_start, loop_end, loop_count);
+  gsl_data_cache_unref (dcache);
+  /* we need to keep inlined data handles open to protect against storage (.bse file) overwriting */
+  Bse::Error error = bse_wave_add_inlined_wave_chunk (wave, wchunk);
+  if (error == 0)
+    bse_wave_add_chunk (wave, wchunk);
+  else
+    {
+      bse_storage_error (storage, "failed to reopen inlined data handle (%s): %s",
+                         gsl_data_handle_name (wchunk->dcache->dhandle), bse_error_blurb (error));
+      gsl_wave_chunk_unref (wchunk);
+    }
+}
+
 static GTokenType
 bse_wave_restore_private (BseObject  *object,
 			  BseStorage *storage,
@@ -624,46 +663,25 @@ bse_wave_restore_private (BseObject  *object,
                                                &parsed_wchunk);
       bse_storage_compat_dhreset (storage); /* VERSION-FIXME: needed for <= 0.5.1 */
 
-      if (expected_token == G_TOKEN_NONE && parsed_wchunk.data_handle)
-	{
-	  if (0)
-	    Bse::printerr ("restore-wave-chunk: nch=%u of=%f mf=%f dh=%p\n",
-                           parsed_wchunk.wh_n_channels,
-                           parsed_wchunk.wh_osc_freq, parsed_wchunk.wh_mix_freq,
-                           parsed_wchunk.data_handle);
-          if (parsed_wchunk.data_handle && parsed_wchunk.xinfos)
-            {
-              GslDataHandle *tmp_handle = parsed_wchunk.data_handle;
-              parsed_wchunk.data_handle = gsl_data_handle_new_add_xinfos (parsed_wchunk.data_handle, parsed_wchunk.xinfos);
-              gsl_data_handle_unref (tmp_handle);
-            }
-	  GslDataCache *dcache = gsl_data_cache_from_dhandle (parsed_wchunk.data_handle,
-                                                              BSE_WAVE_CHUNK_PADDING * parsed_wchunk.wh_n_channels);
-          const gchar *ltype = bse_xinfos_get_value (parsed_wchunk.xinfos, "loop-type");
-          GslWaveLoopType loop_type = ltype ? gsl_wave_loop_type_from_string (ltype) : GSL_WAVE_LOOP_NONE;
-          SfiNum loop_start = bse_xinfos_get_num (parsed_wchunk.xinfos, "loop-start");
-          SfiNum loop_end = bse_xinfos_get_num (parsed_wchunk.xinfos, "loop-end");
-          SfiNum loop_count = bse_xinfos_get_num (parsed_wchunk.xinfos, "loop-count");
-          if (loop_end <= loop_start)
-            {
-              loop_start = loop_end = 0;
-              loop_type = GSL_WAVE_LOOP_NONE;
-              loop_count = 0;
-            }
-          GslWaveChunk *wchunk = gsl_wave_chunk_new (dcache, parsed_wchunk.wh_mix_freq, parsed_wchunk.wh_osc_freq,
-                                                     loop_type, loop_start, loop_end, loop_count);
-	  gsl_data_cache_unref (dcache);
-          /* we need to keep inlined data handles open to protect against storage (.bse file) overwriting */
-          Bse::Error error = bse_wave_add_inlined_wave_chunk (wave, wchunk);
-          if (error == 0)
-            bse_wave_add_chunk (wave, wchunk);
-          else
-            {
-              bse_storage_error (storage, "failed to reopen inlined data handle (%s): %s",
-                                 gsl_data_handle_name (wchunk->dcache->dhandle), bse_error_blurb (error));
-              gsl_wave_chunk_unref (wchunk);
-            }
-	}
+      if (expected_token == G_TOKEN_NONE && parsed_wchunk.job)
+        {
+          gchar **xinfos = g_strdupv (parsed_wchunk.xinfos);
+          g_object_ref (wave);
+          parsed_wchunk.job->done = [wave, storage, xinfos] (GslDataHandle *dhandle, guint n_channels, gfloat mix_freq, gfloat osc_freq) {
+            if (dhandle)
+              wave_restore_chunk (wave, storage, dhandle, n_channels, mix_freq, osc_freq, xinfos);
+            else
+              bse_storage_warn (storage, "invalid wave data reference");
+            g_strfreev (xinfos);
+            g_object_unref (wave);
+          };
+          bse_storage_commit_data_handle_job (storage, parsed_wchunk.job);
+        }
+      else if (expected_token == G_TOKEN_NONE && parsed_wchunk.data_handle)
+        wave_restore_chunk (wave, storage, parsed_wchunk.data_handle, parsed_wchunk.wh_n_channels,
+                            parsed_wchunk.wh_mix_freq, parsed_wchunk.wh_osc_freq, parsed_wchunk.xinfos);
+      else if (parsed_wchunk.job && parsed_wchunk.job->dhandle)
+        gsl_data_handle_unref (parsed_wchunk.job->dhandle);
       if (parsed_wchunk.data_handle)
 	gsl_data_handle_unref (parsed_wchunk.data_handle);
       g_strfreev (parsed_wchunk.xinfos);
@@ -395,8 +395,8 @@ wosc_process (BseModule *module,
 
   gate = wosc->done ? 0.0 : 1.0;
   done = wosc->done ? 1.0 : 0.0;
-  module->ostreams[BSE_WAVE_OSC_OCHANNEL_GATE].values = bse_engine_const_values (gate);
-  module->ostreams[BSE_WAVE_OSC_OCHANNEL_DONE].values = bse_engine_const_values (done);
+  bse_module_const_ostream (module, BSE_WAVE_OSC_OCHANNEL_GATE, gate);
+  bse_module_const_ostream (module, BSE_WAVE_OSC_OCHANNEL_DONE, done);
 }
 
 static void
@@ -91,7 +91,10 @@ ClipImpl::xml_reflink (SerializationNode &xs)
 int
 ClipImpl::end_tick ()
 {
-  return 0;
+  int last = 0;
+  for (const PartNote &note : *tick_events())
+    last = std::max (last, note.tick + note.duration);
+  return last;
 }
 
 int
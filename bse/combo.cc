@@ -446,8 +446,14 @@ Engine::render_block()
 {
   assert_return (!(eflags_ & RESCHEDULE));
   frame_counter_ += MAX_RENDER_BLOCK_SIZE;
+  uint64 rendered = 0, bypassed = 0;
   for (auto procp : schedule_)
-    procp->render_block();
+    if (procp->render_block())
+      rendered++;
+    else
+      bypassed++;
+  rendered_blocks_ += rendered;
+  bypassed_blocks_ += bypassed;
   /* TODO: concurrent rendering:
      - rework schedule_ into a dependency tree, each node reflects a processor and its dependencies
      - a worker starts on a node, processes dependencies in depth first fashion
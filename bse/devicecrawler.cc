@@ -3,9 +3,6 @@
 #include "processor.hh"
 #include "path.hh"
 
-#include <filesystem>
-namespace Fs = std::filesystem;
-
 namespace Bse {
 
 ResourceCrawlerImpl::~ResourceCrawlerImpl ()
@@ -18,56 +15,18 @@ ResourceCrawlerImpl::instance_p()
   return singleton;
 }
 
-static ResourceEntry
-device_entry (ResourceType type, const String &uri, const String &name, const String &hints = "")
-{
-  ResourceEntry r;
-  r.type = type;
-  r.uri = uri;
-  r.label = name;
-  r.hints = hints;
-  return r;
-}
-
-static ResourceList&
-crawl_directory (ResourceList &eseq, const std::string &dir, ResourceType file_type, const bool force = false)
-{
-  const String bname = Path::basename (dir);
-  ResourceEntry entry = device_entry (ResourceType::FOLDER, dir, bname);
-  for (auto &e : Fs::directory_iterator (dir))
-    {
-      const auto filepath = e.path();
-      const auto bname = Path::basename (filepath);
-      if (bname.size() && bname[0] == '.')
-        continue;
-      if (e.is_directory())
-        crawl_directory (entry.entries, e.path(), file_type);
-      if (!e.is_regular_file())
-        continue;
-      if ((file_type == ResourceType::SOUNDFONT && string_endswith (string_tolower (filepath), ".sf2")) ||
-          (file_type == ResourceType::WAVE && string_endswith (string_tolower (filepath), ".wav")))
-        {
-          const auto identifier = e.path();
-          // needs extra syscall: hints += string_format ("size=%u", e.file_size());
-          entry.entries.push_back (device_entry (ResourceType::FOLDER, identifier, Path::basename (identifier)));
-        }
-    }
-  if (force || entry.entries.size())
-    eseq.push_back (entry);
-  return eseq;
-}
-
-ResourceList
-ResourceCrawlerImpl::list_files (ResourceType file_type, ResourceOrigin file_origin)
+// Lazily create the index for `file_origin`, indexing starts in the background.
+ResourceIndex*
+ResourceCrawlerImpl::origin_index (ResourceOrigin file_origin)
 {
-  ResourceList eseq;
+  String rootdir;
   switch (file_origin)
     {
       const char *cstr;
     case ResourceOrigin::USER_DOWNLOADS:
       cstr = g_get_user_special_dir (G_USER_DIRECTORY_DOWNLOAD);
       if (cstr)
-        crawl_directory (eseq, cstr, file_type);
+        rootdir = cstr;
       break;
       // case DeviceOrigin::STANDARD_LIBRARY:        break;
       // case DeviceOrigin::PACKAGE_LIBRARY:		break;
@@ -76,7 +35,38 @@ ResourceCrawlerImpl::list_files (ResourceType file_type, ResourceOrigin file_ori
       // case DeviceOrigin::FAVORITES:	        break;
     case ResourceOrigin::NONE:                  break;
     };
-  return eseq;
+  if (rootdir.empty())
+    return nullptr;
+  std::unique_ptr<ResourceIndex> &index = indexes_[rootdir];
+  if (!index)
+    index = std::make_unique<ResourceIndex> (rootdir, [] () {
+      // called from the indexer thread, at most once per poll interval
+      exec_now ([] () { ResourceCrawlerImpl::instance().notify ("files"); });
+    });
+  return index.get();
+}
+
+ResourceList
+ResourceCrawlerImpl::list_files (ResourceType file_type, ResourceOrigin file_origin)
+{
+  ResourceIndex *index = origin_index (file_origin);
+  return index ? index->list_tree (file_type) : ResourceList();
+}
+
+ResourceList
+ResourceCrawlerImpl::list_files_page (ResourceType file_type, ResourceOrigin file_origin, int64 first, int64 count)
+{
+  ResourceIndex *index = origin_index (file_origin);
+  if (!index || first < 0 || count <= 0)
+    return ResourceList();
+  return index->list_page (file_type, first, count);
+}
+
+int64
+ResourceCrawlerImpl::count_files (ResourceType file_type, ResourceOrigin file_origin)
+{
+  ResourceIndex *index = origin_index (file_origin);
+  return index ? index->count (file_type) : 0;
 }
 
 ResourceList
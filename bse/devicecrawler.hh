@@ -3,16 +3,21 @@
 #define __BSE_DEVICECRAWLER_HH__
 
 #include <bse/bseobject.hh>
+#include <bse/resourceindex.hh>
 
 namespace Bse {
 
 class ResourceCrawlerImpl : public ObjectImpl, public virtual ResourceCrawlerIface {
+  std::map<String, std::unique_ptr<ResourceIndex>> indexes_;
+  ResourceIndex* origin_index (ResourceOrigin file_origin);
 protected:
   virtual     ~ResourceCrawlerImpl  ();
   friend class FriendAllocator<ResourceCrawlerImpl>;
 public:
-  ResourceList list_files   (ResourceType file_type, ResourceOrigin file_origin) override;
-  ResourceList list_devices (ResourceType rtype) override;
+  ResourceList list_files      (ResourceType file_type, ResourceOrigin file_origin) override;
+  ResourceList list_files_page (ResourceType file_type, ResourceOrigin file_origin, int64 first, int64 count) override;
+  int64        count_files     (ResourceType file_type, ResourceOrigin file_origin) override;
+  ResourceList list_devices    (ResourceType rtype) override;
   static ResourceCrawlerImplP instance_p ();
   static ResourceCrawlerImpl& instance   () { return *instance_p(); }
 };
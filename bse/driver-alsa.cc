@@ -5,6 +5,9 @@
 #include "gsldatautils.hh"
 #include "bsesequencer.hh"
 #include "bsemididecoder.hh"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 #define ADEBUG(...)             Bse::debug ("alsa", __VA_ARGS__)
 #define MDEBUG(...)             Bse::debug ("midievent", __VA_ARGS__)
@@ -260,6 +263,120 @@ list_alsa_drivers (Driver::EntryVec &entries, bool need_pcm, bool need_rawmidi)
     }
 }
 
+// == PCM Conversion ==
+/* Sample conversion between engine floats and the formats negotiated with
+ * the device, in order of preference: FLOAT, S32, S16. Conversions to S16
+ * add triangular (TPDF) dither of 1 LSB amplitude to decorrelate quantization
+ * noise, the dither state holds 4 independent xorshift32 generators.
+ */
+struct AlsaDither {
+  alignas (16) uint32 state[4] = { 2654435769u, 3772834019u, 1013904223u, 3188472911u };
+};
+
+static inline void
+pcm_clip_float (const float *src, float *dest, size_t n)
+{
+  for (size_t i = 0; i < n; i++)
+    dest[i] = CLAMP (src[i], -1.0f, +1.0f);
+}
+
+static inline void
+pcm_float_to_s32 (const float *src, int32 *dest, size_t n)
+{
+  const float scale = 2147483392.0;     // largest float below 2^31
+  size_t i = 0;
+#ifdef __SSE2__
+  const __m128 vscale = _mm_set1_ps (scale), vmin = _mm_set1_ps (-1.0), vmax = _mm_set1_ps (+1.0);
+  for (; i + 4 <= n; i += 4)
+    {
+      const __m128 v = _mm_min_ps (_mm_max_ps (_mm_loadu_ps (src + i), vmin), vmax);
+      _mm_storeu_si128 ((__m128i*) (dest + i), _mm_cvtps_epi32 (_mm_mul_ps (v, vscale)));
+    }
+#endif
+  for (; i < n; i++)
+    dest[i] = lrintf (CLAMP (src[i], -1.0f, +1.0f) * scale);
+}
+
+static inline uint32
+pcm_dither_rand (uint32 &x)
+{
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  return x;
+}
+
+static inline void
+pcm_float_to_s16_dither (const float *src, int16 *dest, size_t n, AlsaDither &dither)
+{
+  const float scale = 32767.0, lsb = 1.0 / 8388608.0; // (x >> 9) yields 23bit, lsb maps it onto 0..1 LSB
+  size_t i = 0;
+#ifdef __SSE2__
+  __m128i x = _mm_load_si128 ((const __m128i*) dither.state);
+  const __m128 vscale = _mm_set1_ps (scale), vlsb = _mm_set1_ps (lsb);
+  auto next_rand = [&x] () {
+    x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 13));
+    x = _mm_xor_si128 (x, _mm_srli_epi32 (x, 17));
+    x = _mm_xor_si128 (x, _mm_slli_epi32 (x, 5));
+    return _mm_cvtepi32_ps (_mm_srli_epi32 (x, 9));
+  };
+  for (; i + 8 <= n; i += 8)
+    {
+      // TPDF dither, difference of two uniform random values per sample
+      const __m128 d0 = _mm_mul_ps (_mm_sub_ps (next_rand(), next_rand()), vlsb);
+      const __m128 d1 = _mm_mul_ps (_mm_sub_ps (next_rand(), next_rand()), vlsb);
+      const __m128 v0 = _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (src + i), vscale), d0);
+      const __m128 v1 = _mm_add_ps (_mm_mul_ps (_mm_loadu_ps (src + i + 4), vscale), d1);
+      // _mm_packs_epi32 saturates to int16
+      _mm_storeu_si128 ((__m128i*) (dest + i), _mm_packs_epi32 (_mm_cvtps_epi32 (v0), _mm_cvtps_epi32 (v1)));
+    }
+  _mm_store_si128 ((__m128i*) dither.state, x);
+#endif
+  for (; i < n; i++)
+    {
+      const float d = (float (pcm_dither_rand (dither.state[0]) >> 9) - float (pcm_dither_rand (dither.state[1]) >> 9)) * lsb;
+      dest[i] = CLAMP (lrintf (src[i] * scale + d), -32768, 32767);
+    }
+}
+
+static inline void
+pcm_s32_to_float (const int32 *src, float *dest, size_t n)
+{
+  const float scale = 1.0 / 2147483648.0;
+  for (size_t i = 0; i < n; i++)
+    dest[i] = src[i] * scale;
+}
+
+static inline void
+pcm_s16_to_float (const int16 *src, float *dest, size_t n)
+{
+  const float scale = 1.0 / 32768.0;
+  for (size_t i = 0; i < n; i++)
+    dest[i] = src[i] * scale;
+}
+
+static void
+pcm_convert_from_float (snd_pcm_format_t format, const float *src, void *dest, size_t n, AlsaDither &dither)
+{
+  switch (format)
+    {
+    case SND_PCM_FORMAT_FLOAT:  pcm_clip_float (src, (float*) dest, n);                  break;
+    case SND_PCM_FORMAT_S32:    pcm_float_to_s32 (src, (int32*) dest, n);                break;
+    default:                    pcm_float_to_s16_dither (src, (int16*) dest, n, dither); break;
+    }
+}
+
+static void
+pcm_convert_to_float (snd_pcm_format_t format, const void *src, float *dest, size_t n)
+{
+  switch (format)
+    {
+    case SND_PCM_FORMAT_FLOAT:  memcpy (dest, src, n * sizeof (float));       break;
+    case SND_PCM_FORMAT_S32:    pcm_s32_to_float ((const int32*) src, dest, n); break;
+    default:                    pcm_s16_to_float ((const int16*) src, dest, n); break;
+    }
+}
+
 // == AlsaPcmDriver ==
 class AlsaPcmDriver : public PcmDriver {
   snd_pcm_t    *read_handle_ = nullptr;
@@ -269,8 +386,11 @@ class AlsaPcmDriver : public PcmDriver {
   uint          n_channels_ = 0;
   uint          n_periods_ = 0;
   uint          period_size_ = 0;       // count in frames
-  int16        *period_buffer_ = nullptr;
+  char         *period_buffer_ = nullptr;
   uint          read_write_count_ = 0;
+  snd_pcm_format_t read_format_ = SND_PCM_FORMAT_S16, write_format_ = SND_PCM_FORMAT_S16;
+  bool          read_mmap_ = false, write_mmap_ = false;
+  AlsaDither    dither_;
   String        alsadev_;
 public:
   explicit      AlsaPcmDriver (const String &devid) : PcmDriver (devid) {}
@@ -353,10 +473,10 @@ public:
     Error error = !aerror ? Error::NONE : bse_error_from_errno (-aerror, Error::FILE_OPEN_FAILED);
     uint rh_freq = config.mix_freq, rh_n_periods = 2, rh_period_size = period_size;
     if (!aerror && read_handle_)
-      error = alsa_device_setup (read_handle_, config.latency_ms, &rh_freq, &rh_n_periods, &rh_period_size);
+      error = alsa_device_setup (read_handle_, config.latency_ms, &rh_freq, &rh_n_periods, &rh_period_size, &read_format_, &read_mmap_);
     uint wh_freq = config.mix_freq, wh_n_periods = 2, wh_period_size = period_size;
     if (!aerror && write_handle_)
-      error = alsa_device_setup (write_handle_, config.latency_ms, &wh_freq, &wh_n_periods, &wh_period_size);
+      error = alsa_device_setup (write_handle_, config.latency_ms, &wh_freq, &wh_n_periods, &wh_period_size, &write_format_, &write_mmap_);
     // check duplex
     if (error == 0 && read_handle_ && write_handle_)
       {
@@ -375,7 +495,7 @@ public:
     // finish opening or shutdown
     if (error == 0)
       {
-        period_buffer_ = new int16[period_size_ * n_channels_];
+        period_buffer_ = new char[period_size_ * n_channels_ * sizeof (float)](); // fits all formats
         flags_ |= Flags::OPENED;
       }
     else
@@ -393,7 +513,8 @@ public:
     return error;
   }
   Error
-  alsa_device_setup (snd_pcm_t *phandle, uint latency_ms, uint *mix_freq, uint *n_periodsp, uint *period_sizep)
+  alsa_device_setup (snd_pcm_t *phandle, uint latency_ms, uint *mix_freq, uint *n_periodsp, uint *period_sizep,
+                     snd_pcm_format_t *formatp, bool *mmapp)
   {
     // turn on blocking behaviour since we may end up in read() with an unfilled buffer
     if (snd_pcm_nonblock (phandle, 0) < 0)
@@ -404,10 +525,23 @@ public:
       return_error ("snd_pcm_hw_params_any", FILE_OPEN_FAILED);
     if (snd_pcm_hw_params_set_channels (phandle, hparams, n_channels_) < 0)
       return_error ("snd_pcm_hw_params_set_channels", DEVICE_CHANNELS);
-    if (snd_pcm_hw_params_set_access (phandle, hparams, SND_PCM_ACCESS_RW_INTERLEAVED) < 0)
+    // prefer mmap access, so periods are converted directly into the DMA buffer
+    const bool mmap_access = snd_pcm_hw_params_set_access (phandle, hparams, SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+    if (!mmap_access && snd_pcm_hw_params_set_access (phandle, hparams, SND_PCM_ACCESS_RW_INTERLEAVED) < 0)
       return_error ("snd_pcm_hw_params_set_access", DEVICE_FORMAT);
-    if (snd_pcm_hw_params_set_format (phandle, hparams, SND_PCM_FORMAT_S16_LE) < 0)
+    // prefer formats that preserve engine resolution
+    const snd_pcm_format_t formats[] = { SND_PCM_FORMAT_FLOAT, SND_PCM_FORMAT_S32, SND_PCM_FORMAT_S16 };
+    snd_pcm_format_t format = SND_PCM_FORMAT_UNKNOWN;
+    for (auto f : formats)
+      if (snd_pcm_hw_params_test_format (phandle, hparams, f) == 0 &&
+          snd_pcm_hw_params_set_format (phandle, hparams, f) == 0)
+        {
+          format = f;
+          break;
+        }
+    if (format == SND_PCM_FORMAT_UNKNOWN)
       return_error ("snd_pcm_hw_params_set_format", DEVICE_FORMAT);
+    ADEBUG ("PCM: %s: format: %s, access: %s", alsadev_, snd_pcm_format_name (format), mmap_access ? "MMAP" : "RW");
     // sample_rate
     uint rate = *mix_freq;
     if (snd_pcm_hw_params_set_rate (phandle, hparams, rate, 0) < 0 || rate != *mix_freq)
@@ -467,6 +601,8 @@ public:
     if (snd_pcm_sw_params (phandle, sparams) < 0)
       return_error ("snd_pcm_sw_params", FILE_OPEN_FAILED);
     // return values
+    *formatp = format;
+    *mmapp = mmap_access;
     *mix_freq = rate;
     *n_periodsp = nperiods;
     *period_sizep = period_size;
@@ -497,12 +633,13 @@ public:
     // fill playback buffer with silence
     if (write_handle_)
       {
-        const float *zeros = bse_engine_const_zeros (period_size_ / 2); // sizeof (int16) / sizeof (float)
+        memset (period_buffer_, 0, period_size_ * n_channels_ * sizeof (float)); // 0 is silence in all formats
         for (size_t i = 0; i < n_periods_; i++)
           {
             int n;
             do
-              n = snd_pcm_writei (write_handle_, zeros, period_size_);
+              n = write_mmap_ ? snd_pcm_mmap_writei (write_handle_, period_buffer_, period_size_) :
+                  snd_pcm_writei (write_handle_, period_buffer_, period_size_);
             while (n == -EAGAIN); // retry on signals
             // printerr ("%s: written=%d, left: %d / %d\n", __func__, n, snd_pcm_avail (write_handle_), n_periods_ * period_size_);
           }
@@ -567,6 +704,29 @@ public:
     *rlatency = CLAMP (rdelay, 0, buffer_length);
     *wlatency = CLAMP (wdelay, 0, buffer_length);
   }
+  // Map the next contiguous part of the device ring buffer, waits for at least one frame.
+  static ssize_t
+  mmap_begin (snd_pcm_t *phandle, size_t n_frames, char **bufferp, snd_pcm_uframes_t *offsetp)
+  {
+    snd_pcm_sframes_t avail = snd_pcm_avail_update (phandle);
+    if (avail >= 0 && avail < 1)
+      {
+        if (snd_pcm_state (phandle) == SND_PCM_STATE_PREPARED)
+          snd_pcm_start (phandle);      // capture needs explicit start if not linked
+        const int aerror = snd_pcm_wait (phandle, 1000);
+        avail = aerror < 0 ? aerror : snd_pcm_avail_update (phandle);
+      }
+    if (avail < 0)
+      return avail;
+    const snd_pcm_channel_area_t *areas = nullptr;
+    snd_pcm_uframes_t frames = n_frames;
+    const int aerror = snd_pcm_mmap_begin (phandle, &areas, offsetp, &frames);
+    if (aerror < 0)
+      return aerror;
+    // interleaved access, all channels share areas[0].addr and frames are areas[0].step bits apart
+    *bufferp = (char*) areas[0].addr + (areas[0].first + *offsetp * areas[0].step) / 8;
+    return frames;
+  }
   virtual size_t
   pcm_read (size_t n, float *values) override
   {
@@ -578,22 +738,33 @@ public:
     read_write_count_ += 1;
     do
       {
-        ssize_t n_frames = snd_pcm_readi (read_handle_, period_buffer_, n_left);
-        if (n_frames < 0) // errors during read, could be underrun (-EPIPE)
+        char *buffer = period_buffer_;
+        snd_pcm_uframes_t offset = 0;
+        ssize_t n_frames;
+        if (read_mmap_)
+          n_frames = mmap_begin (read_handle_, n_left, &buffer, &offset);
+        else
+          n_frames = snd_pcm_readi (read_handle_, period_buffer_, n_left);
+        if (n_frames <= 0) // errors during read, could be underrun (-EPIPE)
           {
             ADEBUG ("PCM: %s: read() error: %s", alsadev_, snd_strerror (n_frames));
             snd_lib_error_set_handler (silent_error_handler);
             snd_pcm_prepare (read_handle_);     // force retrigger
             snd_lib_error_set_handler (NULL);
-            n_frames = n_left;
-            const size_t frame_size = n_channels_ * sizeof (period_buffer_[0]);
-            memset (period_buffer_, 0, n_frames * frame_size);
+            if (dest) // fill up with silence
+              {
+                std::fill (dest, dest + n_left * n_channels_, 0.0);
+                dest += n_left * n_channels_;
+              }
+            break;
           }
         if (dest) // ignore dummy reads()
           {
-            gsl_conv_to_float (GSL_WAVE_FORMAT_SIGNED_16, G_BYTE_ORDER, period_buffer_, dest, n_frames * n_channels_);
+            pcm_convert_to_float (read_format_, buffer, dest, n_frames * n_channels_);
             dest += n_frames * n_channels_;
           }
+        if (read_mmap_)
+          snd_pcm_mmap_commit (read_handle_, offset, n_frames);
         n_left -= n_frames;
       }
     while (n_left);
@@ -616,10 +787,24 @@ public:
     size_t n_left = period_size_;       // in frames
     while (n_left)
       {
-        gsl_conv_from_float_clip (GSL_WAVE_FORMAT_SIGNED_16, G_BYTE_ORDER, floats, period_buffer_, n_left * n_channels_);
-        floats += n_left * n_channels_;
         ssize_t n = 0;                  // in frames
-        n = snd_pcm_writei (write_handle_, period_buffer_, n_left);
+        if (write_mmap_)                // convert directly into the DMA buffer
+          {
+            char *buffer = nullptr;
+            snd_pcm_uframes_t offset = 0;
+            n = mmap_begin (write_handle_, n_left, &buffer, &offset);
+            if (n > 0)
+              {
+                pcm_convert_from_float (write_format_, floats, buffer, n * n_channels_, dither_);
+                const snd_pcm_sframes_t committed = snd_pcm_mmap_commit (write_handle_, offset, n);
+                n = committed < 0 ? committed : n;
+              }
+          }
+        else
+          {
+            pcm_convert_from_float (write_format_, floats, period_buffer_, n_left * n_channels_, dither_);
+            n = snd_pcm_writei (write_handle_, period_buffer_, n_left);
+          }
         if (n < 0)                      // errors during write, could be overrun (-EPIPE)
           {
             ADEBUG ("PCM: %s: write() error: %s", alsadev_, snd_strerror (n));
@@ -628,6 +813,7 @@ public:
             snd_lib_error_set_handler (NULL);
             return;
           }
+        floats += n * n_channels_;
         n_left -= n;
       }
   }
@@ -211,6 +211,7 @@ class NullPcmDriver : public PcmDriver {
   uint          block_size_ = 0;
   uint          busy_us_ = 0;
   uint          sleep_us_ = 0;
+  bool          offline_ = false;       // free-wheeling, paced by the sequencer only
 public:
   explicit      NullPcmDriver (const String &devid) : PcmDriver (devid) {}
   static PcmDriverP
@@ -250,13 +251,26 @@ public:
     block_size_ = config.block_length;
     busy_us_ = 0;
     sleep_us_ = nosleep ? 0 : 10 * 1000;
+    offline_ = devid() == "offline";
     flags_ |= Flags::OPENED;
-    DDEBUG ("NULL-PCM: opening with freq=%f channels=%d: %s", mix_freq_, n_channels_, bse_error_blurb (Error::NONE));
+    DDEBUG ("NULL-PCM: opening with freq=%f channels=%d offline=%d: %s", mix_freq_, n_channels_, offline_, bse_error_blurb (Error::NONE));
     return Error::NONE;
   }
   virtual bool
   pcm_check_io (long *timeoutp) override
   {
+    if (offline_)
+      {
+        // render as fast as possible, but never ahead of the sequencer so note timing is deterministic
+        Sequencer::instance().wakeup();
+        if (!Sequencer::instance().wait_ahead (2, 250))
+          {
+            *timeoutp = 1;
+            return false;
+          }
+        *timeoutp = 0;
+        return true;
+      }
     // keep the sequencer busy or we will constantly timeout
     Sequencer::instance().wakeup();
     *timeoutp = 1;
@@ -299,6 +313,7 @@ public:
     entry.writeonly = false;
     entry.priority = Driver::PNULL;
     entries.push_back (entry);
+    // "null=offline" renders faster than realtime, it is not listed since only offline rendering may select it
   }
 };
 
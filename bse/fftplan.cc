@@ -0,0 +1,422 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#include "fftplan.hh"
+#include "bse/internal.hh"
+#include <mutex>
+#ifdef __SSE2__
+#include <pmmintrin.h>
+#endif
+
+namespace Bse {
+
+namespace { // Anon
+
+// One complex value, stored as interleaved re, im floats
+struct C1 {
+  float re, im;
+  static constexpr uint N = 1;
+  static C1     load  (const float *p)          { return C1 { p[0], p[1] }; }
+  void          store (float *p) const          { p[0] = re; p[1] = im; }
+  static C1     splat (float re, float im)      { return C1 { re, im }; }
+  friend C1     operator+ (C1 a, C1 b)          { return C1 { a.re + b.re, a.im + b.im }; }
+  friend C1     operator- (C1 a, C1 b)          { return C1 { a.re - b.re, a.im - b.im }; }
+  friend C1     operator* (C1 a, float f)       { return C1 { a.re * f, a.im * f }; }
+  friend C1     operator* (C1 a, C1 w)          { return C1 { a.re * w.re - a.im * w.im, a.re * w.im + a.im * w.re }; }
+  C1            mul_i     () const              { return C1 { -im, re }; }      // multiply by +i
+  C1            mul_neg_i () const              { return C1 { im, -re }; }      // multiply by -i
+};
+
+#ifdef __SSE2__
+// Two complex values per SSE vector
+struct C2 {
+  __m128 v;
+  static constexpr uint N = 2;
+  static C2     load  (const float *p)          { return C2 { _mm_loadu_ps (p) }; }
+  void          store (float *p) const          { _mm_storeu_ps (p, v); }
+  static C2     splat (float re, float im)      { return C2 { _mm_setr_ps (re, im, re, im) }; }
+  friend C2     operator+ (C2 a, C2 b)          { return C2 { _mm_add_ps (a.v, b.v) }; }
+  friend C2     operator- (C2 a, C2 b)          { return C2 { _mm_sub_ps (a.v, b.v) }; }
+  friend C2     operator* (C2 a, float f)       { return C2 { _mm_mul_ps (a.v, _mm_set1_ps (f)) }; }
+  friend C2
+  operator* (C2 a, C2 w)
+  {
+    const __m128 wre = _mm_shuffle_ps (w.v, w.v, _MM_SHUFFLE (2, 2, 0, 0));
+    const __m128 wim = _mm_shuffle_ps (w.v, w.v, _MM_SHUFFLE (3, 3, 1, 1));
+    const __m128 swapped = _mm_shuffle_ps (a.v, a.v, _MM_SHUFFLE (2, 3, 0, 1)); // [im0 re0 im1 re1]
+#ifdef __SSE3__
+    return C2 { _mm_addsub_ps (_mm_mul_ps (a.v, wre), _mm_mul_ps (swapped, wim)) };
+#else
+    const __m128 sign = _mm_castsi128_ps (_mm_setr_epi32 (0x80000000, 0, 0x80000000, 0));
+    return C2 { _mm_add_ps (_mm_mul_ps (a.v, wre), _mm_xor_ps (_mm_mul_ps (swapped, wim), sign)) };
+#endif
+  }
+  C2
+  mul_i () const
+  {
+    const __m128 sign = _mm_castsi128_ps (_mm_setr_epi32 (0x80000000, 0, 0x80000000, 0));
+    return C2 { _mm_xor_ps (_mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1)), sign) };
+  }
+  C2
+  mul_neg_i () const
+  {
+    const __m128 sign = _mm_castsi128_ps (_mm_setr_epi32 (0, 0x80000000, 0, 0x80000000));
+    return C2 { _mm_xor_ps (_mm_shuffle_ps (v, v, _MM_SHUFFLE (2, 3, 0, 1)), sign) };
+  }
+};
+#endif // __SSE2__
+
+// Twiddle factors are stored for the forward direction, the inverse transform uses their conjugate
+template<class V, bool INVERSE> static inline V
+twiddle (const float *w)
+{
+  return V::splat (w[0], INVERSE ? -w[1] : w[1]);
+}
+
+// Multiply by the forward (-i) or inverse (+i) quarter turn
+template<class V, bool INVERSE> static inline V
+rotate (V a)
+{
+  return INVERSE ? a.mul_i() : a.mul_neg_i();
+}
+
+/* Each stage of the self-sorting FFT computes radix-point DFTs over the inputs
+ *   a_j = x[k + s * (q + m * j)]  with j < radix, q < m, k < s
+ * and stores them with twiddle factor w^(q*r) applied to
+ *   y[k + s * (radix * q + r)]
+ * All values are complex, the k loop is contiguous and processed V::N values at a time.
+ */
+#define STAGE_LOAD(j)           V::load (x + 2 * (k + s * (q + m * (j))))
+#define STAGE_STORE(r, value)   (value).store (y + 2 * (k + s * (RADIX * q + (r))))
+
+template<class V, bool INVERSE> static void
+stage_radix2 (uint m, uint s, const float *x, float *y, const float *tw)
+{
+  constexpr uint RADIX = 2;
+  for (uint q = 0; q < m; q++)
+    {
+      const V w1 = twiddle<V,INVERSE> (tw + 2 * q);
+      for (uint k = 0; k < s; k += V::N)
+        {
+          const V a0 = STAGE_LOAD (0), a1 = STAGE_LOAD (1);
+          STAGE_STORE (0, a0 + a1);
+          STAGE_STORE (1, (a0 - a1) * w1);
+        }
+    }
+}
+
+template<class V, bool INVERSE> static void
+stage_radix3 (uint m, uint s, const float *x, float *y, const float *tw)
+{
+  constexpr uint RADIX = 3;
+  const float c = -0.5, sn = (INVERSE ? +1 : -1) * 0.86602540378443864676372317075294; // sin (2 * pi / 3)
+  for (uint q = 0; q < m; q++)
+    {
+      const V w1 = twiddle<V,INVERSE> (tw + 4 * q), w2 = twiddle<V,INVERSE> (tw + 4 * q + 2);
+      for (uint k = 0; k < s; k += V::N)
+        {
+          const V a0 = STAGE_LOAD (0), a1 = STAGE_LOAD (1), a2 = STAGE_LOAD (2);
+          const V t1 = a1 + a2, t2 = (a1 - a2) * sn;
+          const V m1 = a0 + t1 * c, m2 = t2.mul_i();
+          STAGE_STORE (0, a0 + t1);
+          STAGE_STORE (1, (m1 + m2) * w1);
+          STAGE_STORE (2, (m1 - m2) * w2);
+        }
+    }
+}
+
+template<class V, bool INVERSE> static void
+stage_radix4 (uint m, uint s, const float *x, float *y, const float *tw)
+{
+  constexpr uint RADIX = 4;
+  for (uint q = 0; q < m; q++)
+    {
+      const V w1 = twiddle<V,INVERSE> (tw + 6 * q), w2 = twiddle<V,INVERSE> (tw + 6 * q + 2);
+      const V w3 = twiddle<V,INVERSE> (tw + 6 * q + 4);
+      for (uint k = 0; k < s; k += V::N)
+        {
+          const V a0 = STAGE_LOAD (0), a1 = STAGE_LOAD (1), a2 = STAGE_LOAD (2), a3 = STAGE_LOAD (3);
+          const V t0 = a0 + a2, t1 = a0 - a2, t2 = a1 + a3, t3 = rotate<V,INVERSE> (a1 - a3);
+          STAGE_STORE (0, t0 + t2);
+          STAGE_STORE (1, (t1 + t3) * w1);
+          STAGE_STORE (2, (t0 - t2) * w2);
+          STAGE_STORE (3, (t1 - t3) * w3);
+        }
+    }
+}
+
+template<class V, bool INVERSE> static void
+stage_radix5 (uint m, uint s, const float *x, float *y, const float *tw)
+{
+  constexpr uint RADIX = 5;
+  const float c1 = 0.30901699437494742410229341718282;                                  // cos (2 * pi / 5)
+  const float c2 = -0.80901699437494742410229341718282;                                 // cos (4 * pi / 5)
+  const float s1 = (INVERSE ? +1 : -1) * 0.95105651629515357211643933337938;            // sin (2 * pi / 5)
+  const float s2 = (INVERSE ? +1 : -1) * 0.58778525229247312916870595463907;            // sin (4 * pi / 5)
+  for (uint q = 0; q < m; q++)
+    {
+      const V w1 = twiddle<V,INVERSE> (tw + 8 * q), w2 = twiddle<V,INVERSE> (tw + 8 * q + 2);
+      const V w3 = twiddle<V,INVERSE> (tw + 8 * q + 4), w4 = twiddle<V,INVERSE> (tw + 8 * q + 6);
+      for (uint k = 0; k < s; k += V::N)
+        {
+          const V a0 = STAGE_LOAD (0), a1 = STAGE_LOAD (1), a2 = STAGE_LOAD (2), a3 = STAGE_LOAD (3), a4 = STAGE_LOAD (4);
+          const V t1 = a1 + a4, t2 = a2 + a3, t3 = a1 - a4, t4 = a2 - a3;
+          const V m1 = a0 + t1 * c1 + t2 * c2, m2 = a0 + t1 * c2 + t2 * c1;
+          const V n1 = (t3 * s1 + t4 * s2).mul_i(), n2 = (t3 * s2 - t4 * s1).mul_i();
+          STAGE_STORE (0, a0 + t1 + t2);
+          STAGE_STORE (1, (m1 + n1) * w1);
+          STAGE_STORE (2, (m2 + n2) * w2);
+          STAGE_STORE (3, (m2 - n2) * w3);
+          STAGE_STORE (4, (m1 - n1) * w4);
+        }
+    }
+}
+
+// O(radix^2) DFT for prime factors without specialized butterfly
+template<class V, bool INVERSE> static void
+stage_generic (uint radix, uint m, uint s, const float *x, float *y, const float *tw, const float *omegas)
+{
+  const uint RADIX = radix;
+  V a[radix];
+  for (uint q = 0; q < m; q++)
+    for (uint k = 0; k < s; k += V::N)
+      {
+        for (uint j = 0; j < radix; j++)
+          a[j] = STAGE_LOAD (j);
+        V sum = a[0];
+        for (uint j = 1; j < radix; j++)
+          sum = sum + a[j];
+        STAGE_STORE (0, sum);
+        for (uint r = 1; r < radix; r++)
+          {
+            sum = a[0];
+            for (uint j = 1, jr = r; j < radix; j++, jr += r)
+              sum = sum + a[j] * twiddle<V,INVERSE> (omegas + 2 * (jr % radix));
+            const V w = twiddle<V,INVERSE> (tw + 2 * (q * (radix - 1) + r - 1));
+            STAGE_STORE (r, sum * w);
+          }
+      }
+}
+
+#undef STAGE_LOAD
+#undef STAGE_STORE
+
+template<class V, bool INVERSE> static void
+run_stage (uint radix, uint m, uint s, const float *x, float *y, const float *tw, const float *omegas)
+{
+  switch (radix)
+    {
+    case 2:     return stage_radix2<V,INVERSE> (m, s, x, y, tw);
+    case 3:     return stage_radix3<V,INVERSE> (m, s, x, y, tw);
+    case 4:     return stage_radix4<V,INVERSE> (m, s, x, y, tw);
+    case 5:     return stage_radix5<V,INVERSE> (m, s, x, y, tw);
+    default:    return stage_generic<V,INVERSE> (radix, m, s, x, y, tw, omegas);
+    }
+}
+
+static std::vector<uint>
+factorize (uint n)
+{
+  std::vector<uint> factors;
+  while (n % 4 == 0)
+    factors.push_back (4), n /= 4;
+  if (n % 2 == 0)
+    factors.push_back (2), n /= 2;
+  for (uint p = 3; p * p <= n; p += 2)
+    while (n % p == 0)
+      factors.push_back (p), n /= p;
+  if (n > 1)
+    factors.push_back (n);
+  return factors;
+}
+
+} // Anon
+
+FFTPlan::FFTPlan (uint n_values, bool real) :
+  n_values_ (n_values), real_ (real)
+{
+  assert_return (n_values >= 1);
+  if (real)
+    {
+      assert_return (n_values % 2 == 0);
+      half_ = complex_plan (n_values / 2);
+      real_twiddles_.resize (n_values / 4 + 1);
+      for (uint k = 0; k < real_twiddles_.size(); k++)
+        {
+          const double theta = -2.0 * M_PI * k / n_values;
+          real_twiddles_[k] = { float (cos (theta)), float (sin (theta)) };
+        }
+      return;
+    }
+  uint n = n_values, stride = 1;
+  for (uint radix : factorize (n_values))
+    {
+      Stage stage;
+      stage.radix = radix;
+      stage.m = n / radix;
+      stage.stride = stride;
+      stage.twiddles.resize (stage.m * (radix - 1));
+      for (uint q = 0; q < stage.m; q++)
+        for (uint r = 1; r < radix; r++)
+          {
+            const double theta = -2.0 * M_PI * ((q * r) % n) / n;
+            stage.twiddles[q * (radix - 1) + r - 1] = { float (cos (theta)), float (sin (theta)) };
+          }
+      if (radix > 5)
+        for (uint j = 0; j < radix; j++)
+          {
+            const double theta = -2.0 * M_PI * j / radix;
+            stage.omegas.push_back ({ float (cos (theta)), float (sin (theta)) });
+          }
+      n = stage.m;
+      stride *= radix;
+      stages_.push_back (std::move (stage));
+    }
+}
+
+template<bool INVERSE> void
+FFTPlan::transform (const Complex *in, Complex *out) const
+{
+  if (stages_.empty())  // n_values == 1
+    {
+      out[0] = in[0];
+      return;
+    }
+  static thread_local std::vector<Complex> scratch;
+  if (scratch.size() < n_values_)
+    scratch.resize (n_values_);
+  // alternate between out and scratch, so the last stage writes into out
+  const size_t n_stages = stages_.size();
+  Complex *bufs[2] = { out, scratch.data() };
+  if (in == out && n_stages % 2 == 1)
+    {
+      std::copy (in, in + n_values_, scratch.data());
+      in = scratch.data();
+    }
+  const Complex *x = in;
+  for (size_t i = 0; i < n_stages; i++)
+    {
+      const Stage &stage = stages_[i];
+      Complex *y = bufs[(n_stages - 1 - i) & 1];
+      const float *tw = &stage.twiddles[0].re, *omegas = stage.omegas.empty() ? nullptr : &stage.omegas[0].re;
+#ifdef __SSE2__
+      if (stage.stride % 2 == 0)
+        run_stage<C2,INVERSE> (stage.radix, stage.m, stage.stride, &x[0].re, &y[0].re, tw, omegas);
+      else
+#endif
+        run_stage<C1,INVERSE> (stage.radix, stage.m, stage.stride, &x[0].re, &y[0].re, tw, omegas);
+      x = y;
+    }
+}
+
+void
+FFTPlan::fftac (const float *ri_values_in, float *ri_values_out) const
+{
+  assert_return (!real_);
+  transform<false> ((const Complex*) ri_values_in, (Complex*) ri_values_out);
+}
+
+void
+FFTPlan::fftsc (const float *ri_values_in, float *ri_values_out, bool scale) const
+{
+  assert_return (!real_);
+  transform<true> ((const Complex*) ri_values_in, (Complex*) ri_values_out);
+  if (scale)
+    {
+      const float f = 1.0 / n_values_;
+      for (uint i = 0; i < 2 * n_values_; i++)
+        ri_values_out[i] *= f;
+    }
+}
+
+void
+FFTPlan::fftar (const float *r_values_in, float *ri_values_out) const
+{
+  assert_return (real_);
+  // the even and odd samples form a complex sequence z of n_values/2 with Z = E + i*O
+  half_->transform<false> ((const Complex*) r_values_in, (Complex*) ri_values_out);
+  Complex *X = (Complex*) ri_values_out;
+  const uint n2 = n_values_ / 2;
+  const float z0re = X[0].re, z0im = X[0].im;
+  X[0] = { z0re + z0im, z0re - z0im };          // H(0) and H(n_values/2)
+  for (uint k = 1; k <= n2 / 2; k++)
+    {
+      // E[k] = (Z[k] + conj (Z[n2-k])) / 2, O[k] = -i * (Z[k] - conj (Z[n2-k])) / 2, H[k] = E[k] + w^k * O[k]
+      const uint j = n2 - k;
+      const C1 a { X[k].re, X[k].im }, b { X[j].re, -X[j].im };
+      const C1 e = (a + b) * 0.5f, wo = ((a - b) * 0.5f).mul_neg_i() * C1 { real_twiddles_[k].re, real_twiddles_[k].im };
+      const C1 hk = e + wo, hj = e - wo;
+      X[k] = { hk.re, hk.im };
+      X[j] = { hj.re, -hj.im };
+    }
+}
+
+void
+FFTPlan::fftsr (const float *ri_values_in, float *r_values_out, bool scale) const
+{
+  assert_return (real_);
+  // recombine H into Z = 2 * (E + i*O), the complex synthesis of n_values/2 then yields n_values * samples
+  const Complex *X = (const Complex*) ri_values_in;
+  Complex *Z = (Complex*) r_values_out;
+  const uint n2 = n_values_ / 2;
+  const float f = scale ? 1.0 / n_values_ : 1.0;
+  const float h0 = X[0].re, hn = X[0].im;
+  Z[0] = { (h0 + hn) * f, (h0 - hn) * f };
+  for (uint k = 1; k <= n2 / 2; k++)
+    {
+      const uint j = n2 - k;
+      const C1 a { X[k].re, X[k].im }, b { X[j].re, -X[j].im };
+      const C1 e = (a + b) * f;
+      const C1 o = (a - b) * f * C1 { real_twiddles_[k].re, -real_twiddles_[k].im };
+      const C1 zk = e + o.mul_i(), zj = C1 { e.re, -e.im } + C1 { o.re, -o.im }.mul_i();
+      Z[k] = { zk.re, zk.im };
+      Z[j] = { zj.re, zj.im };
+    }
+  half_->transform<true> (Z, Z);
+}
+
+FFTPlanP
+FFTPlan::cached_plan (uint n_values, bool real)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<uint,bool>,FFTPlanP> plans;
+  const auto key = std::make_pair (n_values, real);
+  {
+    std::lock_guard<std::mutex> locker (mutex);
+    auto it = plans.find (key);
+    if (it != plans.end())
+      return it->second;
+  }
+  // construct without lock, real plans recurse into complex_plan()
+  FFTPlanP plan (new FFTPlan (n_values, real));
+  std::lock_guard<std::mutex> locker (mutex);
+  return plans.emplace (key, plan).first->second;      // a concurrently constructed plan may win
+}
+
+FFTPlanP
+FFTPlan::complex_plan (uint n_values)
+{
+  assert_return (n_values >= 1, nullptr);
+  return cached_plan (n_values, false);
+}
+
+FFTPlanP
+FFTPlan::real_plan (uint n_values)
+{
+  assert_return (n_values >= 2 && n_values % 2 == 0, nullptr);
+  return cached_plan (n_values, true);
+}
+
+uint
+FFTPlan::good_size (uint n_values)
+{
+  for (uint n = std::max (n_values, 1u);; n++)
+    {
+      uint r = n;
+      for (uint p : { 2, 3, 5 })
+        while (r % p == 0)
+          r /= p;
+      if (r == 1)
+        return n;
+    }
+}
+
+} // Bse
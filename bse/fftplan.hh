@@ -0,0 +1,57 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#ifndef __BSE_FFTPLAN_HH__
+#define __BSE_FFTPLAN_HH__
+
+#include <bse/bcore.hh>
+
+namespace Bse {
+
+class FFTPlan;
+using FFTPlanP = std::shared_ptr<const FFTPlan>;
+
+/**
+ * Precomputed single precision FFT of a fixed size.
+ * A plan splits its size into radix 4, 2, 3, 5 and generic prime stages of a self-sorting (Stockham)
+ * FFT, the butterflies process two complex values per SSE vector where the stage stride allows it.
+ * Plans are immutable after construction and are obtained from a process wide cache, so they can be
+ * shared between threads and only the first request for a size pays for the twiddle factor setup.
+ * Storage formats, transform directions and normalization follow the gsl_power2_fft*() functions,
+ * the transforms may be performed in place. The first transform of a new size within a thread may
+ * allocate scratch memory.
+ */
+class FFTPlan {
+public:
+  static FFTPlanP complex_plan (uint n_values);   ///< Plan for `n_values` complex values, MT-Safe.
+  static FFTPlanP real_plan    (uint n_values);   ///< Plan for an even number of `n_values` real values, MT-Safe.
+  static uint     good_size    (uint n_values);   ///< Smallest size >= `n_values` with factors 2, 3 and 5 only.
+  uint  n_values () const       { return n_values_; }
+  bool  is_real  () const       { return real_; }
+  /// Complex analysis of `n_values` complex values, see gsl_power2_fftac().
+  void  fftac    (const float *ri_values_in, float *ri_values_out) const;
+  /// Complex synthesis, unnormalized like gsl_power2_fftsc() or scaled by `1/n_values` like gsl_power2_fftsc_scale().
+  void  fftsc    (const float *ri_values_in, float *ri_values_out, bool scale = false) const;
+  /// Real analysis of `n_values` real values, H(n_values/2) is stored in `ri_values_out[1]`, see gsl_power2_fftar().
+  void  fftar    (const float *r_values_in, float *ri_values_out) const;
+  /// Real synthesis, unnormalized like gsl_power2_fftsr() or scaled by `1/n_values` like gsl_power2_fftsr_scale().
+  void  fftsr    (const float *ri_values_in, float *r_values_out, bool scale = false) const;
+private:
+  struct Complex { float re, im; };
+  struct Stage {
+    uint                 radix = 0, m = 0, stride = 0;
+    std::vector<Complex> twiddles;      // w^(q*r) for q < m, 0 < r < radix
+    std::vector<Complex> omegas;        // radix-th roots of unity for generic radix stages
+  };
+  const uint           n_values_;
+  const bool           real_;
+  std::vector<Stage>   stages_;
+  FFTPlanP             half_;           // complex plan of n_values/2 for real transforms
+  std::vector<Complex> real_twiddles_;  // e^(-2*pi*i*k/n_values) for real transform post processing
+  explicit FFTPlan      (uint n_values, bool real);
+  template<bool INVERSE>
+  void     transform    (const Complex *in, Complex *out) const;
+  static FFTPlanP cached_plan (uint n_values, bool real);
+};
+
+} // Bse
+
+#endif // __BSE_FFTPLAN_HH__
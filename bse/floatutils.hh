@@ -3,6 +3,7 @@
 #define __BSE_FLOAT_UTILS_HH__
 
 #include <bse/memory.hh>
+#include <algorithm>
 #include <cmath>
 
 namespace Bse {
@@ -25,6 +26,16 @@ floatisconst (const float *__restrict src, float vconst, size_t n)
   return true;
 }
 
+/// Find the maximum absolute value of the `n` values in `src`.
+extern inline float
+floatmaxabs (const float *__restrict src, size_t n)
+{
+  float m = 0;
+  for (size_t i = 0; i < n; i++)
+    m = std::max (m, std::abs (src[i]));
+  return m;
+}
+
 /// Copy `n` values from `src` to `dst`, the buffers must not overlap.
 extern inline void
 floatcopy (float *__restrict dst, const float *__restrict src, size_t n)
@@ -4,6 +4,7 @@
 # include files
 echo "#include $2"
 echo '#include "bse/bsemath.hh"'
+echo '#include "bse/fftplan.hh"'
 echo '#include "bse/internal.hh"'
 
 MKFFT="$1"
@@ -477,50 +478,29 @@ gsl_power2_fftar_simple (const unsigned int n_values,
                          const float       *real_values,
                          float             *complex_values)
 {
-  double *rv, *cv;
-  guint i;
-
   assert_return ((n_values & (n_values - 1)) == 0 && n_values >= 2);
 
-  rv = g_new (double, n_values * 2);
-  cv = rv + n_values;
-  i = n_values;
-  while (i--)
-    rv[i] = real_values[i];
-  gsl_power2_fftar (n_values, rv, cv);
-  i = n_values;
-  while (i--)
-    complex_values[i] = cv[i];
+  Bse::FFTPlan::real_plan (n_values)->fftar (real_values, complex_values);
   complex_values[n_values] = complex_values[1];
   complex_values[1] = 0.0;
   complex_values[n_values + 1] = 0.0;
-  g_free (rv);
 }
 __EOF
 for FUNC_NAME in fftsr fftsr_scale
 do
+SCALE=$(test $FUNC_NAME = fftsr_scale && echo true || echo false)
 cat << __EOF
 void
 gsl_power2_${FUNC_NAME}_simple (const unsigned int n_values,
                                 const float       *complex_values,
                                 float             *real_values)
 {
-  double *cv, *rv;
-  guint i;
-
   assert_return ((n_values & (n_values - 1)) == 0 && n_values >= 2);
 
-  cv = g_new (double, n_values * 2);
-  rv = cv + n_values;
-  i = n_values;
-  while (i--)
-    cv[i] = complex_values[i];
-  cv[1] = complex_values[n_values];
-  gsl_power2_$FUNC_NAME (n_values, cv, rv);
-  i = n_values;
-  while (i--)
-    real_values[i] = rv[i];
-  g_free (cv);
+  /* repack H(n_values/2) into the imaginary part of H(0) and transform in place */
+  std::copy (complex_values, complex_values + n_values, real_values);
+  real_values[1] = complex_values[n_values];
+  Bse::FFTPlan::real_plan (n_values)->fftsr (real_values, real_values, $SCALE);
 }
 __EOF
 done
@@ -167,7 +167,7 @@ void	gsl_power2_fftsr_scale (const unsigned int n_values,
 			        double            *r_values_out);
 
 
-/* --- convenience wrappers --- */
+/* --- convenience wrappers, single precision transforms via Bse::FFTPlan --- */
 void	gsl_power2_fftar_simple	(const uint         n_values,
 				 const float       *real_values,
 				 float		   *complex_values);
@@ -29,6 +29,7 @@ oscillator_process_variants (GslOscData  *osc,
   uint32 last_pos = osc->last_pos;
   uint32 sync_pos, pos_inc;
   float posm_strength, self_posm_strength;
+  float xfade = osc->wave.xfade;
   float *boundary = mono_out + n_values;
   GslOscWave *wave = &osc->wave;
 
@@ -106,6 +107,7 @@ oscillator_process_variants (GslOscData  *osc,
                 }
               else
                 pos_inc = bse_dtoi (transposed_freq * fine_tune * wave->freq_to_step);
+              xfade = gsl_osc_wave_xfade (wave, transposed_freq);
               posm_strength = pos_inc * osc->config.fm_strength;
               self_posm_strength = pos_inc * osc->config.self_fm_strength;
               last_freq_level = freq_level;
@@ -129,23 +131,28 @@ oscillator_process_variants (GslOscData  *osc,
       if (PULSE_OSC)	/* pulse width modulation oscillator */
         {
           guint32 tpos, ipos;
+          gfloat w;
           tpos = cur_pos >> wave->n_frac_bits;
           ipos = (cur_pos - osc->pwm_offset) >> wave->n_frac_bits;
           v = wave->values[tpos] - wave->values[ipos];
+          w = wave->xvalues[tpos] - wave->xvalues[ipos];
+          v += (w - v) * xfade;	/* mip level crossfade */
           v = (v + osc->pwm_center) * osc->pwm_max;
         }
       else		/* table read out and linear ipol */
         {
           guint32 tpos, ifrac;
-          gfloat ffrac, w;
+          gfloat ffrac, w, x, y;
           tpos = cur_pos >> wave->n_frac_bits;
           ifrac = cur_pos & wave->frac_bitmask;
           ffrac = ifrac * wave->ifrac_to_float;
           v = wave->values[tpos];
           w = wave->values[tpos + 1];
-          v *= 1.0 - ffrac;
-          w *= ffrac;
-          v += w;
+          v += (w - v) * ffrac;
+          x = wave->xvalues[tpos];
+          y = wave->xvalues[tpos + 1];
+          x += (y - x) * ffrac;
+          v += (x - v) * xfade;	/* mip level crossfade */
         }
       /* v = value_out done */
       *mono_out++ = v;
@@ -176,6 +183,7 @@ oscillator_process_variants (GslOscData  *osc,
   osc->last_sync_level = last_sync_level;
   osc->last_freq_level = last_freq_level;
   osc->last_pwm_level = last_pwm_level;
+  osc->wave.xfade = xfade;
 }
 
 #undef ISYNC1_OSYNC0
@@ -5,222 +5,52 @@
 #include "gslfft.hh"
 #include "bse/internal.hh"
 #include <string.h>
+#include <mutex>
 
 #define ODEBUG(...)     Bse::debug ("osc", __VA_ARGS__)
 
-#define	OSC_FREQ_EPSILON	(1e-3)	/* range within which frequencies are "equal" */
-/* compare mfreqs against each other, use an arbitrary sample rate
- * for which OSC_FREQ_EPSILON makes sense
- */
-#define	CACHE_MATCH_FREQ(usr_mfreq, cache_mfreq) \
-  (fabs ((cache_mfreq) * 44107 - (usr_mfreq) * 44107) < OSC_FREQ_EPSILON)
+#define	OSC_BANK_TOP_MFREQ	(0.25)	/* mix_freq relative, level 0 keeps only the fundamental */
+
 /* --- structures --- */
-struct OscTableEntry
+/* Mip-mapped wave form, level k is band limited for mix_freq relative frequencies up to
+ * OSC_BANK_TOP_MFREQ / 2^k. All levels share one table size, so oscillator positions stay
+ * valid across level changes. Banks depend on wave form and filter only, they are created
+ * once and shared read-only by all tables, regardless of mix_freq.
+ */
+struct GslOscWaveBank
 {
-  /* main key (osc and cache tables) */
-  gfloat         mfreq;			/* [0..0.5], mix_freq relative */
-  /* secondary key (cache tables) */
-  GslOscWaveForm wave_form;
-  guint8	*filter_func;		/* just here for key indexing */
-  /* data */
-  guint		 ref_count;
-  guint		 min_pos, max_pos;	/* pulse extension */
-  guint          n_values;
-  float          values[1];		/* flexible array */
+  struct Level {
+    gfloat         mfreq;		/* [0..0.25], mix_freq relative */
+    guint          min_pos, max_pos;	/* pulse extension */
+    const gfloat  *values;		/* n_values+1 values with values[0]==values[n_values] */
+  };
+  GslOscWaveForm     wave_form;
+  double           (*filter_func) (double);
+  guint              n_values;
+  std::vector<Level> levels;
+  std::vector<float> data;		/* levels.size() * (n_values + 1) */
 };
 
 
 /* --- prototypes --- */
-static gint	cache_table_entry_locs_cmp	(gconstpointer	bsearch_node1, /* key */
-						 gconstpointer	bsearch_node2);
-static gint	osc_table_entry_locs_cmp	(gconstpointer	bsearch_node1, /* key */
-						 gconstpointer	bsearch_node2);
 static void	osc_wave_extrema_pos		(guint		n_values,
 						 const gfloat *values,
 						 guint        *minp_p,
 						 guint        *maxp_p);
-void		gsl_osc_cache_debug_dump	(void);
 
 
 /* --- variables --- */
-static GBSearchArray       *cache_entries = NULL;
-static const GBSearchConfig cache_taconfig = {
-  sizeof (OscTableEntry*),
-  cache_table_entry_locs_cmp,
-  0
-};
-static const GBSearchConfig osc_taconfig = {
-  sizeof (OscTableEntry*),
-  osc_table_entry_locs_cmp,
-  0
-};
+static std::mutex                                   osc_bank_mutex;
+static std::vector<std::unique_ptr<GslOscWaveBank>> osc_banks;
 
 
 /* --- functions --- */
-static gint
-cache_table_entry_locs_cmp (gconstpointer bsearch_node1, /* key */
-			    gconstpointer bsearch_node2)
-{
-  const OscTableEntry *const *ep1 = (const OscTableEntry*const*) bsearch_node1;
-  const OscTableEntry *const *ep2 = (const OscTableEntry*const*) bsearch_node2;
-  const OscTableEntry *e1 = *ep1;
-  const OscTableEntry *e2 = *ep2;
-
-  if (e1->wave_form == e2->wave_form)
-    {
-      if (e1->filter_func == e2->filter_func)
-	return G_BSEARCH_ARRAY_CMP (e1->mfreq, e2->mfreq);
-      else
-	return e1->filter_func > e2->filter_func ? 1 : -1;
-    }
-  else
-    return e1->wave_form > e2->wave_form ? 1 : -1;
-}
-
-static gint
-osc_table_entry_locs_cmp (gconstpointer bsearch_node1, /* key */
-			  gconstpointer bsearch_node2)
-{
-  const OscTableEntry *const *ep1 = (const OscTableEntry*const*) bsearch_node1;
-  const OscTableEntry *const *ep2 = (const OscTableEntry*const*) bsearch_node2;
-  const OscTableEntry *e1 = *ep1;
-  const OscTableEntry *e2 = *ep2;
-
-  return G_BSEARCH_ARRAY_CMP (e1->mfreq, e2->mfreq);
-}
-
-static OscTableEntry*
-cache_table_entry_lookup_best (GslOscWaveForm wave_form,
-			       guint8*        filter_func,
-			       gfloat         mfreq)
-{
-  OscTableEntry key, *k = &key, **ep1 = NULL, **ep2, **ep3 = NULL;
-
-  key.mfreq = mfreq;
-  key.wave_form = wave_form;
-  key.filter_func = filter_func;
-
-  /* get exact match or a match which is one off into either direction */
-  ep2 = (OscTableEntry**) g_bsearch_array_lookup_sibling (cache_entries, &cache_taconfig, &k);
-  if (ep2)
-    {
-      uint i = g_bsearch_array_get_index (cache_entries, &cache_taconfig, ep2);
-
-      /* get siblings */
-      if (i > 0)
-	ep1 = (OscTableEntry**) g_bsearch_array_get_nth (cache_entries, &cache_taconfig, i - 1);
-      if (i + 1 < g_bsearch_array_get_n_nodes (cache_entries))
-	ep3 = (OscTableEntry**) g_bsearch_array_get_nth (cache_entries, &cache_taconfig, i + 1);
-
-      /* get rid of invalid matches, i.e. ones with:
-       * - a different wave
-       * - a different filter
-       * - a filter wider than required
-       */
-      if (ep1 && ((*ep1)->wave_form != wave_form ||
-		  (*ep1)->filter_func != filter_func ||
-		  (*ep1)->mfreq < mfreq))
-	ep1 = NULL;
-      if (ep3 && ((*ep3)->wave_form != wave_form ||
-		  (*ep3)->filter_func != filter_func ||
-		  (*ep3)->mfreq < mfreq))
-	ep3 = NULL;
-      if ((*ep2)->wave_form != wave_form ||
-	  (*ep2)->filter_func != filter_func ||
-	  (*ep2)->mfreq < mfreq)
-	{
-	  /* collapse siblings, so that, if we have valid matches, ep2 is amongst them */
-	  if (ep1)
-	    {
-	      ep2 = ep1;
-	      ep1 = NULL;
-	    }
-	  else if (ep3)
-	    {
-	      ep2 = ep3;
-	      ep3 = NULL;
-	    }
-	  else
-	    ep2 = NULL;	/* no valid match at all */
-	}
-    }
-
-  /* now figure best out of valid siblings */
-  if (ep2)
-    {
-      if (ep1 && fabs ((*ep1)->mfreq - mfreq) < fabs ((*ep2)->mfreq - mfreq))
-	ep2 = ep1;
-      if (ep3 && fabs ((*ep3)->mfreq - mfreq) < fabs ((*ep2)->mfreq - mfreq))
-	ep2 = ep3;
-    }
-  return ep2 ? *ep2 : NULL;
-}
-
-static OscTableEntry*
-osc_table_entry_lookup_best (const GslOscTable *table,
-			     gfloat             mfreq,
-			     gfloat	       *min_mfreq)
-{
-  OscTableEntry key, *k = &key, **ep;
-  uint i;
-
-  /* get exact match or a match which is one off into either direction */
-  key.mfreq = mfreq;
-  ep = (OscTableEntry**) g_bsearch_array_lookup_sibling (table->entry_array, &osc_taconfig, &k);
-  if (UNLIKELY (!ep))
-    return NULL;	/* ugh, bad */
-
-  if (mfreq > (*ep)->mfreq)	/* need better filter */
-    {
-      i = g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep);
-      if (i + 1 < g_bsearch_array_get_n_nodes (table->entry_array))
-	{
-	  ep = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, i + 1);
-	  ODEBUG ("osc-lookup: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-                  mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-                  table, i + 1, g_bsearch_array_get_n_nodes (table->entry_array));
-	}
-      else	/* bad, might cause aliasing */
-	ODEBUG ("osc-lookup: mismatch, aliasing possible: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-                mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-                table, i, g_bsearch_array_get_n_nodes (table->entry_array));
-    }
-  else
-    ODEBUG ("osc-lookup: want_freq=%f got_freq=%f (table=%p, i=%u, n=%u)",
-            mfreq * table->mix_freq, (*ep)->mfreq * table->mix_freq,
-            table, g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep),
-            g_bsearch_array_get_n_nodes (table->entry_array));
-  if (min_mfreq)
-    {
-      /* fetch mfreq from previous */
-      i = g_bsearch_array_get_index (table->entry_array, &osc_taconfig, ep);
-      if (i > 0)
-	{
-	  OscTableEntry **tp = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, i - 1);
-
-	  *min_mfreq = (*tp)->mfreq;
-	}
-      else
-	*min_mfreq = 0;
-    }
-
-  return *ep;
-}
-
 static guint
-wave_table_size (GslOscWaveForm wave_form,
-		 gfloat         mfreq)
+wave_table_size (GslOscWaveForm wave_form)
 {
   /* have to return power of 2, and honour 8 <= size */
 
-  /* FIXME: decide on other table sizes
-  10000: 256
-    5000: 512
-    2500: 1024
-    1250: 2048
-    GSL_OSC_WAVE_SAW_FALL always huge buffers to guarantee pulse width stepping granularity
-  */
-
+  /* GSL_OSC_WAVE_SAW_FALL always huge buffers to guarantee pulse width stepping granularity */
   if (wave_form == GSL_OSC_WAVE_SAW_FALL)
     return 8192;
 
@@ -245,112 +75,77 @@ fft_filter (guint    n_values,
     }
 }
 
-static OscTableEntry*
-cache_table_ref_entry (GslOscWaveForm wave_form,
-		       double       (*filter_func) (double),
-		       gfloat         mfreq)
+static GslOscWaveBank*
+osc_wave_bank_create (GslOscWaveForm wave_form,
+		      double       (*filter_func) (double))
 {
-  OscTableEntry *e = cache_table_entry_lookup_best (wave_form, (guint8*) filter_func, mfreq);
+  GslOscWaveBank *bank = new GslOscWaveBank();
+  const guint n_values = wave_table_size (wave_form);
+  /* level k passes partials below 2^(k+1), the last level passes all partials the table can hold */
+  const guint n_levels = g_bit_storage (n_values - 1) - 1;
+  gfloat min, max;
 
-  if (e && !CACHE_MATCH_FREQ (mfreq, e->mfreq))
-    e = NULL;
-  if (!e)
+  bank->wave_form = wave_form;
+  bank->filter_func = filter_func;
+  bank->n_values = n_values;
+  bank->levels.resize (n_levels);
+  bank->data.resize (n_levels * (n_values + 1));
+
+  /* the unfiltered spectrum is shared by all levels */
+  std::vector<float> wave (n_values), spectrum (n_values + 2), fft (n_values + 2);
+  gsl_osc_wave_fill_buffer (wave_form, n_values, wave.data());
+  gsl_osc_wave_extrema (n_values, wave.data(), &min, &max);
+  gsl_power2_fftar_simple (n_values, wave.data(), spectrum.data());
+  for (guint k = 0; k < n_levels; k++)
     {
-      guint size = wave_table_size (wave_form, mfreq);
-      gfloat *values, *fft, step, min, max;
-
-      /* size:
-       * - OscTableEntry already contains the first float values
-       * - we need n_values+1 adressable floats to provide values[0] == values[n_values]
-       */
-      e = (OscTableEntry*) g_malloc (sizeof (OscTableEntry) + sizeof (gfloat) * size);
-      values = (gfloat*) &e->values[0];
-      e->wave_form = wave_form;
-      e->filter_func = (guint8*) filter_func;
-      e->mfreq = mfreq;
-      e->ref_count = 1;
-      e->n_values = size;
-      gsl_osc_wave_fill_buffer (e->wave_form, e->n_values, values);
-
-      /* filter wave accordingly */
-      gsl_osc_wave_extrema (e->n_values, values, &min, &max);
-      fft = g_new (gfloat, e->n_values + 2);	/* [0..n_values] for n_values/2 complex freqs */
-      gsl_power2_fftar_simple (e->n_values, values, fft);
-      step = e->mfreq * (gdouble) e->n_values;
-      fft_filter (e->n_values, fft, step, filter_func);
-      gsl_power2_fftsr_scale_simple (e->n_values, fft, values);
-      g_free (fft);
-      gsl_osc_wave_normalize (e->n_values, values, (min + max) / 2, max);
+      GslOscWaveBank::Level &level = bank->levels[k];
+      gfloat *values = &bank->data[k * (n_values + 1)];
+
+      level.mfreq = OSC_BANK_TOP_MFREQ / (1 << k);
+      level.values = values;
+      fft = spectrum;
+      fft_filter (n_values, fft.data(), level.mfreq * n_values, filter_func);
+      gsl_power2_fftsr_scale_simple (n_values, fft.data(), values);
+      gsl_osc_wave_normalize (n_values, values, (min + max) / 2, max);
 
       /* provide values[0]==values[n_values] */
-      values[e->n_values] = values[0];
+      values[n_values] = values[0];
 
       /* pulse min/max pos extension */
-      osc_wave_extrema_pos (e->n_values, values, &e->min_pos, &e->max_pos);
-
-      /* insert into cache */
-      cache_entries = g_bsearch_array_insert (cache_entries, &cache_taconfig, &e);
+      osc_wave_extrema_pos (n_values, values, &level.min_pos, &level.max_pos);
     }
-  else
-    e->ref_count++;
-  return e;
+  ODEBUG ("wave bank: wave=%s n_values=%u n_levels=%u", gsl_osc_wave_form_name (wave_form), n_values, n_levels);
+  return bank;
 }
 
-static void
-cache_table_unref_entry (OscTableEntry *e)
+static const GslOscWaveBank*
+osc_wave_bank_get (GslOscWaveForm wave_form,
+		   double       (*filter_func) (double))
 {
-  assert_return (e->ref_count > 0);
-
-  e->ref_count -= 1;
-  if (e->ref_count == 0)
-    {
-      OscTableEntry **ep = (OscTableEntry**) g_bsearch_array_lookup (cache_entries, &cache_taconfig, &e);
-      uint i = g_bsearch_array_get_index (cache_entries, &cache_taconfig, ep);
-      cache_entries = g_bsearch_array_remove (cache_entries, &cache_taconfig, i);
-    }
+  std::lock_guard<std::mutex> locker (osc_bank_mutex);
+  for (const auto &bank : osc_banks)
+    if (bank->wave_form == wave_form && bank->filter_func == filter_func)
+      return bank.get();
+  osc_banks.emplace_back (osc_wave_bank_create (wave_form, filter_func));
+  return osc_banks.back().get();
 }
 
 GslOscTable*
 gsl_osc_table_create (gfloat         mix_freq,
 		      GslOscWaveForm wave_form,
-		      double       (*filter_func) (double),
-		      guint          n_freqs,
-		      const gfloat  *freqs)
+		      double       (*filter_func) (double))
 {
   GslOscTable *table;
-  gfloat nyquist;
-  guint i;
 
   assert_return (mix_freq > 0, NULL);
-  assert_return (n_freqs > 0, NULL);
-  assert_return (freqs != NULL, NULL);
-
-  if (!cache_entries)
-    cache_entries = g_bsearch_array_create (&cache_taconfig);
+  assert_return (filter_func != NULL, NULL);
 
   table = sfi_new_struct (GslOscTable, 1);
   table->mix_freq = mix_freq;
   table->wave_form = wave_form;
-  table->entry_array = g_bsearch_array_create (&osc_taconfig);
-  nyquist = table->mix_freq * 0.5;
   if (wave_form == GSL_OSC_WAVE_PULSE_SAW)
     wave_form = GSL_OSC_WAVE_SAW_FALL;
-  for (i = 0; i < n_freqs; i++)
-    {
-      OscTableEntry *e;
-      gdouble mfreq = MIN (nyquist, freqs[i]);
-
-      mfreq /= table->mix_freq;
-      e = osc_table_entry_lookup_best (table, mfreq, NULL);
-      if (!e || fabs (e->mfreq * table->mix_freq - mfreq * table->mix_freq) > OSC_FREQ_EPSILON)
-	{
-	  e = cache_table_ref_entry (wave_form, filter_func, mfreq);
-	  table->entry_array = g_bsearch_array_insert (table->entry_array, &osc_taconfig, &e);
-	}
-      else if (e)
-	ODEBUG ("not inserting existing entry (freq=%f) for freq %f (nyquist=%f)",
-                e->mfreq * table->mix_freq, mfreq * table->mix_freq, nyquist);
-    }
+  table->bank = osc_wave_bank_get (wave_form, filter_func);
 
   return table;
 }
@@ -360,65 +155,57 @@ gsl_osc_table_lookup (const GslOscTable	*table,
 		      gfloat		 freq,
 		      GslOscWave	*wave)
 {
-  OscTableEntry *e;
-  gfloat mfreq, min_mfreq;
+  const GslOscWaveBank *bank;
+  guint32 int_one;
+  gfloat float_one;
+  guint r, n_levels;
 
   assert_return (table != NULL);
   assert_return (wave != NULL);
 
-  mfreq = freq / table->mix_freq;
-  e = osc_table_entry_lookup_best (table, mfreq, &min_mfreq);
-  if (e)
-    {
-      guint32 int_one;
-      gfloat float_one;
-
-      wave->min_freq = min_mfreq * table->mix_freq;
-      wave->max_freq = e->mfreq * table->mix_freq;
-      wave->n_values = e->n_values;
-      wave->values = e->values;
-      wave->n_frac_bits = g_bit_storage (wave->n_values - 1);
-      wave->n_frac_bits = 32 - wave->n_frac_bits;
-      int_one = 1 << wave->n_frac_bits;
-      wave->frac_bitmask = int_one - 1;
-      float_one = int_one;
-      wave->freq_to_step = float_one * wave->n_values / table->mix_freq;
-      wave->phase_to_pos = wave->n_values * float_one;
-      wave->ifrac_to_float = 1.0 / float_one;
-      /* pulse min/max pos extension */
-      wave->min_pos = e->min_pos;
-      wave->max_pos = e->max_pos;
-    }
-  else
-    {
-      /* shouldn't happen */
-      ODEBUG ("table lookup revealed NULL, empty table?");
-      memset (wave, 0, sizeof (*wave));
-    }
+  /* frequency range r lies between m(r) and m(r-1) with m(k) = OSC_BANK_TOP_MFREQ / 2^k, level k
+   * is alias free up to m(k). So range r crossfades between levels r-1 and r-2, which are both
+   * alias free there, r=0 and r=1 use the first level only, ranges below the last level use it only
+   */
+  bank = table->bank;
+  n_levels = bank->levels.size();
+  for (r = 0; r <= n_levels; r++)
+    if (freq > OSC_BANK_TOP_MFREQ / (1 << r) * table->mix_freq)
+      break;
+  const GslOscWaveBank::Level &upper = bank->levels[CLAMP (int (r) - 2, 0, int (n_levels) - 1)];
+  const GslOscWaveBank::Level &lower = bank->levels[MIN (MAX (r, 1) - 1, n_levels - 1)];
+  wave->min_freq = r <= n_levels ? OSC_BANK_TOP_MFREQ / (1 << r) * table->mix_freq : 0;
+  wave->max_freq = r > 0 ? OSC_BANK_TOP_MFREQ / (1 << (r - 1)) * table->mix_freq : G_MAXFLOAT;
+  wave->values = upper.values;
+  wave->xvalues = lower.values;
+  wave->xfade_scale = &upper != &lower ? 1.0 / (wave->max_freq - wave->min_freq) : 0;
+  wave->xfade = gsl_osc_wave_xfade (wave, freq);
+  ODEBUG ("osc-lookup: want_freq=%f min_freq=%f max_freq=%f xfade=%f (table=%p, r=%u)",
+          freq, wave->min_freq, wave->max_freq, wave->xfade, table, r);
+
+  wave->n_values = bank->n_values;
+  wave->n_frac_bits = g_bit_storage (wave->n_values - 1);
+  wave->n_frac_bits = 32 - wave->n_frac_bits;
+  int_one = 1 << wave->n_frac_bits;
+  wave->frac_bitmask = int_one - 1;
+  float_one = int_one;
+  wave->freq_to_step = float_one * wave->n_values / table->mix_freq;
+  wave->phase_to_pos = wave->n_values * float_one;
+  wave->ifrac_to_float = 1.0 / float_one;
+  /* pulse min/max pos extension */
+  wave->min_pos = upper.min_pos;
+  wave->max_pos = upper.max_pos;
 }
 
 void
 gsl_osc_table_free (GslOscTable *table)
 {
-  guint n;
-
   assert_return (table != NULL);
 
-  n = g_bsearch_array_get_n_nodes (table->entry_array);
-  while (n--)
-    {
-      OscTableEntry **ep = (OscTableEntry**) g_bsearch_array_get_nth (table->entry_array, &osc_taconfig, n);
-      cache_table_unref_entry (*ep);
-      table->entry_array = g_bsearch_array_remove (table->entry_array, &osc_taconfig, n);
-    }
-  g_bsearch_array_free (table->entry_array, &osc_taconfig);
+  /* banks are shared and stay alive */
   sfi_delete_struct (GslOscTable, table);
 }
-void
-gsl_osc_cache_debug_dump (void)
-{
-  ODEBUG ("left in cache: %u", g_bsearch_array_get_n_nodes (cache_entries));
-}
+
 void
 gsl_osc_wave_fill_buffer (GslOscWaveForm type,
 			  guint	         n_values,
@@ -3,7 +3,6 @@
 #define __GSL_OSC_TABLE_H__
 
 #include <bse/gsldefs.hh>
-#include <bse/gbsearcharray.hh>
 
 
 /* --- structures & enums --- */
@@ -21,11 +20,13 @@ typedef enum    /*< skip >*/
   GSL_OSC_WAVE_PULSE_SAW
 } GslOscWaveForm;
 
+typedef struct GslOscWaveBank GslOscWaveBank;	/* process wide, read-only mip-mapped tables */
+
 typedef struct
 {
-  gfloat         mix_freq;
-  GslOscWaveForm wave_form;
-  GBSearchArray *entry_array;
+  gfloat                mix_freq;
+  GslOscWaveForm        wave_form;
+  const GslOscWaveBank *bank;
 } GslOscTable;
 
 typedef struct
@@ -34,6 +35,10 @@ typedef struct
   gfloat        max_freq;
   guint         n_values;
   const gfloat *values;	/* contains n_values+1 values with values[0]==values[n_values] */
+  /* mip level crossfading between min_freq and max_freq */
+  const gfloat *xvalues;	/* next mip level with more partials, same layout as values */
+  gfloat	xfade_scale;		/* (max_freq - freq) * xfade_scale -> xvalues weight */
+  gfloat	xfade;			/* xvalues weight at the last looked up or tracked frequency */
   /* integer stepping (block size dependant) */
   guint32	n_frac_bits;
   guint32	frac_bitmask;
@@ -47,14 +52,21 @@ typedef struct
 /* --- oscillator table --- */
 GslOscTable*    gsl_osc_table_create            (gfloat                  mix_freq,
 						 GslOscWaveForm          wave_form,
-						 double                (*filter_func) (double),
-						 guint                   n_freqs,
-						 const gfloat           *freqs);
+						 double                (*filter_func) (double));
 void            gsl_osc_table_lookup            (const GslOscTable      *table,
 						 gfloat                  freq,
 						 GslOscWave             *wave);
 void            gsl_osc_table_free              (GslOscTable            *table);
 
+/* weight of wave->xvalues for a frequency within ]wave->min_freq, wave->max_freq] */
+static inline gfloat
+gsl_osc_wave_xfade (const GslOscWave *wave,
+		    gfloat            freq)
+{
+  const gfloat xfade = (wave->max_freq - freq) * wave->xfade_scale;
+  return CLAMP (xfade, 0.0f, 1.0f);
+}
+
 
 /* --- oscillator wave utils --- */
 void            gsl_osc_wave_fill_buffer        (GslOscWaveForm          type,
@@ -7,6 +7,12 @@
 #include <vorbis/vorbisenc.h>
 #include <string.h>
 #include <errno.h>
+#include <condition_variable>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <deque>
+#include <vector>
 
 #define VDEBUG(...)     Bse::debug ("vorbis", __VA_ARGS__)
 
@@ -15,6 +21,18 @@ typedef struct {
   guint length;
   guint8 data[1];       /* flexible arary */
 } EDataBlock;
+/* encoder thread state, PCM blocks are queued up to max_values */
+struct VorbisEncoderThread {
+  std::thread                     thread;
+  std::mutex                      mutex;        /* protects queue and encoder output */
+  std::condition_variable         cond;
+  std::deque<std::vector<gfloat>> pcm_queue;
+  size_t                          queued_values = 0;
+  size_t                          max_values = 0;
+  bool                            pcm_done = false;
+  bool                            finished = false;
+  bool                            quit = false;
+};
 struct _GslVorbisEncoder
 {
   /* stream config */
@@ -26,11 +44,12 @@ struct _GslVorbisEncoder
   /* state flags */
   guint			stream_setup : 1;
   guint			have_vblock : 1;        /* filled vorbis block pending */
-  guint			pcm_done : 1;
-  guint			eos : 1;        	/* end of stream reached */
+  std::atomic<bool>     pcm_done { false };
+  std::atomic<bool>     eos { false };              /* end of stream reached, set by the encoder thread */
   /* packed data */
   guint			dblock_offset;          /* read offset into topmost data block */
   SfiRing              *dblocks;                /* data block queue */
+  VorbisEncoderThread  *thread;                 /* threaded encoding */
   /* ogg/vorbis codec state */
   ogg_stream_state	ostream;
   vorbis_block		vblock;
@@ -43,6 +62,7 @@ struct _GslVorbisEncoder
 
 /* --- prototypes --- */
 static void     gsl_vorbis_encoder_reset (GslVorbisEncoder *self);
+static void     vorbis_encoder_stop_thread (GslVorbisEncoder *self);
 
 
 /* --- miscellaneous --- */
@@ -53,11 +73,18 @@ gsl_vorbis_encoder_enqueue_page (GslVorbisEncoder *self,
   EDataBlock *dblock = (EDataBlock*) g_malloc (sizeof (EDataBlock) - sizeof (dblock->data[0]) + opage->header_len);
   dblock->length = opage->header_len;
   memcpy (dblock->data, opage->header, dblock->length);
+  EDataBlock *bblock = (EDataBlock*) g_malloc (sizeof (EDataBlock) - sizeof (bblock->data[0]) + opage->body_len);
+  bblock->length = opage->body_len;
+  memcpy (bblock->data, opage->body, bblock->length);
+  std::unique_lock<std::mutex> locker;
+  if (self->thread)     /* pages are read from the caller thread */
+    locker = std::unique_lock<std::mutex> (self->thread->mutex);
   self->dblocks = sfi_ring_append (self->dblocks, dblock);
-  dblock = (EDataBlock*) g_malloc (sizeof (EDataBlock) - sizeof (dblock->data[0]) + opage->body_len);
-  dblock->length = opage->body_len;
-  memcpy (dblock->data, opage->body, dblock->length);
-  self->dblocks = sfi_ring_append (self->dblocks, dblock);
+  self->dblocks = sfi_ring_append (self->dblocks, bblock);
+  if (ogg_page_eos (opage))
+    self->eos = true;
+  if (self->thread)
+    self->thread->cond.notify_all();
 }
 
 
@@ -67,7 +94,7 @@ gsl_vorbis_encoder_new (void)
 {
   GslVorbisEncoder *self;
 
-  self = g_new0 (GslVorbisEncoder, 1);
+  self = new GslVorbisEncoder();
   self->stream_setup = FALSE;
 
   vorbis_comment_init (&self->vcomment);
@@ -90,7 +117,7 @@ gsl_vorbis_encoder_destroy (GslVorbisEncoder *self)
 
   gsl_vorbis_encoder_reset (self);
   vorbis_comment_clear (&self->vcomment);
-  g_free (self);
+  delete self;
 }
 
 void
@@ -220,6 +247,8 @@ gsl_vorbis_encoder_reset (GslVorbisEncoder *self)
 {
   assert_return (self != NULL);
 
+  /* stop encoder thread */
+  vorbis_encoder_stop_thread (self);
   /* cleanup codec state */
   if (self->stream_setup)
     {
@@ -237,8 +266,8 @@ gsl_vorbis_encoder_reset (GslVorbisEncoder *self)
   vorbis_comment_clear (&self->vcomment);
   vorbis_comment_init (&self->vcomment);
   /* cleanup state flags */
-  self->pcm_done = FALSE;
-  self->eos = FALSE;
+  self->pcm_done = false;
+  self->eos = false;
   self->have_vblock = FALSE;
 }
 
@@ -339,6 +368,19 @@ gsl_vorbis_encoder_write_pcm (GslVorbisEncoder *self,
   if (n_values)
     assert_return (values != NULL);
 
+  if (self->thread)
+    {
+      VorbisEncoderThread &t = *self->thread;
+      std::unique_lock<std::mutex> locker (t.mutex);
+      /* backpressure, wait for the encoder thread to catch up */
+      while (t.queued_values && t.queued_values + n_values > t.max_values)
+        t.cond.wait (locker);
+      t.pcm_queue.push_back (std::vector<gfloat> (values, values + n_values));
+      t.queued_values += n_values;
+      t.cond.notify_all();
+      return;
+    }
+
   /* compress away remaining data so we only buffer encoded data */
   while (gsl_vorbis_encoder_needs_processing (self))
     gsl_vorbis_encoder_process (self);
@@ -361,8 +403,15 @@ gsl_vorbis_encoder_pcm_done (GslVorbisEncoder *self)
 
   if (!self->pcm_done)
     {
-      self->pcm_done = TRUE;
-      vorbis_analysis_wrote (&self->vdsp, 0);	/* termination mark */
+      self->pcm_done = true;
+      if (self->thread)
+        {
+          std::lock_guard<std::mutex> locker (self->thread->mutex);
+          self->thread->pcm_done = true;        /* termination mark is written by the encoder thread */
+          self->thread->cond.notify_all();
+        }
+      else
+        vorbis_analysis_wrote (&self->vdsp, 0);	/* termination mark */
     }
 }
 
@@ -379,15 +428,14 @@ gsl_vorbis_encoder_needs_processing (GslVorbisEncoder *self)
 {
   assert_return (self != NULL, FALSE);
 
+  if (self->thread)
+    return FALSE;       /* processing is carried out by the encoder thread */
   return self->stream_setup && !self->eos && gsl_vorbis_encoder_blockout (self);
 }
 
-void
-gsl_vorbis_encoder_process (GslVorbisEncoder *self)
+static void
+vorbis_encoder_analyse_block (GslVorbisEncoder *self)
 {
-  assert_return (self != NULL);
-  assert_return (self->stream_setup == TRUE);
-
   /* analyse data blockwise */
   if (gsl_vorbis_encoder_blockout (self))
     {
@@ -404,19 +452,92 @@ gsl_vorbis_encoder_process (GslVorbisEncoder *self)
           ogg_stream_packetin (&self->ostream, &opacket);
           while (ogg_stream_pageout (&self->ostream, &opage))
             {
-              /* queue bitstream pages as outgoing data */
+              /* queue bitstream pages as outgoing data, catches end of stream */
               gsl_vorbis_encoder_enqueue_page (self, &opage);
-              /* catch end of stream */
-              if (ogg_page_eos (&opage))
-                {
-                  self->eos = TRUE;
-                  return;       /* break all loops */
-                }
+              if (self->eos)
+                return;         /* break all loops */
             }
         }
     }
 }
 
+void
+gsl_vorbis_encoder_process (GslVorbisEncoder *self)
+{
+  assert_return (self != NULL);
+  assert_return (self->stream_setup == TRUE);
+
+  if (!self->thread)
+    vorbis_encoder_analyse_block (self);
+}
+
+static void
+vorbis_encoder_thread_loop (GslVorbisEncoder *self)
+{
+  VorbisEncoderThread &t = *self->thread;
+  std::unique_lock<std::mutex> locker (t.mutex);
+  while (!t.quit)
+    if (!t.pcm_queue.empty())
+      {
+        std::vector<gfloat> block = std::move (t.pcm_queue.front());
+        t.pcm_queue.pop_front();
+        t.queued_values -= block.size();
+        t.cond.notify_all();
+        locker.unlock();
+        for (size_t i = 0; i < block.size(); i += 1024)
+          vorbis_encoder_write_pcm_1k (self, MIN (block.size() - i, 1024), &block[i]);
+        while (!self->eos && gsl_vorbis_encoder_blockout (self))
+          vorbis_encoder_analyse_block (self);
+        locker.lock();
+      }
+    else if (t.pcm_done)
+      {
+        locker.unlock();
+        vorbis_analysis_wrote (&self->vdsp, 0); /* termination mark */
+        while (!self->eos && gsl_vorbis_encoder_blockout (self))
+          vorbis_encoder_analyse_block (self);
+        locker.lock();
+        break;
+      }
+    else
+      t.cond.wait (locker);
+  t.finished = true;
+  t.cond.notify_all();
+}
+
+Bse::Error
+gsl_vorbis_encoder_start_thread (GslVorbisEncoder *self,
+                                 guint             max_queued_values)
+{
+  assert_return (self != NULL, Bse::Error::INTERNAL);
+  assert_return (self->stream_setup == TRUE, Bse::Error::INTERNAL);
+  assert_return (self->pcm_done == FALSE, Bse::Error::INTERNAL);
+  assert_return (self->thread == NULL, Bse::Error::INTERNAL);
+
+  /* encode pending blocks, so the encoder thread owns all codec state */
+  while (gsl_vorbis_encoder_needs_processing (self))
+    gsl_vorbis_encoder_process (self);
+  self->thread = new VorbisEncoderThread();
+  self->thread->max_values = MAX (max_queued_values, 1024 * self->n_channels);
+  self->thread->thread = std::thread (vorbis_encoder_thread_loop, self);
+  return Bse::Error::NONE;
+}
+
+static void
+vorbis_encoder_stop_thread (GslVorbisEncoder *self)
+{
+  if (!self->thread)
+    return;
+  {
+    std::lock_guard<std::mutex> locker (self->thread->mutex);
+    self->thread->quit = true;
+    self->thread->cond.notify_all();
+  }
+  self->thread->thread.join();
+  delete self->thread;
+  self->thread = NULL;
+}
+
 guint
 gsl_vorbis_encoder_read_ogg (GslVorbisEncoder *self,
                              guint             n_bytes,
@@ -427,7 +548,16 @@ gsl_vorbis_encoder_read_ogg (GslVorbisEncoder *self,
   assert_return (self != NULL, 0);
   assert_return (self->stream_setup == TRUE, 0);
 
-  if (!self->dblocks)
+  std::unique_lock<std::mutex> locker;
+  if (self->thread)
+    {
+      VorbisEncoderThread &t = *self->thread;
+      locker = std::unique_lock<std::mutex> (t.mutex);
+      /* once all PCM data is queued, block until more Ogg data is available */
+      while (t.pcm_done && !self->dblocks && !t.finished)
+        t.cond.wait (locker);
+    }
+  else if (!self->dblocks)
     gsl_vorbis_encoder_process (self);
   while (n_bytes && self->dblocks)
     {
@@ -452,6 +582,11 @@ gsl_vorbis_encoder_ogg_eos (GslVorbisEncoder *self)
   assert_return (self != NULL, FALSE);
   assert_return (self->stream_setup == TRUE, FALSE);
 
+  if (self->thread)
+    {
+      std::lock_guard<std::mutex> locker (self->thread->mutex);
+      return self->eos && !self->dblocks;
+    }
   return self->eos && !self->dblocks;
 }
 
@@ -41,6 +41,11 @@ Bse::Error      gsl_vorbis_encoder_setup_stream       (GslVorbisEncoder       *s
 void              gsl_vorbis_encoder_write_pcm          (GslVorbisEncoder       *self,
                                                          guint                   n_values,
                                                          gfloat                 *values);
+/* (optional) encode on a separate thread, write_pcm() then queues up to
+ * max_queued_values and blocks once the queue is full (call after setup_stream)
+ */
+Bse::Error      gsl_vorbis_encoder_start_thread       (GslVorbisEncoder       *self,
+                                                         guint                   max_queued_values);
 /* (optional) incremental load distribution */
 gboolean          gsl_vorbis_encoder_needs_processing   (GslVorbisEncoder       *self);
 void              gsl_vorbis_encoder_process            (GslVorbisEncoder       *self);
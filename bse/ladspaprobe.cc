@@ -0,0 +1,29 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#include <bse/bseladspa.hh>
+#include <unistd.h>
+
+/* BseLadspaProbe - load LADSPA plugins outside of BSE and report their types.
+ * Usage: BseLadspaProbe <plugin.so>...
+ * Probe results go to the original stdout, anything the plugins print is redirected to stderr.
+ */
+int
+main (int argc, char *argv[])
+{
+  const int outfd = dup (1);
+  if (outfd < 0 || dup2 (2, 1) < 0)
+    return 1;
+  std::string output;
+  for (int i = 1; i < argc; i++)
+    output += bse_ladspa_plugin_probe (argv[i]);
+  size_t written = 0;
+  while (written < output.size())
+    {
+      const ssize_t l = write (outfd, output.data() + written, output.size() - written);
+      if (l < 0 && errno == EINTR)
+        continue;
+      if (l <= 0)
+        break;
+      written += l;
+    }
+  return written == output.size() ? 0 : 1;
+}
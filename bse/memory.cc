@@ -4,7 +4,6 @@
 #include <bse/testing.hh>
 #include <sys/mman.h>
 #include <unistd.h>     // _SC_PAGESIZE
-#include <shared_mutex>
 
 #define MEM_ALIGN(addr, alignment)      (alignment * size_t ((size_t (addr) + alignment - 1) / alignment))
 #define CHECK_FREE_OVERLAPS             0       /* paranoid chcks that slow down */
@@ -520,12 +519,229 @@ mm_info_pop_mt (void *block_start) // MT-Safe
   return {};
 }
 
+// == SizeClassAllocator ==
+/* Blocks up to size_class_max bytes are served from size classes, in cache line
+ * steps up to small_class_max and in quarter power of 2 steps above. Each class
+ * carves its blocks from 64k slabs and never returns them to an arena. Released
+ * blocks are kept in a per-thread cache and overflow in batches into a per-class
+ * depot, a lock-free stack that a thread cache refill takes over as a whole, so
+ * allocation and release are O(1) and never lock. All slabs live in a single
+ * address range that is reserved upfront, so new slabs are claimed with an
+ * atomic increment and the slab of a block is found by its offset.
+ */
+static constexpr size_t small_class_max = 4096;
+static constexpr size_t small_class_shift = 12; // log2 (small_class_max)
+static constexpr size_t n_small_classes = small_class_max / cache_line_size;
+static constexpr size_t slab_size = 64 * 1024;
+static constexpr size_t size_class_max = slab_size;
+static constexpr size_t n_size_classes = n_small_classes + 4 * 4; // 4 steps per power of 2 up to slab_size
+static constexpr size_t slab_region_size = 256 * 1024 * 1024;
+static constexpr size_t n_slabs_max = slab_region_size / slab_size;
+static constexpr uint32 thread_cache_max = 32; // blocks per size class
+static_assert (small_class_max << 4 == size_class_max);
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+struct SlabRegion {
+  char               *mem = nullptr;
+  uint8               slab_class[n_slabs_max] = { 0, }; // size class index per slab
+  std::atomic<uint32> n_slabs { 0 };
+  SlabRegion()
+  {
+    // reserve address space only, the kernel supplies zeroed pages on first touch
+    void *memory = mmap (nullptr, slab_region_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED)
+      fatal_error ("BSE: failed to reserve memory (%u bytes): %s", slab_region_size, strerror (errno));
+    mem = (char*) memory;
+    // fault in the first slabs, so early allocations do not page fault
+    memset (mem, 0, MINIMUM_ARENA_SIZE);
+  }
+};
+
+static SlabRegion&
+slab_region()
+{
+  static SlabRegion *const slab_region_ = new SlabRegion();
+  return *slab_region_;
+}
+
+// Released blocks of all threads, pushed in batches and only ever taken as a whole, so there is no ABA problem.
+struct SizeClassDepot {
+  std::atomic<FreeBlock*> free_list { nullptr };
+  void
+  push (FreeBlock *head, FreeBlock *tail) // MT-Safe
+  {
+    FreeBlock *next = free_list.load (std::memory_order_relaxed);
+    do
+      tail->next = next;
+    while (!free_list.compare_exchange_weak (next, head, std::memory_order_release, std::memory_order_relaxed));
+  }
+  FreeBlock*
+  take () // MT-Safe
+  {
+    return free_list.exchange (nullptr, std::memory_order_acquire);
+  }
+};
+static SizeClassDepot size_class_depots[n_size_classes];
+
+static inline size_t
+size_class_block_size (size_t ci)
+{
+  if (ci < n_small_classes)
+    return (ci + 1) * cache_line_size;
+  const size_t k = ci - n_small_classes;
+  const size_t base = small_class_max << (k / 4);
+  return base + (k % 4 + 1) * (base / 4);
+}
+
+static inline size_t
+size_class_index (size_t size)
+{
+  if (size <= small_class_max)
+    return (size - 1) / cache_line_size;
+  const size_t shift = 63 - __builtin_clzll (size - 1);  // base < size <= 2 * base
+  const size_t base = size_t (1) << shift;
+  return n_small_classes + (shift - small_class_shift) * 4 + (size - 1 - base) / (base / 4);
+}
+
+static char*
+size_class_new_slab (size_t ci) // MT-Safe
+{
+  SlabRegion &sr = slab_region();
+  uint32 slab = sr.n_slabs.load (std::memory_order_relaxed);
+  do
+    {
+      if (slab >= n_slabs_max)
+        return nullptr;         // out of slabs
+    }
+  while (!sr.n_slabs.compare_exchange_weak (slab, slab + 1, std::memory_order_relaxed));
+  sr.slab_class[slab] = ci;     // published to other threads along with the blocks of this slab
+  return sr.mem + slab * slab_size;
+}
+
+struct ThreadCache {
+  FreeBlock *lists[n_size_classes] = { nullptr, };
+  uint32     counts[n_size_classes] = { 0, };
+  char      *slab_next[n_size_classes] = { nullptr, }; // unused part of the last slab claimed
+  char      *slab_end[n_size_classes] = { nullptr, };
+  void
+  flush (size_t ci, uint32 n_blocks)
+  {
+    FreeBlock *head = lists[ci], *tail = head;
+    for (uint32 i = 1; i < n_blocks; i++)
+      tail = tail->next;
+    lists[ci] = tail->next;
+    counts[ci] -= n_blocks;
+    size_class_depots[ci].push (head, tail);
+  }
+  FreeBlock*
+  refill (size_t ci)
+  {
+    // take over the blocks released by other threads
+    FreeBlock *block = size_class_depots[ci].take();
+    if (block)
+      {
+        lists[ci] = block;
+        for (counts[ci] = 1; block->next; block = block->next)
+          counts[ci]++;
+        return lists[ci];
+      }
+    // carve new blocks
+    const size_t block_size = size_class_block_size (ci);
+    while (counts[ci] < thread_cache_max / 2)
+      {
+        if (slab_next[ci] + block_size > slab_end[ci])
+          {
+            slab_next[ci] = size_class_new_slab (ci);
+            slab_end[ci] = slab_next[ci] ? slab_next[ci] + slab_size : nullptr;
+            if (!slab_next[ci])
+              break;            // out of slabs
+          }
+        block = (FreeBlock*) slab_next[ci];
+        slab_next[ci] += block_size;
+        block->next = lists[ci];
+        lists[ci] = block;
+        counts[ci]++;
+      }
+    return lists[ci];
+  }
+  ~ThreadCache()
+  {
+    for (size_t ci = 0; ci < n_size_classes; ci++)
+      {
+        // hand the rest of the current slab to other threads
+        const size_t block_size = size_class_block_size (ci);
+        for (; slab_next[ci] && slab_next[ci] + block_size <= slab_end[ci]; slab_next[ci] += block_size)
+          {
+            FreeBlock *block = (FreeBlock*) slab_next[ci];
+            block->next = lists[ci];
+            lists[ci] = block;
+            counts[ci]++;
+          }
+        if (counts[ci])
+          flush (ci, counts[ci]);
+      }
+  }
+};
+static thread_local ThreadCache thread_cache;
+
+static void*
+size_class_alloc (size_t size)
+{
+  const size_t ci = size_class_index (size);
+  ThreadCache &tc = thread_cache;
+  FreeBlock *block = tc.lists[ci];
+  if (BSE_UNLIKELY (!block))
+    {
+      block = tc.refill (ci);
+      if (!block)
+        return nullptr;
+    }
+  tc.lists[ci] = block->next;
+  tc.counts[ci]--;
+  block->next = nullptr;        // released blocks are zeroed
+  return block;
+}
+
+static bool
+size_class_free (void *mem)
+{
+  const SlabRegion &sr = slab_region();
+  const size_t offset = ((char*) mem) - sr.mem;
+  if (offset >= slab_region_size)
+    return false;
+  const size_t slab = offset / slab_size;
+  if (BSE_UNLIKELY (slab >= sr.n_slabs.load (std::memory_order_relaxed)))
+    fatal_error ("%s: invalid memory pointer: %p\n", "fast_mem_free", mem);
+  const size_t ci = sr.slab_class[slab];
+  const size_t block_offset = offset % slab_size;
+  if (BSE_UNLIKELY (block_offset % size_class_block_size (ci) != 0))
+    fatal_error ("%s: invalid memory pointer: %p\n", "fast_mem_free", mem);
+  memset (mem, 0, size_class_block_size (ci));
+  ThreadCache &tc = thread_cache;
+  FreeBlock *block = (FreeBlock*) mem;
+  block->next = tc.lists[ci];
+  tc.lists[ci] = block;
+  tc.counts[ci]++;
+  if (BSE_UNLIKELY (tc.counts[ci] > thread_cache_max))
+    tc.flush (ci, thread_cache_max / 2);
+  return true;
+}
+
 } // FastMemory
 
 // == aligned malloc/calloc/free ==
 void*
 fast_mem_alloc (size_t size)
 {
+  if (size > 0 && size <= FastMemory::size_class_max)
+    {
+      void *const ptr = FastMemory::size_class_alloc (size);
+      if (BSE_ISLIKELY (ptr))
+        return ptr;
+    }
   std::unique_lock<std::mutex> shortlock (FastMemory::fast_mem_mutex);
   FastMemory::ArenaBlock ab = FastMemory::fast_mem_allocate_aligned_block (size); // MT-Guarded
   shortlock.unlock();
@@ -541,6 +757,8 @@ void
 fast_mem_free (void *mem)
 {
   return_unless (mem);
+  if (FastMemory::size_class_free (mem))
+    return;
   FastMemory::ArenaBlock ab = FastMemory::mm_info_pop_mt (mem);
   if (!ab.block_start)
     fatal_error ("%s: invalid memory pointer: %p\n", __func__, mem);
@@ -552,22 +770,55 @@ fast_mem_free (void *mem)
 #ifndef NDEBUG
 static CString cstring_early_test = "NULL"; // initialization must preceede cstring_globals
 #endif
+/* Quarks are indices into pages of strings which are never moved or released,
+ * quark 0 is always the empty string. A string to quark hash index is kept as
+ * open addressing table, readers probe it without locks, while insertions are
+ * serialized by assign_mutex. Tables are only replaced (never modified in a
+ * way that invalidates readers) when they grow, superseded tables are leaked.
+ */
 struct CStringGlobals {
-  static constexpr size_t static_quarks_max = 2048; // results in ca 64k for sizeof (static_quarks)
-  std::string static_quarks[static_quarks_max];
-  std::atomic<size_t> n_static_quarks = 1;
-  std::shared_mutex quarks_mutex;
-  std::unordered_map<uint, std::string> quarks_map;
-  uint               assign_quark (const std::string &s);
-  uint               lookup_quark (const std::string &s);
-  const std::string& string       (uint quark);
+  static constexpr uint page_bits = 12, page_size = 1 << page_bits, pages_max = 4096; // 16M quarks
+  struct HashTable {
+    const uint32         mask;
+    std::atomic<uint64> *const slots;   // (hash << 32) | quark, 0 == unused
+    explicit HashTable (uint32 n_slots) : mask (n_slots - 1), slots (new std::atomic<uint64>[n_slots]) {}
+  };
+  std::atomic<std::string*> pages[pages_max] = { nullptr, };
+  std::atomic<uint>         n_quarks = 1;
+  std::atomic<HashTable*>   hash_table = nullptr;
+  std::mutex                assign_mutex;
+  /*ctor*/           CStringGlobals ();
+  uint               assign_quark   (const std::string &s);
+  uint               lookup_quark   (const std::string &s);
+  const std::string& string         (uint quark);
+  uint               find_quark     (const std::string &s, uint32 hash);
+  void               insert_quark   (uint32 hash, uint quark);
+  static uint32
+  string_hash (const std::string &s)
+  {
+    uint32 hash = 0x811c9dc5; // FNV-1a
+    for (const char c : s)
+      hash = 0x01000193 * (hash ^ uint8 (c));
+    return hash;
+  }
 };
 static PersistentStaticInstance<CStringGlobals> cstring_globals;
 
+CStringGlobals::CStringGlobals ()
+{
+  for (size_t i = 0; i < pages_max; i++)
+    pages[i].store (nullptr, std::memory_order_relaxed);
+  pages[0].store (new std::string[page_size]); // quark 0 == ""
+  HashTable *table = new HashTable (1024);
+  for (size_t i = 0; i <= table->mask; i++)
+    table->slots[i].store (0, std::memory_order_relaxed);
+  hash_table.store (table);
+}
+
 /// Assign a std::string to a CString, after deduplication, its memory is never released.
 /// In contrast to lookup(), the resulting CString is guaranteed to resolve to the contents
 /// of std::string `s`, memory is allocated if needed.
-/// Note that CString::assign() is not particularly fast, use it only to save
+/// Note that CString::assign() needs to hash `s`, use it only to save
 /// memory for strings that are known to persist throughout runtime.
 CString&
 CString::assign (const std::string &s)
@@ -577,34 +828,76 @@ CString::assign (const std::string &s)
   return *this;
 }
 
+uint
+CStringGlobals::find_quark (const std::string &s, uint32 hash)
+{
+  HashTable *table = hash_table.load (std::memory_order_acquire);
+  for (uint32 i = hash & table->mask; ; i = (i + 1) & table->mask)
+    {
+      const uint64 slot = table->slots[i].load (std::memory_order_acquire);
+      if (!slot)
+        return 0; // not found
+      if (uint32 (slot >> 32) == hash && string (uint32 (slot)) == s)
+        return uint32 (slot);
+    }
+}
+
+void
+CStringGlobals::insert_quark (uint32 hash, uint quark) // assign_mutex must be locked
+{
+  HashTable *table = hash_table.load (std::memory_order_relaxed);
+  if (quark * 2 > table->mask) // keep load factor <= 0.5, n_quarks - 1 are hashed
+    {
+      HashTable *bigger = new HashTable (2 * (table->mask + 1));
+      for (size_t i = 0; i <= bigger->mask; i++)
+        bigger->slots[i].store (0, std::memory_order_relaxed);
+      for (size_t j = 0; j <= table->mask; j++)
+        {
+          const uint64 slot = table->slots[j].load (std::memory_order_relaxed);
+          if (!slot)
+            continue;
+          uint32 i = uint32 (slot >> 32) & bigger->mask;
+          while (bigger->slots[i].load (std::memory_order_relaxed))
+            i = (i + 1) & bigger->mask;
+          bigger->slots[i].store (slot, std::memory_order_relaxed);
+        }
+      hash_table.store (bigger, std::memory_order_release);
+      table = bigger; // the old table may still be probed by readers, so it is leaked
+    }
+  uint32 i = hash & table->mask;
+  while (table->slots[i].load (std::memory_order_relaxed))
+    i = (i + 1) & table->mask;
+  table->slots[i].store (uint64 (hash) << 32 | quark, std::memory_order_release);
+}
+
 uint
 CStringGlobals::assign_quark (const std::string &s)
 {
-  const size_t lastmax = n_static_quarks;
-  for (size_t i = 0; i < lastmax; i++)
-    if (s == static_quarks[i])
-      return i; // fast path
-  std::unique_lock ulock (quarks_mutex);
-  for (size_t i = lastmax; i < n_static_quarks; i++)
-    if (s == static_quarks[i])
-      return i; // found concurrently assigned quark
-  if (n_static_quarks < static_quarks_max)
+  if (s.empty())
+    return 0;
+  const uint32 hash = string_hash (s);
+  uint quark = find_quark (s, hash);
+  if (quark)
+    return quark; // fast path
+  std::lock_guard<std::mutex> locker (assign_mutex);
+  quark = find_quark (s, hash);
+  if (quark)
+    return quark; // found concurrently assigned quark
+  quark = n_quarks.load (std::memory_order_relaxed);
+  if (BSE_UNLIKELY (quark >= page_size * pages_max))
+    fatal_error ("%s: too many quarks: %u\n", __func__, quark);
+  std::string *page = pages[quark >> page_bits].load (std::memory_order_relaxed);
+  if (!page)
     {
-      const uint quark = n_static_quarks;
-      std::string str = s;
-      str.shrink_to_fit();
-      static_quarks[quark] = str;
-      n_static_quarks += 1;
-      return quark; // assignment via static_quarks
+      page = new std::string[page_size];
+      pages[quark >> page_bits].store (page, std::memory_order_release);
     }
-  for (auto it = quarks_map.begin(); it != quarks_map.end(); it++)
-    if (it->second == s)
-      return it->first; // found quark in map
-  const uint quark = static_quarks_max + quarks_map.size();
-  std::string str = s;
+  std::string &str = page[quark & (page_size - 1)];
+  str = s;
   str.shrink_to_fit();
-  quarks_map[quark] = str;
-  return quark; // assignment via quarks_map
+  n_quarks.store (quark + 1, std::memory_order_release);
+  insert_quark (hash, quark);
+  return quark;
 }
 
 /// Lookup a previously existing CString for a std::string `s`.
@@ -622,18 +915,9 @@ CString::lookup (const std::string &s)
 uint
 CStringGlobals::lookup_quark (const std::string &s)
 {
-  const size_t lastmax = n_static_quarks;
-  for (size_t i = 0; i < lastmax; i++)
-    if (s == static_quarks[i])
-      return i; // fast path
-  std::shared_lock ulock (quarks_mutex);
-  for (size_t i = lastmax; i < n_static_quarks; i++)
-    if (s == static_quarks[i])
-      return i; // found concurrently assigned quark
-  for (auto it = quarks_map.begin(); it != quarks_map.end(); it++)
-    if (it->second == s)
-      return it->first; // found quark in map
-  return 0; // giving up
+  if (s.empty())
+    return 0;
+  return find_quark (s, string_hash (s)); // yields 0 if not found
 }
 
 /// Convert `CString` into a std::string.
@@ -647,10 +931,12 @@ CString::string () const
 const std::string&
 CStringGlobals::string (uint quark)
 {
-  if (BSE_ISLIKELY (quark < n_static_quarks))
-    return static_quarks[quark];
-  std::shared_lock slock (quarks_mutex);
-  return quarks_map[quark];
+  if (BSE_ISLIKELY (quark < n_quarks.load (std::memory_order_acquire)))
+    {
+      std::string *page = pages[quark >> page_bits].load (std::memory_order_acquire);
+      return page[quark & (page_size - 1)];
+    }
+  return pages[0].load (std::memory_order_relaxed)[0]; // invalid quarks yield ""
 }
 
 } // Bse
@@ -67,6 +67,9 @@ Event::to_string () const
     case PITCH_BEND:            if (!et) et = "PITCH_BEND";
       return string_format ("%+4d ch=%-2u %s value=%+f",
                             frame, channel, et, value);
+    case PARAM_VALUE:           if (!et) et = "PARAM_VALUE";
+      return string_format ("%+4d %s param=%u value=%f ramp=%u/%u",
+                            frame, et, param, pvalue, nframes, uint (ramp));
     case SYSEX:                 if (!et) et = "SYSEX";
       return string_format ("%+4d %s (unhandled)", frame, et);
     default:
@@ -159,6 +162,17 @@ make_pitch_bend (uint16 chnl, float val)
   return ev;
 }
 
+Event
+make_param_value (uint paramid, float val, uint nframes, RampShape shape)
+{
+  Event ev (Event::PARAM_VALUE);
+  ev.param = paramid;
+  ev.pvalue = val;
+  ev.nframes = nframes;
+  ev.ramp = nframes ? shape : RampShape::STEP;
+  return ev;
+}
+
 // == EventStream ==
 EventStream::EventStream ()
 {
@@ -11,6 +11,13 @@ namespace AudioSignal {
 /// Type of MIDI Events.
 enum class EventType : uint8_t {};
 
+/// Shape of a parameter change delivered via Event::PARAM_VALUE.
+enum class RampShape : uint8_t {
+  STEP          = 0,    ///< Jump to the target value.
+  LINEAR        = 1,    ///< Linear interpolation towards the target value.
+  EXPONENTIAL   = 2,    ///< Exponential curve, for frequencies and gains; both ends need the same sign.
+};
+
 /// Extended type information for Event.
 enum class Message : int32_t {
   NONE                          = 0,
@@ -29,11 +36,13 @@ enum class Message : int32_t {
   PROGRAM_CHANGE                = 0xC0,
   CHANNEL_PRESSURE              = 0xD0,
   PITCH_BEND                    = 0xE0,
+  PARAM_VALUE                   = 0x70,
   SYSEX                         = 0xF0,
 };
 
 /// MIDI Event data structure.
 struct Event {
+  constexpr static EventType PARAM_VALUE      = EventType (0x70); ///< Processor parameter automation, not MIDI
   constexpr static EventType NOTE_OFF         = EventType (0x80);
   constexpr static EventType NOTE_ON          = EventType (0x90);
   constexpr static EventType AFTERTOUCH       = EventType (0xA0); ///< Key Pressure, polyphonic aftertouch
@@ -48,10 +57,11 @@ struct Event {
   union {
     uint8   key;        ///< NOTE, KEY_PRESSURE MIDI note, 0…0x7f, 60 = middle C at 261.63 Hz.
     uint8   fragment;   ///< Flag for multi-part control change mesages.
+    RampShape ramp;     ///< PARAM_VALUE curve towards the target value.
   };
   union {
     uint    length;     ///< Data event length of byte array.
-    uint    param;      ///< PROGRAM_CHANGE program, CONTROL_CHANGE controller, 0…0x7f
+    uint    param;      ///< PROGRAM_CHANGE program, CONTROL_CHANGE controller, 0…0x7f, PARAM_VALUE ParamId
     uint    noteid;     ///< NOTE, identifier for note expression handling or 0xffffffff.
   };
   union {
@@ -60,6 +70,10 @@ struct Event {
       float value;      ///< CONTROL_CHANGE 0…+1, CHANNEL_PRESSURE, 0…+1, PITCH_BEND -1…+1
       uint  cval;       ///< CONTROL_CHANGE control value, 0…0x7f
     };
+    struct {
+      float pvalue;     ///< PARAM_VALUE target value.
+      uint  nframes;    ///< PARAM_VALUE ramp length in frames, 0 for an immediate change.
+    };
     struct {
       float velocity;   ///< NOTE, KEY_PRESSURE, CHANNEL_PRESSURE, 0…+1
       float tuning;     ///< NOTE, fine tuning in ±cents
@@ -81,6 +95,7 @@ Event make_control    (uint16 chnl, uint prm, float val);
 Event make_control8   (uint16 chnl, uint prm, uint8 cval);
 Event make_program    (uint16 chnl, uint prgrm);
 Event make_pitch_bend (uint16 chnl, float val);
+Event make_param_value (uint paramid, float val, uint nframes = 0, RampShape shape = RampShape::LINEAR);
 
 /// A stream of writable Event structures.
 class EventStream {
@@ -94,6 +109,7 @@ public:
   size_t       size            () const noexcept { return events_.size(); }
   bool         empty           () const noexcept { return events_.empty(); }
   void         clear           () noexcept       { events_.clear(); }
+  void         reserve         (size_t n)        { events_.reserve (n); }
   bool         append_unsorted (int8_t frame, const Event &event);
   void         ensure_order    ();
   int64_t      last_frame      () const BSE_PURE;
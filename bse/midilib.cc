@@ -15,52 +15,100 @@ constexpr int64_t MINBPM = 1, MAXBPM = 1024;
 constexpr int64_t MINRATE = 44100, MAXRATE = 192000;
 constexpr static int64_t PPQ = 384;
 
-struct TickNote {
-  int64_t tick;
-  Event note_event;
-};
-struct CmpTickNotes {
-  int64_t
-  operator() (const TickNote &a, const TickNote &b) const
-  {
-    return int64_t (a.tick) - int64_t (b.tick);
-  }
-  static const CmpTickNotes cmpticknotes;
-};
+// == ClipSchedule ==
+/// Append the range @a start_tick .. @a stop_tick of @a events, empty ranges are ignored.
+void
+ClipSchedule::add_clip (const ClipEventVectorP &events, int64_t start_tick, int64_t stop_tick)
+{
+  return_unless (events && stop_tick > start_tick);
+  clips.push_back ({ events, start_tick, stop_tick });
+  length += stop_tick - start_tick;
+  // count overlapping notes, note-offs are flushed before note-ons at the same tick
+  std::vector<int64_t> offs;
+  const PartNote *const notes = events->data();
+  size_t n_notes = 0;
+  for (size_t i = 0; i < events->size(); i++)
+    if (notes[i].tick >= start_tick && notes[i].tick < stop_tick)
+      {
+        while (offs.size() && offs.front() <= notes[i].tick)
+          {
+            std::pop_heap (offs.begin(), offs.end(), std::greater<int64_t>());
+            offs.pop_back();
+          }
+        offs.push_back (std::min (int64_t (notes[i].tick) + notes[i].duration, stop_tick));
+        std::push_heap (offs.begin(), offs.end(), std::greater<int64_t>());
+        n_notes = std::max (n_notes, offs.size());
+      }
+  max_notes = std::max (max_notes, n_notes);
+  // leave room for note-offs still pending from a previous schedule
+  offheap.reserve (2 * max_notes);
+}
+
+// == ClipScheduler ==
+ClipScheduler::ClipScheduler (size_t n_reserved)
+{
+  offheap_.reserve (n_reserved);
+}
+
+/// Swap in a new schedule, the playback position is kept (modulo the new length).
+/// The note-off heap adopts the storage reserved by ClipSchedule::add_clip() if that is larger,
+/// so no allocations happen here and advance() drops notes instead of growing the heap.
+void
+ClipScheduler::swap_schedule (ClipScheduleP &schedule)
+{
+  // swap shared_ptr so lengthy dtors are executed in another thread
+  schedule_.swap (schedule);
+  if (schedule_ && schedule_->offheap.capacity() > offheap_.capacity())
+    {
+      std::vector<TickNote> &spare = schedule_->offheap;
+      spare.assign (offheap_.begin(), offheap_.end());  // fits into reserved capacity
+      offheap_.swap (spare);                            // old storage is released with schedule_
+    }
+  const int64_t length = schedule_ ? schedule_->length : 0;
+  if (length && position_ >= length)
+    seek (loop_ ? position_ % length : length);
+  else
+    seek (std::min (position_, length));
+}
+
+/// Rewind and discard pending note-offs.
+void
+ClipScheduler::reset ()
+{
+  offheap_.clear();
+  seq_ = 0;
+  seek (0);
+}
+
+void
+ClipScheduler::seek (int64_t position)
+{
+  position_ = position;
+  clip_index_ = 0;
+  clip_offset_ = 0;
+  return_unless (schedule_);
+  const auto &clips = schedule_->clips;
+  while (clip_index_ + 1 < clips.size() &&
+         clip_offset_ + clips[clip_index_].stop_tick - clips[clip_index_].start_tick <= position_)
+    {
+      clip_offset_ += clips[clip_index_].stop_tick - clips[clip_index_].start_tick;
+      clip_index_++;
+    }
+}
 
 // == MidiInputImpl ==
 class MidiInputImpl : public MidiInputIface {
   constexpr static int64_t I63MAX = 9223372036854775807;
   int64_t start_frame = I63MAX;
   double frame2tick_ = 0, tick2frame_ = 0, bpm_ = 0;
-  ClipEventVectorP cevp;
-  std::vector<TickNote> offqueue;
+  ClipScheduler scheduler_;
   double block_tick_ = 0; // tick count at block boundary, (past) BPM dependent
-  int64_t clip_tick_ = 0; // tick counter within clip start..end
-  int64_t clip_end_ = 0;
   const Event *midi_through = nullptr, *midi_through_end = nullptr;
-  bool loop_clip_ = true;
 public:
-  MidiInputImpl()
-  {
-    offqueue.reserve (256);
-  }
   void
-  swap_event_vector (ClipEventVectorP &cev) override
+  swap_clip_schedule (ClipScheduleP &schedule) override
   {
-    // swap shared_ptr so lengthy dtors are executed in another thread
-    ClipEventVectorP old = cevp;
-    cevp = cev;
-    cev = old;
-    clip_end_ = 0 + 4 * PPQ * 2; // FIXME: hard coded to 2 bars atm
-    if (clip_tick_ >= clip_end_)
-      {
-        if (loop_clip_ && clip_end_)
-          while (clip_tick_ >= clip_end_)
-            clip_tick_ -= clip_end_;
-        else // !loop_clip_
-          clip_tick_ = clip_end_;
-      }
+    scheduler_.swap_schedule (schedule);
   }
   void
   query_info (ProcessorInfo &info) const override
@@ -91,9 +139,8 @@ public:
   reset() override
   {
     block_tick_ = 0;
-    clip_tick_ = 0;
     bpm_ = 0;
-    offqueue.clear();
+    scheduler_.reset();
     const int64_t start_ms = 100;                                               // start time in ms
     start_frame = engine().frame_counter() + sample_rate() * start_ms / 1000;
     bpm_ = 0;
@@ -126,72 +173,21 @@ public:
     // determine ranges
     const double next_block_tick = block_tick_ + n_frames * frame2tick_;
     // starting and playback
-    const int64_t tick_start = block_tick_, tick_delta = next_block_tick - block_tick_;
-    if (frame0 + n_frames > start_frame)
-      {
-        // start playback
-        if (UNLIKELY (start_frame >= frame0))
-          clip_tick_ = 0;
-        // playback in number of frames
-        advance_ticks (tick_start, tick_delta);
-      }
-    enqueue_until_tick (tick_start, tick_delta);
-    enqueue_until_frame (n_frames - 1);
+    const int64_t tick_start = block_tick_, tick_delta = int64_t (next_block_tick) - tick_start;
+    const bool playing = frame0 + n_frames > start_frame;
+    if (UNLIKELY (playing && start_frame >= frame0))
+      scheduler_.rewind();      // start playback
+    const int64_t last_frame = n_frames - 1;
+    scheduler_.advance (tick_start, tick_delta, playing, [&] (int64_t tick, const Event &event) {
+      const int64_t frame = CLAMP (int64_t (tick2frame_ * tick), 0, last_frame);
+      CDEBUG ("emit: engineframe=%u t2f=%.3f type=%d key=%d tick=%d frame=%u last=%d span=%d\n", engine().frame_counter(), tick2frame_,
+              event.type, event.key, tick, frame, tick_start, tick_delta);
+      enqueue_at_frame (frame, event);
+    });
+    enqueue_until_frame (last_frame);
     block_tick_ = next_block_tick;
   }
   void
-  advance_ticks (const int64_t last_tick, const int64_t tick_span)
-  {
-    // playback in ticks
-    PartNote index;
-    int64_t current_tick = 0; // offset in ticks into render().n_frames
-    int64_t delta = MIN (clip_end_ - clip_tick_, tick_span - current_tick);
-    while (delta > 0)
-      {
-        // queue events for clip_tick + delta
-        index.tick = clip_tick_;
-        const PartNote *note = cevp->lookup_after (index);
-        while (note && note != &*cevp->end() && note->tick < clip_tick_ + delta)
-          {
-            const int64_t tick_on  = current_tick + note->tick - clip_tick_;
-            const int64_t tick_off = current_tick + MIN (note->tick + note->duration, clip_end_) - clip_tick_;
-            enqueue_until_tick (last_tick, tick_on);
-            const int64_t frame = tick2frame_ * tick_on;
-            CDEBUG ("play: engineframe=%u t2f=%.3f key=%d tick=%d frame=%u cur=%d clip=%d span=%d\n", engine().frame_counter(), tick2frame_,
-                    note->key, note->tick, frame, current_tick, clip_tick_, tick_span);
-            Event ev = make_note_on (note->channel, note->key, note->velocity, note->fine_tune, note->id);
-            enqueue_at_frame (frame, ev);
-            ev.type = Event::NOTE_OFF;
-            TickNote tnote { last_tick + tick_off, ev };
-            auto old = offqueue.size();
-            vector_insert_sorted (offqueue, tnote, CmpTickNotes::cmpticknotes);
-            CDEBUG ("qoff: engineframe=%u t2f=%.3f key=%d tick=%d frame=%u last=%d span=%d fq=%d old=%d\n", engine().frame_counter(), tick2frame_,
-                    tnote.note_event.key, tnote.tick, frame, last_tick, tick_span, offqueue.size(), old);
-            note++;
-          }
-        // adjust deltas
-        current_tick += delta;  // march in sync with clip_tick
-        clip_tick_ += delta;    // march in sync with current_tick
-        if (BSE_UNLIKELY (clip_tick_ >= clip_end_) && loop_clip_)
-          clip_tick_ = 0;
-        delta = MIN (clip_end_ - clip_tick_, tick_span - current_tick);
-      }
-  }
-  void
-  enqueue_until_tick (const int64_t last_tick, const int64_t span)
-  {
-    return_unless (offqueue.size());
-    while (offqueue.size() && offqueue.front().tick <= last_tick + span)
-      {
-        TickNote tnote = offqueue.front();
-        offqueue.erase (offqueue.begin());
-        const int64_t frame = tick2frame_ * (tnote.tick - last_tick);
-        CDEBUG ("soff: engineframe=%u t2f=%.3f key=%d tick=%d frame=%u last=%d span=%d\n", engine().frame_counter(), tick2frame_,
-                tnote.note_event.key, tnote.tick, frame, last_tick, span);
-        enqueue_at_frame (frame, tnote.note_event);
-      }
-  }
-  void
   enqueue_until_frame (const int64_t frame)
   {
     assert_return (frame >= -128 && frame <= 127);
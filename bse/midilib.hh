@@ -11,16 +11,136 @@ namespace MidiLib {
 
 using ClipEventVectorP = ClipImpl::OrderedEventsP;
 
+/// Pending note-off, ordered by tick and FIFO sequence.
+struct ClipNoteOff {
+  int64_t            tick;
+  uint64_t           seq;       // keeps note-offs with equal ticks in FIFO order
+  AudioSignal::Event event;
+};
+
+/// Sequence of clip ranges, played back to back.
+struct ClipSchedule {
+  struct Clip {
+    ClipEventVectorP events;
+    int64_t          start_tick = 0;    ///< First tick of `events` to play.
+    int64_t          stop_tick = 0;     ///< Tick past the last tick of `events` to play.
+  };
+  std::vector<Clip> clips;
+  int64_t           length = 0;         ///< Sum of all clip lengths in ticks.
+  size_t            max_notes = 0;      ///< Maximum number of notes sounding at once.
+  std::vector<ClipNoteOff> offheap;     ///< Note-off heap storage, reserved before the schedule is handed to a ClipScheduler.
+  void              add_clip (const ClipEventVectorP &events, int64_t start_tick, int64_t stop_tick);
+};
+using ClipScheduleP = std::shared_ptr<ClipSchedule>;
+
+/// Generate note events from a ClipSchedule, pending note-offs are kept in a binary heap.
+class ClipScheduler {
+  using TickNote = ClipNoteOff;
+  std::vector<TickNote> offheap_;       // never grows during advance(), see swap_schedule()
+  ClipScheduleP         schedule_;
+  int64_t               position_ = 0;          // tick within schedule_->length
+  int64_t               clip_offset_ = 0;       // position of clips[clip_index_]
+  size_t                clip_index_ = 0;
+  uint64_t              seq_ = 0;
+  bool                  loop_ = true;
+  static bool           later    (const TickNote &a, const TickNote &b);
+  void                  seek     (int64_t position);
+  void                  push_off (int64_t tick, const AudioSignal::Event &event);
+  template<class Emit>
+  void                  flush_until (int64_t block_tick, int64_t tick_span, Emit &emit);
+public:
+  explicit ClipScheduler (size_t n_reserved = 256);
+  void     swap_schedule (ClipScheduleP &schedule);
+  void     reset         ();
+  void     rewind        ()             { seek (0); }
+  void     loop          (bool enabled) { loop_ = enabled; }
+  int64_t  position      () const       { return position_; }
+  size_t   n_pending     () const       { return offheap_.size(); }
+  template<class Emit>
+  void     advance       (int64_t block_tick, int64_t tick_span, bool playing, Emit &&emit);
+};
+
 class MidiInputIface : public AudioSignal::Processor {
 public:
   constexpr static ParamId BPM = ParamId (1);
-  virtual void swap_event_vector (ClipEventVectorP &cev) = 0;
+  virtual void swap_clip_schedule (ClipScheduleP &schedule) = 0;
 };
 
 using MidiInputIfaceP = std::shared_ptr<MidiInputIface>;
 
+// == Implementation Details ==
+inline bool
+ClipScheduler::later (const TickNote &a, const TickNote &b)
+{
+  return a.tick > b.tick || (a.tick == b.tick && a.seq > b.seq);
+}
+
+inline void
+ClipScheduler::push_off (int64_t tick, const AudioSignal::Event &event)
+{
+  offheap_.push_back ({ tick, seq_++, event });
+  std::push_heap (offheap_.begin(), offheap_.end(), later);
+}
+
+template<class Emit> inline void
+ClipScheduler::flush_until (int64_t block_tick, int64_t tick_span, Emit &emit)
+{
+  while (offheap_.size() && offheap_.front().tick <= block_tick + tick_span)
+    {
+      std::pop_heap (offheap_.begin(), offheap_.end(), later);
+      const TickNote &tnote = offheap_.back();
+      emit (tnote.tick - block_tick, tnote.event);
+      offheap_.pop_back();
+    }
+}
+
+/// Emit note events between @a block_tick and @a block_tick + @a tick_span in tick order via `emit (tick_offset, event)`.
+template<class Emit> void
+ClipScheduler::advance (int64_t block_tick, int64_t tick_span, bool playing, Emit &&emit)
+{
+  const ClipSchedule *schedule = schedule_.get();
+  int64_t current = 0;          // tick offset into block
+  while (playing && schedule && schedule->length > 0 && current < tick_span)
+    {
+      if (position_ >= schedule->length)
+        {
+          if (!loop_)
+            break;
+          seek (0);
+        }
+      const ClipSchedule::Clip &clip = schedule->clips[clip_index_];
+      const int64_t clip_tick = clip.start_tick + position_ - clip_offset_;
+      const int64_t delta = std::min (clip.stop_tick - clip_tick, tick_span - current);
+      PartNote index;
+      index.tick = clip_tick;
+      index.key = -1;
+      index.id = 0;
+      const PartNote *note = clip.events->lookup_after (index);
+      const PartNote *const end = clip.events->data() + clip.events->size();
+      for (; note && note < end && note->tick < clip_tick + delta; note++)
+        {
+          const int64_t tick_on = current + note->tick - clip_tick;
+          const int64_t tick_off = tick_on + std::min (int64_t (note->tick) + note->duration, clip.stop_tick) - note->tick;
+          flush_until (block_tick, tick_on, emit);
+          if (UNLIKELY (offheap_.size() >= offheap_.capacity()))
+            continue;   // drop notes whose note-off cannot be queued without allocating
+          AudioSignal::Event ev = AudioSignal::make_note_on (note->channel, note->key, note->velocity, note->fine_tune, note->id);
+          emit (tick_on, ev);
+          ev.type = AudioSignal::Event::NOTE_OFF;
+          push_off (block_tick + tick_off, ev);
+        }
+      current += delta;
+      position_ += delta;
+      if (clip_tick + delta >= clip.stop_tick && clip_index_ + 1 < schedule->clips.size())
+        {
+          clip_offset_ += clip.stop_tick - clip.start_tick;
+          clip_index_ += 1;
+        }
+    }
+  flush_until (block_tick, tick_span, emit);
+}
+
 } // MidiLib
 } // Bse
 
 #endif // __BSE_MIDILIB_HH__
-
@@ -79,45 +79,125 @@ ObjectImpl::list_props ()
 }
 
 // == NotifierImpl ==
-void
-NotifierImpl::emit_event (const std::string &type, const KV &a1, const KV &a2, const KV &a3,
-                          const KV &a4, const KV &a5, const KV &a6, const KV &a7)
+// Objects with pending notifies, flushed once per NOTIFY_INTERVAL_MS from the main loop.
+struct NotifyQueue {
+  std::vector<NotifierImpl*>  pending;
+  std::vector<NotifierImpl*> *flushing = nullptr;       // batch currently being emitted
+  uint                        timer_id = 0;
+  static NotifyQueue&
+  instance()
+  {
+    static NotifyQueue *const queue = new NotifyQueue();
+    return *queue;
+  }
+  static void
+  forget (std::vector<NotifierImpl*> *batch, NotifierImpl *notifier)
+  {
+    if (batch)
+      for (auto &entry : *batch)
+        if (entry == notifier)
+          entry = nullptr;
+  }
+};
+
+NotifierImpl::~NotifierImpl()
+{
+  if (!pending_notifies_.empty())
+    {
+      NotifyQueue &queue = NotifyQueue::instance();
+      NotifyQueue::forget (&queue.pending, this);
+      NotifyQueue::forget (queue.flushing, this);
+    }
+}
+
+static bool
+valid_event_type (const std::string &type)
 {
   const char ident_chars[] =
     "0123456789"
     "abcdefghijklmnopqrstuvwxyz"
     "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
-  const char *const ctype = type.c_str(), *const colon = strchr (ctype, ':');
-  const String name = colon ? type.substr (0, colon - ctype) : type;
-  const String detail = colon ? type.substr (colon - ctype + 1) : "";
-  for (size_t i = 0; name[i]; i++)
-    if (!strchr (ident_chars, name[i]))
-      {
-        warning ("invalid characters in Event type: %s", type);
-        break;
-      }
-  for (size_t i = 0; detail[i]; i++)
-    if (!strchr (ident_chars, detail[i]) and detail[i] != '_')
-      {
-        warning ("invalid characters in Event type: %s", type);
-        break;
-      }
+  const size_t colon = type.find (':');
+  for (size_t i = 0; i < type.size() && i < colon; i++)
+    if (!strchr (ident_chars, type[i]))
+      return false;
+  for (size_t i = colon + 1; colon != std::string::npos && i < type.size(); i++)
+    if (!strchr (ident_chars, type[i]) and type[i] != '_')
+      return false;
+  return true;
+}
+
+// Intern `type`, event type characters are validated only once per type.
+static Aida::EventDispatcher::EventId
+intern_event_type (const std::string &type)
+{
+  bool newly_interned = false;
+  const Aida::EventDispatcher::EventId event_id = Aida::EventDispatcher::event_id (type, &newly_interned);
+  if (newly_interned && !valid_event_type (type))
+    warning ("invalid characters in Event type: %s", type);
+  return event_id;
+}
+
+void
+NotifierImpl::emit_event_id (EventId event_id, const KV *const *args, size_t n_args)
+{
+  const std::string type = Aida::EventDispatcher::event_type (event_id);
+  const size_t colon = type.find (':');
   Aida::Event ev (type);
-  const KV *args[] = { &a1, &a2, &a3, &a4, &a5, &a6, &a7 };
-  for (size_t i = 0; i < sizeof (args) / sizeof (args[0]); i++)
+  for (size_t i = 0; i < n_args; i++)
     if (!args[i]->key.empty())
       ev[args[i]->key] = args[i]->value;
-  ev["name"] = name;
-  ev["detail"] = detail;
-  event_dispatcher_.emit (ev);  // emits "notify:detail" as type="notify:detail" name="notify" detail="detail"
+  ev["name"] = colon != std::string::npos ? type.substr (0, colon) : type;
+  ev["detail"] = colon != std::string::npos ? type.substr (colon + 1) : "";
+  event_dispatcher_.emit (ev, event_id);  // emits "notify:detail" as type="notify:detail" name="notify" detail="detail"
+}
+
+void
+NotifierImpl::emit_event (const std::string &type, const KV &a1, const KV &a2, const KV &a3,
+                          const KV &a4, const KV &a5, const KV &a6, const KV &a7)
+{
+  const KV *args[] = { &a1, &a2, &a3, &a4, &a5, &a6, &a7 };
+  emit_event_id (intern_event_type (type), args, sizeof (args) / sizeof (args[0]));
   // using namespace Aida::KeyValueArgs; emit_event ("notification", "value"_v = 5);
 }
 
+void
+NotifierImpl::flush_notifies()
+{
+  NotifyQueue &queue = NotifyQueue::instance();
+  queue.timer_id = 0;
+  std::vector<NotifierImpl*> batch;
+  batch.swap (queue.pending);
+  queue.flushing = &batch;
+  for (size_t i = 0; i < batch.size(); i++)
+    if (batch[i])
+      {
+        NotifierImpl *notifier = batch[i];
+        std::vector<EventId> event_ids;
+        event_ids.swap (notifier->pending_notifies_);
+        auto lifeguard = notifier->shared_from_this();  // handlers may release the notifier
+        for (EventId event_id : event_ids)
+          notifier->emit_event_id (event_id, nullptr, 0);
+      }
+  queue.flushing = nullptr;
+}
+
+/// Queue "notify:" + @a detail, repeated notifications are coalesced and emitted within NOTIFY_INTERVAL_MS.
 void
 NotifierImpl::notify (const String &detail)
 {
   assert_return (detail.empty() == false);
-  emit_event ("notify:" + detail);
+  assert_return (this_thread_is_bse());
+  const EventId event_id = intern_event_type ("notify:" + detail);
+  for (EventId pending : pending_notifies_)
+    if (pending == event_id)
+      return;
+  NotifyQueue &queue = NotifyQueue::instance();
+  if (pending_notifies_.empty())
+    queue.pending.push_back (this);
+  pending_notifies_.push_back (event_id);
+  if (!queue.timer_id)
+    queue.timer_id = exec_timeout (flush_notifies, NOTIFY_INTERVAL_MS);
 }
 
 int64_t
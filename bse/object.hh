@@ -8,12 +8,18 @@
 namespace Bse {
 
 class NotifierImpl : public Aida::EnableSharedFromThis<NotifierImpl>, public virtual NotifierIface {
+  using EventId = Aida::EventDispatcher::EventId;
   Aida::EventDispatcher  event_dispatcher_;
+  std::vector<EventId>   pending_notifies_;     // coalesced "notify:detail" IDs, see flush_notifies()
+  static void            flush_notifies ();
+  void                   emit_event_id  (EventId event_id, const Aida::KeyValue *const *args, size_t n_args);
 protected:
   using KV = Aida::KeyValue;
   virtual Aida::IfaceEventConnection __attach__ (const String &eventselector, EventHandlerF handler) override
   { return event_dispatcher_.attach (eventselector, handler); }
+  virtual ~NotifierImpl ();
 public:
+  static constexpr uint NOTIFY_INTERVAL_MS = 16;        ///< Interval for coalescing notify() calls.
   void    notify     (const String &detail) override;
   int64_t notifyon   (const std::string &event, const std::string &callback) override;
   bool    notifyoff  (int64_t notifierid) override;
@@ -377,6 +377,18 @@ struct ProcessorRegistryContext {
 };
 static __thread ProcessorRegistryContext *processor_ctor_registry_context = nullptr;
 
+// Processor parameter values published in shared memory, one normalized float per PParam
+struct Processor::ParamFeedback {
+  SharedBlock         block;
+  std::vector<double> values;   // last published parameter values, owned by the render thread
+  ParamFeedback      *trash_next = nullptr;
+};
+
+// Map shared memory offsets of ParamFeedback blocks to their Processor, for param_send_shm_mt()
+static std::mutex                                  param_feedback_mutex;
+static std::map<int64,std::weak_ptr<Processor>>    param_feedback_procs;
+std::atomic<Processor::ParamFeedback*> Processor::pfeedback_trash_ { nullptr };
+
 /// Constructor for Processor
 Processor::Processor() :
   engine_ (*processor_ctor_registry_context->engine)
@@ -389,6 +401,15 @@ Processor::Processor() :
 Processor::~Processor ()
 {
   remove_all_buses();
+  delete pevents_;
+  // the shared memory arena is owned by the BSE thread, and this may run in the render thread
+  ParamFeedback *feedback = pfeedback_.exchange (nullptr);
+  if (feedback)
+    {
+      feedback->trash_next = pfeedback_trash_.load();
+      while (!pfeedback_trash_.compare_exchange_weak (feedback->trash_next, feedback))
+        ;
+    }
 }
 
 /// Create the `Bse::ProcessorIface` for `this`.
@@ -487,6 +508,7 @@ Processor::assign_iobufs ()
     }
   else
     fbuffers_ = nullptr;
+  bypassed_ = false;
 }
 
 static __thread CString tls_param_group;
@@ -687,14 +709,10 @@ Processor::find_pparam_ (ParamId paramid) const
   return nullptr;
 }
 
-/// Set parameter `id` to `value`.
-void
-Processor::set_param (Id32 paramid, const double value)
+// Clamp `v` into the parameter range and round to its stepping.
+static double
+constrain_param_value (const ParamInfo *info, double v)
 {
-  const PParam *pparam = find_pparam (ParamId (paramid.id));
-  return_unless (pparam);
-  const ParamInfo *info = pparam->info.get();
-  double v = value;
   if (info)
     {
       const auto mm = info->get_minmax();
@@ -710,9 +728,110 @@ Processor::set_param (Id32 paramid, const double value)
           v = CLAMP (mm.first + v, mm.first, mm.second);
         }
     }
+  return v;
+}
+
+/// Set parameter `id` to `value`.
+void
+Processor::set_param (Id32 paramid, const double value)
+{
+  const PParam *pparam = find_pparam (ParamId (paramid.id));
+  return_unless (pparam);
+  const double v = constrain_param_value (pparam->info.get(), value);
   const_cast<PParam*> (pparam)->assign (v);
 }
 
+/** Schedule a sample accurate change of parameter `paramid` to `value`.
+ * The change starts at the engine frame `frame_stamp` (see Engine::frame_counter())
+ * and reaches `value` after `n_frames` along `shape`. Stamps in the past take effect
+ * with the next render block. Processors retrieve per-frame values with render_param(),
+ * otherwise the automation is applied per block and seen via get_param().
+ * Changes are passed through a preallocated lock-free queue that the render thread
+ * drains at the start of each block, `false` is returned if the queue is full.
+ * This function is MT-Safe after proper Processor initialization.
+ */
+bool
+Processor::schedule_param_mt (Id32 paramid, double value, uint64 frame_stamp, uint n_frames, RampShape shape)
+{
+  assert_return (is_initialized() && pevents_, false);
+  const PParam *pparam = find_pparam (ParamId (paramid.id));
+  return_unless (pparam, false);
+  const ParamInfo *info = pparam->info.get();
+  if (info && info->get_stepping() > 0)
+    shape = RampShape::STEP;    // no intermediate values for choices and toggles
+  const Event ev = make_param_value (uint (pparam->id), constrain_param_value (info, value), n_frames, shape);
+  return_unless (pevents_->push_mt ({ frame_stamp, ev }), false);
+  flags_.fetch_or (PARAMEVENTS);
+  return true;
+}
+
+/** Fill `values` with the per-frame values of parameter `paramid` for the current render block.
+ * This applies changes queued with schedule_param_mt() at their exact frames and renders
+ * ramps with vectorizable loops, so consumers need no per-sample branching.
+ * Returns `true` if all `n_frames` values are equal, which allows a scalar code path.
+ */
+bool
+Processor::render_param (Id32 paramid, float *values, uint n_frames)
+{
+  PParam *pparam = const_cast<PParam*> (find_pparam (ParamId (paramid.id)));
+  assert_return (pparam && n_frames <= MAX_RENDER_BLOCK_SIZE, false);
+  ParamRamp &ramp = pparam->ramp;
+  if (!ramp.active() || pparam->peek() != ramp.value)
+    ramp.jump (pparam->peek());         // set_param() overrides automation
+  pparam->clear_dirty();
+  uint done = 0;
+  if (BSE_UNLIKELY (pevents_))
+    for (const Event &ev : pevents_->block)
+      if (ev.param == paramid.id)
+        {
+          const uint frame = std::min (uint (ev.frame), n_frames);
+          ramp.fill (values + done, frame - done);
+          done = frame;
+          ramp.start (ev.pvalue, ev.nframes, ev.ramp);
+        }
+  const bool isconst = done == 0 && !ramp.active();
+  ramp.fill (values + done, n_frames - done);
+  pparam->store (ramp.value);
+  pparam->mark_rendered();
+  return isconst;
+}
+
+// Apply automation at block granularity for parameters not consumed via render_param().
+// Returns if any ramp is still active.
+bool
+Processor::advance_params (uint n_frames)
+{
+  const ParamEvents &pevents = *pevents_;
+  bool active = false;
+  for (PParam &p : params_)
+    {
+      ParamRamp &ramp = p.ramp;
+      if (p.was_rendered())
+        p.clear_rendered();
+      else
+        {
+          bool changed = ramp.active();
+          if (!ramp.active() || p.peek() != ramp.value)
+            ramp.jump (p.peek());
+          uint done = 0;
+          for (const Event &ev : pevents.block)
+            if (ev.param == uint (p.id))
+              {
+                const uint frame = std::min (uint (ev.frame), n_frames);
+                ramp.skip (frame - done);
+                done = frame;
+                ramp.start (ev.pvalue, ev.nframes, ev.ramp);
+                changed = true;
+              }
+          ramp.skip (n_frames - done);
+          if (changed)
+            p.assign (ramp.value);      // marks dirty for get_param()
+        }
+      active |= ramp.active();
+    }
+  return active;
+}
+
 /// Retrieve supplemental information for parameters, usually to enhance the user interface.
 ParamInfoP
 Processor::param_info (Id32 paramid) const
@@ -754,6 +873,83 @@ Processor::param_notifies_mt (ProcessorP proc, Id32 paramid, bool need_notifies)
     const_cast<PParam*> (param)->must_notify_mt (need_notifies);
 }
 
+/** Send a normalized parameter value to a Processor from any thread.
+ * The value is stored in a lock-free slot per parameter and applied via set_normalized()
+ * at the start of the next render block, only the last value sent per block takes effect.
+ * This function is MT-Safe after proper Processor initialization.
+ */
+void
+Processor::param_send_normalized_mt (ProcessorP proc, Id32 paramid, double normalized)
+{
+  assert_return (proc);
+  assert_return (proc->is_initialized());
+  const PParam *param = proc->find_pparam (ParamId (paramid.id));
+  return_unless (param);
+  if (!BSE_ISLIKELY (normalized >= 0.0))
+    normalized = 0;
+  else if (!BSE_ISLIKELY (normalized <= 1.0))
+    normalized = 1.0;
+  const_cast<PParam*> (param)->send_mt (normalized);
+  proc->flags_.fetch_or (PARAMINPUT);
+}
+
+/// Send a normalized parameter value to the parameter published at `shmoffset`, see param_shm_offset_e().
+/// This function is MT-Safe, it is intended for IPC threads that need to bypass the BSE thread.
+bool
+Processor::param_send_shm_mt (int64 shmoffset, double normalized)
+{
+  ProcessorP proc;
+  size_t index;
+  {
+    std::lock_guard<std::mutex> locker (param_feedback_mutex);
+    auto it = param_feedback_procs.upper_bound (shmoffset);
+    return_unless (it != param_feedback_procs.begin(), false);
+    --it;
+    proc = it->second.lock();
+    return_unless (proc && (shmoffset - it->first) % sizeof (float) == 0, false);
+    index = (shmoffset - it->first) / sizeof (float);
+  }
+  return_unless (index < proc->params_.size(), false);
+  param_send_normalized_mt (proc, proc->params_[index].id, normalized);
+  return true;
+}
+
+/** Retrieve the shared memory offset of a normalized `float` value that tracks parameter `paramid`.
+ * The first call allocates the shared memory for all parameters of `proc`, afterwards
+ * the render thread updates the values at the end of every render block that changed them.
+ * Returns -1 for unknown parameters.
+ */
+int64
+Processor::param_shm_offset_e (ProcessorP proc, Id32 paramid)
+{
+  assert_return (this_thread_is_bse(), -1);
+  assert_return (proc, -1);
+  assert_return (proc->is_initialized(), -1);
+  const PParam *param = proc->find_pparam (ParamId (paramid.id));
+  return_unless (param, -1);
+  ParamFeedback *feedback = proc->pfeedback_.load();
+  if (!feedback)
+    {
+      const size_t n_params = proc->params_.size();
+      feedback = new ParamFeedback();
+      feedback->block = BSE_SERVER.allocate_shared_block (n_params * sizeof (float));
+      feedback->values.resize (n_params);
+      float *shmvalues = (float*) feedback->block.mem_start;
+      for (size_t i = 0; i < n_params; i++)
+        {
+          const PParam &p = proc->params_[i];
+          feedback->values[i] = p.peek();
+          shmvalues[i] = proc->value_to_normalized (p.id, feedback->values[i]);
+        }
+      {
+        std::lock_guard<std::mutex> locker (param_feedback_mutex);
+        param_feedback_procs[feedback->block.mem_offset] = proc;
+      }
+      proc->pfeedback_.store (feedback, std::memory_order_release);
+    }
+  return feedback->block.mem_offset + (param - proc->params_.data()) * sizeof (float);
+}
+
 double
 Processor::value_to_normalized (Id32 paramid, double value) const
 {
@@ -1200,6 +1396,8 @@ Processor::ensure_initialized()
       tls_param_group = "";
       initialize();
       tls_param_group = "";
+      if (!params_.empty())
+        pevents_ = new ParamEvents();   // preallocated, so automation never allocates
       flags_ |= INITIALIZED;
       const SpeakerArrangement ibuses = SpeakerArrangement::STEREO;
       const SpeakerArrangement obuses = SpeakerArrangement::STEREO;
@@ -1230,6 +1428,18 @@ void
 Processor::reset()
 {}
 
+/** Declare the number of frames the outputs may keep sounding after all inputs became silent.
+ * Once inputs and outputs have been silent for `n_frames`, and no parameter changes or
+ * events are pending, the engine skips render() and provides silent output buffers instead.
+ * This should only be used by processors whose output is solely derived from their inputs,
+ * the default of `~0` disables skipping.
+ */
+void
+Processor::set_tail_frames (uint64 n_frames)
+{
+  tail_frames_ = n_frames;
+}
+
 /// Enqueue all rendering dependencies in the engine schedule.
 void
 Processor::enqueue_deps()
@@ -1258,15 +1468,163 @@ void
 Processor::render (uint32 n_frames)
 {}
 
-void
+// Render a block, returns `false` if render() was skipped due to silence.
+bool
 Processor::render_block ()
 {
   const uint64_t engine_frame_counter = engine_.frame_counter();
-  return_unless (done_frames_ < engine_frame_counter);
+  return_unless (done_frames_ < engine_frame_counter, true);
   if (BSE_UNLIKELY (estreams_) && !BSE_ISLIKELY (estreams_->estream.empty()))
     estreams_->estream.clear();
-  render (MAX_RENDER_BLOCK_SIZE);
+  if (BSE_UNLIKELY (flags_ & PARAMINPUT))
+    apply_param_input();
+  const bool param_events = BSE_UNLIKELY (flags_ & PARAMEVENTS);
+  if (param_events)
+    fetch_param_events (engine_frame_counter);
+  const bool bypass = tail_frames_ != ~uint64_t (0) && can_bypass (engine_frame_counter);
+  if (BSE_UNLIKELY (bypass != bypassed_))
+    bypass_oblocks (bypass);
+  if (BSE_ISLIKELY (!bypass))
+    {
+      render (MAX_RENDER_BLOCK_SIZE);
+      update_silence (engine_frame_counter);
+    }
+  if (param_events)
+    {
+      const bool active = advance_params (MAX_RENDER_BLOCK_SIZE);
+      pevents_->block.clear();
+      if (active || !pevents_->pending.empty())
+        flags_ |= PARAMEVENTS;  // keep automating in the next block
+    }
+  ParamFeedback *feedback = pfeedback_.load (std::memory_order_acquire);
+  if (BSE_UNLIKELY (feedback))
+    publish_params (*feedback);
   done_frames_ = engine_frame_counter;
+  return !bypass;
+}
+
+// Move queued parameter changes into `pending` and those due in this block into a frame relative EventStream.
+void
+Processor::fetch_param_events (uint64_t frame)
+{
+  ParamEvents &pevents = *pevents_;
+  flags_ &= ~uint32 (PARAMEVENTS);     // producers set it again after queueing
+  for (PParam &p : params_)
+    p.clear_rendered();                 // left over from blocks without automation
+  auto &pending = pevents.pending;
+  auto later = [] (uint64 stamp, const ParamEvents::Stamped &s) { return stamp < s.stamp; };
+  ParamEvents::Stamped stamped;
+  while (pending.size() < pending.capacity() && pevents.pop (stamped))
+    pending.insert (std::upper_bound (pending.begin(), pending.end(), stamped.stamp, later), stamped);
+  size_t i = 0;
+  for (; i < pending.size() && pending[i].stamp < frame + MAX_RENDER_BLOCK_SIZE; i++)
+    {
+      const int64 bframe = std::max (int64 (pending[i].stamp) - int64 (frame), int64 (0));
+      pevents.block.append (bframe, pending[i].event);
+    }
+  pending.erase (pending.begin(), pending.begin() + i);
+  if (pending.size() == pending.capacity())
+    flags_ |= PARAMEVENTS;              // fetch the remaining queue with the next block
+}
+
+// Output levels below 24 bit resolution are considered silent.
+static constexpr float SILENCE_LEVEL = 1.0 / 16777216;
+
+// Track the frame since which each output channel has been silent.
+void
+Processor::update_silence (uint64_t frame)
+{
+  for (OBusId ob = OBusId (1); size_t (ob) <= n_obuses(); ob = OBusId (size_t (ob) + 1))
+    {
+      const OBus &bus = iobus (ob);
+      for (size_t i = 0; i < bus.fbuffer_count; i++)
+        {
+          FloatBuffer &fbuffer = fbuffers_[bus.fbuffer_index + i];
+          if (floatmaxabs (fbuffer.buffer, MAX_RENDER_BLOCK_SIZE) > SILENCE_LEVEL)
+            fbuffer.silent_since_ = FloatBuffer::NOT_SILENT;
+          else if (fbuffer.silent_since_ == FloatBuffer::NOT_SILENT)
+            fbuffer.silent_since_ = frame;
+        }
+    }
+}
+
+/* Check if render() can be skipped for the block starting at `frame`.
+ * That is the case if all inputs have been silent and all outputs have been silent
+ * for at least the declared tail length, and no parameter changes or events are pending.
+ */
+bool
+Processor::can_bypass (uint64_t frame) const
+{
+  if (BSE_UNLIKELY (pevents_) && !pevents_->block.empty())
+    return false;
+  if (BSE_UNLIKELY (estreams_) && estreams_->oproc && estreams_->oproc->estreams_ &&
+      !estreams_->oproc->estreams_->estream.empty())
+    return false;
+  for (OBusId ob = OBusId (1); size_t (ob) <= n_obuses(); ob = OBusId (size_t (ob) + 1))
+    {
+      const OBus &bus = iobus (ob);
+      for (size_t i = 0; i < bus.fbuffer_count; i++)
+        if (!fbuffers_[bus.fbuffer_index + i].silent_for (frame, tail_frames_))
+          return false;
+    }
+  for (IBusId ib = IBusId (1); size_t (ib) <= n_ibuses(); ib = IBusId (size_t (ib) + 1))
+    {
+      const IBus &bus = iobus (ib);
+      for (size_t i = 0; i < bus.n_channels(); i++)
+        if (!float_buffer (ib, i).silent_for (frame, tail_frames_))
+          return false;
+    }
+  for (const PParam &p : params_)
+    if (p.is_dirty())
+      return false;             // render() needs to pick up parameter changes
+  return true;
+}
+
+// Redirect outputs to zeros while render() is skipped, restore the output blocks afterwards.
+void
+Processor::bypass_oblocks (bool bypass)
+{
+  const float *const zeros = &zero_buffer().fblock[0];
+  for (OBusId ob = OBusId (1); size_t (ob) <= n_obuses(); ob = OBusId (size_t (ob) + 1))
+    {
+      const OBus &bus = iobus (ob);
+      for (size_t i = 0; i < bus.fbuffer_count; i++)
+        {
+          FloatBuffer &fbuffer = fbuffers_[bus.fbuffer_index + i];
+          fbuffer.buffer = bypass ? const_cast<float*> (zeros) : &fbuffer.fblock[0];
+        }
+    }
+  bypassed_ = bypass;
+}
+
+// Apply parameter values sent via param_send_normalized_mt().
+void
+Processor::apply_param_input ()
+{
+  // clear the flag before the slots are taken, so values sent concurrently are seen next block
+  flags_.fetch_and (~uint32 (PARAMINPUT));
+  for (PParam &p : params_)
+    {
+      const double normalized = p.fetch_input();
+      if (!std::isnan (normalized))
+        set_normalized (p.id, normalized);
+    }
+}
+
+// Write changed parameter values into shared memory.
+void
+Processor::publish_params (ParamFeedback &feedback)
+{
+  float *shmvalues = (float*) feedback.block.mem_start;
+  for (size_t i = 0; i < params_.size(); i++)
+    {
+      const double value = params_[i].peek();
+      if (BSE_UNLIKELY (value != feedback.values[i]))
+        {
+          feedback.values[i] = value;
+          shmvalues[i] = value_to_normalized (params_[i].id, value);
+        }
+    }
 }
 
 /// Invoke Processor::configure() with `ipatch`/`opatch` applied to the current configuration.
@@ -1342,6 +1700,17 @@ void
 Processor::call_notifies_e ()
 {
   assert_return (this_thread_is_bse());
+  ParamFeedback *feedback = pfeedback_trash_.exchange (nullptr);
+  while (feedback)
+    {
+      ParamFeedback *current = std::exchange (feedback, feedback->trash_next);
+      {
+        std::lock_guard<std::mutex> locker (param_feedback_mutex);
+        param_feedback_procs.erase (current->block.mem_offset);
+      }
+      BSE_SERVER.release_shared_block (current->block);
+      delete current;
+    }
   Processor *head = notifies_head.exchange (notifies_tail);
   while (head != notifies_tail)
     {
@@ -1363,7 +1732,7 @@ Processor::call_notifies_e ()
           if (nflags & REMOVAL)
             bprocp->emit_event ("sub:remove");
           if (nflags & PARAMCHANGE)
-            bprocp->emit_event ("notify:paramchange"); // FIXME
+            bprocp->notify ("paramchange"); // FIXME
         }
     }
 }
@@ -1371,7 +1740,7 @@ Processor::call_notifies_e ()
 bool
 Processor::has_notifies_e ()
 {
-  return notifies_head != notifies_tail;
+  return notifies_head != notifies_tail || pfeedback_trash_ != nullptr;
 }
 
 // == RegistryEntry ==
@@ -1527,10 +1896,91 @@ Processor::PParam::operator= (const PParam &src)
   id = src.id;
   flags_ = src.flags_.load();
   value_ = src.value_.load();
+  input_ = src.input_.load();
   info = src.info;
   return *this;
 }
 
+// == Processor::ParamEvents ==
+Processor::ParamEvents::ParamEvents ()
+{
+  for (uint i = 0; i < QUEUE_SIZE; i++)
+    queue_[i].seq.store (i, std::memory_order_relaxed);
+  pending.reserve (2 * QUEUE_SIZE);
+  block.reserve (2 * QUEUE_SIZE);
+}
+
+// Enqueue `stamped` without locks or allocations, fails if the queue is full.
+bool
+Processor::ParamEvents::push_mt (const Stamped &stamped)
+{
+  uint64 pos = tail_.load (std::memory_order_relaxed);
+  for (;;)
+    {
+      Slot &slot = queue_[pos & (QUEUE_SIZE - 1)];
+      const int64 delta = int64 (slot.seq.load (std::memory_order_acquire)) - int64 (pos);
+      if (delta < 0)
+        return false;                   // slot still holds an unconsumed event
+      if (delta > 0)
+        pos = tail_.load (std::memory_order_relaxed);
+      else if (tail_.compare_exchange_weak (pos, pos + 1, std::memory_order_relaxed))
+        {
+          slot.stamped = stamped;
+          slot.seq.store (pos + 1, std::memory_order_release);
+          return true;
+        }
+    }
+}
+
+// Dequeue the oldest event, must only be called from the render thread.
+bool
+Processor::ParamEvents::pop (Stamped &stamped)
+{
+  Slot &slot = queue_[head_ & (QUEUE_SIZE - 1)];
+  return_unless (slot.seq.load (std::memory_order_acquire) == head_ + 1, false);
+  stamped = slot.stamped;
+  slot.seq.store (head_ + QUEUE_SIZE, std::memory_order_release);
+  head_ += 1;
+  return true;
+}
+
+// == ParamRamp ==
+/// Start a ramp from the current value towards `v`, reached after `n_frames`.
+/// Exponential ramps fall back to linear ramps if the values differ in sign or touch 0.
+void
+ParamRamp::start (double v, uint n_frames, RampShape rshape)
+{
+  if (n_frames == 0 || rshape == RampShape::STEP || v == value)
+    return jump (v);
+  target = v;
+  remaining = n_frames;
+  if (rshape == RampShape::EXPONENTIAL && value * target > 0)
+    {
+      shape = RampShape::EXPONENTIAL;
+      step = std::pow (target / value, 1.0 / n_frames);
+    }
+  else
+    {
+      shape = RampShape::LINEAR;
+      step = (target - value) / n_frames;
+    }
+}
+
+/// Advance the ramp by `n_frames` without rendering values.
+void
+ParamRamp::skip (uint n_frames)
+{
+  const uint k = std::min (n_frames, remaining);
+  return_unless (k > 0);
+  if (shape == RampShape::EXPONENTIAL)
+    value *= std::pow (step, double (k));
+  else
+    value += step * k;
+  remaining -= k;
+  if (!remaining)
+    value = target;
+}
+
 // == FloatBuffer ==
 /// Check for end-of-buffer overwrites
 void
@@ -1588,12 +2038,7 @@ public:
   bool
   set_normalized (double v) override
   {
-    AudioSignal::ProcessorP proc = proc_;
-    const AudioSignal::ParamId pid = info_->id;
-    auto lambda = [proc, pid, v] () {
-      proc->set_normalized (pid, v);
-    };
-    BSE_SERVER.commit_job (lambda);
+    AudioSignal::Processor::param_send_normalized_mt (proc_, info_->id, v);
     return true;
   }
   std::string
@@ -1607,14 +2052,14 @@ public:
   {
     const double value = proc_->param_value_from_text (info_->id, v);
     const double normalized = proc_->value_to_normalized (info_->id, value);
-    AudioSignal::ProcessorP proc = proc_;
-    const AudioSignal::ParamId pid = info_->id;
-    auto lambda = [proc, pid, normalized] () {
-      proc->set_normalized (pid, normalized);
-    };
-    BSE_SERVER.commit_job (lambda);
+    AudioSignal::Processor::param_send_normalized_mt (proc_, info_->id, normalized);
     return true;
   }
+  int64
+  get_shm_offset () override
+  {
+    return AudioSignal::Processor::param_shm_offset_e (proc_, info_->id);
+  }
   bool
   is_numeric () override
   {
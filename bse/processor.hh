@@ -176,13 +176,29 @@ struct BusInfo {
   uint               n_channels () const;
 };
 
+/// Linear or exponential parameter ramp, rendered in blocks without per-sample branching.
+struct ParamRamp {
+  double    value = 0;                  ///< Current value, i.e. the last value rendered.
+  double    target = 0;                 ///< Value reached after `remaining` frames.
+  double    step = 0;                   ///< Per frame increment (LINEAR) or factor (EXPONENTIAL).
+  uint      remaining = 0;              ///< Number of frames left until `target` is reached.
+  RampShape shape = RampShape::STEP;
+  bool      active () const             { return remaining > 0; }
+  void      jump   (double v)           { value = v; target = v; remaining = 0; shape = RampShape::STEP; }
+  void      start  (double v, uint n_frames, RampShape rshape);
+  void      skip   (uint n_frames);
+  void      fill   (float *dst, uint n_frames);
+};
+
 /// Audio signal Processor base class, implemented by all effects and instruments.
 class Processor : public std::enable_shared_from_this<Processor>, public FastMemory::NewDeleteBase {
   struct IBus;
   struct OBus;
   struct EventStreams;
+  struct ParamEvents;
   union  PBus;
   struct PParam;
+  struct ParamFeedback;
   class FloatBuffer;
   friend class ProcessorManager;
   friend class Engine;
@@ -206,6 +222,8 @@ protected:
   using MinMax = std::pair<double,double>;
 #endif
   enum { INITIALIZED   = 1 << 0,
+         PARAMINPUT    = 1 << 1,
+         PARAMEVENTS   = 1 << 2,
          PARAMCHANGE   = 1 << 3,
          BUSCONNECT    = 1 << 4,
          BUSDISCONNECT = 1 << 5,
@@ -219,7 +237,10 @@ private:
   std::vector<PParam>      params_;
   std::vector<OConnection> outputs_;
   EventStreams            *estreams_ = nullptr;
+  ParamEvents             *pevents_ = nullptr;
   uint64_t                 done_frames_ = 0;
+  uint64_t                 tail_frames_ = ~uint64_t (0);
+  bool                     bypassed_ = false;
   static void        registry_init      ();
   const PParam*      find_pparam        (Id32 paramid) const;
   const PParam*      find_pparam_       (ParamId paramid) const;
@@ -231,7 +252,14 @@ private:
   FloatBuffer&       float_buffer       (OBusId busid, uint channelindex, bool resetptr = false);
   static
   const FloatBuffer& zero_buffer        ();
-  void               render_block       ();
+  bool               render_block       ();
+  bool               can_bypass         (uint64_t frame) const;
+  void               bypass_oblocks     (bool bypass);
+  void               update_silence     (uint64_t frame);
+  void               fetch_param_events (uint64_t frame);
+  bool               advance_params     (uint n_frames);
+  void               apply_param_input  ();
+  void               publish_params     (ParamFeedback &feedback);
   void               reset_state        ();
   void               enqueue_deps       ();
   /*copy*/           Processor          (const Processor&) = delete;
@@ -245,6 +273,7 @@ protected:
   virtual void  configure         (uint n_ibuses, const SpeakerArrangement *ibuses,
                                    uint n_obuses, const SpeakerArrangement *obuses) = 0;
   void          enqueue_notify_mt (uint32 pushmask);
+  void          set_tail_frames   (uint64 n_frames);
   virtual ProcessorImplP processor_interface () const;
   // Parameters
   virtual void  adjust_param      (Id32 tag) {}
@@ -273,6 +302,7 @@ protected:
                                    bool boolvalue, std::string hints = "",
                                    const std::string &blurb = "", const std::string &description = "");
   double        peek_param_mt     (Id32 paramid) const;
+  bool          render_param      (Id32 paramid, float *values, uint n_frames);
   // Buses
   IBusId        add_input_bus     (CString uilabel, SpeakerArrangement speakerarrangement,
                                    const std::string &hints = "", const std::string &blurb = "");
@@ -310,6 +340,8 @@ public:
   // Parameters
   double              get_param             (Id32 paramid);
   void                set_param             (Id32 paramid, double value);
+  bool                schedule_param_mt     (Id32 paramid, double value, uint64 frame_stamp, uint n_frames = 0,
+                                             RampShape shape = RampShape::LINEAR);
   ParamInfoP          param_info            (Id32 paramid) const;
   MaybeParamId        find_param            (const std::string &identifier) const;
   ParamInfoPVec       list_params           () const;
@@ -351,12 +383,17 @@ public:
   // MT-Safe accessors
   static double param_peek_mt     (const ProcessorP proc, Id32 paramid);
   static void   param_notifies_mt (ProcessorP proc, Id32 paramid, bool need_notifies);
+  static void   param_send_normalized_mt (ProcessorP proc, Id32 paramid, double normalized);
+  static bool   param_send_shm_mt        (int64 shmoffset, double normalized);
+  static int64  param_shm_offset_e       (ProcessorP proc, Id32 paramid);
 private:
   static bool   has_notifies_e    ();
   static void   call_notifies_e   ();
   std::atomic<Processor*> nqueue_next_ { nullptr }; ///< No notifications queued while == nullptr
   ProcessorP              nqueue_guard_;            ///< Only used while nqueue_next_ != nullptr
   std::weak_ptr<Bse::ProcessorImpl> bproc_;
+  std::atomic<ParamFeedback*> pfeedback_ { nullptr }; ///< Shared memory parameter values, see param_shm_offset_e()
+  static std::atomic<ParamFeedback*> pfeedback_trash_; ///< Released by call_notifies_e() after the Processor is gone
   static constexpr uint32 NOTIFYMASK = PARAMCHANGE | BUSCONNECT | BUSDISCONNECT | INSERTION | REMOVAL;
   static __thread uint64  tls_timestamp;
 };
@@ -374,6 +411,8 @@ class Engine {
   const uint         sample_rate_; ///< Sample rate (mixing frequency) in Hz used for Processor::render().
   uint64_t           frame_counter_;
   std::atomic<uint32> eflags_;
+  std::atomic<uint64> rendered_blocks_ { 0 };
+  std::atomic<uint64> bypassed_blocks_ { 0 };
   enum { RESCHEDULE = 1 << 0, WOKEN = 1 << 1, };
   uint               scheduler_depth_;
   std::vector<Processor*> schedule_;
@@ -387,6 +426,8 @@ public:
   double        nyquist          () const BSE_CONST      { return nyquist_; }
   double        inyquist         () const BSE_CONST      { return inyquist_; }
   uint64_t      frame_counter    () const                { return frame_counter_; }
+  uint64        rendered_blocks  () const                { return rendered_blocks_; } ///< Number of Processor::render() calls, MT-Safe.
+  uint64        bypassed_blocks  () const                { return bypassed_blocks_; } ///< Number of render() calls skipped due to silence, MT-Safe.
   void          add_root         (ProcessorP rootproc);
   bool          del_root         (ProcessorP rootproc);
   bool          in_schedule      (Processor &proc);
@@ -408,10 +449,14 @@ class Processor::FloatBuffer {
   alignas (64) float fblock[MAX_RENDER_BLOCK_SIZE] = { 0, };
   const uint64       canary0_ = const_canary;
   const uint64       canary1_ = const_canary;
-  struct { uint64 d1, d2, d3, d4; }; // dummy mem
+  /// First frame from which on the buffer contents are silent, NOT_SILENT otherwise.
+  uint64             silent_since_ = 0;
+  struct { uint64 d2, d3, d4; }; // dummy mem
   SpeakerArrangement speaker_arrangement_ = SpeakerArrangement::NONE;
   SpeakerArrangement speaker_arrangement () const;
+  bool               silent_for  (uint64 frame, uint64 n_frames) const;
   static constexpr uint64 const_canary = 0xE14D8A302B97C56F;
+  static constexpr uint64 NOT_SILENT = ~uint64 (0);
   friend class Processor;
   /// Pointer to the IO samples, this can be redirected or point to #fblock.
   float             *buffer = &fblock[0];
@@ -461,6 +506,28 @@ struct Processor::EventStreams {
   bool        has_event_output = false;
 };
 
+// Processor internal parameter automation book keeping
+struct Processor::ParamEvents {
+  struct Stamped {
+    uint64 stamp = 0;
+    Event  event;
+  };
+  static constexpr uint QUEUE_SIZE = 256; // power of 2, producers fail once it is full
+  explicit ParamEvents ();
+  bool     push_mt     (const Stamped &stamped);
+  bool     pop         (Stamped &stamped);
+  std::vector<Stamped> pending; // sorted by stamp, FIFO for equal stamps, capacity is preallocated
+  EventStream          block;   // PARAM_VALUE events of the current render block
+private:
+  struct Slot {
+    std::atomic<uint64> seq;
+    Stamped             stamped;
+  };
+  Slot                 queue_[QUEUE_SIZE];  // bounded MPSC queue, drained by the render thread
+  std::atomic<uint64>  tail_ = 0;
+  uint64               head_ = 0;
+};
+
 // Processor internal parameter book keeping
 struct Processor::PParam {
   explicit PParam          (ParamId id);
@@ -477,6 +544,12 @@ struct Processor::PParam {
   void     clear_updated   ()       { flags_ &= ~uint32 (2); }
   void     must_notify_mt  (bool n) { if (n) flags_ |= 4; else flags_ &= ~uint32 (4); }
   bool     must_notify     () const { return flags_ & 4; }
+  bool     was_rendered    () const { return flags_ & 8; }
+  void     mark_rendered   ()       { flags_ |= 8; }
+  void     clear_rendered  ()       { flags_ &= ~uint32 (8); }
+  void     store           (double f) { value_ = f; }
+  void     send_mt         (double n) { input_ = n; }
+  double   fetch_input     ()         { return input_.exchange (FP_NAN); }
   void
   assign (double f)
   {
@@ -495,8 +568,10 @@ public:
 private:
   std::atomic<uint32> flags_ = 1;
   std::atomic<double> value_ = FP_NAN;
+  std::atomic<double> input_ = FP_NAN; // normalized value from param_send_normalized_mt(), NAN if empty
 public:
   ParamInfoP          info;
+  ParamRamp           ramp;     ///< Automation state, only used by the render thread.
 };
 
 /// Number of channels described by `speakers`.
@@ -612,6 +687,48 @@ Processor::find_pparam (Id32 paramid) const
   return find_pparam_ (ParamId (paramid.id));
 }
 
+/// Render `n_frames` values of the ramp into `dst`, holding `target` once it is reached.
+inline void
+ParamRamp::fill (float *dst, uint n_frames)
+{
+  const uint k = std::min (n_frames, remaining);
+  if (k)
+    {
+      const double v0 = value;
+      if (shape == RampShape::EXPONENTIAL)
+        {
+          // 4 interleaved geometric series avoid a loop carried dependency per sample
+          float lane[4];
+          lane[0] = v0 * step;
+          for (uint j = 1; j < 4; j++)
+            lane[j] = lane[j - 1] * step;
+          const float f4 = step * step * step * step;
+          uint i = 0;
+          for (; i + 4 <= k; i += 4)
+            for (uint j = 0; j < 4; j++)
+              {
+                dst[i + j] = lane[j];
+                lane[j] *= f4;
+              }
+          for (uint j = 0; i < k; i++, j++)
+            dst[i] = lane[j];
+          value = v0 * std::pow (step, double (k));
+        }
+      else // RampShape::LINEAR
+        {
+          const float fv = v0, fs = step;
+          for (uint i = 0; i < k; i++)
+            dst[i] = fv + fs * float (i + 1);
+          value = v0 + step * k;
+        }
+      remaining -= k;
+      if (!remaining)
+        value = target;
+      dst[k - 1] = value; // keep segment ends exact
+    }
+  floatfill (dst + k, value, n_frames - k);
+}
+
 /// Fetch `value` of parameter `id` and clear its `dirty` flag.
 inline double
 Processor::get_param (Id32 paramid)
@@ -681,6 +798,13 @@ Processor::FloatBuffer::speaker_arrangement () const
   return speaker_arrangement_;
 }
 
+/// Check if the buffer has been silent for at least `n_frames` before `frame`.
+inline bool
+Processor::FloatBuffer::silent_for (uint64 frame, uint64 n_frames) const
+{
+  return silent_since_ != NOT_SILENT && silent_since_ <= frame && frame - silent_since_ >= n_frames;
+}
+
 } // AudioSignal
 
 template<typename Class> extern inline AudioSignal::RegistryId
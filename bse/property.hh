@@ -31,6 +31,7 @@ protected:
   virtual void        get_range        (double *min, double *max, double *step) = 0;
   virtual std::string get_text         () = 0;
   virtual bool        set_text         (const std::string &v) = 0;
+  virtual int64       get_shm_offset   ()                              { return -1; }
   friend class PropertyImpl;
 };
 using PropertyWrapperP = std::unique_ptr<PropertyWrapper>;
@@ -43,6 +44,7 @@ public:
   virtual bool         set_normalized (double v) override             { return wrapper_->set_normalized (v); }
   virtual std::string  get_text       () override                     { return wrapper_->get_text(); }
   virtual bool         set_text       (const std::string &v) override { return wrapper_->set_text (v); }
+  virtual int64        get_shm_offset () override                     { return wrapper_->get_shm_offset(); }
   virtual std::string  identifier     () override { return wrapper_->get_tag (PropertyWrapper::IDENTIFIER); }
   virtual std::string  label          () override { return wrapper_->get_tag (PropertyWrapper::LABEL); }
   virtual std::string  nick           () override { return wrapper_->get_tag (PropertyWrapper::NICK); }
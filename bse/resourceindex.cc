@@ -0,0 +1,547 @@
+// This Source Code Form is licensed MPL-2.0: http://mozilla.org/MPL/2.0
+#include "resourceindex.hh"
+#include "bseloader.hh"
+#include "gsldatahandle.hh"
+#include "randomhash.hh"
+#include "path.hh"
+#include "internal.hh"
+#include <filesystem>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <poll.h>
+namespace Fs = std::filesystem;
+
+#define RDEBUG(...)     Bse::debug ("resourceindex", __VA_ARGS__)
+
+namespace Bse {
+
+static constexpr uint32 INOTIFY_MASK = IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+static constexpr auto   SAVE_INTERVAL = std::chrono::seconds (5);
+static const char       cache_header[] = "# BEAST ResourceIndex 1\n";
+
+static bool
+stat_file (const String &path, int64 *mtime, int64 *size)
+{
+  struct stat st;
+  if (stat (path.c_str(), &st) != 0 || !S_ISREG (st.st_mode))
+    return false;
+  *mtime = st.st_mtim.tv_sec * int64 (1000000000) + st.st_mtim.tv_nsec;
+  *size = st.st_size;
+  return true;
+}
+
+// Strip characters that would break the line based cache format.
+static String
+sanitize (const String &string)
+{
+  String s = string;
+  for (char &c : s)
+    if (c == '\t' || c == '\n' || c == '\r')
+      c = ' ';
+  return s;
+}
+
+ResourceIndex::ResourceIndex (const String &rootdir, const ChangedF &changed) :
+  rootdir_ (rootdir.size() > 1 && rootdir.back() == '/' ? rootdir.substr (0, rootdir.size() - 1) : rootdir),
+  cachefile_ (Path::join (Path::cache_home(), "beast", string_format ("resourceindex-%016x.txt", fnv1a_consthash64 (rootdir_.c_str())))),
+  changed_ (changed)
+{
+  inotify_fd_ = inotify_init1 (IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0)
+    RDEBUG ("inotify_init1: %s", strerror (errno));
+  const size_t n_workers = CLAMP (size_t (this_thread_online_cpus()) / 2, size_t (1), size_t (4));
+  for (size_t i = 0; i < n_workers; i++)
+    workers_.push_back (std::thread (&ResourceIndex::worker_loop, this));
+  indexer_ = std::thread (&ResourceIndex::indexer_loop, this);
+}
+
+ResourceIndex::~ResourceIndex ()
+{
+  quit_ = true;
+  {
+    std::lock_guard<std::mutex> locker (mutex_);
+    jobs_cond_.notify_all();
+  }
+  indexer_.join();
+  for (auto &worker : workers_)
+    worker.join();
+  if (inotify_fd_ >= 0)
+    close (inotify_fd_);
+}
+
+/// Classify `filename` by extension, yields ResourceType::NONE for unindexed files.
+ResourceType
+ResourceIndex::match_type (const String &filename)
+{
+  const String lname = string_tolower (filename);
+  if (string_endswith (lname, ".wav"))
+    return ResourceType::WAVE;
+  if (string_endswith (lname, ".sf2"))
+    return ResourceType::SOUNDFONT;
+  return ResourceType::NONE;
+}
+
+// Read preset names from the `phdr` chunk of an SF2 file without loading samples.
+static StringVector
+sf2_preset_names (const String &filename)
+{
+  StringVector names;
+  FILE *file = fopen (filename.c_str(), "rb");
+  if (!file)
+    return names;
+  auto read_chunk = [file] (char tag[4], uint32 *size) {
+    uint8 b[8];
+    if (fread (b, 8, 1, file) != 1)
+      return false;
+    memcpy (tag, b, 4);
+    *size = b[4] | b[5] << 8 | b[6] << 16 | uint32 (b[7]) << 24;
+    return true;
+  };
+  char tag[4], form[4];
+  uint32 size = 0;
+  if (read_chunk (tag, &size) && memcmp (tag, "RIFF", 4) == 0 &&
+      fread (form, 4, 1, file) == 1 && memcmp (form, "sfbk", 4) == 0)
+    while (read_chunk (tag, &size))
+      {
+        if (memcmp (tag, "LIST", 4) != 0 || fread (form, 4, 1, file) != 1 || memcmp (form, "pdta", 4) != 0)
+          {
+            const long skip = memcmp (tag, "LIST", 4) == 0 ? long (size) - 4 : long (size);
+            if (fseek (file, skip + (size & 1), SEEK_CUR) != 0)
+              break;
+            continue;
+          }
+        const long pdta_end = ftell (file) + long (size) - 4;
+        while (ftell (file) < pdta_end && read_chunk (tag, &size))
+          {
+            if (memcmp (tag, "phdr", 4) == 0)
+              {
+                constexpr uint32 PHDR_SIZE = 38;        // char name[20], then bank, preset, indices
+                char record[PHDR_SIZE];
+                for (uint32 i = 0; i + PHDR_SIZE <= size && fread (record, PHDR_SIZE, 1, file) == 1; i += PHDR_SIZE)
+                  names.push_back (String (record, strnlen (record, 20)));
+                if (names.size())
+                  names.pop_back();                     // terminal "EOP" record
+                break;
+              }
+            if (fseek (file, long (size) + (size & 1), SEEK_CUR) != 0)
+              break;
+          }
+        break;
+      }
+  fclose (file);
+  return names;
+}
+
+/// Extract metadata `hints` for `filename` with the BSE loaders, this may block on disk I/O.
+String
+ResourceIndex::extract_hints (const String &filename, ResourceType type, String *blurb)
+{
+  String hints;
+  if (type == ResourceType::WAVE)
+    {
+      Error error = Error::NONE;
+      BseWaveFileInfo *finfo = bse_wave_file_info_load (filename.c_str(), &error);
+      BseWaveDsc *wdsc = finfo ? bse_wave_dsc_load (finfo, 0, false, &error) : NULL;
+      if (wdsc && wdsc->n_chunks)
+        {
+          int64 n_frames = 0;
+          GslDataHandle *dhandle = bse_wave_handle_create (wdsc, 0, &error);
+          if (dhandle && gsl_data_handle_open (dhandle) == Error::NONE)
+            {
+              n_frames = gsl_data_handle_n_values (dhandle) / std::max (1u, gsl_data_handle_n_channels (dhandle));
+              gsl_data_handle_close (dhandle);
+            }
+          if (dhandle)
+            gsl_data_handle_unref (dhandle);
+          hints = string_format ("channels=%u:rate=%u:frames=%d", wdsc->n_channels, uint (wdsc->chunks[0].mix_freq), n_frames);
+        }
+      if (wdsc)
+        bse_wave_dsc_free (wdsc);
+      if (finfo)
+        bse_wave_file_info_unref (finfo);
+      if (error != Error::NONE)
+        RDEBUG ("%s: %s", filename, bse_error_blurb (error));
+    }
+  else if (type == ResourceType::SOUNDFONT)
+    {
+      const StringVector names = sf2_preset_names (filename);
+      hints = string_format ("presets=%u", names.size());
+      if (blurb)
+        *blurb = sanitize (string_join (", ", names));
+    }
+  return hints;
+}
+
+void
+ResourceIndex::queue_job (const String &path)
+{
+  // mutex_ must be held
+  jobs_.push_back (path);
+  jobs_cond_.notify_one();
+}
+
+void
+ResourceIndex::update_file (const String &path)
+{
+  const ResourceType type = match_type (path);
+  if (type == ResourceType::NONE)
+    return;
+  int64 mtime = 0, size = 0;
+  const bool exists = stat_file (path, &mtime, &size);
+  std::lock_guard<std::mutex> locker (mutex_);
+  if (!exists)
+    {
+      if (files_.erase (path))
+        dirty_ = index_stale_ = true;
+      return;
+    }
+  auto inserted = files_.emplace (path, File());
+  index_stale_ |= inserted.second;
+  File &file = inserted.first->second;
+  if (file.type != type || file.mtime != mtime || file.size != size)
+    {
+      file = File();
+      file.type = type;
+      file.mtime = mtime;
+      file.size = size;
+      dirty_ = true;
+    }
+  if (!file.scanned)
+    queue_job (path);
+}
+
+void
+ResourceIndex::scan_directory (const String &dir, std::vector<String> *seen)
+{
+  if (inotify_fd_ >= 0)
+    {
+      const int wd = inotify_add_watch (inotify_fd_, dir.c_str(), INOTIFY_MASK);
+      if (wd >= 0)
+        {
+          std::lock_guard<std::mutex> locker (mutex_);
+          watches_[wd] = dir;
+        }
+      else
+        RDEBUG ("inotify_add_watch: %s: %s", dir, strerror (errno));
+    }
+  std::error_code ec;
+  for (Fs::directory_iterator it (dir, ec), end; !ec && it != end && !quit_; it.increment (ec))
+    {
+      const String path = it->path();
+      const String bname = Path::basename (path);
+      if (bname.size() && bname[0] == '.')
+        continue;
+      std::error_code tec;
+      if (it->is_directory (tec))
+        {
+          if (!it->is_symlink (tec))    // avoid cycles
+            scan_directory (path, seen);
+        }
+      else if (match_type (path) != ResourceType::NONE)
+        {
+          if (seen)
+            seen->push_back (path);
+          update_file (path);
+        }
+    }
+}
+
+void
+ResourceIndex::remove_prefix (const String &dirpath)
+{
+  const String prefix = dirpath + "/";
+  std::lock_guard<std::mutex> locker (mutex_);
+  for (auto it = files_.lower_bound (prefix); it != files_.end() && string_startswith (it->first, prefix);)
+    {
+      it = files_.erase (it);
+      dirty_ = index_stale_ = true;
+    }
+  for (auto it = watches_.begin(); it != watches_.end();)
+    if (it->second == dirpath || string_startswith (it->second, prefix))
+      {
+        inotify_rm_watch (inotify_fd_, it->first);
+        it = watches_.erase (it);
+      }
+    else
+      ++it;
+}
+
+// Apply pending inotify events, returns true if the event queue overflowed.
+bool
+ResourceIndex::process_inotify ()
+{
+  alignas (struct inotify_event) char buffer[16384];
+  bool overflow = false;
+  ssize_t len;
+  while ((len = read (inotify_fd_, buffer, sizeof (buffer))) > 0)
+    for (ssize_t offset = 0; offset < len;)
+      {
+        const struct inotify_event *ev = (const struct inotify_event*) (buffer + offset);
+        offset += sizeof (struct inotify_event) + ev->len;
+        if (ev->mask & IN_Q_OVERFLOW)
+          {
+            overflow = true;
+            continue;
+          }
+        String dir;
+        {
+          std::lock_guard<std::mutex> locker (mutex_);
+          auto it = watches_.find (ev->wd);
+          if (it == watches_.end())
+            continue;
+          dir = it->second;
+          if (ev->mask & IN_IGNORED)
+            watches_.erase (it);
+        }
+        if (!ev->len || ev->name[0] == '.')
+          continue;
+        const String path = Path::join (dir, ev->name);
+        if (ev->mask & IN_ISDIR)
+          {
+            if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+              remove_prefix (path);
+            if (ev->mask & (IN_CREATE | IN_MOVED_TO))
+              scan_directory (path, nullptr);
+          }
+        else if (ev->mask & (IN_DELETE | IN_MOVED_FROM))
+          {
+            std::lock_guard<std::mutex> locker (mutex_);
+            if (files_.erase (path))
+              dirty_ = index_stale_ = true;
+          }
+        else // IN_CREATE IN_CLOSE_WRITE IN_MOVED_TO
+          update_file (path);
+      }
+  return overflow;
+}
+
+void
+ResourceIndex::indexer_loop ()
+{
+  this_thread_set_name ("ResourceIndexer");
+  load_cache();
+  if (changed_ && count (ResourceType::NONE))
+    changed_();
+  bool rescan = true, needs_save = false;
+  auto last_save = std::chrono::steady_clock::now();
+  while (!quit_)
+    {
+      if (rescan)
+        {
+          rescan = false;
+          std::vector<String> seen;
+          scan_directory (rootdir_, &seen);
+          std::sort (seen.begin(), seen.end());
+          std::lock_guard<std::mutex> locker (mutex_);
+          for (auto it = files_.begin(); it != files_.end() && !quit_;)  // purge files removed since the last session
+            if (!std::binary_search (seen.begin(), seen.end(), it->first))
+              {
+                it = files_.erase (it);
+                dirty_ = index_stale_ = true;
+              }
+            else
+              ++it;
+        }
+      struct pollfd pfd = { inotify_fd_, POLLIN, 0 };
+      if (inotify_fd_ < 0)
+        usleep (250 * 1000);
+      else if (poll (&pfd, 1, 250) > 0)
+        rescan = process_inotify();
+      if (dirty_.exchange (false))
+        {
+          needs_save = true;
+          if (changed_)
+            changed_();
+        }
+      const auto now = std::chrono::steady_clock::now();
+      if (needs_save && now - last_save >= SAVE_INTERVAL)
+        {
+          save_cache();
+          needs_save = false;
+          last_save = now;
+        }
+    }
+  if (needs_save || dirty_)
+    save_cache();
+}
+
+void
+ResourceIndex::worker_loop ()
+{
+  this_thread_set_name ("ResourceWorker");
+  std::unique_lock<std::mutex> locker (mutex_);
+  while (!quit_)
+    {
+      if (jobs_.empty())
+        {
+          jobs_cond_.wait (locker);
+          continue;
+        }
+      const String path = jobs_.front();
+      jobs_.pop_front();
+      auto it = files_.find (path);
+      if (it == files_.end() || it->second.scanned)
+        continue;       // removed or duplicate job
+      const File probe = it->second;
+      locker.unlock();
+      String blurb;
+      const String hints = extract_hints (path, probe.type, &blurb);
+      int64 mtime = 0, size = 0;
+      const bool exists = stat_file (path, &mtime, &size);
+      locker.lock();
+      it = files_.find (path);
+      if (exists && it != files_.end() && it->second.mtime == mtime && it->second.size == size &&
+          probe.mtime == mtime && probe.size == size)
+        {
+          it->second.hints = hints;
+          it->second.blurb = blurb;
+          it->second.scanned = true;
+          dirty_ = true;
+        }
+    }
+}
+
+void
+ResourceIndex::load_cache ()
+{
+  const String data = Path::stringread (cachefile_);
+  if (!string_startswith (data, cache_header))
+    return;
+  const String prefix = rootdir_ + "/";
+  size_t pos = strlen (cache_header);
+  std::lock_guard<std::mutex> locker (mutex_);
+  while (pos < data.size())
+    {
+      const size_t eol = std::min (data.find ('\n', pos), data.size());
+      const StringVector fields = string_split (data.substr (pos, eol - pos), "\t", 3);
+      pos = eol + 1;
+      if (fields.size() != 4 || !string_startswith (fields[3], prefix))
+        continue;
+      const StringVector nums = string_split (fields[0], " ");
+      if (nums.size() != 4)
+        continue;
+      File file;
+      file.type = ResourceType (string_to_int (nums[0]));
+      file.mtime = string_to_int (nums[1]);
+      file.size = string_to_int (nums[2]);
+      file.scanned = string_to_int (nums[3]);
+      file.hints = fields[1];
+      file.blurb = fields[2];
+      if (file.type == match_type (fields[3]))
+        files_[fields[3]] = file;
+    }
+  index_stale_ = true;
+  RDEBUG ("%s: loaded %u cached entries", cachefile_, files_.size());
+}
+
+void
+ResourceIndex::save_cache ()
+{
+  String data = cache_header;
+  {
+    std::lock_guard<std::mutex> locker (mutex_);
+    for (const auto &pair : files_)
+      if (pair.first.find_first_of ("\t\n") == String::npos)
+        data += string_format ("%d %d %d %d\t%s\t%s\t%s\n", int (pair.second.type), pair.second.mtime, pair.second.size,
+                               pair.second.scanned, pair.second.hints, pair.second.blurb, pair.first);
+  }
+  const String tmpfile = cachefile_ + string_format (".%u~", getpid());
+  if (Path::stringwrite (tmpfile, data, true) && rename (tmpfile.c_str(), cachefile_.c_str()) == 0)
+    RDEBUG ("%s: saved %u bytes", cachefile_, data.size());
+  else
+    {
+      RDEBUG ("%s: failed to save: %s", cachefile_, strerror (errno));
+      unlink (tmpfile.c_str());
+    }
+}
+
+ResourceEntry
+ResourceIndex::file_entry (const String &path, const File &file)
+{
+  ResourceEntry r;
+  r.type = file.type;
+  r.uri = path;
+  r.label = Path::basename (path);
+  r.category = Path::dirname (path).substr (std::min (rootdir_.size() + 1, Path::dirname (path).size()));
+  r.blurb = file.blurb;
+  r.hints = string_format ("size=%d", file.size) + (file.hints.empty() ? "" : ":" + file.hints);
+  return r;
+}
+
+const ResourceIndex::FileIndex&
+ResourceIndex::type_index (ResourceType type)
+{
+  // mutex_ must be held
+  if (index_stale_)
+    {
+      type_index_.clear();
+      for (auto it = files_.cbegin(); it != files_.cend(); ++it)
+        type_index_[it->second.type].push_back (it);
+      index_stale_ = false;
+    }
+  return type_index_[type];
+}
+
+/// Count indexed files of `type`, ResourceType::NONE counts all files.
+size_t
+ResourceIndex::count (ResourceType type)
+{
+  std::lock_guard<std::mutex> locker (mutex_);
+  if (type == ResourceType::NONE)
+    return files_.size();
+  return type_index (type).size();
+}
+
+/// List files of `type` as nested FOLDER entries, directories without matches are omitted.
+ResourceList
+ResourceIndex::list_tree (ResourceType type)
+{
+  std::function<FileMap::const_iterator (ResourceEntry&, FileMap::const_iterator)> build_folder;
+  const FileMap::const_iterator end = files_.end();
+  build_folder = [&] (ResourceEntry &folder, FileMap::const_iterator it) {
+    const String prefix = folder.uri + "/";
+    while (it != end && string_startswith (it->first, prefix))
+      {
+        const size_t slash = it->first.find ('/', prefix.size());
+        if (slash == String::npos)
+          {
+            if (it->second.type == type)
+              folder.entries.push_back (file_entry (it->first, it->second));
+            ++it;
+            continue;
+          }
+        ResourceEntry subfolder;
+        subfolder.type = ResourceType::FOLDER;
+        subfolder.uri = it->first.substr (0, slash);
+        subfolder.label = Path::basename (subfolder.uri);
+        it = build_folder (subfolder, it);
+        if (subfolder.entries.size())
+          folder.entries.push_back (subfolder);
+      }
+    return it;
+  };
+  ResourceList eseq;
+  ResourceEntry root;
+  root.type = ResourceType::FOLDER;
+  root.uri = rootdir_;
+  root.label = Path::basename (rootdir_);
+  std::lock_guard<std::mutex> locker (mutex_);
+  build_folder (root, files_.lower_bound (rootdir_ + "/"));
+  if (root.entries.size())
+    eseq.push_back (root);
+  return eseq;
+}
+
+/// List up to `count` files of `type` in path order, starting at the `first` matching file.
+ResourceList
+ResourceIndex::list_page (ResourceType type, size_t first, size_t count)
+{
+  ResourceList eseq;
+  std::lock_guard<std::mutex> locker (mutex_);
+  const FileIndex &index = type_index (type);
+  for (size_t i = first; i < index.size() && eseq.size() < count; i++)
+    eseq.push_back (file_entry (index[i]->first, index[i]->second));
+  return eseq;
+}
+
+} // Bse
@@ -0,0 +1,67 @@
+// This Source Code Form is licensed MPL-2.0: http://mozilla.org/MPL/2.0
+#ifndef __BSE_RESOURCEINDEX_HH__
+#define __BSE_RESOURCEINDEX_HH__
+
+#include <bse/bseutils.hh>
+#include <bse/bseenums.hh>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <map>
+
+namespace Bse {
+
+/// Persistent index of WAVE and SOUNDFONT files below a directory, kept current via inotify.
+class ResourceIndex {
+public:
+  /// Indexed file with metadata, `hints` and `blurb` are filled in by background workers.
+  struct File {
+    ResourceType type = ResourceType::NONE;
+    int64        mtime = 0;             ///< Modification time in nanoseconds.
+    int64        size = 0;
+    bool         scanned = false;       ///< Metadata has been extracted for `mtime` and `size`.
+    String       hints;                 ///< Colon separated `key=value` pairs, e.g. `channels=2:rate=48000:frames=9600`.
+    String       blurb;                 ///< Soundfont preset names.
+  };
+  using ChangedF = std::function<void()>;
+  explicit     ResourceIndex  (const String &rootdir, const ChangedF &changed = nullptr);
+  /*dtor*/    ~ResourceIndex  ();
+  String       rootdir        () const  { return rootdir_; }
+  size_t       count          (ResourceType type);
+  ResourceList list_tree      (ResourceType type);
+  ResourceList list_page      (ResourceType type, size_t first, size_t count);
+  static ResourceType match_type (const String &filename);
+  static String       extract_hints (const String &filename, ResourceType type, String *blurb);
+private:
+  using FileMap = std::map<String,File>;        // sorted by path, so directories are contiguous
+  using FileIndex = std::vector<FileMap::const_iterator>;
+  const String             rootdir_, cachefile_;
+  ChangedF                 changed_;
+  std::mutex               mutex_;
+  std::condition_variable  jobs_cond_;
+  FileMap                  files_;
+  std::map<ResourceType,FileIndex> type_index_; // files_ per type in path order, rebuilt after insertions and removals
+  bool                     index_stale_ = true;
+  std::deque<String>       jobs_;
+  std::map<int,String>     watches_;            // inotify watch descriptor -> directory
+  std::thread              indexer_;
+  std::vector<std::thread> workers_;
+  int                      inotify_fd_ = -1;
+  std::atomic<bool>        quit_ { false };
+  std::atomic<bool>        dirty_ { false };    // needs cache save and change notification
+  void   indexer_loop     ();
+  void   worker_loop      ();
+  void   scan_directory   (const String &dir, std::vector<String> *seen);
+  void   update_file      (const String &path);
+  void   remove_prefix    (const String &dirpath);
+  bool   process_inotify  ();
+  void   load_cache       ();
+  void   save_cache       ();
+  void   queue_job        (const String &path);
+  const FileIndex& type_index (ResourceType type);
+  ResourceEntry file_entry (const String &path, const File &file);
+};
+
+} // Bse
+
+#endif /* __BSE_RESOURCEINDEX_HH__ */
@@ -0,0 +1,312 @@
+// Licensed GNU LGPL v2.1 or later: http://www.gnu.org/licenses/lgpl.html
+#include "signalmath.hh"
+#include "bse/bsemathsignal.hh"
+#include "bse/internal.hh"
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+#if defined (__SSE2__) && (defined (__x86_64__) || defined (__i386__)) && (defined (__GNUC__) || defined (__clang__))
+#define BSE_SIGNALMATH_AVX2     1       // compile an AVX2+FMA variant, selected at runtime
+#define BSE_TARGET_AVX2         __attribute__ ((__target__ ("avx2,fma")))
+#endif
+
+namespace Bse {
+
+// Coefficients shared by all implementations, see fast_exp2(), fast_log2() and bse_approx_atan1()
+static constexpr float EXP2_C5 = 0.0013276471992255f, EXP2_C4 = 0.0096755413344448f, EXP2_C3 = 0.0555071327349880f;
+static constexpr float EXP2_C2 = 0.2402211972384019f, EXP2_C1 = 0.6931469670647601f;
+static constexpr float LOG2_C6 = -0.0259366993544709205147977455165000143561553284592936f;
+static constexpr float LOG2_C5 = +0.122047857676447181074792747820717519424533931189428f;
+static constexpr float LOG2_C4 = -0.27814297685064327713977752916286528359628147166014f;
+static constexpr float LOG2_C3 = +0.45764712300320092992105460899527194244236573556309f;
+static constexpr float LOG2_C2 = -0.71816105664624015087225994551041120290062342459945f;
+static constexpr float LOG2_C1 = +1.44254540258782520489769598315182363877204824648687f;
+static constexpr float ATAN_N1 = -0.41156875521951602506487246309908f;
+static constexpr float ATAN_N2 = -1.0091272542790025586079663559158f;
+static constexpr float ATAN_D1 = 0.81901156857081841441890603235599f;
+static constexpr float ATAN_D2 = 1.0091272542790025586079663559158f;
+static constexpr float TANH_LIMIT = 20;         // tanh (±20) rounds to ±1 in single precision
+
+// == FPU ==
+static void
+fpu_exp2_block (uint n, const float *input, float *output)
+{
+  for (uint i = 0; i < n; i++)
+    output[i] = fast_exp2 (input[i]);
+}
+
+static void
+fpu_log2_block (uint n, const float *input, float *output)
+{
+  for (uint i = 0; i < n; i++)
+    output[i] = fast_log2 (input[i]);
+}
+
+static void
+fpu_tanh_block (uint n, const float *input, float *output, float prescale)
+{
+  for (uint i = 0; i < n; i++)
+    output[i] = bse_approx4_tanh (prescale * input[i]);
+}
+
+static void
+fpu_atan1_block (uint n, const float *input, float *output, float prescale)
+{
+  for (uint i = 0; i < n; i++)
+    output[i] = bse_approx_atan1 (prescale * input[i]);
+}
+
+// == SSE2 ==
+#ifdef __SSE2__
+static inline __m128
+sse_exp2 (__m128 ex)
+{
+  ex = _mm_min_ps (_mm_max_ps (ex, _mm_set1_ps (-127)), _mm_set1_ps (127));
+  const __m128i i = _mm_cvtps_epi32 (ex);      // round to nearest, like irintf()
+  const __m128 x = _mm_sub_ps (ex, _mm_cvtepi32_ps (i));
+  const __m128 fp = _mm_castsi128_ps (_mm_slli_epi32 (_mm_add_epi32 (i, _mm_set1_epi32 (BSE_FLOAT_BIAS)), 23));
+  __m128 r = _mm_mul_ps (x, _mm_set1_ps (EXP2_C5));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (EXP2_C4), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (EXP2_C3), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (EXP2_C2), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (EXP2_C1), r));
+  return _mm_mul_ps (fp, _mm_add_ps (_mm_set1_ps (1.0f), r));
+}
+
+static inline __m128
+sse_log2 (__m128 value)
+{
+  const __m128i bits = _mm_castps_si128 (value);
+  const __m128i e = _mm_sub_epi32 (_mm_and_si128 (_mm_srli_epi32 (bits, 23), _mm_set1_epi32 (0xff)), _mm_set1_epi32 (127));
+  const __m128i m = _mm_or_si128 (_mm_and_si128 (bits, _mm_set1_epi32 (0x007fffff)), _mm_set1_epi32 (0x3f800000));
+  const __m128 x = _mm_sub_ps (_mm_castsi128_ps (m), _mm_set1_ps (1.0f));
+  __m128 r = _mm_mul_ps (x, _mm_set1_ps (LOG2_C6));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (LOG2_C5), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (LOG2_C4), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (LOG2_C3), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (LOG2_C2), r));
+  r = _mm_mul_ps (x, _mm_add_ps (_mm_set1_ps (LOG2_C1), r));
+  return _mm_add_ps (_mm_cvtepi32_ps (e), r);
+}
+
+static inline __m128
+sse_tanh (__m128 x)
+{
+  x = _mm_min_ps (_mm_max_ps (x, _mm_set1_ps (-TANH_LIMIT)), _mm_set1_ps (TANH_LIMIT));
+  const __m128 bpot = sse_exp2 (_mm_mul_ps (x, _mm_set1_ps (BSE_2_DIV_LN2)));
+  return _mm_div_ps (_mm_sub_ps (bpot, _mm_set1_ps (1.0f)), _mm_add_ps (bpot, _mm_set1_ps (1.0f)));
+}
+
+static inline __m128
+sse_atan1 (__m128 x)
+{
+  // positive_atan1(x) = 1 + (n1 * x + n2) / ((1 + d1 * x) * x + d2), with atan1(-x) = -atan1(x)
+  const __m128 sign = _mm_and_ps (x, _mm_castsi128_ps (_mm_set1_epi32 (0x80000000)));
+  const __m128 a = _mm_xor_ps (x, sign);
+  const __m128 numerator = _mm_add_ps (_mm_mul_ps (a, _mm_set1_ps (ATAN_N1)), _mm_set1_ps (ATAN_N2));
+  __m128 denominator = _mm_add_ps (_mm_mul_ps (a, _mm_set1_ps (ATAN_D1)), _mm_set1_ps (1.0f));
+  denominator = _mm_add_ps (_mm_mul_ps (denominator, a), _mm_set1_ps (ATAN_D2));
+  const __m128 r = _mm_add_ps (_mm_set1_ps (1.0f), _mm_div_ps (numerator, denominator));
+  return _mm_xor_ps (r, sign);
+}
+
+// Apply KERNEL to 4 values at a time, the tail is padded so all values take the same code path
+#define SSE_BLOCK_LOOP(KERNEL, PRESCALE)      do {                          \
+  const __m128 prescale_m = _mm_set1_ps (PRESCALE);                             \
+  uint i = 0;                                                                   \
+  for (; i + 4 <= n; i += 4)                                                    \
+    _mm_storeu_ps (output + i, KERNEL (_mm_mul_ps (_mm_loadu_ps (input + i), prescale_m))); \
+  if (i < n)                                                                    \
+    {                                                                           \
+      alignas (16) float tail[4] = { 0, };                                      \
+      for (uint j = i; j < n; j++)                                              \
+        tail[j - i] = input[j];                                                 \
+      _mm_store_ps (tail, KERNEL (_mm_mul_ps (_mm_load_ps (tail), prescale_m))); \
+      for (uint j = i; j < n; j++)                                              \
+        output[j] = tail[j - i];                                                \
+    }                                                                           \
+} while (0)
+
+static void
+sse_exp2_block (uint n, const float *input, float *output)
+{
+  SSE_BLOCK_LOOP (sse_exp2, 1.0f);
+}
+
+static void
+sse_log2_block (uint n, const float *input, float *output)
+{
+  // padding with 0 is harmless, log2 (0) yields a finite bogus value here
+  SSE_BLOCK_LOOP (sse_log2, 1.0f);
+}
+
+static void
+sse_tanh_block (uint n, const float *input, float *output, float prescale)
+{
+  SSE_BLOCK_LOOP (sse_tanh, prescale);
+}
+
+static void
+sse_atan1_block (uint n, const float *input, float *output, float prescale)
+{
+  SSE_BLOCK_LOOP (sse_atan1, prescale);
+}
+#endif // __SSE2__
+
+// == AVX2 + FMA ==
+#ifdef BSE_SIGNALMATH_AVX2
+static inline BSE_TARGET_AVX2 __m256
+avx2_exp2 (__m256 ex)
+{
+  ex = _mm256_min_ps (_mm256_max_ps (ex, _mm256_set1_ps (-127)), _mm256_set1_ps (127));
+  const __m256i i = _mm256_cvtps_epi32 (ex);
+  const __m256 x = _mm256_sub_ps (ex, _mm256_cvtepi32_ps (i));
+  const __m256 fp = _mm256_castsi256_ps (_mm256_slli_epi32 (_mm256_add_epi32 (i, _mm256_set1_epi32 (BSE_FLOAT_BIAS)), 23));
+  __m256 r = _mm256_mul_ps (x, _mm256_set1_ps (EXP2_C5));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (EXP2_C4), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (EXP2_C3), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (EXP2_C2), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (EXP2_C1), r));
+  return _mm256_fmadd_ps (fp, r, fp);
+}
+
+static inline BSE_TARGET_AVX2 __m256
+avx2_log2 (__m256 value)
+{
+  const __m256i bits = _mm256_castps_si256 (value);
+  const __m256i e = _mm256_sub_epi32 (_mm256_and_si256 (_mm256_srli_epi32 (bits, 23), _mm256_set1_epi32 (0xff)),
+                                      _mm256_set1_epi32 (127));
+  const __m256i m = _mm256_or_si256 (_mm256_and_si256 (bits, _mm256_set1_epi32 (0x007fffff)), _mm256_set1_epi32 (0x3f800000));
+  const __m256 x = _mm256_sub_ps (_mm256_castsi256_ps (m), _mm256_set1_ps (1.0f));
+  __m256 r = _mm256_mul_ps (x, _mm256_set1_ps (LOG2_C6));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (LOG2_C5), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (LOG2_C4), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (LOG2_C3), r));
+  r = _mm256_mul_ps (x, _mm256_add_ps (_mm256_set1_ps (LOG2_C2), r));
+  return _mm256_fmadd_ps (x, _mm256_add_ps (_mm256_set1_ps (LOG2_C1), r), _mm256_cvtepi32_ps (e));
+}
+
+static inline BSE_TARGET_AVX2 __m256
+avx2_tanh (__m256 x)
+{
+  x = _mm256_min_ps (_mm256_max_ps (x, _mm256_set1_ps (-TANH_LIMIT)), _mm256_set1_ps (TANH_LIMIT));
+  const __m256 bpot = avx2_exp2 (_mm256_mul_ps (x, _mm256_set1_ps (BSE_2_DIV_LN2)));
+  return _mm256_div_ps (_mm256_sub_ps (bpot, _mm256_set1_ps (1.0f)), _mm256_add_ps (bpot, _mm256_set1_ps (1.0f)));
+}
+
+static inline BSE_TARGET_AVX2 __m256
+avx2_atan1 (__m256 x)
+{
+  const __m256 sign = _mm256_and_ps (x, _mm256_castsi256_ps (_mm256_set1_epi32 (0x80000000)));
+  const __m256 a = _mm256_xor_ps (x, sign);
+  const __m256 numerator = _mm256_fmadd_ps (a, _mm256_set1_ps (ATAN_N1), _mm256_set1_ps (ATAN_N2));
+  const __m256 denominator = _mm256_fmadd_ps (_mm256_fmadd_ps (a, _mm256_set1_ps (ATAN_D1), _mm256_set1_ps (1.0f)), a,
+                                              _mm256_set1_ps (ATAN_D2));
+  const __m256 r = _mm256_add_ps (_mm256_set1_ps (1.0f), _mm256_div_ps (numerator, denominator));
+  return _mm256_xor_ps (r, sign);
+}
+
+// Apply KERNEL to 8 values at a time, the tail is padded so all values take the same code path
+#define AVX2_BLOCK_LOOP(KERNEL, PRESCALE)      do {                         \
+  const __m256 prescale_m = _mm256_set1_ps (PRESCALE);                          \
+  uint i = 0;                                                                   \
+  for (; i + 8 <= n; i += 8)                                                    \
+    _mm256_storeu_ps (output + i, KERNEL (_mm256_mul_ps (_mm256_loadu_ps (input + i), prescale_m))); \
+  if (i < n)                                                                    \
+    {                                                                           \
+      alignas (32) float tail[8] = { 0, };                                      \
+      for (uint j = i; j < n; j++)                                              \
+        tail[j - i] = input[j];                                                 \
+      _mm256_store_ps (tail, KERNEL (_mm256_mul_ps (_mm256_load_ps (tail), prescale_m))); \
+      for (uint j = i; j < n; j++)                                              \
+        output[j] = tail[j - i];                                                \
+    }                                                                           \
+} while (0)
+
+static BSE_TARGET_AVX2 void
+avx2_exp2_block (uint n, const float *input, float *output)
+{
+  AVX2_BLOCK_LOOP (avx2_exp2, 1.0f);
+}
+
+static BSE_TARGET_AVX2 void
+avx2_log2_block (uint n, const float *input, float *output)
+{
+  AVX2_BLOCK_LOOP (avx2_log2, 1.0f);
+}
+
+static BSE_TARGET_AVX2 void
+avx2_tanh_block (uint n, const float *input, float *output, float prescale)
+{
+  AVX2_BLOCK_LOOP (avx2_tanh, prescale);
+}
+
+static BSE_TARGET_AVX2 void
+avx2_atan1_block (uint n, const float *input, float *output, float prescale)
+{
+  AVX2_BLOCK_LOOP (avx2_atan1, prescale);
+}
+#endif // BSE_SIGNALMATH_AVX2
+
+// == Runtime Dispatch ==
+struct FastMathBlockImpl {
+  const char *name;
+  void      (*exp2_block)  (uint, const float*, float*);
+  void      (*log2_block)  (uint, const float*, float*);
+  void      (*tanh_block)  (uint, const float*, float*, float);
+  void      (*atan1_block) (uint, const float*, float*, float);
+};
+
+static FastMathBlockImpl
+fast_math_block_select ()
+{
+#ifdef BSE_SIGNALMATH_AVX2
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports ("avx2") && __builtin_cpu_supports ("fma"))
+    return { "AVX2+FMA", avx2_exp2_block, avx2_log2_block, avx2_tanh_block, avx2_atan1_block };
+#endif
+#ifdef __SSE2__
+  return { "SSE2", sse_exp2_block, sse_log2_block, sse_tanh_block, sse_atan1_block };
+#endif
+  return { "FPU", fpu_exp2_block, fpu_log2_block, fpu_tanh_block, fpu_atan1_block };
+}
+
+static const FastMathBlockImpl&
+fast_math_block_impl_table ()
+{
+  static const FastMathBlockImpl impl = fast_math_block_select();
+  return impl;
+}
+
+const char*
+fast_math_block_impl ()
+{
+  return fast_math_block_impl_table().name;
+}
+
+void
+fast_exp2_block (uint n, const float *input, float *output)
+{
+  fast_math_block_impl_table().exp2_block (n, input, output);
+}
+
+void
+fast_log2_block (uint n, const float *input, float *output)
+{
+  fast_math_block_impl_table().log2_block (n, input, output);
+}
+
+void
+fast_tanh_block (uint n, const float *input, float *output, float prescale)
+{
+  fast_math_block_impl_table().tanh_block (n, input, output, prescale);
+}
+
+void
+fast_atan1_block (uint n, const float *input, float *output, float prescale)
+{
+  fast_math_block_impl_table().atan1_block (n, input, output, prescale);
+}
+
+} // Bse
@@ -40,6 +40,25 @@ extern inline float fast_exp2   (float x)       G_GNUC_CONST;
  */
 extern inline float fast_log2   (float x)       G_GNUC_CONST;
 
+/// Apply fast_exp2() to `n` values of `input`, processing in place is ok.
+void        fast_exp2_block   (uint n, const float *input, float *output);
+
+/// Apply fast_log2() to `n` positive values of `input`, processing in place is ok.
+void        fast_log2_block   (uint n, const float *input, float *output);
+
+/**
+ * Calculate `bse_approx4_tanh (prescale * input[i])` for `n` values, processing in place is ok.
+ * The hyperbolic tangent is computed from fast_exp2() as `(e^2x - 1) / (e^2x + 1)`, with
+ * `|prescale * input[i]| > 20` saturating at ±1.
+ */
+void        fast_tanh_block   (uint n, const float *input, float *output, float prescale = 1);
+
+/// Calculate `bse_approx_atan1 (prescale * input[i])` for `n` values, processing in place is ok.
+void        fast_atan1_block  (uint n, const float *input, float *output, float prescale = 1);
+
+/// Name of the SIMD implementation used by the `*_block()` functions, selected at runtime.
+const char* fast_math_block_impl ();
+
 // == Implementations ==
 extern inline G_GNUC_CONST float
 fast_exp2 (float ex)
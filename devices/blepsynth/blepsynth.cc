@@ -161,37 +161,92 @@ public:
     level_ = level_ * params_.factor + params_.delta;
     params_.len--;
     if (!params_.len)
+      next_state();
+    return level_;
+  }
+  /// Number of samples until the next state change, the level follows `level * factor + delta` until then.
+  uint
+  segment (double &level, double &factor, double &delta) const
+  {
+    level = level_;
+    if (state_ == State::SUSTAIN || state_ == State::DONE)
       {
-        level_ = params_.end;
-
-        if (state_ == State::DELAY)
-          {
-            compute_slope_params (attack_len_, 0, 1, State::ATTACK);
-            state_ = State::ATTACK;
-          }
-        else if (state_ == State::ATTACK)
-          {
-            compute_slope_params (hold_len_, 1, 1, State::HOLD);
-            state_ = State::HOLD;
-          }
-        else if (state_ == State::HOLD)
-          {
-            compute_slope_params (decay_len_, 1, sustain_level_, State::DECAY);
-            state_ = State::DECAY;
-          }
-        else if (state_ == State::DECAY)
-          {
-            state_ = State::SUSTAIN;
-          }
-        else if (state_ == State::RELEASE)
-          {
-            state_ = State::DONE;
-          }
+        factor = 1;
+        delta = 0;
+        return ~0u;
       }
+    factor = params_.factor;
+    delta = params_.delta;
+    return params_.len;
+  }
+  /// Account for `n` samples computed from segment(), returns the level after the last sample.
+  float
+  advance (double level, uint n)
+  {
+    if (state_ == State::SUSTAIN || state_ == State::DONE)
+      return level_;
+
+    level_ = level;
+    params_.len -= n;
+    if (!params_.len)
+      next_state();
     return level_;
   }
+private:
+  void
+  next_state()
+  {
+    level_ = params_.end;
+
+    if (state_ == State::DELAY)
+      {
+        compute_slope_params (attack_len_, 0, 1, State::ATTACK);
+        state_ = State::ATTACK;
+      }
+    else if (state_ == State::ATTACK)
+      {
+        compute_slope_params (hold_len_, 1, 1, State::HOLD);
+        state_ = State::HOLD;
+      }
+    else if (state_ == State::HOLD)
+      {
+        compute_slope_params (decay_len_, 1, sustain_level_, State::DECAY);
+        state_ = State::DECAY;
+      }
+    else if (state_ == State::DECAY)
+      {
+        state_ = State::SUSTAIN;
+      }
+    else if (state_ == State::RELEASE)
+      {
+        state_ = State::DONE;
+      }
+  }
 };
 
+/// Render the envelopes of `LANES` voices at once, the state changes are handled between vectorized segments.
+template<uint LANES> static void
+render_envelopes (Envelope *const *envelopes, float *const *out, uint n_frames)
+{
+  uint done = 0;
+  while (done < n_frames)
+    {
+      alignas (32) double level[LANES], factor[LANES], delta[LANES];
+      uint n = n_frames - done;
+      for (uint l = 0; l < LANES; l++)
+        n = std::min (n, envelopes[l]->segment (level[l], factor[l], delta[l]));
+      for (uint i = done; i < done + n; i++)
+        for (uint l = 0; l < LANES; l++)
+          {
+            level[l] = level[l] * factor[l] + delta[l];
+            out[l][i] = level[l];
+          }
+      for (uint l = 0; l < LANES; l++)
+        out[l][done + n - 1] = envelopes[l]->advance (level[l], n);
+      done += n;
+    }
+}
+
 } // Anon
 
 // == BlepSynth ==
@@ -263,11 +318,15 @@ class BlepSynth : public AudioSignal::Processor {
 
     BlepUtils::OscImpl osc1_;
     BlepUtils::OscImpl osc2_;
-    LadderVCFNonLinear vcf_;
   };
-  std::vector<Voice>    voices_;
-  std::vector<Voice *>  active_voices_;
-  std::vector<Voice *>  idle_voices_;
+  // Voices are rendered in groups of LANES, filters and envelopes of a group are computed in SIMD lanes
+  static constexpr uint LANES = 4;
+  struct VoiceGroup {
+    LadderVCFLanes<true, true, LANES> vcf_;
+  };
+  std::vector<Voice>      voices_;      // voices_[g * LANES + l] is lane `l` of voice_groups_[g]
+  std::vector<VoiceGroup> voice_groups_;
+  std::vector<Voice *>    active_voices_;
   void
   query_info (ProcessorInfo &info) const override
   {
@@ -347,30 +406,26 @@ class BlepSynth : public AudioSignal::Processor {
   void
   set_max_voices (uint n_voices)
   {
+    const uint n_groups = (n_voices + LANES - 1) / LANES;
     voices_.clear();
-    voices_.resize (n_voices);
+    voices_.resize (n_groups * LANES);
+    voice_groups_.clear();
+    voice_groups_.resize (n_groups);
 
     active_voices_.clear();
-    active_voices_.reserve (n_voices);
-
-    idle_voices_.clear();
-    for (auto& v : voices_)
-      idle_voices_.push_back (&v);
+    active_voices_.reserve (voices_.size());
   }
   Voice *
   alloc_voice()
   {
-    if (idle_voices_.empty()) // out of voices?
-      return nullptr;
-
-    Voice *voice = idle_voices_.back();
-    assert_return (voice->state_ == Voice::IDLE, nullptr);   // every item in idle_voices should be idle
-
-    // move voice from idle to active list
-    idle_voices_.pop_back();
-    active_voices_.push_back (voice);
-
-    return voice;
+    // use the first idle voice, this keeps the active voices packed into few groups
+    for (auto &voice : voices_)
+      if (voice.state_ == Voice::IDLE)
+        {
+          active_voices_.push_back (&voice);
+          return &voice;
+        }
+    return nullptr; // out of voices
   }
   void
   free_unused_voices()
@@ -381,14 +436,8 @@ class BlepSynth : public AudioSignal::Processor {
       {
         Voice *voice = active_voices_[i];
 
-        if (voice->state_ == Voice::IDLE)    // voice used?
-          {
-            idle_voices_.push_back (voice);
-          }
-        else
-          {
-            active_voices_[new_voice_count++] = voice;
-          }
+        if (voice->state_ != Voice::IDLE)    // voice used?
+          active_voices_[new_voice_count++] = voice;
       }
     active_voices_.resize (new_voice_count);
   }
@@ -468,7 +517,8 @@ class BlepSynth : public AudioSignal::Processor {
 
         voice->osc1_.reset();
         voice->osc2_.reset();
-        voice->vcf_.reset();
+        const size_t index = voice - &voices_[0];
+        voice_groups_[index / LANES].vcf_.reset_lane (index % LANES);
 
         voice->cutoff_smooth_.reset (sample_rate(), 0.020);
         voice->last_cutoff_ = -5000; // force reset
@@ -541,101 +591,162 @@ class BlepSynth : public AudioSignal::Processor {
     floatfill (left_out, 0.f, n_frames);
     floatfill (right_out, 0.f, n_frames);
 
-    for (auto& voice : active_voices_)
+    // parameters shared by all voices
+    const float mix_norm = get_param (pid_mix_) * 0.01;
+    const float v1 = 1 - mix_norm;
+    const float v2 = mix_norm;
+    bool run_filter = true;
+    LadderVCFMode vcf_mode = LadderVCFMode::LP4;
+    switch (bse_ftoi (get_param (pid_mode_)))
+      {
+      case 4: vcf_mode = LadderVCFMode::LP4;
+        break;
+      case 3: vcf_mode = LadderVCFMode::LP3;
+        break;
+      case 2: vcf_mode = LadderVCFMode::LP2;
+        break;
+      case 1: vcf_mode = LadderVCFMode::LP1;
+        break;
+      default: run_filter = false;
+        break;
+      }
+    // automated cutoff changes are sample accurate, they replace the smoothing while ramping
+    float cutoffs[n_frames];
+    const bool cutoff_const = render_param (pid_cutoff_, cutoffs, n_frames);
+    const double cutoff = cutoffs[n_frames - 1] * inyquist();
+    if (!cutoff_const)
       {
-        float osc1_left_out[n_frames];
-        float osc1_right_out[n_frames];
-        float osc2_left_out[n_frames];
-        float osc2_right_out[n_frames];
-
-        update_osc (voice->osc1_, osc_params[0]);
-        update_osc (voice->osc2_, osc_params[1]);
-        voice->osc1_.process_sample_stereo (osc1_left_out, osc1_right_out, n_frames);
-        voice->osc2_.process_sample_stereo (osc2_left_out, osc2_right_out, n_frames);
-
-        // apply volume envelope & mix
-        float mix_left_out[n_frames];
-        float mix_right_out[n_frames];
-        const float mix_norm = get_param (pid_mix_) * 0.01;
-        const float v1 = 1 - mix_norm;
-        const float v2 = mix_norm;
         for (uint i = 0; i < n_frames; i++)
-          {
-            mix_left_out[i]  = osc1_left_out[i] * v1 + osc2_left_out[i] * v2;
-            mix_right_out[i] = osc1_right_out[i] * v1 + osc2_right_out[i] * v2;
-          }
-        bool run_filter = true;
-        switch (bse_ftoi (get_param (pid_mode_)))
-          {
-          case 4: voice->vcf_.set_mode (LadderVCFMode::LP4);
-            break;
-          case 3: voice->vcf_.set_mode (LadderVCFMode::LP3);
-            break;
-          case 2: voice->vcf_.set_mode (LadderVCFMode::LP2);
-            break;
-          case 1: voice->vcf_.set_mode (LadderVCFMode::LP1);
-            break;
-          default: run_filter = false;
-            break;
-          }
-        /* --------- run ladder filter - processing in place is ok --------- */
-
-        /* TODO: under some conditions we could enable SSE in LadderVCF (alignment and block_size) */
-        const float *inputs[2]  = { mix_left_out, mix_right_out };
-        float       *outputs[2] = { mix_left_out, mix_right_out };
-        double cutoff = get_param (pid_cutoff_) * inyquist();
-        double resonance = get_param (pid_resonance_) * 0.01;
-        double key_track = get_param (pid_key_track_) * 0.01;
-
-        if (fabs (voice->last_cutoff_ - cutoff) > 1e-7 || fabs (voice->last_key_track_ - key_track) > 1e-7)
-          {
-            const bool reset = voice->last_cutoff_ < -1000;
-
-            // original strategy for key tracking: cutoff * exp (amount * log (key / 261.63))
-            // but since cutoff_smooth_ is already in log2-frequency space, we can do it better
+          cutoffs[i] *= inyquist();
+        fast_log2_block (n_frames, cutoffs, cutoffs);
+      }
+    const double resonance = get_param (pid_resonance_) * 0.01;
+    const double key_track = get_param (pid_key_track_) * 0.01;
+    const double cut_mod = get_param (pid_fil_cut_mod_) / 12.; /* convert semitones to octaves */
+    const double drive = get_param (pid_drive_);
 
-            voice->cutoff_smooth_.set (fast_log2 (cutoff) + key_track * fast_log2 (voice->freq_ / 261.63), reset);
-            voice->last_cutoff_ = cutoff;
-            voice->last_key_track_ = key_track;
-          }
-        double cut_mod = get_param (pid_fil_cut_mod_) / 12.; /* convert semitones to octaves */
-        if (fabs (voice->last_cut_mod_ - cut_mod) > 1e-7)
+    for (size_t g = 0; g < voice_groups_.size(); g++)
+      {
+        Voice *const lanes = &voices_[g * LANES];
+        uint n_active = 0;
+        for (uint l = 0; l < LANES; l++)
+          n_active += lanes[l].state_ != Voice::IDLE;
+        if (!n_active)
+          continue;
+
+        // per lane buffers, mix_out[c * LANES + l] holds channel `c` of lane `l`
+        float mix_buffers[2 * LANES][n_frames];
+        float freq_buffers[LANES][n_frames];
+        float env_buffers[LANES][n_frames];
+        float *mix_out[2 * LANES], *freq_in[LANES], *env_out[LANES];
+        Envelope *fil_envelopes[LANES], *envelopes[LANES];
+        for (uint l = 0; l < LANES; l++)
           {
-            const bool reset = voice->last_cut_mod_ < -1000;
-
-            voice->cut_mod_smooth_.set (cut_mod, reset);
-            voice->last_cut_mod_ = cut_mod;
+            mix_out[l] = mix_buffers[l];
+            mix_out[LANES + l] = mix_buffers[LANES + l];
+            freq_in[l] = freq_buffers[l];
+            env_out[l] = env_buffers[l];
+            fil_envelopes[l] = &lanes[l].fil_envelope_;
+            envelopes[l] = &lanes[l].envelope_;
           }
-        /* TODO: possible improvements:
-         *  - exponential smoothing (get rid of exp2f)
-         *  - don't do anything if cutoff_smooth_->steps_ == 0 (add accessor)
-         */
-        float freq_in[n_frames];
-        for (uint i = 0; i < n_frames; i++)
-          freq_in[i] = fast_exp2 (voice->cutoff_smooth_.get_next() + voice->fil_envelope_.get_next() * voice->cut_mod_smooth_.get_next());
-        voice->vcf_.set_drive (get_param (pid_drive_));
 
-        float no_out[n_frames];
-        if (!run_filter)
+        // oscillators are rendered per voice, they insert band limited steps at irregular positions
+        for (uint l = 0; l < LANES; l++)
           {
-            // we keep running the filter even if it is disabled in order to have
-            // sane filter signal to switch to when the filter is enabled again
-            outputs[0] = no_out;
-            outputs[1] = no_out;
+            Voice *voice = &lanes[l];
+            float *mix_left_out = mix_out[l], *mix_right_out = mix_out[LANES + l];
+            if (voice->state_ == Voice::IDLE)
+              {
+                floatfill (mix_left_out, 0.f, n_frames);
+                floatfill (mix_right_out, 0.f, n_frames);
+                continue;
+              }
+            float osc1_left_out[n_frames];
+            float osc1_right_out[n_frames];
+            float osc2_left_out[n_frames];
+            float osc2_right_out[n_frames];
+
+            update_osc (voice->osc1_, osc_params[0]);
+            update_osc (voice->osc2_, osc_params[1]);
+            voice->osc1_.process_sample_stereo (osc1_left_out, osc1_right_out, n_frames);
+            voice->osc2_.process_sample_stereo (osc2_left_out, osc2_right_out, n_frames);
+
+            // mix oscillators
+            for (uint i = 0; i < n_frames; i++)
+              {
+                mix_left_out[i]  = osc1_left_out[i] * v1 + osc2_left_out[i] * v2;
+                mix_right_out[i] = osc1_right_out[i] * v1 + osc2_right_out[i] * v2;
+              }
+            if (fabs (voice->last_cutoff_ - cutoff) > 1e-7 || fabs (voice->last_key_track_ - key_track) > 1e-7)
+              {
+                const bool reset = voice->last_cutoff_ < -1000 || !cutoff_const;
+
+                // original strategy for key tracking: cutoff * exp (amount * log (key / 261.63))
+                // but since cutoff_smooth_ is already in log2-frequency space, we can do it better
+
+                voice->cutoff_smooth_.set (fast_log2 (cutoff) + key_track * fast_log2 (voice->freq_ / 261.63), reset);
+                voice->last_cutoff_ = cutoff;
+                voice->last_key_track_ = key_track;
+              }
+            if (fabs (voice->last_cut_mod_ - cut_mod) > 1e-7)
+              {
+                const bool reset = voice->last_cut_mod_ < -1000;
+
+                voice->cut_mod_smooth_.set (cut_mod, reset);
+                voice->last_cut_mod_ = cut_mod;
+              }
           }
-        voice->vcf_.run_block (n_frames, cutoff, resonance, inputs, outputs, true, true, freq_in, nullptr, nullptr, nullptr);
 
-        // apply volume envelope
-        for (uint i = 0; i < n_frames; i++)
+        // filter envelopes of all lanes, then the per lane cutoff frequencies
+        render_envelopes<LANES> (fil_envelopes, env_out, n_frames);
+        for (uint l = 0; l < LANES; l++)
           {
-            float amp = 0.25 * voice->envelope_.get_next();
-            left_out[i] += mix_left_out[i] * amp;
-            right_out[i] += mix_right_out[i] * amp;
+            float cut_mod_block[n_frames];
+            if (BSE_ISLIKELY (cutoff_const) || lanes[l].state_ == Voice::IDLE)
+              lanes[l].cutoff_smooth_.get_block (freq_in[l], n_frames);
+            else
+              {
+                const float key_offset = key_track * fast_log2 (lanes[l].freq_ / 261.63);
+                for (uint i = 0; i < n_frames; i++)
+                  freq_in[l][i] = cutoffs[i] + key_offset;
+              }
+            lanes[l].cut_mod_smooth_.get_block (cut_mod_block, n_frames);
+            for (uint i = 0; i < n_frames; i++)
+              freq_in[l][i] += env_out[l][i] * cut_mod_block[i];
+            fast_exp2_block (n_frames, freq_in[l], freq_in[l]);
           }
-        if (voice->envelope_.done())
+
+        /* --------- run ladder filter - processing in place is ok --------- */
+        VoiceGroup &group = voice_groups_[g];
+        group.vcf_.set_mode (vcf_mode);
+        group.vcf_.set_drive (drive);
+        float no_buffers[2 * LANES][n_frames];
+        float *no_out[2 * LANES];
+        for (uint k = 0; k < 2 * LANES; k++)
+          no_out[k] = no_buffers[k];
+        // we keep running the filter even if it is disabled in order to have
+        // sane filter signal to switch to when the filter is enabled again
+        group.vcf_.run_block (n_frames, resonance, mix_out, run_filter ? mix_out : no_out, freq_in);
+
+        // apply volume envelope & mix
+        render_envelopes<LANES> (envelopes, env_out, n_frames);
+        for (uint l = 0; l < LANES; l++)
           {
-            voice->state_ = Voice::IDLE;
-            need_free = true;
+            Voice *voice = &lanes[l];
+            if (voice->state_ == Voice::IDLE)
+              continue;
+            const float *mix_left_out = mix_out[l], *mix_right_out = mix_out[LANES + l];
+            for (uint i = 0; i < n_frames; i++)
+              {
+                const float amp = 0.25 * env_out[l][i];
+                left_out[i] += mix_left_out[i] * amp;
+                right_out[i] += mix_right_out[i] * amp;
+              }
+            if (voice->envelope_.done())
+              {
+                voice->state_ = Voice::IDLE;
+                need_free = true;
+              }
           }
       }
     if (need_free)
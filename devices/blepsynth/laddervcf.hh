@@ -3,6 +3,7 @@
 #define __BSE_DEVICES_LADDER_VCF_HH__
 
 #include <bse/bseresampler.hh>
+#include <bse/signalmath.hh>
 
 namespace Bse {
 
@@ -199,6 +200,14 @@ private:
 
     fc *= freq_scale;
 
+    float freq_mod_factor[freq_mod_in ? n_samples : 1];
+    if (freq_mod_in)
+      {
+        for (uint i = 0; i < n_samples; i++)
+          freq_mod_factor[i] = freq_mod_in[i] * freq_mod_octaves;
+        fast_exp2_block (n_samples, freq_mod_factor, freq_mod_factor);
+      }
+
     for (uint i = 0; i < n_samples; i++)
       {
         double mod_fc = fc;
@@ -208,7 +217,7 @@ private:
           mod_fc = BSE_SIGNAL_TO_FREQ (freq_in[i]) * freq_scale / nyquist;
 
         if (freq_mod_in)
-          mod_fc *= fast_exp2 (freq_mod_in[i] * freq_mod_octaves);
+          mod_fc *= freq_mod_factor[i];
 
         if (key_freq_in)
           {
@@ -323,6 +332,185 @@ public:
   }
 };
 
+/// Stereo ladder filter for `LANES` voices at once.
+/// The filter state is laid out as structure of arrays, indexed by `channel * LANES + lane`,
+/// so the per-sample recursion of all voices is computed by the same vectorizable loops.
+/// Mode, drive and resonance are shared by all lanes, the cutoff frequency is per lane.
+template<bool OVERSAMPLE, bool NON_LINEAR, uint LANES>
+class LadderVCFLanes
+{
+  static constexpr uint N = 2 * LANES;
+  alignas (32) double x1[N], x2[N], x3[N], x4[N];
+  alignas (32) double y1[N], y2[N], y3[N], y4[N];
+  struct Resamplers {
+    // NOTE: Bse currently doesn't enforce SSE alignment so we force FPU resampling
+    Resampler2 res_up   { Resampler2::UP,   Resampler2::PREC_48DB, false };
+    Resampler2 res_down { Resampler2::DOWN, Resampler2::PREC_48DB, false };
+  };
+  std::array<Resamplers, N> resamplers;
+  LadderVCFMode mode;
+  double pre_scale, post_scale;
+  double rate;
+public:
+  LadderVCFLanes()
+  {
+    reset();
+    set_mode (LadderVCFMode::LP4);
+    set_drive (0);
+    set_rate (48000);
+  }
+  void
+  set_mode (LadderVCFMode new_mode)
+  {
+    mode = new_mode;
+  }
+  void
+  set_drive (double drive_db)
+  {
+    const double drive_delta_db = 36;
+
+    pre_scale = bse_db_to_factor (drive_db - drive_delta_db);
+    post_scale = std::max (1 / pre_scale, 1.0);
+  }
+  void
+  set_rate (double r)
+  {
+    rate = r;
+  }
+  void
+  reset()
+  {
+    for (uint lane = 0; lane < LANES; lane++)
+      reset_lane (lane);
+  }
+  /// Reset the filter state of a single voice.
+  void
+  reset_lane (uint lane)
+  {
+    for (uint k = lane; k < N; k += LANES)
+      {
+        x1[k] = x2[k] = x3[k] = x4[k] = 0;
+        y1[k] = y2[k] = y3[k] = y4[k] = 0;
+        resamplers[k].res_up.reset();
+        resamplers[k].res_down.reset();
+      }
+  }
+  static double
+  distort (double x)
+  {
+    if (NON_LINEAR)
+      {
+        /* shaped somewhat similar to tanh() and others, but faster */
+        x = std::min (std::max (x, -1.0), 1.0); // like std::clamp, but without branches
+
+        return x - x * x * x * (1.0 / 3);
+      }
+    else
+      {
+        return x;
+      }
+  }
+private:
+  // one sample step for all lanes and channels, see LadderVCF::run()
+  template<LadderVCFMode MODE> inline void
+  run (double *values, const double *g, const double *res, const double *oscale)
+  {
+    for (uint k = 0; k < N; k++)
+      {
+        const double gg = g[k] * g[k];
+        const double x = values[k] * pre_scale;
+        const double g_comp = 0.5; // passband gain correction
+        const double x0 = distort (x - (y4[k] - g_comp * x) * res[k] * 4) * gg * gg * (1.0 / 1.3 / 1.3 / 1.3 / 1.3);
+
+        y1[k] = x0 + x1[k] * 0.3 + y1[k] * (1 - g[k]);
+        x1[k] = x0;
+
+        y2[k] = y1[k] + x2[k] * 0.3 + y2[k] * (1 - g[k]);
+        x2[k] = y1[k];
+
+        y3[k] = y2[k] + x3[k] * 0.3 + y3[k] * (1 - g[k]);
+        x3[k] = y2[k];
+
+        y4[k] = y3[k] + x4[k] * 0.3 + y4[k] * (1 - g[k]);
+        x4[k] = y3[k];
+
+        switch (MODE)
+          {
+          case LadderVCFMode::LP1:      values[k] = y1[k] * oscale[k];  break;
+          case LadderVCFMode::LP2:      values[k] = y2[k] * oscale[k];  break;
+          case LadderVCFMode::LP3:      values[k] = y3[k] * oscale[k];  break;
+          case LadderVCFMode::LP4:      values[k] = y4[k] * oscale[k];  break;
+          }
+      }
+  }
+  template<LadderVCFMode MODE> inline void
+  do_run_block (uint n_samples, double res, const float *const *inputs, float *const *outputs, const float *const *freq_in)
+  {
+    constexpr uint oversample_count = OVERSAMPLE ? 2 : 1;
+    float over_samples[OVERSAMPLE ? N : 1][2 * n_samples];
+    const double freq_scale = OVERSAMPLE ? 0.5 : 1.0;
+    const double nyquist = rate * 0.5;
+
+    if (OVERSAMPLE)
+      for (uint k = 0; k < N; k++)
+        resamplers[k].res_up.process_block (inputs[k], n_samples, over_samples[k]);
+
+    for (uint i = 0; i < n_samples; i++)
+      {
+        // coefficients are per lane, duplicated for both channels
+        alignas (32) double g[N], lres[N], oscale[N];
+        for (uint l = 0; l < LANES; l++)
+          {
+            const double mod_fc = std::clamp (BSE_SIGNAL_TO_FREQ (freq_in[l][i]) * freq_scale / nyquist, 0.0, 1.0);
+            const double fc = M_PI * mod_fc;
+            g[l] = 0.9892 * fc - 0.4342 * fc * fc + 0.1381 * fc * fc * fc - 0.0202 * fc * fc * fc * fc;
+            lres[l] = res * (1.0029 + 0.0526 * fc - 0.0926 * fc * fc + 0.0218 * fc * fc * fc);
+            switch (MODE)
+              {
+              case LadderVCFMode::LP1:  oscale[l] = post_scale / (g[l] * g[l] * g[l] * (1.0 / (1.3 * 1.3 * 1.3)));  break;
+              case LadderVCFMode::LP2:  oscale[l] = post_scale / (g[l] * g[l] * (1.0 / (1.3 * 1.3)));  break;
+              case LadderVCFMode::LP3:  oscale[l] = post_scale / (g[l] * (1.0 / 1.3));  break;
+              case LadderVCFMode::LP4:  oscale[l] = post_scale;  break;
+              }
+            g[LANES + l] = g[l];
+            lres[LANES + l] = lres[l];
+            oscale[LANES + l] = oscale[l];
+          }
+        for (uint os = 0; os < oversample_count; os++)
+          {
+            alignas (32) double values[N];
+            for (uint k = 0; k < N; k++)
+              values[k] = OVERSAMPLE ? over_samples[k][i * 2 + os] : inputs[k][i];
+
+            run<MODE> (values, g, lres, oscale);
+
+            for (uint k = 0; k < N; k++)
+              if (OVERSAMPLE)
+                over_samples[k][i * 2 + os] = values[k];
+              else
+                outputs[k][i] = values[k];
+          }
+      }
+    if (OVERSAMPLE)
+      for (uint k = 0; k < N; k++)
+        resamplers[k].res_down.process_block (over_samples[k], 2 * n_samples, outputs[k]);
+  }
+public:
+  /// Filter `inputs` into `outputs` (processing in place is ok), both are indexed by `channel * LANES + lane`.
+  /// The per-lane cutoff frequencies are given as signal values in `freq_in[lane]`.
+  void
+  run_block (uint n_samples, double res, const float *const *inputs, float *const *outputs, const float *const *freq_in)
+  {
+    switch (mode)
+      {
+      case LadderVCFMode::LP4: do_run_block<LadderVCFMode::LP4> (n_samples, res, inputs, outputs, freq_in);  break;
+      case LadderVCFMode::LP3: do_run_block<LadderVCFMode::LP3> (n_samples, res, inputs, outputs, freq_in);  break;
+      case LadderVCFMode::LP2: do_run_block<LadderVCFMode::LP2> (n_samples, res, inputs, outputs, freq_in);  break;
+      case LadderVCFMode::LP1: do_run_block<LadderVCFMode::LP1> (n_samples, res, inputs, outputs, freq_in);  break;
+      }
+  }
+};
+
 // fast linear model of the filter
 typedef LadderVCF<false, false> LadderVCFLinear;
 
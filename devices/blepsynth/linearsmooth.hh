@@ -53,6 +53,20 @@ public:
         return linear_value_;
       }
   }
+  /// Equivalent to `n` calls to get_next(), without per-sample branching.
+  void
+  get_block (float *dst, uint n)
+  {
+    const uint k = std::min (n, steps_);
+    const float start = linear_value_;
+    for (uint i = 0; i < k; i++)
+      dst[i] = start + linear_step_ * (i + 1);
+    if (k)
+      linear_value_ = dst[k - 1];
+    steps_ -= k;
+    for (uint i = k; i < n; i++)
+      dst[i] = value_;
+  }
 };
 
 }
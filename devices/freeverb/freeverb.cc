@@ -49,6 +49,7 @@ class Freeverb : public AudioSignal::Processor {
     centries += { "VLC Damping",    "The VLC Freeverb version disables one damping feedback chain" };
     centries += { "Normal Damping", "Damping with sign correction as implemented in STK Freeverb" };
     add_param (MODE, "Mode",  "M", std::move (centries), 2, "", "Damping mode found in different Freeverb variants");
+    set_tail_frames (sample_rate() / 2); // outlast the longest comb filter delay
   }
   void
   configure (uint n_ibusses, const SpeakerArrangement *ibusses, uint n_obusses, const SpeakerArrangement *obusses) override
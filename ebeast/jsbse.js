@@ -7,6 +7,17 @@ export * from './bseapi_jsonipc.js';
 // -------- Javascript BSE API (auto-generated) --------
 
 // == Notifier.on ==
+// Event handlers by connection id, events arrive batched via "Bse/EventHub/events"
+const event_handlers = new Map();
+function BseEventHub_dispatchevents (batch) {
+  for (const [id, event] of batch)
+    {
+      const handler = event_handlers.get (id);
+      if (handler)
+	handler (event);
+    }
+}
+Bse.$jsonipc.observe ("Bse/EventHub/events", [], BseEventHub_dispatchevents);
 Bse.NotifierIface.prototype.on = function (eventselector, callback) {
   const connection = {
     active: true,
@@ -21,7 +32,7 @@ Bse.NotifierIface.prototype.on = function (eventselector, callback) {
 	  if (connection.active)
 	    callback.call (this, ...args);
 	}; // this wrapper function needs an accurate name for backtraces
-	Bse.$jsonipc.observe ("Bse/EventHub/event", [ connection.id ], BseNotifierIface_dispatchevent);
+	event_handlers.set (connection.id, BseNotifierIface_dispatchevent);
       }
   };
   connection.promise = BseNotifierIface_connect();
@@ -32,7 +43,7 @@ Bse.NotifierIface.prototype.on = function (eventselector, callback) {
     await connection.promise;
     if (connection.id)
       {
-	Bse.$jsonipc.unobserve ("Bse/EventHub/event", [ connection.id ]);
+	event_handlers.delete (connection.id);
 	await Bse.$jsonipc.send ("Bse/EventHub/disconnect", [ connection.id ]);
       }
   };
@@ -91,6 +91,13 @@ export const $jsonipc = {
     return promise;
   },
 
+  /// Send binary data, e.g. records of parameter changes
+  send_binary (data) {
+    if (!this.web_socket)
+      throw "$jsonipc: connection closed";
+    this.web_socket.send (data);
+  },
+
   /// Handle a Jsonipc message
   socket_message (event) {
     // Binary message
@@ -136,7 +136,7 @@ class Compressor : public CompressorBase
 	  else
 	    {
 	      process_loop <CHANNELS_A1y_A2n> (n_values);
-	      ostream_set (OCHANNEL_AUDIO_OUT2, const_values (0));
+	      ostream_set_const (OCHANNEL_AUDIO_OUT2, 0);
 	    }
 	}
       else
@@ -144,13 +144,13 @@ class Compressor : public CompressorBase
 	  if (istream (ICHANNEL_AUDIO_IN2).connected)
 	    {
 	      process_loop <CHANNELS_A1n_A2y> (n_values);
-	      ostream_set (OCHANNEL_AUDIO_OUT1, const_values (0));
+	      ostream_set_const (OCHANNEL_AUDIO_OUT1, 0);
 	    }
 	  else
 	    {
 	      process_loop <CHANNELS_A1n_A2n> (n_values);
-	      ostream_set (OCHANNEL_AUDIO_OUT1, const_values (0));
-	      ostream_set (OCHANNEL_AUDIO_OUT2, const_values (0));
+	      ostream_set_const (OCHANNEL_AUDIO_OUT1, 0);
+	      ostream_set_const (OCHANNEL_AUDIO_OUT2, 0);
 	    }
 	}
     }
@@ -156,8 +156,6 @@ atan_distort_process (BseModule *module,
   AtanDistortModule *admod = (AtanDistortModule*) module->user_data;
   const gfloat *sig_in = module->istreams[BSE_ATAN_DISTORT_ICHANNEL_MONO1].values;
   gfloat *sig_out = module->ostreams[BSE_ATAN_DISTORT_OCHANNEL_MONO1].values;
-  gfloat *bound = sig_out + n_values;
-  gdouble prescale = admod->prescale;
 
   /* we don't need to process any data if our input or
    * output stream isn't connected
@@ -173,9 +171,7 @@ atan_distort_process (BseModule *module,
     }
 
   /* do the mixing */
-  do
-    *sig_out++ = bse_approx_atan1 (prescale * *sig_in++);
-  while (sig_out < bound);
+  Bse::fast_atan1_block (n_values, sig_in, sig_out, admod->prescale);
 }
 
 static void
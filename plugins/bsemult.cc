@@ -70,8 +70,9 @@ multiply_process (BseModule *module,
       }
   if (i >= BSE_MODULE_N_ISTREAMS (module))
     {
-      /* no input, FIXME: should set static-0 here */
-      memset (wave_out, 0, n_values * sizeof (wave_out[0]));
+      /* no input */
+      bse_module_const_ostream (module, 0, 0.0);
+      return;
     }
   for (i += 1; i < BSE_MODULE_N_ISTREAMS (module); i++)
     if (module->istreams[i].connected)
@@ -80,9 +81,17 @@ multiply_process (BseModule *module,
 	gfloat *out = wave_out;
 
 	/* found 1+nth channel to multiply with */
-	do
-	  *out++ *= *in++;
-	while (out < bound);
+	if (module->istreams[i].constant)
+	  {
+	    const gfloat factor = in[0];
+	    do
+	      *out++ *= factor;
+	    while (out < bound);
+	  }
+	else
+	  do
+	    *out++ *= *in++;
+	  while (out < bound);
       }
 }
 
@@ -4,85 +4,67 @@
 #include <bse/bsemain.hh>
 #include "bse/internal.hh"
 #include <vector>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace Bse {
 namespace Dav {
 
 class Organ : public OrganBase {
-  /* per mix_freq() tables */
+  /* process wide tables, shared by all mix_freq() rates */
   class Tables
   {
-    vector<float> m_sine_table, m_triangle_table, m_pulse_table;
-    uint	  m_ref_count, m_rate;
-    Tables (uint urate) :
-      m_sine_table (urate), m_triangle_table (urate), m_pulse_table (urate),
-      m_ref_count (1), m_rate (urate)
+  public:
+    static constexpr uint SIZE_BITS = 10;
+    static constexpr uint SIZE = 1 << SIZE_BITS;
+    static constexpr uint STRIDE = SIZE + 1;    // guard value for linear interpolation
+    enum { SINE = 0, TRIANGLE = STRIDE, PULSE = 2 * STRIDE };
+    static const Tables&
+    instance()
+    {
+      static const Tables tables;
+      return tables;
+    }
+    /// Sine, triangle and pulse tables with SIZE+1 values each, at offsets SINE, TRIANGLE and PULSE.
+    const float*
+    tables() const
     {
-      double rate = urate, half = rate / 2, slope = rate / 10;
-      int    i;
+      return m_tables;
+    }
+  private:
+    float m_tables[3 * STRIDE];
+    Tables()
+    {
+      float *sine_table = m_tables + SINE, *triangle_table = m_tables + TRIANGLE, *pulse_table = m_tables + PULSE;
+      const double size = SIZE, half = size / 2, slope = size / 10;
+      uint i;
       /* Initialize sine table. */
-      for (i = 0; i < rate; i++)
-	m_sine_table[i] = sin (i / rate * 2.0 * PI) / 6.0;
+      for (i = 0; i < SIZE; i++)
+	sine_table[i] = sin (i / size * 2.0 * PI) / 6.0;
       /* Initialize triangle table. */
-      for (i = 0; i < rate / 2; i++)
-	m_triangle_table[i] = (4 / rate * i - 1.0) / 6.0;
-      for (; i < rate; i++)
-	m_triangle_table[i] = (4 / rate * (rate - i) - 1.0) / 6.0;
+      for (i = 0; i < SIZE / 2; i++)
+	triangle_table[i] = (4 / size * i - 1.0) / 6.0;
+      for (; i < SIZE; i++)
+	triangle_table[i] = (4 / size * (size - i) - 1.0) / 6.0;
       /* Initialize beveled pulse table:  _
        *                                 / \
        *                              \_/
        */
       for (i = 0; i < slope; i++)
-	m_pulse_table[i] = -i / slope / 6.0;
+	pulse_table[i] = -(i / slope) / 6.0;
       for (; i < half - slope; i++)
-	m_pulse_table[i] = -1.0 / 6.0;
+	pulse_table[i] = -1.0 / 6.0;
       for (; i < half + slope; i++)
-	m_pulse_table[i] = ((i - half) / slope) / 6.0;
-      for (; i < rate - slope; i++)
-	m_pulse_table[i] = 1.0 / 6.0;
-      for (; i < rate; i++)
-	m_pulse_table[i] = ((rate - i) * 1.0 / slope) / 6.0;
-    }
-    ~Tables()
-    {} // private destructor; use ref_counting
-    static map<uint, Tables*> table_map;        // map of rate specific tables
-    static std::mutex         table_mutex;
-  public:
-    static Tables*
-    ref (uint rate)
-    {
-      std::lock_guard<std::mutex> locker (table_mutex);
-      if (table_map[rate])
-	table_map[rate]->m_ref_count++;
-      else
-	table_map[rate] = new Tables (rate);
-      return table_map[rate];
-    }
-    void
-    unref()
-    {
-      return_unless (m_ref_count > 0);
-      std::lock_guard<std::mutex> locker (table_mutex);
-      if (--m_ref_count == 0)
-	{
-	  table_map[m_rate] = 0;
-	  delete this;
-	}
-    }
-    const float*
-    sine_table() const
-    {
-      return &m_sine_table[0];
-    }
-    const float*
-    triangle_table() const
-    {
-      return &m_triangle_table[0];
-    }
-    const float*
-    pulse_table() const
-    {
-      return &m_pulse_table[0];
+	pulse_table[i] = ((i - half) / slope) / 6.0;
+      for (; i < size - slope; i++)
+	pulse_table[i] = 1.0 / 6.0;
+      for (; i < SIZE; i++)
+	pulse_table[i] = ((size - i) / slope) / 6.0;
+      /* Wrap around values for interpolation. */
+      sine_table[SIZE] = sine_table[0];
+      triangle_table[SIZE] = triangle_table[0];
+      pulse_table[SIZE] = pulse_table[0];
     }
   };
   /* FIXME: get rid of this as soon as the modules have their own current_musical_tuning() accessor */
@@ -95,24 +77,22 @@ class Organ : public OrganBase {
   };
   class Module : public SynthesisModule {
   public:
+    /* the harmonics are rendered as N_LANES SIMD lanes, the last two lanes stay silent */
+    static constexpr uint N_HARMONICS = 6, N_LANES = 8;
+    static constexpr uint FRAC_BITS = 32 - Tables::SIZE_BITS;
     /* frequency */
     double	  m_transpose_factor, m_fine_tune_factor, m_base_freq;
     /* instrument flavour */
     bool	  m_flute, m_reed, m_brass;
     /* harmonics */
     double	  m_harm0, m_harm1, m_harm2, m_harm3, m_harm4, m_harm5;
-    /* phase accumulators */
-    uint32	  m_harm0_paccu, m_harm1_paccu, m_harm2_paccu, m_harm3_paccu, m_harm4_paccu, m_harm5_paccu;
-    /* mix_freq() specific tables */
-    Tables       *m_tables;
+    /* phase accumulators, a full table period wraps around at 2^32 */
+    uint32	  m_paccu[N_LANES];
+    /* mix_freq() independent tables */
+    const Tables &m_tables;
     Module() :
-      m_tables (Tables::ref (mix_freq()))
+      m_paccu(), m_tables (Tables::instance())
     {}
-    ~Module()
-    {
-      m_tables->unref();
-      m_tables = NULL;
-    }
     void
     config (Properties *properties)
     {
@@ -134,31 +114,14 @@ class Organ : public OrganBase {
     reset()
     {
       uint32 rfactor = config_bool ("allow-randomization") ? 1 : 0;
-      uint32 mix_freq_256 = mix_freq() * 256;
       /* to make all notes sound a bit different, randomize the initial phase of
        * each harmonic (except if the user requested deterministic behaviour)
        */
-      m_harm0_paccu = rfactor * g_random_int_range (0, mix_freq_256);
-      m_harm1_paccu = rfactor * g_random_int_range (0, mix_freq_256);
-      m_harm2_paccu = rfactor * g_random_int_range (0, mix_freq_256);
-      m_harm3_paccu = rfactor * g_random_int_range (0, mix_freq_256);
-      m_harm4_paccu = rfactor * g_random_int_range (0, mix_freq_256);
-      m_harm5_paccu = rfactor * g_random_int_range (0, mix_freq_256);
+      for (uint h = 0; h < N_LANES; h++)
+        m_paccu[h] = h < N_HARMONICS ? rfactor * g_random_int() : 0;
     }
-    static inline float
-    table_pos (const float *table,
-	       uint	    freq_256,
-	       uint	    mix_freq_256,
-	       uint32	   *paccu)
-    {
-      *paccu += freq_256;
-      while (*paccu >= mix_freq_256)
-	*paccu -= mix_freq_256;
-
-      return table[*paccu >> 8];
-    }
-    inline uint
-    dfreq_to_freq_256 (double dfreq)
+    inline double
+    dfreq_to_mfreq (double dfreq)
     {
       dfreq *= m_transpose_factor * m_fine_tune_factor;
 
@@ -168,70 +131,89 @@ class Organ : public OrganBase {
        */
       dfreq = std::min (fabs (dfreq), mix_freq() * 0.5);
 
-      /* round frequency with dtoi during conversion from floating point to our
-       * fixed point representation, in order to minimize the conversion error
-       */
-      return dtoi (dfreq * 256);
+      return dfreq / mix_freq();
+    }
+    /* Render the sum of all lanes, each lane reads from `tables + offsets[lane]` with linear
+     * interpolation, advances its phase by `pincs[lane]` per sample and is weighted by `amps[lane]`.
+     */
+    static void
+    render_lanes (uint n_values, float *ovalues, uint32 *paccu, const uint32 *pincs,
+                  const uint32 *offsets, const float *amps, const float *tables)
+    {
+#ifdef __SSE2__
+      const __m128i frac_mask = _mm_set1_epi32 ((1 << FRAC_BITS) - 1);
+      const __m128 frac_scale = _mm_set1_ps (1.0 / (1 << FRAC_BITS));
+      const __m128i inc_a = _mm_loadu_si128 ((const __m128i*) &pincs[0]), inc_b = _mm_loadu_si128 ((const __m128i*) &pincs[4]);
+      const __m128i off_a = _mm_loadu_si128 ((const __m128i*) &offsets[0]), off_b = _mm_loadu_si128 ((const __m128i*) &offsets[4]);
+      const __m128 amp_a = _mm_loadu_ps (&amps[0]), amp_b = _mm_loadu_ps (&amps[4]);
+      __m128i pos_a = _mm_loadu_si128 ((const __m128i*) &paccu[0]), pos_b = _mm_loadu_si128 ((const __m128i*) &paccu[4]);
+      for (uint i = 0; i < n_values; i++)
+	{
+	  alignas (16) uint32 idx[N_LANES];
+	  _mm_store_si128 ((__m128i*) &idx[0], _mm_add_epi32 (_mm_srli_epi32 (pos_a, FRAC_BITS), off_a));
+	  _mm_store_si128 ((__m128i*) &idx[4], _mm_add_epi32 (_mm_srli_epi32 (pos_b, FRAC_BITS), off_b));
+	  const __m128 frac_a = _mm_mul_ps (_mm_cvtepi32_ps (_mm_and_si128 (pos_a, frac_mask)), frac_scale);
+	  const __m128 frac_b = _mm_mul_ps (_mm_cvtepi32_ps (_mm_and_si128 (pos_b, frac_mask)), frac_scale);
+	  // load adjacent table value pairs per lane, then deinterleave into v0 and v1
+	  const __m128 p01 = _mm_loadh_pi (_mm_castpd_ps (_mm_load_sd ((const double*) &tables[idx[0]])), (const __m64*) &tables[idx[1]]);
+	  const __m128 p23 = _mm_loadh_pi (_mm_castpd_ps (_mm_load_sd ((const double*) &tables[idx[2]])), (const __m64*) &tables[idx[3]]);
+	  const __m128 p45 = _mm_loadh_pi (_mm_castpd_ps (_mm_load_sd ((const double*) &tables[idx[4]])), (const __m64*) &tables[idx[5]]);
+	  const __m128 p67 = _mm_loadh_pi (_mm_castpd_ps (_mm_load_sd ((const double*) &tables[idx[6]])), (const __m64*) &tables[idx[7]]);
+	  const __m128 v0_a = _mm_shuffle_ps (p01, p23, _MM_SHUFFLE (2, 0, 2, 0)), v1_a = _mm_shuffle_ps (p01, p23, _MM_SHUFFLE (3, 1, 3, 1));
+	  const __m128 v0_b = _mm_shuffle_ps (p45, p67, _MM_SHUFFLE (2, 0, 2, 0)), v1_b = _mm_shuffle_ps (p45, p67, _MM_SHUFFLE (3, 1, 3, 1));
+	  const __m128 v_a = _mm_add_ps (v0_a, _mm_mul_ps (_mm_sub_ps (v1_a, v0_a), frac_a));
+	  const __m128 v_b = _mm_add_ps (v0_b, _mm_mul_ps (_mm_sub_ps (v1_b, v0_b), frac_b));
+	  __m128 vaccu = _mm_add_ps (_mm_mul_ps (v_a, amp_a), _mm_mul_ps (v_b, amp_b));
+	  vaccu = _mm_add_ps (vaccu, _mm_movehl_ps (vaccu, vaccu));
+	  vaccu = _mm_add_ss (vaccu, _mm_shuffle_ps (vaccu, vaccu, 1));
+	  _mm_store_ss (&ovalues[i], vaccu);
+	  pos_a = _mm_add_epi32 (pos_a, inc_a);
+	  pos_b = _mm_add_epi32 (pos_b, inc_b);
+	}
+      _mm_storeu_si128 ((__m128i*) &paccu[0], pos_a);
+      _mm_storeu_si128 ((__m128i*) &paccu[4], pos_b);
+#else
+      for (uint i = 0; i < n_values; i++)
+	{
+	  float vaccu = 0;
+	  for (uint h = 0; h < N_LANES; h++)
+	    {
+	      const float *t = tables + offsets[h] + (paccu[h] >> FRAC_BITS);
+	      const float frac = (paccu[h] & ((1 << FRAC_BITS) - 1)) * (1.0f / (1 << FRAC_BITS));
+	      vaccu += (t[0] + (t[1] - t[0]) * frac) * amps[h];
+	      paccu[h] += pincs[h];
+	    }
+	  ovalues[i] = vaccu;
+	}
+#endif
     }
     void
     process (unsigned int n_values)
     {
-      const float *sine_table = m_tables->sine_table();
-      const float *flute_table = m_flute ? m_tables->triangle_table() : sine_table;
-      const float *reed_table = m_reed ? m_tables->pulse_table() : sine_table;
+      const uint32 sine_table = Tables::SINE;
+      const uint32 flute_table = m_flute ? Tables::TRIANGLE : sine_table;
+      const uint32 reed_table = m_reed ? Tables::PULSE : sine_table;
       const float *ifreq = istream (ICHANNEL_FREQ_IN).values;
       float	  *ovalues = ostream (OCHANNEL_AUDIO_OUT).values;
-      uint         freq_256;
+      double       mfreq;
 
       if (istream (ICHANNEL_FREQ_IN).connected)
-	freq_256 = dfreq_to_freq_256 (BSE_FREQ_FROM_VALUE (ifreq[0]));
-      else
-	freq_256 = dfreq_to_freq_256 (m_base_freq);
-
-      uint mix_freq_256 = mix_freq() * 256;
-      uint freq_256_harm0 = freq_256 / 2;
-      uint freq_256_harm1 = freq_256;
-
-      if (m_brass)
-	{
-	  uint freq_256_harm2 = freq_256 * 2;
-	  uint freq_256_harm3 = freq_256_harm2 * 2;
-	  uint freq_256_harm4 = freq_256_harm3 * 2;
-	  uint freq_256_harm5 = freq_256_harm4 * 2;
-
-	  for (uint i = 0; i < n_values; i++)
-	    {
-	      float vaccu;
-
-	      vaccu  = table_pos (sine_table,  freq_256_harm0, mix_freq_256, &m_harm0_paccu) * m_harm0;
-	      vaccu += table_pos (sine_table,  freq_256_harm1, mix_freq_256, &m_harm1_paccu) * m_harm1;
-	      vaccu += table_pos (reed_table,  freq_256_harm2, mix_freq_256, &m_harm2_paccu) * m_harm2;
-	      vaccu += table_pos (sine_table,  freq_256_harm3, mix_freq_256, &m_harm3_paccu) * m_harm3;
-	      vaccu += table_pos (flute_table, freq_256_harm4, mix_freq_256, &m_harm4_paccu) * m_harm4;
-	      vaccu += table_pos (flute_table, freq_256_harm5, mix_freq_256, &m_harm5_paccu) * m_harm5;
-	      ovalues[i] = vaccu;
-	    }
-	}
+	mfreq = dfreq_to_mfreq (BSE_FREQ_FROM_VALUE (ifreq[0]));
       else
-	{
-	  uint freq_256_harm2 = freq_256 * 3 / 2;
-	  uint freq_256_harm3 = freq_256 * 2;
-	  uint freq_256_harm4 = freq_256 * 3;
-	  uint freq_256_harm5 = freq_256_harm3 * 2;
+	mfreq = dfreq_to_mfreq (m_base_freq);
 
-	  for (uint i = 0; i < n_values; i++)
-	    {
-	      float vaccu;
+      /* per lane frequency ratios and tables */
+      static const double brass_ratios[N_LANES] = { 0.5, 1, 2, 4, 8, 16, 0, 0 };
+      static const double organ_ratios[N_LANES] = { 0.5, 1, 1.5, 2, 3, 4, 0, 0 };
+      const double *ratios = m_brass ? brass_ratios : organ_ratios;
+      const uint32 brass_offsets[N_LANES] = { sine_table, sine_table, reed_table, sine_table, flute_table, flute_table, 0, 0 };
+      const uint32 organ_offsets[N_LANES] = { sine_table, sine_table, sine_table, reed_table, sine_table, flute_table, 0, 0 };
+      const float amps[N_LANES] = { float (m_harm0), float (m_harm1), float (m_harm2), float (m_harm3), float (m_harm4), float (m_harm5), 0, 0 };
+      uint32 pincs[N_LANES];
+      for (uint h = 0; h < N_LANES; h++)
+	pincs[h] = int64 (mfreq * ratios[h] * 4294967296.0);    // harmonics above 1.0 wrap around
 
-	      vaccu  = table_pos (sine_table,  freq_256_harm0, mix_freq_256, &m_harm0_paccu) * m_harm0;
-	      vaccu += table_pos (sine_table,  freq_256_harm1, mix_freq_256, &m_harm1_paccu) * m_harm1;
-	      vaccu += table_pos (sine_table,  freq_256_harm2, mix_freq_256, &m_harm2_paccu) * m_harm2;
-	      vaccu += table_pos (reed_table,  freq_256_harm3, mix_freq_256, &m_harm3_paccu) * m_harm3;
-	      vaccu += table_pos (sine_table,  freq_256_harm4, mix_freq_256, &m_harm4_paccu) * m_harm4;
-	      vaccu += table_pos (flute_table, freq_256_harm5, mix_freq_256, &m_harm5_paccu) * m_harm5;
-	      ovalues[i] = vaccu;
-	    }
-	}
+      render_lanes (n_values, ovalues, m_paccu, pincs, m_brass ? brass_offsets : organ_offsets, amps, m_tables.tables());
     }
   };
 public:
@@ -257,9 +239,6 @@ public:
   BSE_EFFECT_INTEGRATE_MODULE (Organ, Module, Properties);
 };
 
-map<uint, Organ::Tables*> Organ::Tables::table_map;
-std::mutex                Organ::Tables::table_mutex;
-
 BSE_CXX_DEFINE_EXPORTS();
 BSE_CXX_REGISTER_EFFECT (Organ);
 
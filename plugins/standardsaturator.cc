@@ -116,6 +116,29 @@ class Saturator : public SaturatorBase {
         return bse_approx_atan1 (input * prescale);
       }
     };
+    // SIMD block variants for the saturation curves that have one
+    inline void
+    process_block (guint              n_values,
+                   const float       *in,
+                   float             *out,
+                   const SaturateTanh saturate)
+    {
+      fast_tanh_block (n_values, in, out, saturate.prescale);
+      if (olevel != 1)
+        for (guint i = 0; i < n_values; i++)
+          out[i] *= olevel;
+    }
+    inline void
+    process_block (guint              n_values,
+                   const float       *in,
+                   float             *out,
+                   const SaturateAtan saturate)
+    {
+      fast_atan1_block (n_values, in, out, saturate.prescale);
+      if (olevel != 1)
+        for (guint i = 0; i < n_values; i++)
+          out[i] *= olevel;
+    }
     struct SaturateQuadratic {
       double limit;
       SaturateQuadratic (double h) :
@@ -356,4 +356,36 @@ test_aida_any_containers()
 }
 TEST_ADD (test_aida_any_containers);
 
+static void
+test_aida_event_dispatcher()
+{
+  EventDispatcher edispatcher;
+  int n_notify = 0, n_foo = 0, n_other = 0;
+  auto c1 = edispatcher.attach ("notify", [&] (const Event&) { n_notify++; });
+  auto c2 = edispatcher.attach ("notify:foo", [&] (const Event&) { n_foo++; });
+  auto c3 = edispatcher.attach ("other", [&] (const Event&) { n_other++; });
+  edispatcher.emit (Event ("notify:foo"));
+  edispatcher.emit (Event ("notify:bar"));
+  edispatcher.emit (Event ("other"));
+  TCMP (n_notify, ==, 2);
+  TCMP (n_foo, ==, 1);
+  TCMP (n_other, ==, 1);
+  // interned event IDs
+  const EventDispatcher::EventId foo_id = EventDispatcher::event_id ("notify:foo");
+  bool newly_interned = true;
+  TCMP (EventDispatcher::event_id ("notify:foo", &newly_interned), ==, foo_id);
+  TASSERT (newly_interned == false);
+  TCMP (EventDispatcher::event_type (foo_id), ==, "notify:foo");
+  TCMP (EventDispatcher::general_id (foo_id), ==, EventDispatcher::event_id ("notify"));
+  TCMP (EventDispatcher::event_id (""), ==, 0u);
+  edispatcher.emit (Event ("notify:foo"), foo_id);
+  TCMP (n_notify, ==, 3);
+  TCMP (n_foo, ==, 2);
+  c2.disconnect();
+  edispatcher.emit (Event ("notify:foo"), foo_id);
+  TCMP (n_notify, ==, 4);
+  TCMP (n_foo, ==, 2);
+}
+TEST_ADD (test_aida_event_dispatcher);
+
 } // Anon
@@ -2,7 +2,15 @@
 #include <bse/testing.hh>
 #include <bse/unicode.hh>
 #include <bse/memory.hh>
+#include <bse/bsemain.hh>
+#include <bse/bsesoundfontosc.hh>
+#include <bse/bseengine.hh>
+#include <bse/bseblockutils.hh>
+#include <bse/midilib.hh>
+#include <bse/path.hh>
 #include <cmath>
+#include <thread>
+#include <condition_variable>
 
 static constexpr size_t RUNS = 1;
 static constexpr double MAXTIME = 0.15;
@@ -368,4 +376,370 @@ aligned_allocator_bench31_fast_mem_alloc()
 }
 TEST_BENCH (aligned_allocator_bench31_fast_mem_alloc);
 
+template<AllocatorType AT> static void
+bse_aligned_allocator_mt_benchloop (uint32 seed)
+{
+  constexpr const int64 MAX_CHUNK_SIZE = 4096;
+  constexpr const int64 N_ALLOCS = 4093;
+  constexpr const int64 RESIDENT = N_ALLOCS / 3;
+  const uint n_threads = std::max (2, std::min (8, Bse::this_thread_online_cpus()));
+  std::atomic<uint64> accu { 0 };
+  // every thread allocates and releases with its own random sequence, contending for the allocator
+  auto thread_loop = [&] (uint32 rand_seed) {
+    std::vector<FastMemory::Block> blocks (N_ALLOCS);
+    uint64 sum = 0;
+    for (size_t i = 0; i < N_ALLOCS; i++)
+      {
+        rand_seed = 1664525 * rand_seed + 1013904223;
+        const size_t length = 1 + ((uint64 (rand_seed) * MAX_CHUNK_SIZE) >> 32);
+        blocks[i] = TestAllocator<AT>::allocate_block (length);
+        sum += *((uint8*) blocks[i].block_start);
+        if (i > RESIDENT)
+          {
+            FastMemory::Block &rblock = blocks[i - RESIDENT];
+            TestAllocator<AT>::release_block (rblock);
+            rblock = {};
+          }
+      }
+    for (size_t i = 0; i < N_ALLOCS; i++)
+      if (blocks[i].block_length)
+        TestAllocator<AT>::release_block (blocks[i]);
+    accu += sum;
+  };
+  auto loop_mt = [&] () {
+    std::vector<std::thread> threads;
+    for (uint t = 0; t < n_threads; t++)
+      threads.push_back (std::thread (thread_loop, seed + t));
+    for (auto &thread : threads)
+      thread.join();
+  };
+  Bse::Test::Timer timer (0.1);
+  const double bench_mt = timer.benchmark (loop_mt);
+  const size_t n_allocations = n_threads * N_ALLOCS;
+  const double ns_p_a = 1000000000.0 * bench_mt / n_allocations;
+  Bse::printerr ("  BENCH    %-21s %u allocations in %u threads, %.1f msecs, %.1fnsecs/allocation\n",
+                 TestAllocator<AT>::name() + ":", n_allocations, n_threads, 1000 * bench_mt, ns_p_a);
+  if (AT == AllocatorType::FastMemAlloc)
+    TASSERT (accu == 0); // fast_mem_alloc() yields zeroed memory
+}
+
+static void
+aligned_allocator_bench31_mt_fast_mem_alloc()
+{
+  ensure_block_allocator_initialization();
+  bse_aligned_allocator_mt_benchloop<AllocatorType::FastMemAlloc> (2654435769);
+}
+TEST_BENCH (aligned_allocator_bench31_mt_fast_mem_alloc);
+
+static void
+aligned_allocator_bench31_mt_memalign()
+{
+  ensure_block_allocator_initialization();
+  bse_aligned_allocator_mt_benchloop<AllocatorType::PosixMemalign> (2654435769);
+}
+TEST_BENCH (aligned_allocator_bench31_mt_memalign);
+
+// == CString Tests ==
+static void
+cstring_quark_bench()
+{
+  constexpr const size_t N_STRINGS = 100000, BATCH = 10000;
+  std::vector<std::string> strings;
+  for (size_t i = 0; i < N_STRINGS; i++)
+    strings.push_back (Bse::string_format ("cstring_quark_bench-%u-%x", i, i * 2654435769u));
+  // first time interning, must not slow down with the number of known quarks
+  std::vector<Bse::CString> cstrings (N_STRINGS);
+  double first_batch = 0, last_batch = 0;
+  for (size_t b = 0; b < N_STRINGS; b += BATCH)
+    {
+      const uint64_t start = Bse::timestamp_benchmark();
+      for (size_t i = b; i < b + BATCH; i++)
+        cstrings[i] = strings[i];
+      const double ns = (Bse::timestamp_benchmark() - start) / double (BATCH);
+      if (b == 0)
+        first_batch = ns;
+      last_batch = ns;
+    }
+  for (size_t i = 0; i < N_STRINGS; i++)
+    TASSERT (cstrings[i] == strings[i] && Bse::CString::lookup (strings[i]) == cstrings[i]);
+  Bse::printerr ("  BENCH    CString::assign new:      %7.1f nsecs/string (first %u), %7.1f nsecs/string (last %u of %u)\n",
+                 first_batch, BATCH, last_batch, BATCH, N_STRINGS);
+  // re-interning existing strings, takes the lock-free lookup path
+  size_t accu = 0;
+  auto loop_assign = [&] () {
+    for (size_t i = 0; i < N_STRINGS; i++)
+      {
+        Bse::CString c = strings[i];
+        accu += c.string().size();
+      }
+  };
+  Bse::Test::Timer timer (MAXTIME);
+  const double assign_time = timer.benchmark (loop_assign);
+  Bse::printerr ("  BENCH    CString::assign existing: %7.1f nsecs/string (%u quarks)\n", assign_time * 1e9 / N_STRINGS, N_STRINGS);
+  TASSERT (accu > 0);
+}
+TEST_BENCH (cstring_quark_bench);
+
+// == SoundFont Tests ==
+struct SoundFontTrack {
+  fluid_settings_t *settings = nullptr;
+  fluid_synth_t    *synth = nullptr;
+};
+
+// Render a soundfont track like the BseSoundFontOsc module does.
+static void
+soundfont_track_process (BseModule *module, uint n_values)
+{
+  SoundFontTrack *track = (SoundFontTrack*) module->user_data;
+  float *channels[2] = { BSE_MODULE_OBUFFER (module, 0), BSE_MODULE_OBUFFER (module, 1) };
+  Bse::Block::fill (n_values, channels[0], 0.0);
+  Bse::Block::fill (n_values, channels[1], 0.0);
+  fluid_synth_process (track->synth, n_values, 0, nullptr, 2, channels);
+}
+
+struct SoundFontMixdown {
+  static constexpr uint   N_TRACKS = 16;
+  std::mutex              mutex;
+  std::condition_variable cond;
+  uint                    blocks_left = 0;
+  double                  accu = 0;
+};
+
+// Consume all track outputs, so a block is counted after all tracks rendered it.
+static void
+soundfont_mixdown_process (BseModule *module, uint n_values)
+{
+  SoundFontMixdown *mixdown = (SoundFontMixdown*) module->user_data;
+  double accu = 0;
+  for (uint i = 0; i < 2 * SoundFontMixdown::N_TRACKS; i++)
+    accu += module->istreams[i].values[n_values - 1];
+  std::lock_guard<std::mutex> locker (mixdown->mutex);
+  mixdown->accu += accu;
+  if (mixdown->blocks_left && --mixdown->blocks_left == 0)
+    mixdown->cond.notify_all();
+}
+
+static gboolean
+soundfont_mixdown_poll (gpointer data, guint n_values, glong *timeout_p, guint n_fds, const GPollFD *fds, gboolean revents_filled)
+{
+  SoundFontMixdown *mixdown = (SoundFontMixdown*) data;
+  std::lock_guard<std::mutex> locker (mixdown->mutex);
+  if (mixdown->blocks_left)
+    return true;
+  *timeout_p = 1;       // check again for blocks to render
+  return false;
+}
+
+static void
+soundfont_tracks_bench()
+{
+  const std::string sf2file = "tests/audio/minfluid.sf2";
+  if (!Bse::Path::check (sf2file, "r"))
+    {
+      Bse::printerr ("  SKIP     %s: missing %s\n", __func__, sf2file);
+      return;
+    }
+  constexpr const uint N_TRACKS = SoundFontMixdown::N_TRACKS, N_BLOCKS = 64;
+  static const BseModuleClass track_class = { 0, 0, 2, soundfont_track_process, NULL, NULL, NULL, Bse::ModuleFlag::EXPENSIVE };
+  static const BseModuleClass mixdown_class = { 2 * N_TRACKS, 0, 0, soundfont_mixdown_process, NULL, NULL, NULL, Bse::ModuleFlag::CHEAP };
+  uint mix_freq = 0, block_size = 0;
+  Bse::jobs += [&] () {
+    mix_freq = bse_engine_sample_freq();
+    block_size = bse_engine_block_size();
+  };
+  std::vector<SoundFontTrack> tracks (N_TRACKS);
+  for (uint t = 0; t < N_TRACKS; t++)
+    {
+      SoundFontTrack &track = tracks[t];
+      int sfont_id = -1;
+      track.synth = bse_sound_font_osc_new_track_synth (sf2file, mix_freq, &track.settings, &sfont_id);
+      TASSERT (track.synth && sfont_id >= 0);
+      fluid_synth_program_select (track.synth, 0, sfont_id, 0, 0);
+      for (uint n = 0; n < 6; n++)       // sustained chord per track
+        fluid_synth_noteon (track.synth, 0, 36 + t + n * 7, 100);
+    }
+  // render all tracks in a single thread
+  std::vector<float> left (block_size), right (block_size);
+  double serial_accu = 0;
+  auto loop_serial = [&] () {
+    for (auto &track : tracks)
+      for (uint b = 0; b < N_BLOCKS; b++)
+        {
+          float *channels[2] = { left.data(), right.data() };
+          std::fill (left.begin(), left.end(), 0.0);
+          std::fill (right.begin(), right.end(), 0.0);
+          fluid_synth_process (track.synth, block_size, 0, nullptr, 2, channels);
+          serial_accu += left[block_size - 1] + right[block_size - 1];
+        }
+  };
+  // let the engine schedule the tracks as independent nodes via thread_process_nodes()
+  SoundFontMixdown mixdown;
+  std::vector<BseModule*> modules;
+  BseModule *mixmodule = NULL;
+  Bse::jobs += [&] () {
+    BseTrans *trans = bse_trans_open();
+    mixmodule = bse_module_new (&mixdown_class, &mixdown);
+    bse_trans_add (trans, bse_job_integrate (mixmodule));
+    bse_trans_add (trans, bse_job_set_consumer (mixmodule, true));
+    for (uint t = 0; t < N_TRACKS; t++)
+      {
+        BseModule *module = bse_module_new (&track_class, &tracks[t]);
+        modules.push_back (module);
+        bse_trans_add (trans, bse_job_integrate (module));
+        bse_trans_add (trans, bse_job_connect (module, 0, mixmodule, 2 * t));
+        bse_trans_add (trans, bse_job_connect (module, 1, mixmodule, 2 * t + 1));
+      }
+    bse_trans_add (trans, bse_job_add_poll (soundfont_mixdown_poll, &mixdown, NULL, 0, NULL));
+    bse_trans_commit (trans);
+    bse_engine_wait_on_trans();
+  };
+  auto loop_engine = [&] () {
+    std::unique_lock<std::mutex> locker (mixdown.mutex);
+    mixdown.blocks_left = N_BLOCKS;
+    mixdown.cond.wait (locker, [&] () { return mixdown.blocks_left == 0; });
+  };
+  const double n_samples = N_TRACKS * N_BLOCKS * block_size;
+  Bse::Test::Timer timer (MAXTIME);
+  const double serial_time = timer.benchmark (loop_serial);
+  Bse::printerr ("  BENCH    SoundFont %u tracks, 1 thread:   %11.1f MSamples/s\n", N_TRACKS, n_samples / serial_time / M);
+  const double engine_time = timer.benchmark (loop_engine);
+  Bse::printerr ("  BENCH    SoundFont %u tracks, engine:     %11.1f MSamples/s (%.2fx, %u CPUs)\n", N_TRACKS,
+                 n_samples / engine_time / M, serial_time / engine_time, Bse::this_thread_online_cpus());
+  Bse::jobs += [&] () {
+    BseTrans *trans = bse_trans_open();
+    bse_trans_add (trans, bse_job_remove_poll (soundfont_mixdown_poll, &mixdown));
+    bse_trans_add (trans, bse_job_discard (mixmodule));
+    for (BseModule *module : modules)
+      bse_trans_add (trans, bse_job_discard (module));
+    bse_trans_commit (trans);
+    bse_engine_wait_on_trans();
+  };
+  TASSERT (!std::isnan (serial_accu) && !std::isnan (mixdown.accu));
+  for (auto &track : tracks)
+    {
+      delete_fluid_synth (track.synth);
+      delete_fluid_settings (track.settings);
+    }
+}
+TEST_BENCH (soundfont_tracks_bench);
+
+// == Clip Scheduler Tests ==
+static void
+clip_scheduler_bench()
+{
+  using namespace Bse;
+  using OrderedEvents = std::remove_const_t<MidiLib::ClipEventVectorP::element_type>;
+  constexpr const int64_t N_NOTES = 100000, PPQ = 384, BLOCK_TICKS = 2;
+  // dense clip, 4 notes per tick with long sustained chords of up to 4 bars
+  std::vector<PartNote> notes;
+  for (int64_t i = 0; i < N_NOTES; i++)
+    {
+      PartNote note;
+      note.id = i + 1;
+      note.channel = 0;
+      note.tick = i / 4;
+      note.key = 24 + i % 4 * 12 + i / 4 % 12;
+      note.duration = 1 + (i * 7919) % (16 * PPQ);
+      note.velocity = 0.5;
+      notes.push_back (note);
+    }
+  MidiLib::ClipEventVectorP events = std::make_shared<const OrderedEvents> (notes);
+  const int64_t clip_length = N_NOTES / 4;
+  size_t n_on = 0, n_off = 0;
+  int64_t last_tick = -1;
+  MidiLib::ClipScheduler scheduler;
+  scheduler.loop (false);
+  auto loop_render = [&] () {
+    MidiLib::ClipScheduleP schedule = std::make_shared<MidiLib::ClipSchedule>();
+    schedule->add_clip (events, 0, clip_length);
+    scheduler.swap_schedule (schedule);
+    scheduler.reset();
+    n_on = n_off = 0;
+    last_tick = -1;
+    for (int64_t tick = 0; tick < clip_length + 16 * PPQ + BLOCK_TICKS; tick += BLOCK_TICKS)
+      scheduler.advance (tick, BLOCK_TICKS, true, [&] (int64_t offset, const AudioSignal::Event &ev) {
+        TASSERT (tick + offset >= last_tick);
+        last_tick = tick + offset;
+        if (ev.type == AudioSignal::Event::NOTE_ON)
+          n_on++;
+        else
+          n_off++;
+      });
+  };
+  Bse::Test::Timer timer (MAXTIME);
+  const double bench_time = timer.benchmark (loop_render);
+  TCMP (n_on, ==, size_t (N_NOTES));
+  TCMP (n_off, ==, size_t (N_NOTES));
+  TCMP (scheduler.n_pending(), ==, size_t (0));
+  Bse::printerr ("  BENCH    ClipScheduler %u notes: %11.1f notes/msec (%.3f msecs)\n",
+                 N_NOTES, N_NOTES / bench_time / 1000.0, bench_time * 1000.0);
+}
+TEST_BENCH (clip_scheduler_bench);
+
+// == BlepSynth Tests ==
+namespace {
+using namespace Bse::AudioSignal;
+
+// Emit a chord of `n_notes` with the next render block.
+class BenchNoteSource : public Processor {
+  void query_info (ProcessorInfo &info) const override { info.uri = "Bse.Test.BenchNoteSource"; info.label = "BenchNoteSource"; }
+  void reset      () override {}
+  void
+  configure (uint n_ibuses, const SpeakerArrangement *ibuses, uint n_obuses, const SpeakerArrangement *obuses) override
+  {
+    remove_all_buses();
+    prepare_event_output();
+  }
+  void
+  render (uint n_frames) override
+  {
+    EventStream &evout = get_event_output();
+    for (uint i = 0; i < n_notes; i++)
+      evout.append (0, make_note_on (0, 24 + i * 2, 0.8));
+    n_notes = 0;
+  }
+public:
+  uint n_notes = 0;
+};
+static auto bench_note_source = Bse::enroll_asp<BenchNoteSource>();
+
+struct BenchProcessorManager : ProcessorManager {
+  using ProcessorManager::pm_connect_events;
+};
+
+static void
+blepsynth_voices_bench()
+{
+  const uint N_BLOCKS = 64, SAMPLE_RATE = 48000;
+  for (uint n_voices : { 1, 4, 8, 16, 32 })
+    {
+      AudioTiming timing { 120, 0 };
+      Engine engine (SAMPLE_RATE, timing, [] () {});
+      ProcessorP synth = Processor::registry_create (engine, "Bse.BlepSynth");
+      ProcessorP source = Processor::registry_create (engine, "Bse.Test.BenchNoteSource");
+      TASSERT (synth && source);
+      BenchProcessorManager::pm_connect_events (*source, *synth);
+      engine.add_root (synth);
+      engine.make_schedule();
+      dynamic_cast<BenchNoteSource&> (*source).n_notes = n_voices;
+      engine.render_block();    // start all voices
+      double accu = 0;
+      auto loop_render = [&] () {
+        for (uint b = 0; b < N_BLOCKS; b++)
+          {
+            engine.render_block();
+            accu += synth->ofloats (OBusId (1), 0)[0];
+          }
+      };
+      Bse::Test::Timer timer (MAXTIME);
+      const double bench_time = timer.benchmark (loop_render);
+      const double realtime = N_BLOCKS * MAX_RENDER_BLOCK_SIZE / double (SAMPLE_RATE);
+      TASSERT (!std::isnan (accu));
+      Bse::printerr ("  BENCH    BlepSynth %2u voices: %11.1f voices/core (%.3f msecs per block)\n",
+                     n_voices, n_voices * realtime / bench_time, bench_time * 1000.0 / N_BLOCKS);
+      engine.del_root (synth);
+    }
+}
+TEST_BENCH (blepsynth_voices_bench);
+
 } // Anon
@@ -6,6 +6,16 @@
 #include <bse/bsecxxplugin.hh> // for generated types
 #include "jsonipc/testjsonipc.cc" // test_jsonipc
 #include <bse/signalmath.hh>
+#include <bse/gsloscillator.hh>
+#include <bse/fftplan.hh>
+#include <bse/gslvorbis-enc.hh>
+#include <bse/gsldatahandle-vorbis.hh>
+#include <bse/path.hh>
+#include <bse/resourceindex.hh>
+#include <bse/randomhash.hh>
+#include <unistd.h>
+#include <bse/processor.hh>
+#include <bse/bseengine.hh>
 
 static void
 test_jsonipc_functions()
@@ -330,6 +340,666 @@ fast_math_bench()
 }
 TEST_BENCH (fast_math_bench);
 
+static void
+test_fast_math_blocks()
+{
+  // accuracy table: maximum error of block functions against libm and against the scalar approximations
+  struct BlockFun {
+    const char *name;
+    float       start, end, step, prescale, max_error;
+    std::function<void (uint, const float*, float*, float)> block;
+    std::function<double (float)> scalar;
+    std::function<double (double)> exact;
+  };
+  const BlockFun funs[] = {
+    { "fast_exp2_block", -1, +1, 0.0001, 1, 4e-7,
+      [] (uint n, const float *i, float *o, float) { fast_exp2_block (n, i, o); }, fast_exp2,
+      [] (double x) { return ::exp2 (x); } },
+    { "fast_log2_block", 1e-7, +1, 0.00001, 1, 3.8e-6,
+      [] (uint n, const float *i, float *o, float) { fast_log2_block (n, i, o); }, fast_log2,
+      [] (double x) { return ::log2 (x); } },
+    { "fast_tanh_block", -5, +5, 0.0001, 1, 2e-6,
+      [] (uint n, const float *i, float *o, float p) { fast_tanh_block (n, i, o, p); }, bse_approx4_tanh,
+      [] (double x) { return ::tanh (x); } },
+    { "fast_atan1_block", -5, +5, 0.0001, 1, 1e-2,
+      [] (uint n, const float *i, float *o, float p) { fast_atan1_block (n, i, o, p); }, bse_approx_atan1,
+      [] (double x) { return ::atan (x) * (2 / M_PI); } },
+  };
+  TNOTE ("Block functions: %s", fast_math_block_impl());
+  for (const auto &f : funs)
+    {
+      std::vector<float> input, output;
+      for (float x = f.start; x < f.end; x += f.step)
+        input.push_back (x);
+      input.push_back (f.end);
+      output.resize (input.size());
+      f.block (input.size(), input.data(), output.data(), f.prescale);
+      double exact_error = 0, scalar_error = 0;
+      for (size_t i = 0; i < input.size(); i++)
+        {
+          exact_error = std::max (exact_error, fabs (output[i] - f.exact (input[i] * f.prescale)));
+          scalar_error = std::max (scalar_error, fabs (output[i] - f.scalar (input[i] * f.prescale)));
+        }
+      TNOTE ("%-18s [%+g,%+g]: error=%.9f (%.1f bit) scalar_diff=%.9f", f.name, f.start, f.end,
+             exact_error, -log2 (exact_error), scalar_error);
+      TCMP (exact_error, <, f.max_error);
+      TCMP (scalar_error, <, 1e-5);
+    }
+  // saturation outside of the approximation range
+  float sat[6] = { -1000, -21, -20, 20, 21, 1000 };
+  fast_tanh_block (6, sat, sat);
+  for (size_t i = 0; i < 6; i++)
+    TCMP (fabs (fabs (sat[i]) - 1), <, 1e-7);
+  // odd lengths and in-place processing
+  for (uint n = 0; n < 19; n++)
+    {
+      float values[19], expected[19];
+      for (uint i = 0; i < n; i++)
+        {
+          values[i] = i * 0.37 - 3;
+          expected[i] = bse_approx_atan1 (values[i] * 0.5);
+        }
+      fast_atan1_block (n, values, values, 0.5);
+      for (uint i = 0; i < n; i++)
+        TCMP (fabs (values[i] - expected[i]), <, 1e-6);
+    }
+}
+TEST_ADD (test_fast_math_blocks);
+
+static void
+fast_math_block_bench()
+{
+  const uint n_values = 256;
+  float input[n_values], output[n_values];
+  for (uint i = 0; i < n_values; i++)
+    input[i] = sin (i * 0.1) * 3;
+  Test::Timer timer (0.15); // maximum seconds
+  double t;
+  auto print_bench = [] (const char *name, double secs) {
+    TBENCH ("%-22s # timing: fastest=%fs values=%.1f/s\n", name, secs, n_values / secs);
+  };
+  t = timer.benchmark ([&] () { fast_exp2_block (n_values, input, output); });
+  print_bench ("fast_exp2_block", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) output[i] = fast_exp2 (input[i]); });
+  print_bench ("fast_exp2", t);
+  t = timer.benchmark ([&] () { fast_log2_block (n_values, output, input); });
+  print_bench ("fast_log2_block", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) input[i] = fast_log2 (output[i]); });
+  print_bench ("fast_log2", t);
+  t = timer.benchmark ([&] () { fast_tanh_block (n_values, input, output, 0.7); });
+  print_bench ("fast_tanh_block", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) output[i] = bse_approx4_tanh (0.7 * input[i]); });
+  print_bench ("bse_approx4_tanh", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) output[i] = tanhf (0.7 * input[i]); });
+  print_bench ("tanhf", t);
+  t = timer.benchmark ([&] () { fast_atan1_block (n_values, input, output, 0.7); });
+  print_bench ("fast_atan1_block", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) output[i] = bse_approx_atan1 (0.7 * input[i]); });
+  print_bench ("bse_approx_atan1", t);
+  t = timer.benchmark ([&] () { for (uint i = 0; i < n_values; i++) output[i] = atanf (0.7 * input[i]); });
+  print_bench ("atanf", t);
+  TASSERT (!std::isnan (output[0]));
+}
+TEST_BENCH (fast_math_block_bench);
+
+static void
+test_osc_wave_bank()
+{
+  // tables of different mix rates share the mip levels for the same relative frequency
+  GslOscTable *t44 = gsl_osc_table_create (44100, GSL_OSC_WAVE_SAW_RISE, bse_window_blackman);
+  GslOscTable *t96 = gsl_osc_table_create (96000, GSL_OSC_WAVE_SAW_RISE, bse_window_blackman);
+  TASSERT (t44->bank == t96->bank);
+  GslOscWave w44, w96;
+  gsl_osc_table_lookup (t44, 441, &w44);
+  gsl_osc_table_lookup (t96, 960, &w96);
+  TASSERT (w44.values == w96.values && w44.xvalues == w96.xvalues);
+  TCMP (fabs (w44.xfade - w96.xfade), <, 1e-6);
+  // the crossfaded levels may not contain partials above nyquist
+  for (double freq = 20; freq < 22050; freq *= 1.1)
+    {
+      GslOscWave wave;
+      gsl_osc_table_lookup (t44, freq, &wave);
+      TASSERT (freq > wave.min_freq && freq <= wave.max_freq);
+      TASSERT (wave.xfade >= 0 && wave.xfade <= 1);
+      std::vector<float> mixed (wave.n_values), spectrum (wave.n_values);
+      for (uint i = 0; i < wave.n_values; i++)
+        mixed[i] = wave.values[i] + (wave.xvalues[i] - wave.values[i]) * wave.xfade;
+      FFTPlan::real_plan (wave.n_values)->fftar (mixed.data(), spectrum.data());
+      const double fundamental = hypot (spectrum[2], spectrum[3]);
+      for (uint h = 2; h < wave.n_values / 2; h++)
+        if (h * freq > 22050)
+          TCMP (hypot (spectrum[2 * h], spectrum[2 * h + 1]), <, fundamental * 1e-5);
+      // the xvalues level alone must be alias free as well whenever it is faded in
+      if (wave.xfade > 0)
+        {
+          FFTPlan::real_plan (wave.n_values)->fftar (wave.xvalues, spectrum.data());
+          const double xfundamental = hypot (spectrum[2], spectrum[3]);
+          for (uint h = 2; h < wave.n_values / 2; h++)
+            if (h * freq > 22050)
+              TCMP (hypot (spectrum[2 * h], spectrum[2 * h + 1]), <, xfundamental * 1e-5);
+        }
+    }
+  // sweep across all mip levels
+  GslOscConfig config = { 0, };
+  config.table = t44;
+  config.transpose_factor = 1;
+  config.pulse_width = 0.5;
+  GslOscData osc = { { 0, }, };
+  gsl_osc_config (&osc, &config);
+  gsl_osc_reset (&osc);
+  const uint n_values = 44100;
+  std::vector<float> freq (n_values), output (n_values);
+  for (uint i = 0; i < n_values; i++)
+    freq[i] = BSE_SIGNAL_FROM_FREQ (20 * pow (1000, i / double (n_values)));
+  for (bool pulse : { false, true })
+    {
+      for (uint i = 0; i < n_values; i += 128)
+        if (pulse)
+          gsl_osc_process_pulse (&osc, 128, &freq[i], NULL, NULL, NULL, &output[i], NULL);
+        else
+          gsl_osc_process (&osc, 128, &freq[i], NULL, NULL, &output[i], NULL);
+      for (uint i = 0; i < n_values; i++)
+        TCMP (fabs (output[i]), <, 1.01);
+    }
+  gsl_osc_table_free (t44);
+  gsl_osc_table_free (t96);
+}
+TEST_ADD (test_osc_wave_bank);
+
+static std::string
+vorbis_encode_sine (bool threaded)
+{
+  GslVorbisEncoder *enc = gsl_vorbis_encoder_new ();
+  gsl_vorbis_encoder_set_quality (enc, 3.0);
+  gsl_vorbis_encoder_set_n_channels (enc, 2);
+  gsl_vorbis_encoder_set_sample_freq (enc, 44100);
+  Error error = gsl_vorbis_encoder_setup_stream (enc, 0x42534531);
+  TASSERT (error == Error::NONE);
+  if (threaded)
+    {
+      error = gsl_vorbis_encoder_start_thread (enc, 4096);
+      TASSERT (error == Error::NONE);
+    }
+  std::string ogg;
+  guint8 bytes[4096];
+  float values[2 * 1000];
+  for (size_t frame = 0; frame < 2 * 44100; frame += 1000)
+    {
+      for (size_t i = 0; i < 1000; i++)
+        values[2 * i] = values[2 * i + 1] = 0.5 * sin ((frame + i) * 2 * M_PI * 440 / 44100);
+      gsl_vorbis_encoder_write_pcm (enc, 2 * 1000, values);
+      for (guint n = gsl_vorbis_encoder_read_ogg (enc, sizeof (bytes), bytes); n; n = gsl_vorbis_encoder_read_ogg (enc, sizeof (bytes), bytes))
+        ogg.append ((const char*) bytes, n);
+    }
+  gsl_vorbis_encoder_pcm_done (enc);
+  while (!gsl_vorbis_encoder_ogg_eos (enc))
+    {
+      guint n = gsl_vorbis_encoder_read_ogg (enc, sizeof (bytes), bytes);
+      ogg.append ((const char*) bytes, n);
+    }
+  gsl_vorbis_encoder_destroy (enc);
+  return ogg;
+}
+
+static void
+vorbis_encoder_thread_test()
+{
+  // threaded encoding must yield the same Ogg stream as synchronous encoding
+  const std::string sync_ogg = vorbis_encode_sine (false);
+  const std::string threaded_ogg = vorbis_encode_sine (true);
+  TASSERT (sync_ogg.size() > 0);
+  TCMP (sync_ogg.size(), ==, threaded_ogg.size());
+  TASSERT (sync_ogg == threaded_ogg);
+  // the stream must decode with libvorbisfile into the encoded signal
+  gchar *tmpname = NULL;
+  const int tmpfd = g_file_open_tmp ("misctests-vorbis-XXXXXX.ogg", &tmpname, NULL);
+  TASSERT (tmpfd >= 0);
+  close (tmpfd);
+  TASSERT (Path::stringwrite (tmpname, threaded_ogg));
+  GslDataHandle *dhandle = gsl_data_handle_new_ogg_vorbis_muxed (tmpname, 0, 440);
+  TASSERT (dhandle != NULL);
+  Error error = gsl_data_handle_open (dhandle);
+  TASSERT (error == Error::NONE);
+  TCMP (gsl_data_handle_n_channels (dhandle), ==, 2);
+  TCMP (gsl_data_handle_mix_freq (dhandle), ==, 44100);
+  const int64 l = gsl_data_handle_length (dhandle);
+  TCMP (l, ==, 2 * 2 * 44100);
+  std::vector<float> values (l);
+  for (int64 n = 0; n < l; )
+    {
+      const int64 r = gsl_data_handle_read (dhandle, n, l - n, &values[n]);
+      TASSERT (r > 0);
+      n += r;
+    }
+  double err2 = 0;
+  for (int64 i = 0; i < l; i++)
+    {
+      const double expected = 0.5 * sin ((i / 2) * 2 * M_PI * 440 / 44100);
+      err2 += (values[i] - expected) * (values[i] - expected);
+    }
+  const double rms_error = sqrt (err2 / l);
+  TCMP (rms_error, <, 0.01);
+  gsl_data_handle_close (dhandle);
+  gsl_data_handle_unref (dhandle);
+  unlink (tmpname);
+  g_free (tmpname);
+}
+TEST_ADD (vorbis_encoder_thread_test);
+
+static void
+resource_index_test()
+{
+  const String tmpdir = Path::join (Path::cache_home(), "beast", string_format ("misctests-%u", getpid()));
+  TASSERT (Path::mkdirs (tmpdir + "/sub"));
+  // minimal mono 16bit WAV with 8 frames
+  auto write_wav = [] (const String &filename) {
+    String wav ("RIFF\x34\0\0\0WAVEfmt \x10\0\0\0\1\0\1\0\x80\xbb\0\0\0\x77\1\0\2\0\x10\0data\x10\0\0\0", 44);
+    wav.resize (44 + 16);
+    return Path::stringwrite (filename, wav);
+  };
+  TASSERT (write_wav (tmpdir + "/a.wav"));
+  TASSERT (write_wav (tmpdir + "/sub/b.wav"));
+  TASSERT (write_wav (tmpdir + "/sub/c.wav"));
+  TASSERT (Path::stringwrite (tmpdir + "/notes.txt", "ignored"));
+  std::mutex mutex;
+  std::condition_variable cond;
+  auto wait_for = [&] (const std::function<bool()> &condition) {
+    std::unique_lock<std::mutex> locker (mutex);
+    return cond.wait_for (locker, std::chrono::seconds (10), condition);
+  };
+  {
+    ResourceIndex index (tmpdir, [&] () {
+      std::lock_guard<std::mutex> locker (mutex);
+      cond.notify_all();
+    });
+    auto all_scanned = [&] () {
+      for (const ResourceEntry &entry : index.list_page (ResourceType::WAVE, 0, 100))
+        if (entry.hints.find ("channels=1") == String::npos)
+          return false;
+      return index.count (ResourceType::WAVE) == 3;
+    };
+    TASSERT (wait_for (all_scanned));
+    TCMP (index.count (ResourceType::SOUNDFONT), ==, 0);
+    ResourceList page = index.list_page (ResourceType::WAVE, 1, 5);
+    TCMP (page.size(), ==, 2);
+    TCMP (page[0].uri, ==, tmpdir + "/sub/b.wav");
+    TCMP (page[0].category, ==, "sub");
+    TASSERT (page[0].hints.find ("rate=48000:frames=8") != String::npos);
+    TCMP (page[1].uri, ==, tmpdir + "/sub/c.wav");
+    TCMP (index.list_page (ResourceType::WAVE, 3, 5).size(), ==, 0);
+    // removals and additions are picked up via inotify
+    TCMP (unlink ((tmpdir + "/sub/b.wav").c_str()), ==, 0);
+    TASSERT (wait_for ([&] () { return index.count (ResourceType::WAVE) == 2; }));
+    TCMP (index.list_page (ResourceType::WAVE, 1, 1)[0].uri, ==, tmpdir + "/sub/c.wav");
+    TASSERT (write_wav (tmpdir + "/sub/0.wav"));
+    TASSERT (wait_for ([&] () { return index.count (ResourceType::WAVE) == 3 && all_scanned(); }));
+    TCMP (index.list_page (ResourceType::WAVE, 1, 1)[0].uri, ==, tmpdir + "/sub/0.wav");
+  }
+  for (const char *file : { "/a.wav", "/sub/0.wav", "/sub/c.wav", "/notes.txt", "/sub", "" })
+    TCMP (remove ((tmpdir + file).c_str()), ==, 0);
+  const String cachefile = Path::join (Path::cache_home(), "beast", string_format ("resourceindex-%016x.txt", fnv1a_consthash64 (tmpdir.c_str())));
+  unlink (cachefile.c_str());
+}
+TEST_ADD (resource_index_test);
+
+static void
+param_ramp_test()
+{
+  using namespace Bse::AudioSignal;
+  float buf[16];
+  ParamRamp ramp;
+  // linear ramp, target reached on the last ramp frame, then held
+  ramp.jump (0);
+  ramp.start (1, 8, RampShape::LINEAR);
+  ramp.fill (buf, 12);
+  TASSERT (std::fabs (buf[0] - 0.125) < 1e-6);
+  TASSERT (std::fabs (buf[3] - 0.5) < 1e-6);
+  TASSERT (buf[7] == 1 && buf[11] == 1 && !ramp.active());
+  // exponential ramp, doubling per frame
+  ramp.jump (100);
+  ramp.start (1600, 4, RampShape::EXPONENTIAL);
+  ramp.fill (buf, 5);
+  TASSERT (std::fabs (buf[0] - 200) < 1e-3 && std::fabs (buf[1] - 400) < 1e-3 && std::fabs (buf[2] - 800) < 1e-3);
+  TASSERT (buf[3] == 1600 && buf[4] == 1600);
+  // exponential ramps crossing 0 fall back to linear
+  ramp.jump (-1);
+  ramp.start (1, 2, RampShape::EXPONENTIAL);
+  TASSERT (ramp.shape == RampShape::LINEAR);
+  // split rendering and skipping match a single fill
+  float whole[16], split[16];
+  ramp.jump (440);
+  ramp.start (55, 13, RampShape::EXPONENTIAL);
+  ramp.fill (whole, 16);
+  ramp.jump (440);
+  ramp.start (55, 13, RampShape::EXPONENTIAL);
+  ramp.fill (split, 5);
+  ramp.skip (3);
+  TASSERT (std::fabs (ramp.value - whole[7]) < 1e-3);
+  ramp.fill (split + 8, 8);
+  for (uint i = 8; i < 16; i++)
+    TASSERT (std::fabs (split[i] - whole[i]) < 1e-3);
+  TASSERT (whole[12] == 55 && whole[15] == 55);
+}
+TEST_ADD (param_ramp_test);
+
+namespace {
+using namespace Bse::AudioSignal;
+
+// Write the per-frame values of a single parameter into a mono output.
+class ParamRampSink : public Processor {
+  OBusId monoout_;
+  void query_info (ProcessorInfo &info) const override { info.uri = "Bse.Test.ParamRampSink"; info.label = "ParamRampSink"; }
+  void initialize () override { add_param (1, "Level", "Lvl", 0.0, 1.0, 0.0); }
+  void reset      () override {}
+  void
+  configure (uint n_ibuses, const SpeakerArrangement *ibuses, uint n_obuses, const SpeakerArrangement *obuses) override
+  {
+    remove_all_buses();
+    monoout_ = add_output_bus ("Mono Out", SpeakerArrangement::MONO);
+  }
+  void
+  render (uint n_frames) override
+  {
+    isconst = render_param (ParamId (1), oblock (monoout_, 0), n_frames);
+  }
+public:
+  bool isconst = false;
+};
+static auto param_ramp_sink = Bse::enroll_asp<ParamRampSink>();
+} // Anon
+
+static void
+param_schedule_test()
+{
+  AudioTiming timing { 120, 0 };
+  Engine engine (48000, timing, [] () {});
+  ProcessorP proc = Processor::registry_create (engine, "Bse.Test.ParamRampSink");
+  TASSERT (proc);
+  ParamRampSink &sink = dynamic_cast<ParamRampSink&> (*proc);
+  engine.add_root (proc);
+  engine.make_schedule();
+  engine.render_block();
+  TASSERT (sink.isconst && proc->ofloats (OBusId (1), 0)[0] == 0);
+  // schedule a ramp from another thread, starting at frame 10 of the next block
+  const uint64 stamp = engine.frame_counter() + MAX_RENDER_BLOCK_SIZE + 10;
+  bool queued = false;
+  std::thread producer ([&] () { queued = proc->schedule_param_mt (1, 1.0, stamp, 20, RampShape::LINEAR); });
+  producer.join();
+  TASSERT (queued);
+  engine.render_block();
+  const float *values = proc->ofloats (OBusId (1), 0);
+  TASSERT (!sink.isconst);
+  for (uint i = 0; i < 10; i++)
+    TCMP (values[i], ==, 0);
+  for (uint i = 10; i < 30; i++)
+    TASSERT (std::fabs (values[i] - (i - 9) / 20.0) < 1e-6);
+  for (uint i = 30; i < MAX_RENDER_BLOCK_SIZE; i++)
+    TCMP (values[i], ==, 1);
+  TCMP (proc->peek_param_mt (1), ==, 1);
+  engine.render_block();
+  TASSERT (sink.isconst && proc->ofloats (OBusId (1), 0)[0] == 1);
+  // the queue is bounded and never grows from producer threads
+  uint n_queued = 0;
+  for (uint i = 0; i < 1024; i++)
+    n_queued += proc->schedule_param_mt (1, 0.5, stamp, 0);
+  TASSERT (n_queued > 0 && n_queued < 1024);
+  engine.del_root (proc);
+  // BlepSynth renders its cutoff sample accurately and follows scheduled sweeps
+  ProcessorP synth = Processor::registry_create (engine, "Bse.BlepSynth");
+  TASSERT (synth);
+  const auto cutoff = synth->find_param ("cutoff");
+  TASSERT (cutoff.second);
+  engine.add_root (synth);
+  engine.make_schedule();
+  engine.render_block();
+  const double start = synth->peek_param_mt (cutoff.first);
+  const uint64 sweep_start = engine.frame_counter() + MAX_RENDER_BLOCK_SIZE;
+  TASSERT (synth->schedule_param_mt (cutoff.first, 2 * start, sweep_start, 4 * MAX_RENDER_BLOCK_SIZE, RampShape::EXPONENTIAL));
+  engine.render_block();
+  engine.render_block();
+  const double middle = synth->peek_param_mt (cutoff.first);
+  TASSERT (middle > start && middle < 2 * start);
+  for (uint i = 0; i < 4; i++)
+    engine.render_block();
+  TASSERT (std::fabs (synth->peek_param_mt (cutoff.first) - 2 * start) < 1e-3 * start);
+  TASSERT (!std::isnan (synth->ofloats (OBusId (1), 0)[0]));
+  engine.del_root (synth);
+}
+TEST_ADD (param_schedule_test);
+
+namespace {
+// Emit stereo silence, or a unit impulse at the start of the next block.
+class ImpulseSource : public Processor {
+  OBusId stereout_;
+  void query_info (ProcessorInfo &info) const override { info.uri = "Bse.Test.ImpulseSource"; info.label = "ImpulseSource"; }
+  void reset      () override {}
+  void
+  configure (uint n_ibuses, const SpeakerArrangement *ibuses, uint n_obuses, const SpeakerArrangement *obuses) override
+  {
+    remove_all_buses();
+    stereout_ = add_output_bus ("Stereo Out", SpeakerArrangement::STEREO);
+  }
+  void
+  render (uint n_frames) override
+  {
+    for (uint c = 0; c < 2; c++)
+      {
+        float *out = oblock (stereout_, c);
+        floatfill (out, 0.f, n_frames);
+        out[0] = impulse ? 1.0 : 0.0;
+      }
+    impulse = false;
+  }
+public:
+  bool impulse = false;
+};
+static auto impulse_source = Bse::enroll_asp<ImpulseSource>();
+
+struct TestProcessorManager : ProcessorManager {
+  using ProcessorManager::pm_connect;
+};
+
+// Render an ImpulseSource through a Freeverb.
+struct ReverbChain {
+  AudioTiming timing { 120, 0 };
+  Engine      engine { 48000, timing, [] () {} };
+  ProcessorP  source, reverb;
+  ReverbChain()
+  {
+    source = Processor::registry_create (engine, "Bse.Test.ImpulseSource");
+    reverb = Processor::registry_create (engine, "Bse.VST2.JzR3.Freeverb3");
+    TASSERT (source && reverb);
+    TestProcessorManager::pm_connect (*reverb, IBusId (1), *source, OBusId (1));
+    engine.add_root (reverb);
+    engine.make_schedule();
+  }
+  ~ReverbChain() { engine.del_root (reverb); }
+  void impulse() { dynamic_cast<ImpulseSource&> (*source).impulse = true; }
+};
+} // Anon
+
+static void
+silence_bypass_test()
+{
+  ReverbChain chain, fresh;
+  Engine &engine = chain.engine;
+  // a reverb fed with silence is rendered until its tail has decayed
+  const uint tail_blocks = engine.sample_rate() / 2 / MAX_RENDER_BLOCK_SIZE;
+  for (uint i = 0; i + 1 < tail_blocks; i++)
+    engine.render_block();
+  TCMP (engine.bypassed_blocks(), ==, uint64 (0));
+  for (uint i = 0; i < 4; i++)
+    engine.render_block();
+  TCMP (engine.bypassed_blocks(), >, uint64 (0));
+  const uint64 bypassed = engine.bypassed_blocks();
+  engine.render_block();
+  TCMP (engine.bypassed_blocks(), ==, bypassed + 1);
+  for (uint c = 0; c < 2; c++)
+    TCMP (floatmaxabs (chain.reverb->ofloats (OBusId (1), c), MAX_RENDER_BLOCK_SIZE), ==, 0.f);
+  // an impulse resumes rendering, output must match a reverb that was never bypassed
+  chain.impulse();
+  fresh.impulse();
+  float maxabs = 0;
+  for (uint b = 0; b < 32; b++)
+    {
+      const uint64 rendered = engine.rendered_blocks();
+      engine.render_block();
+      fresh.engine.render_block();
+      TCMP (engine.rendered_blocks(), ==, rendered + 2);        // source and reverb
+      for (uint c = 0; c < 2; c++)
+        {
+          const float *out = chain.reverb->ofloats (OBusId (1), c);
+          const float *ref = fresh.reverb->ofloats (OBusId (1), c);
+          for (uint i = 0; i < MAX_RENDER_BLOCK_SIZE; i++)
+            TASSERT (std::fabs (out[i] - ref[i]) < 1e-6);
+          maxabs = std::max (maxabs, floatmaxabs (out, MAX_RENDER_BLOCK_SIZE));
+        }
+    }
+  TCMP (engine.bypassed_blocks(), ==, bypassed + 1);
+  TCMP (maxabs, >, 0.001);
+}
+TEST_ADD (silence_bypass_test);
+
+// == Engine output virtualization ==
+struct EngineRecord {
+  static constexpr uint N_BLOCKS = 4;
+  uint               block_size = 0;
+  uint               n_frames = 0;
+  std::atomic<int>   frames_left { 0 };
+  std::vector<float> values[2];
+  bool               constant[2][N_BLOCKS] = {};
+  std::atomic<bool>  probed { false };
+  std::vector<float> probe_values;
+  std::mutex              mutex;
+  std::condition_variable cond;         // signalled once all frames are recorded and once probed
+  void
+  notify()
+  {
+    std::lock_guard<std::mutex> locker (mutex);
+    cond.notify_all();
+  }
+};
+
+static void
+const_source_process (BseModule *module, uint n_values)
+{
+  bse_module_const_ostream (module, 0, 0.5);
+}
+
+static void
+fill_source_process (BseModule *module, uint n_values)
+{
+  bse_module_fill_const_ostream (module, 0, n_values, 0.25);
+}
+
+static void
+pass_through_process (BseModule *module, uint n_values)
+{
+  module->ostreams[0].values = const_cast<float*> (module->istreams[0].values);
+}
+
+static void
+record_sink_process (BseModule *module, uint n_values)
+{
+  EngineRecord *record = (EngineRecord*) module->user_data;
+  return_unless (record->n_frames + n_values <= record->values[0].size());
+  for (uint i = 0; i < 2; i++)
+    {
+      std::copy (module->istreams[i].values, module->istreams[i].values + n_values, &record->values[i][record->n_frames]);
+      record->constant[i][record->n_frames / record->block_size] = module->istreams[i].constant;
+    }
+  record->n_frames += n_values;
+  if (record->frames_left.fetch_sub (n_values) - int (n_values) <= 0)
+    record->notify();
+}
+
+static gboolean
+record_poll (gpointer data, guint n_values, glong *timeout_p, guint n_fds, const GPollFD *fds, gboolean revents_filled)
+{
+  EngineRecord *record = (EngineRecord*) data;
+  if (record->frames_left > 0)
+    return true;
+  *timeout_p = 1;       // check again for new frames to render
+  return false;
+}
+
+static void
+record_probe (gpointer data, guint n_values, guint64 tick_stamp, guint n_ostreams, BseOStream **ostreams_p)
+{
+  EngineRecord *record = (EngineRecord*) data;
+  record->probe_values.assign ((*ostreams_p)[0].values, (*ostreams_p)[0].values + n_values);
+  record->probed = true;
+  record->notify();
+}
+
+static void
+engine_const_stream_test()
+{
+  static const BseModuleClass const_source_class = { 0, 0, 1, const_source_process, NULL, NULL, NULL, Bse::ModuleFlag::CHEAP };
+  static const BseModuleClass fill_source_class = { 0, 0, 1, fill_source_process, NULL, NULL, NULL, Bse::ModuleFlag::CHEAP };
+  static const BseModuleClass pass_through_class = { 1, 0, 1, pass_through_process, NULL, NULL, NULL, Bse::ModuleFlag::CHEAP };
+  static const BseModuleClass record_sink_class = { 2, 0, 0, record_sink_process, NULL, NULL, NULL, Bse::ModuleFlag::CHEAP };
+  EngineRecord record;
+  BseModule *csource = NULL, *fsource = NULL, *pass = NULL, *sink = NULL;
+  // const source -> pass through -> sink, fill source -> sink, flow jobs split the second block
+  Bse::jobs += [&] () {
+    record.block_size = bse_engine_block_size();
+    for (uint i = 0; i < 2; i++)
+      record.values[i].resize (EngineRecord::N_BLOCKS * record.block_size);
+    csource = bse_module_new (&const_source_class, NULL);
+    fsource = bse_module_new (&fill_source_class, NULL);
+    pass = bse_module_new (&pass_through_class, NULL);
+    sink = bse_module_new (&record_sink_class, &record);
+    BseTrans *trans = bse_trans_open();
+    for (BseModule *module : { csource, fsource, pass, sink })
+      bse_trans_add (trans, bse_job_integrate (module));
+    bse_trans_add (trans, bse_job_set_consumer (sink, true));
+    bse_trans_add (trans, bse_job_connect (csource, 0, pass, 0));
+    bse_trans_add (trans, bse_job_connect (pass, 0, sink, 0));
+    bse_trans_add (trans, bse_job_connect (fsource, 0, sink, 1));
+    bse_trans_add (trans, bse_job_add_poll (record_poll, &record, NULL, 0, NULL));
+    bse_trans_commit (trans);
+    bse_engine_wait_on_trans();
+    const uint64 split_stamp = Bse::TickStamp::current() + record.block_size + record.block_size / 2;
+    auto noop = [] (BseModule*, gpointer) {};
+    trans = bse_trans_open();
+    bse_trans_add (trans, bse_job_flow_access (pass, split_stamp, noop, NULL, NULL));
+    bse_trans_add (trans, bse_job_flow_access (fsource, split_stamp, noop, NULL, NULL));
+    bse_trans_add (trans, bse_job_probe_request (pass, record_probe, &record));
+    bse_trans_commit (trans);
+    bse_engine_wait_on_trans();
+    record.frames_left = EngineRecord::N_BLOCKS * record.block_size;
+  };
+  {
+    std::unique_lock<std::mutex> locker (record.mutex);
+    TASSERT (record.cond.wait_for (locker, std::chrono::seconds (5), [&] () { return record.frames_left <= 0 && record.probed; }));
+  }
+  Bse::jobs += [&] () {
+    BseTrans *trans = bse_trans_open();
+    bse_trans_add (trans, bse_job_remove_poll (record_poll, &record));
+    for (BseModule *module : { sink, pass, fsource, csource })
+      bse_trans_add (trans, bse_job_discard (module));
+    bse_trans_commit (trans);
+    bse_engine_wait_on_trans();
+  };
+  TCMP (record.n_frames, ==, EngineRecord::N_BLOCKS * record.block_size);
+  // passed through constants and filled constants arrive intact, also for partial blocks
+  for (uint i = 0; i < record.n_frames; i++)
+    {
+      TCMP (record.values[0][i], ==, 0.5f);
+      TCMP (record.values[1][i], ==, 0.25f);
+    }
+  // only whole blocks are flagged constant
+  for (uint b = 0; b < EngineRecord::N_BLOCKS; b++)
+    for (uint i = 0; i < 2; i++)
+      TCMP (record.constant[i][b], ==, b != 1);
+  // the probe took over the real output buffer after a virtualized block
+  TCMP (record.probe_values.size(), ==, record.block_size);
+  for (float v : record.probe_values)
+    TCMP (v, ==, 0.5f);
+}
+TEST_ADD (engine_const_stream_test);
+
 #if 0
 int
 main (gint   argc,
@@ -3,6 +3,7 @@
 #include <bse/bsemath.hh>
 #include <bse/bsemain.hh>
 #include <bse/gslfft.hh>
+#include <bse/fftplan.hh>
 #include <bse/testing.hh>
 #include <sys/time.h>
 #include <stdlib.h>
@@ -136,6 +137,105 @@ test_fft_variants()
 }
 TEST_ADD (test_fft_variants);
 
+static void
+test_fft_plans()
+{
+  static const uint sizes[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 12, 15, 16, 25, 30, 49, 64, 97, 100, 120, 210,
+                                256, 360, 441, 480, 500, 512, 1000 };
+  for (uint n : sizes)
+    {
+      const double epsilon = 1e-5 * (1 + sqrt (n) * log2 (n + 1));
+      double ref_in[2 * n], ref_out[2 * n];
+      float fin[2 * n], fout[2 * n], fback[2 * n];
+      double d = 0;
+      fill_rand (2 * n, ref_in);
+      for (uint i = 0; i < 2 * n; i++)
+        fin[i] = ref_in[i];
+      for (uint i = 0; i < 2 * n; i++)
+        ref_in[i] = fin[i];             // compare against the float precision input
+      /* complex analysis against reference dft */
+      Bse::FFTPlanP plan = Bse::FFTPlan::complex_plan (n);
+      TASSERT (plan == Bse::FFTPlan::complex_plan (n));
+      plan->fftac (fin, fout);
+      reference_dftc (n, ref_in, ref_out);
+      for (uint i = 0; i < 2 * n; i++)
+        d = MAX (d, fabs (fout[i] - ref_out[i]));
+      TCHECK (d < epsilon, "FFTPlan complex analysis FFT-%u error below epsilon: %g < %g", n, d, epsilon);
+      /* scaled re-synthesis, in place */
+      std::copy (fout, fout + 2 * n, fback);
+      plan->fftsc (fback, fback, true);
+      d = 0;
+      for (uint i = 0; i < 2 * n; i++)
+        d = MAX (d, fabs (fback[i] - fin[i]));
+      TCHECK (d < 1e-5, "FFTPlan complex re-synthesis FFT-%u error below epsilon: %g < %g", n, d, 1e-5);
+      if (n < 2 || n % 2)
+        continue;
+      /* real analysis against reference dft, packing like gsl_power2_fftar() */
+      make_real (2 * n, ref_in);
+      extract_real (2 * n, ref_in, ref_out);
+      for (uint i = 0; i < n; i++)
+        fin[i] = ref_out[i];
+      reference_dftc (n, ref_in, ref_out);
+      ref_out[1] = ref_out[n];
+      Bse::FFTPlanP rplan = Bse::FFTPlan::real_plan (n);
+      rplan->fftar (fin, fout);
+      d = 0;
+      for (uint i = 0; i < n; i++)
+        d = MAX (d, fabs (fout[i] - ref_out[i]));
+      TCHECK (d < epsilon, "FFTPlan real analysis FFT-%u error below epsilon: %g < %g", n, d, epsilon);
+      rplan->fftsr (fout, fback, true);
+      d = 0;
+      for (uint i = 0; i < n; i++)
+        d = MAX (d, fabs (fback[i] - fin[i]));
+      TCHECK (d < 1e-5, "FFTPlan real re-synthesis FFT-%u error below epsilon: %g < %g", n, d, 1e-5);
+      /* unscaled synthesis matches gsl_power2_fftsr(), which doesn't scale FFT-2 */
+      if ((n & (n - 1)) == 0 && n >= 4)
+        {
+          double gin[n], gout[n];
+          for (uint i = 0; i < n; i++)
+            gin[i] = fout[i];
+          gsl_power2_fftsr (n, gin, gout);
+          rplan->fftsr (fout, fback);
+          d = 0;
+          for (uint i = 0; i < n; i++)
+            d = MAX (d, fabs (fback[i] - gout[i]) / n);
+          TCHECK (d < 1e-5, "FFTPlan real synthesis FFT-%u matches gsl_power2_fftsr: %g < %g", n, d, 1e-5);
+        }
+    }
+  TCMP (Bse::FFTPlan::good_size (1001), ==, 1024u);
+  TCMP (Bse::FFTPlan::good_size (1000), ==, 1000u);
+  TCMP (Bse::FFTPlan::good_size (97), ==, 100u);
+}
+TEST_ADD (test_fft_plans);
+
+static void
+bench_fft_plans()
+{
+  Bse::Test::Timer timer (0.15); // maximum seconds
+  for (uint n : { 256, 1024, 4096, 16384 })
+    {
+      std::vector<double> din (2 * n), dout (2 * n);
+      std::vector<float> fin (2 * n), fout (2 * n);
+      fill_rand (2 * n, din.data());
+      std::copy (din.begin(), din.end(), fin.begin());
+      Bse::FFTPlanP plan = Bse::FFTPlan::complex_plan (n), rplan = Bse::FFTPlan::real_plan (n);
+      const double gsl_c = timer.benchmark ([&] () { gsl_power2_fftac (n, din.data(), dout.data()); });
+      const double plan_c = timer.benchmark ([&] () { plan->fftac (fin.data(), fout.data()); });
+      const double gsl_r = timer.benchmark ([&] () { gsl_power2_fftar (n, din.data(), dout.data()); });
+      const double plan_r = timer.benchmark ([&] () { rplan->fftar (fin.data(), fout.data()); });
+      TBENCH ("FFT-%-5u complex: gsl_power2_fftac=%.2fus FFTPlan::fftac=%.2fus (%.2fx)\n", n, gsl_c * 1e6, plan_c * 1e6, gsl_c / plan_c);
+      TBENCH ("FFT-%-5u real:    gsl_power2_fftar=%.2fus FFTPlan::fftar=%.2fus (%.2fx)\n", n, gsl_r * 1e6, plan_r * 1e6, gsl_r / plan_r);
+    }
+  for (uint n : { 1000, 1536, 3000 })
+    {
+      std::vector<float> fin (2 * n, 0.5), fout (2 * n);
+      Bse::FFTPlanP plan = Bse::FFTPlan::complex_plan (n);
+      const double plan_c = timer.benchmark ([&] () { plan->fftac (fin.data(), fout.data()); });
+      TBENCH ("FFT-%-5u complex: FFTPlan::fftac=%.2fus\n", n, plan_c * 1e6);
+    }
+}
+TEST_BENCH (bench_fft_plans);
+
 static void
 fill_rand (guint   n,
 	   double *a)
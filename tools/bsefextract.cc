@@ -5,7 +5,7 @@
 #include <bse/bsemathsignal.hh>
 #include <bse/gsldatautils.hh>
 #include <bse/bseloader.hh>
-#include <bse/gslfft.hh>
+#include <bse/fftplan.hh>
 #include <bse/gslfilter.hh>
 #include "bse/internal.hh"
 #include <stdio.h>
@@ -19,6 +19,11 @@
 #include <utility>
 #include <list>
 #include <complex>
+#include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using namespace Bse;
 using namespace BseTool;
@@ -37,6 +42,7 @@ struct FExtractOptions {
   bool          cut_zeros_head;
   bool          cut_zeros_tail;
   bool          verbose;
+  bool          streaming;
   double        silence_threshold;
   double        base_freq_hint;
   double        focus_center;
@@ -63,6 +69,25 @@ class FeAudioSignal
   uint		  m_n_channels;
   GslLong	  m_length;
   GslLong         m_offset;
+  double          m_mix_freq;
+  /* in streaming mode, samples are read on demand through a one block cache */
+  mutable vector<float> m_cache;
+  mutable GslLong       m_cache_offset;
+
+  float
+  raw_sample (GslLong pos) const
+  {
+    if (!m_samples.empty())
+      return m_samples[pos];
+    if (pos < m_cache_offset || pos >= m_cache_offset + GslLong (m_cache.size()))
+      {
+        const GslLong block_size = 4096 * m_n_channels;
+        m_cache_offset = pos - pos % block_size;
+        m_cache.resize (MIN (block_size, gsl_data_handle_length (m_data_handle) - m_cache_offset));
+        read (m_cache_offset, m_cache.size(), &m_cache[0]);
+      }
+    return m_cache[pos - m_cache_offset];
+  }
 
   /* check if the first sample is silent on all channels */
   bool head_is_silent()
@@ -96,25 +121,18 @@ class FeAudioSignal
   }
 
 public:
-  FeAudioSignal (GslDataHandle *data_handle) :
-    m_data_handle (data_handle)
+  FeAudioSignal (GslDataHandle *data_handle, bool streaming) :
+    m_data_handle (data_handle), m_cache_offset (0)
   {
     m_n_channels = gsl_data_handle_n_channels (data_handle);
     m_length = gsl_data_handle_length (data_handle);
     m_offset = 0;
+    m_mix_freq = gsl_data_handle_mix_freq (data_handle);
 
-    m_samples.resize (m_length);
-    ssize_t have_samples = 0;
-    while (have_samples < m_length)
+    if (!streaming)
       {
-        int64 r = gsl_data_handle_read (data_handle, have_samples, MIN (m_length - have_samples, 4096 * m_n_channels),
-                                        &m_samples[have_samples]);
-        if (r < 0)
-          {
-            printerr ("error reading sample data\n");
-            _exit (1);
-          }
-        have_samples += r;
+        m_samples.resize (m_length);
+        read (0, m_length, m_samples.data());
       }
 
     if (options.cut_zeros_head)
@@ -154,6 +172,33 @@ public:
 
     m_offset += istart;
     m_length = iend - istart;
+
+    /* release memory that is not needed for the stream */
+    vector<float>().swap (m_cache);
+  }
+
+  /* read n_values interleaved samples from the data handle, starting at (absolute) pos */
+  void
+  read (GslLong pos, GslLong n_values, float *values) const
+  {
+    GslLong have_samples = 0;
+    while (have_samples < n_values)
+      {
+        int64 r = gsl_data_handle_read (m_data_handle, pos + have_samples, MIN (n_values - have_samples, 4096 * m_n_channels),
+                                        values + have_samples);
+        if (r <= 0)
+          {
+            printerr ("error reading sample data\n");
+            _exit (1);
+          }
+        have_samples += r;
+      }
+  }
+
+  /* absolute data handle position of the first sample */
+  GslLong offset() const
+  {
+    return m_offset;
   }
 
   GslLong length() const
@@ -168,12 +213,17 @@ public:
 
   double operator[] (GslLong k) const
   {
-    return m_samples[k + m_offset];
+    return raw_sample (k + m_offset);
   }
 
   double mix_freq() const
   {
-    return gsl_data_handle_mix_freq (m_data_handle);
+    return m_mix_freq;
+  }
+
+  GslLong n_frames() const
+  {
+    return m_length / m_n_channels;
   }
 
   double time_ms (GslLong k) const
@@ -181,6 +231,32 @@ public:
     GslLong n_frames = k / n_channels();
     return n_frames * 1000.0 / mix_freq();
   }
+
+  double frame_time_ms (GslLong frame) const
+  {
+    return frame * 1000.0 / mix_freq();
+  }
+};
+
+/* incremental consumer of the selected channel, used in streaming mode */
+struct FeStreamConsumer
+{
+  /* number of times the frame stream needs to be consumed */
+  virtual uint n_passes() const
+  {
+    return 1;
+  }
+  virtual void stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+  }
+  /* process n_values frames of the selected channel, starting at frame */
+  virtual void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values) = 0;
+  virtual void stream_end (const FeAudioSignal &signal, uint pass)
+  {
+  }
+  virtual ~FeStreamConsumer()
+  {
+  }
 };
 
 struct Feature;
@@ -258,12 +334,285 @@ struct Feature
 
   virtual void compute (const FeAudioSignal &signal) = 0;
   virtual void print_results() const = 0;
+  /* streaming mode: the consumer that needs to see the frame stream for this feature */
+  virtual FeStreamConsumer* stream_consumer() = 0;
+  /* streaming mode: called after all consumers have finished */
+  virtual void stream_finish()
+  {
+  }
   virtual ~Feature()
   {
   }
 };
 
-struct StartTimeFeature : public Feature
+/* Distributes blocks of the selected channel to several consumers, each consumer
+ * runs in its own thread. Blocks are kept in a small ring, so memory usage only
+ * depends on the block size and the consumer windows, not on the signal length.
+ */
+class FeBlockStream
+{
+  static const uint BLOCK_SIZE = 4096;  /* frames per block */
+  static const uint N_SLOTS = 8;
+  struct Slot {
+    GslLong       frame;
+    uint          n_values;
+    vector<float> values;
+  };
+  const FeAudioSignal      &m_signal;
+  std::mutex                m_mutex;
+  std::condition_variable   m_cond;
+  Slot                      m_slots[N_SLOTS];
+  uint64                    m_n_produced;
+  vector<uint64>            m_n_consumed;
+
+  void
+  produce()
+  {
+    const uint n_channels = m_signal.n_channels();
+    vector<float> interleaved (BLOCK_SIZE * n_channels);
+    uint64 block = 0;
+    for (GslLong frame = 0; frame < m_signal.n_frames(); frame += BLOCK_SIZE, block++)
+      {
+        /* wait until all consumers released the slot */
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_cond.wait (lock, [&] () { return *std::min_element (m_n_consumed.begin(), m_n_consumed.end()) + N_SLOTS > block; });
+        lock.unlock();
+        Slot &slot = m_slots[block % N_SLOTS];
+        slot.frame = frame;
+        slot.n_values = MIN (BLOCK_SIZE, m_signal.n_frames() - frame);
+        m_signal.read (m_signal.offset() + frame * n_channels, slot.n_values * n_channels, &interleaved[0]);
+        for (uint i = 0; i < slot.n_values; i++)
+          slot.values[i] = interleaved[i * n_channels + options.channel];
+        lock.lock();
+        m_n_produced = block + 1;
+        m_cond.notify_all();
+      }
+  }
+
+  void
+  consume (FeStreamConsumer *consumer, uint index, uint64 n_blocks, uint pass)
+  {
+    consumer->stream_begin (m_signal, pass);
+    for (uint64 block = 0; block < n_blocks; block++)
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_cond.wait (lock, [&] () { return m_n_produced > block; });
+        lock.unlock();
+        const Slot &slot = m_slots[block % N_SLOTS];
+        consumer->stream_block (m_signal, pass, slot.frame, &slot.values[0], slot.n_values);
+        lock.lock();
+        m_n_consumed[index] = block + 1;
+        m_cond.notify_all();
+      }
+    consumer->stream_end (m_signal, pass);
+  }
+
+public:
+  FeBlockStream (const FeAudioSignal &signal) :
+    m_signal (signal)
+  {
+    for (uint i = 0; i < N_SLOTS; i++)
+      m_slots[i].values.resize (BLOCK_SIZE);
+  }
+
+  /* stream the signal once per pass, until all consumers are done */
+  void
+  run (const vector<FeStreamConsumer*> &consumers)
+  {
+    const uint64 n_blocks = (m_signal.n_frames() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    for (uint pass = 0; ; pass++)
+      {
+        vector<FeStreamConsumer*> pass_consumers;
+        for (auto consumer : consumers)
+          if (consumer->n_passes() > pass)
+            pass_consumers.push_back (consumer);
+        if (pass_consumers.empty())
+          break;
+        m_n_produced = 0;
+        m_n_consumed.assign (pass_consumers.size(), 0);
+        vector<std::thread> threads;
+        for (uint i = 0; i < pass_consumers.size(); i++)
+          threads.push_back (std::thread (&FeBlockStream::consume, this, pass_consumers[i], i, n_blocks, pass));
+        produce();
+        for (auto &thread : threads)
+          thread.join();
+      }
+  }
+};
+
+/* Collects frames for windows of a fixed size, placed at fixed time steps; like the
+ * non-streaming code, windows that would exceed the end of the signal are skipped.
+ */
+class FeSlidingWindow
+{
+  uint            m_size;
+  double          m_stepping_ms;
+  double          m_file_size_ms;
+  double          m_offset_ms;
+  GslLong         m_length;
+  uint            m_n_channels;
+  GslLong         m_next_start;
+  std::deque<double> m_frames;
+  GslLong         m_frames_start;
+  vector<double>  m_window;
+
+  void
+  update_next_start()
+  {
+    if (m_offset_ms < m_file_size_ms)
+      m_next_start = GslLong (m_offset_ms / m_file_size_ms * m_length / m_n_channels);
+    else
+      m_next_start = -1; /* done */
+  }
+
+  void
+  drop_frames()
+  {
+    while (!m_frames.empty() && (m_next_start < 0 || m_frames_start < m_next_start))
+      {
+        m_frames.pop_front();
+        m_frames_start++;
+      }
+  }
+
+public:
+  void
+  begin (const FeAudioSignal &signal, uint size, double stepping_ms)
+  {
+    m_size = size;
+    m_stepping_ms = stepping_ms;
+    m_file_size_ms = signal.time_ms (signal.length());
+    m_length = signal.length();
+    m_n_channels = signal.n_channels();
+    m_offset_ms = 0;
+    m_frames.clear();
+    m_frames_start = 0;
+    m_window.resize (size);
+    update_next_start();
+  }
+
+  /* append frames, window_func (const double *samples) is called for every complete window */
+  template<class WindowFunc> void
+  feed (GslLong frame, const float *values, uint n_values, WindowFunc window_func)
+  {
+    if (m_frames.empty())
+      m_frames_start = frame;
+    m_frames.insert (m_frames.end(), values, values + n_values);
+    drop_frames();
+    while (m_next_start >= 0 && m_frames_start == m_next_start && m_frames.size() >= m_size)
+      {
+        std::copy (m_frames.begin(), m_frames.begin() + m_size, m_window.begin());
+        window_func (&m_window[0]);
+        m_offset_ms += m_stepping_ms;
+        update_next_start();
+        drop_frames();
+      }
+  }
+};
+
+/* Hilbert filters a stream of frames, like ComplexSignalFeature::compute() */
+class FeHilbertStream
+{
+  const double   *m_hilbert;
+  uint            m_hsize;
+  vector<double>  m_history;    /* twice the filter length, to read windows without wrapping */
+  uint            m_pos;
+  GslLong         m_n_pushed;
+  GslLong         m_n_emitted;
+
+  template<class EmitFunc> void
+  push (double value, EmitFunc emit)
+  {
+    const uint filter_len = 2 * m_hsize + 1;
+    m_history[m_pos] = m_history[m_pos + filter_len] = value;
+    m_pos = (m_pos + 1) % filter_len;
+    m_n_pushed++;
+    if (m_n_pushed > m_hsize)
+      {
+        const double *window = &m_history[m_pos]; /* oldest .. newest frame */
+        double im = 0;
+        for (uint k = 0; k < filter_len; k++)
+          im += window[k] * m_hilbert[k];
+        emit (std::complex<double> (window[m_hsize], im));
+        m_n_emitted++;
+      }
+  }
+
+public:
+  void
+  begin (const double *hilbert, uint hsize)
+  {
+    m_hilbert = hilbert;
+    m_hsize = hsize;
+    m_history.assign (2 * (2 * hsize + 1), 0.0);
+    m_pos = 0;
+    m_n_pushed = 0;
+    m_n_emitted = 0;
+  }
+
+  template<class EmitFunc> void
+  feed (const float *values, uint n_values, EmitFunc emit)
+  {
+    for (uint i = 0; i < n_values; i++)
+      push (values[i], emit);
+  }
+
+  /* emit the remaining n_frames - emitted values, with zeros after the end of the signal */
+  template<class EmitFunc> void
+  finish (GslLong n_frames, EmitFunc emit)
+  {
+    while (m_n_emitted < n_frames)
+      push (0.0, emit);
+  }
+};
+
+/* Averages values over windows of size, advancing by step, like the smear and wobble computations */
+class FeWindowAverager
+{
+  uint               m_size;
+  uint               m_step;
+  GslLong            m_n_values;
+  GslLong            m_n_fed;
+  GslLong            m_offset;
+  std::deque<double> m_values;  /* values starting at m_offset */
+
+public:
+  void
+  begin (uint size, uint step, GslLong n_values)
+  {
+    m_size = size;
+    m_step = step;
+    m_n_values = n_values;
+    m_n_fed = 0;
+    m_offset = 0;
+    m_values.clear();
+  }
+
+  /* avg_func (double avg) is called for every window offset where offset + 2 * step < n_values */
+  template<class AvgFunc> void
+  feed (double value, AvgFunc avg_func)
+  {
+    if (m_n_fed++ >= m_offset)
+      m_values.push_back (value);
+    while (m_offset + 2 * m_step < m_n_values && (m_values.size() >= m_size || m_n_fed >= m_n_values))
+      {
+        double avg = 0.0, avg_div = 0.0;
+        for (uint i = 0; i < m_size && i < m_values.size(); i++)
+          {
+            avg += m_values[i];
+            avg_div += 1.0;
+          }
+        if (avg_div > 0.0)
+          avg /= avg_div;
+        avg_func (avg);
+        for (uint i = 0; i < m_step && !m_values.empty(); i++)
+          m_values.pop_front();
+        m_offset += m_step;
+      }
+  }
+};
+
+struct StartTimeFeature : public Feature, public FeStreamConsumer
 {
   double start_time;
   StartTimeFeature() :
@@ -288,9 +637,21 @@ struct StartTimeFeature : public Feature
   {
     print_value ("start_time", start_time);
   }
+  FeStreamConsumer*
+  stream_consumer()
+  {
+    return this;
+  }
+  void
+  stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    for (uint i = 0; i < n_values && start_time < 0; i++)
+      if (values[i] != 0)
+        start_time = signal.frame_time_ms (frame + i);
+  }
 };
 
-struct EndTimeFeature : public Feature
+struct EndTimeFeature : public Feature, public FeStreamConsumer
 {
   double end_time;
   EndTimeFeature() : Feature ("--end-time", "signal end time in ms (last non-zero sample)")
@@ -309,13 +670,24 @@ struct EndTimeFeature : public Feature
   {
     print_value ("end_time", end_time);
   }
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    for (uint i = 0; i < n_values; i++)
+      if (values[i] != 0)
+        end_time = signal.frame_time_ms (frame + i);
+  }
 };
 
-struct SpectrumFeature : public Feature
+struct SpectrumFeature : public Feature, public FeStreamConsumer
 {
   vector< vector<double> > spectrum;
   vector< vector<double> > joined_spectrum;
   vector< double >         window;
+  FeSlidingWindow          sliding_window;
 
   SpectrumFeature() :
     Feature ("--spectrum", "generate 30ms sliced frequency spectrums")
@@ -332,18 +704,18 @@ struct SpectrumFeature : public Feature
   }
 
   vector<double>
-  build_frequency_vector (double *samples)
+  build_frequency_vector (const double *samples)
   {
     const size_t size = window.size();
     assert_return (size > 0, vector<double>());
 
     vector<double> fvector;
-    double in[size], c[size + 2], *im;
+    float in[size], c[size + 2], *im;
 
     for (size_t i = 0; i < size; i++)
       in[i] = window[i] * samples[i];
 
-    gsl_power2_fftar (size, in, c);
+    FFTPlan::real_plan (size)->fftar (in, c);
     c[size] = c[1];
     c[size + 1] = 0;
     c[1] = 0;
@@ -448,6 +820,12 @@ struct SpectrumFeature : public Feature
 	  }
       }
 
+    join_spectrum();
+  }
+
+  void
+  join_spectrum()
+  {
     if (options.join_spectrum_slices > 1)
       {
 	typedef vector< vector<double> >::const_iterator SpectrumConstIterator;
@@ -477,6 +855,30 @@ struct SpectrumFeature : public Feature
     else
       print_matrix ("spectrum", spectrum);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  void stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+    init_window (4096);
+    sliding_window.begin (signal, 4096, 30); /* extract a feature vector every 30 ms */
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    sliding_window.feed (frame, values, n_values, [&] (const double *samples) {
+      vector<double> fvector = build_frequency_vector (samples);
+      spectrum.push_back (collapse_frequency_vector (fvector, signal.mix_freq(), 50, 1.6));
+    });
+  }
+
+  void stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    join_spectrum();
+  }
 };
 
 struct AvgSpectrumFeature : public Feature
@@ -496,7 +898,10 @@ struct AvgSpectrumFeature : public Feature
      * dependancy: we need the spectrum to compute the average spectrum
      */
     spectrum_feature->compute (signal);
-
+    average_spectrum();
+  }
+  void average_spectrum()
+  {
     for (vector< vector<double> >::const_iterator si = spectrum_feature->spectrum.begin(); si != spectrum_feature->spectrum.end(); si++)
     {
       avg_spectrum.resize (si->size());
@@ -508,15 +913,25 @@ struct AvgSpectrumFeature : public Feature
   {
     print_vector ("avg_spectrum", avg_spectrum);
   }
+  FeStreamConsumer* stream_consumer()
+  {
+    return spectrum_feature;
+  }
+  void stream_finish()
+  {
+    average_spectrum();
+  }
 };
 
-struct AvgEnergyFeature : public Feature
+struct AvgEnergyFeature : public Feature, public FeStreamConsumer
 {
   double avg_energy;
+  GslLong avg_energy_count;
 
   AvgEnergyFeature() : Feature ("--avg-energy", "average signal energy in dB")
   {
     avg_energy = 0;
+    avg_energy_count = 0;
   }
 
   void compute (const FeAudioSignal &signal)
@@ -540,9 +955,33 @@ struct AvgEnergyFeature : public Feature
   {
     print_value ("avg_energy", avg_energy);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    for (uint i = 0; i < n_values; i++)
+      {
+	double sample = values[i];
+
+	avg_energy += sample * sample;
+	avg_energy_count++;
+      }
+  }
+
+  void stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    if (avg_energy_count)
+      avg_energy /= avg_energy_count;
+
+    avg_energy = bse_db_from_factor (sqrt (avg_energy), -200);
+  }
 };
 
-struct MinMaxPeakFeature : public Feature
+struct MinMaxPeakFeature : public Feature, public FeStreamConsumer
 {
   double min_peak;
   double max_peak;
@@ -568,21 +1007,37 @@ struct MinMaxPeakFeature : public Feature
     print_value ("min_peak", min_peak);
     print_value ("max_peak", max_peak);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    for (uint i = 0; i < n_values; i++)
+      {
+	min_peak = min (double (values[i]), min_peak);
+	max_peak = max (double (values[i]), max_peak);
+      }
+  }
 };
 
-struct DCOffsetFeature : public Feature
+struct DCOffsetFeature : public Feature, public FeStreamConsumer
 {
   double dc_offset;
+  double dc_offset_div;
 
   DCOffsetFeature() :
     Feature ("--dc-offset-db", "computes the DC offset in dB")
   {
     dc_offset = 0;
+    dc_offset_div = 0;
   }
 
   void compute (const FeAudioSignal &signal)
   {
-    double dc_offset_div = 0.0;
+    dc_offset_div = 0.0;
 
     for (GslLong l = options.channel; l < signal.length(); l += signal.n_channels())
       {
@@ -598,9 +1053,29 @@ struct DCOffsetFeature : public Feature
   {
     print_value ("dc_offset_db", bse_db_from_factor (dc_offset, -200));
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    for (uint i = 0; i < n_values; i++)
+      {
+        dc_offset += values[i];
+        dc_offset_div += 1.0;
+      }
+  }
+
+  void stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    if (dc_offset_div > 0.5)
+      dc_offset /= dc_offset_div;
+  }
 };
 
-struct RawSignalFeature : public Feature
+struct RawSignalFeature : public Feature, public FeStreamConsumer
 {
   vector<double> raw_signal;
 
@@ -623,14 +1098,25 @@ struct RawSignalFeature : public Feature
     for (uint i = 0; i < raw_signal.size(); i++)
       fprintf (options.output_file, "%s\n", double_to_string (raw_signal[i]).c_str());
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    raw_signal.insert (raw_signal.end(), values, values + n_values);
+  }
 };
 
-struct ComplexSignalFeature : public Feature
+struct ComplexSignalFeature : public Feature, public FeStreamConsumer
 {
   static const int HSIZE = 256;
 
   vector< std::complex<double> > complex_signal;
   double                         hilbert[2*HSIZE+1];
+  FeHilbertStream                hilbert_stream;
 
   /*
    * Evaluates the FIR frequency response of the hilbert filter.
@@ -729,10 +1215,36 @@ struct ComplexSignalFeature : public Feature
       fprintf (options.output_file, "%s %s\n", double_to_string (complex_signal[i].real()).c_str(),
                                                double_to_string (complex_signal[i].imag()).c_str());
   }
+
+  FeStreamConsumer*
+  stream_consumer()
+  {
+    return this;
+  }
+
+  void
+  stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+    hilbert_stream.begin (hilbert, HSIZE);
+  }
+
+  void
+  stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    hilbert_stream.feed (values, n_values, [&] (std::complex<double> c) { complex_signal.push_back (c); });
+  }
+
+  void
+  stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    hilbert_stream.finish (signal.n_frames(), [&] (std::complex<double> c) { complex_signal.push_back (c); });
+  }
 };
 
-struct BaseFreqFeature : public Feature
+struct BaseFreqFeature : public Feature, public FeStreamConsumer
 {
+  static const int BANDPASS_ORDER = 2;
+
   ComplexSignalFeature *complex_signal_feature;
   vector<double> freq;
 
@@ -740,6 +1252,18 @@ struct BaseFreqFeature : public Feature
   double base_freq_smear;
   double base_freq_wobble;
 
+  /* frequency estimation state */
+  double a[BANDPASS_ORDER + 1];
+  double b[BANDPASS_ORDER + 1];
+  std::complex<double> x1, x2, y1, y2;
+  double last_phase;
+
+  /* streaming state */
+  FeHilbertStream  hilbert_stream;
+  FeWindowAverager window_averager;
+  double stream_base_freq_div;
+  double stream_smear_sum, stream_wobble_sum, stream_last_avg, stream_window_count;
+
   BaseFreqFeature (ComplexSignalFeature *complex_signal_feature) :
     Feature ("--base-freq", "try to detect pitch of a signal"),
     complex_signal_feature (complex_signal_feature)
@@ -750,24 +1274,15 @@ struct BaseFreqFeature : public Feature
   }
 
   void
-  compute (const FeAudioSignal &signal)
+  init_estimation (const FeAudioSignal &signal)
   {
-    if (freq.size()) /* already finished? */
-      return;
-
-    /*
-     * dependancy: we need the complex signal to compute the base frequency
-     */
-    complex_signal_feature->compute (signal);
-
     /*
      * if the user specified a base frequency hint, we search especially in
      * a +/- 10% range around that hint; to do so, we use a 2nd order
      * butterworth bandpass
      */
-    const int BANDPASS_ORDER = 2;
-    double a[BANDPASS_ORDER + 1] = { 0, };
-    double b[BANDPASS_ORDER + 1] = { 0, };
+    std::fill (a, a + BANDPASS_ORDER + 1, 0.0);
+    std::fill (b, b + BANDPASS_ORDER + 1, 0.0);
 
     if (options.base_freq_hint > 0)
       {
@@ -777,12 +1292,11 @@ struct BaseFreqFeature : public Feature
 	    0.1, a, b);
       }
 
-    std::complex<double> x0, x1, x2, y0, y1, y2;
-
-    double last_phase = 0.0;
-    double base_freq_div = 0.01; /* avoid division by zero */
+    x1 = x2 = y1 = y2 = 0;
+    last_phase = 0.0;
 
 #if 0 // test filter
+    std::complex<double> x0, y0;
     for (double i = 1.0; i < 10000; i = i * 11 / 10)
       {
 	double vol = 0.0;
@@ -802,33 +1316,58 @@ struct BaseFreqFeature : public Feature
       }
     _exit (1);
 #endif
+  }
 
-    for (vector< std::complex<double> >::const_iterator si = complex_signal_feature->complex_signal.begin();
-	                                                si != complex_signal_feature->complex_signal.end(); si++)
-    {
-      if (options.base_freq_hint > 0)
-	{
-	  x0 = *si;
-	  y0 = x0 * a[0] + x1 * a[1] + x2 * a[2] - y1 * b[1] - y2 * b[2];
-	  x2 = x1; x1 = x0; y2 = y1; y1 = y0;
-	}
-      else
-	{
-	  y0 = *si;
-	}
+  double
+  estimate_freq (std::complex<double> sig,
+                 double               mix_freq)
+  {
+    std::complex<double> y0;
+
+    if (options.base_freq_hint > 0)
+      {
+	std::complex<double> x0 = sig;
+	y0 = x0 * a[0] + x1 * a[1] + x2 * a[2] - y1 * b[1] - y2 * b[2];
+	x2 = x1; x1 = x0; y2 = y1; y1 = y0;
+      }
+    else
+      {
+	y0 = sig;
+      }
 
-      /* determine frequency value from phase difference */
-      double phase = std::arg (y0);
-      double phase_diff = last_phase - phase;
+    /* determine frequency value from phase difference */
+    double phase = std::arg (y0);
+    double phase_diff = last_phase - phase;
 
-      if (phase_diff > M_PI)
-	phase_diff -= 2.0*M_PI;
-      else if(phase_diff < -M_PI)
-	phase_diff += 2.0*M_PI;
+    if (phase_diff > M_PI)
+      phase_diff -= 2.0*M_PI;
+    else if(phase_diff < -M_PI)
+      phase_diff += 2.0*M_PI;
 
-      last_phase = phase;
+    last_phase = phase;
 
-      double current_freq = fabs (phase_diff / 2.0 / M_PI) * signal.mix_freq();
+    return fabs (phase_diff / 2.0 / M_PI) * mix_freq;
+  }
+
+  void
+  compute (const FeAudioSignal &signal)
+  {
+    if (freq.size()) /* already finished? */
+      return;
+
+    /*
+     * dependancy: we need the complex signal to compute the base frequency
+     */
+    complex_signal_feature->compute (signal);
+
+    init_estimation (signal);
+
+    double base_freq_div = 0.01; /* avoid division by zero */
+
+    for (vector< std::complex<double> >::const_iterator si = complex_signal_feature->complex_signal.begin();
+	                                                si != complex_signal_feature->complex_signal.end(); si++)
+    {
+      double current_freq = estimate_freq (*si, signal.mix_freq());
       freq.push_back (current_freq);
 
       /*
@@ -849,6 +1388,83 @@ struct BaseFreqFeature : public Feature
     compute_smear_and_wobble (signal);
   }
 
+  /* streaming: the first pass determines base_freq, the second pass smear and wobble */
+  FeStreamConsumer*
+  stream_consumer()
+  {
+    return this;
+  }
+
+  uint
+  n_passes() const
+  {
+    return 2;
+  }
+
+  void
+  stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+    init_estimation (signal);
+    hilbert_stream.begin (complex_signal_feature->hilbert, ComplexSignalFeature::HSIZE);
+    if (pass == 0)
+      {
+        base_freq = 0;
+        stream_base_freq_div = 0.01; /* avoid division by zero */
+      }
+    else
+      {
+        const int window_size = int (signal.mix_freq() / base_freq + 0.5);
+        const int window_step = max (window_size / 3, 30);
+        window_averager.begin (window_size, window_step, signal.n_frames());
+        stream_smear_sum = stream_wobble_sum = stream_last_avg = stream_window_count = 0.0;
+      }
+  }
+
+  void
+  stream_value (const FeAudioSignal &signal, uint pass, std::complex<double> sig)
+  {
+    double current_freq = estimate_freq (sig, signal.mix_freq());
+    if (pass == 0)
+      {
+        if (current_freq > 1.0)
+          {
+            base_freq += current_freq;
+            stream_base_freq_div += 1.0;
+          }
+      }
+    else
+      window_averager.feed (current_freq, [&] (double avg_base_freq) {
+        stream_smear_sum += fabs (avg_base_freq - base_freq);
+        stream_wobble_sum += fabs (stream_last_avg - avg_base_freq);
+        stream_window_count += 1.0;
+        stream_last_avg = avg_base_freq;
+      });
+  }
+
+  void
+  stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    hilbert_stream.feed (values, n_values, [&] (std::complex<double> sig) { stream_value (signal, pass, sig); });
+  }
+
+  void
+  stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    hilbert_stream.finish (signal.n_frames(), [&] (std::complex<double> sig) { stream_value (signal, pass, sig); });
+    if (pass == 0)
+      base_freq /= stream_base_freq_div;
+    else if (stream_window_count > 0.0)
+      {
+	base_freq_smear = stream_smear_sum / stream_window_count;
+	base_freq_wobble = stream_wobble_sum / stream_window_count;
+      }
+    else
+      {
+	base_freq_smear = 0.0;
+	base_freq_wobble = 0.0;
+      }
+  }
+
   void
   compute_smear_and_wobble (const FeAudioSignal &signal)
   {
@@ -925,6 +1541,11 @@ struct BaseFreqSmear : public Feature
   {
     print_value ("base_freq_smear", base_freq_feature->base_freq_smear);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return base_freq_feature;
+  }
 };
 
 struct BaseFreqWobble : public Feature
@@ -949,9 +1570,14 @@ struct BaseFreqWobble : public Feature
   {
     print_value ("base_freq_wobble", base_freq_feature->base_freq_wobble);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return base_freq_feature;
+  }
 };
 
-struct VolumeFeature : public Feature
+struct VolumeFeature : public Feature, public FeStreamConsumer
 {
   ComplexSignalFeature *complex_signal_feature;
   vector<double> vol;
@@ -960,6 +1586,12 @@ struct VolumeFeature : public Feature
   double volume_smear;
   double volume_wobble;
 
+  /* streaming state */
+  FeHilbertStream  hilbert_stream;
+  FeWindowAverager window_averager;
+  GslLong stream_n_values;
+  double stream_last_avg, stream_window_count;
+
   VolumeFeature (ComplexSignalFeature *complex_signal_feature)
     : Feature ("--volume", "determine average signal volume"),
       complex_signal_feature (complex_signal_feature)
@@ -1043,6 +1675,72 @@ struct VolumeFeature : public Feature
   {
     print_value ("volume", volume);
   }
+
+  /* streaming: the first pass determines the volume, the second pass smear and wobble */
+  FeStreamConsumer* stream_consumer()
+  {
+    return this;
+  }
+
+  uint n_passes() const
+  {
+    return 2;
+  }
+
+  void stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+    hilbert_stream.begin (complex_signal_feature->hilbert, ComplexSignalFeature::HSIZE);
+    if (pass == 0)
+      {
+        volume = 0.0;
+        stream_n_values = 0;
+      }
+    else
+      {
+        const double window_size_ms = 30; /* window size in milliseconds */
+        const int window_size = int (signal.mix_freq() * window_size_ms / 1000.0 + 0.5);
+        const int window_step = max (window_size / 3, 30);
+        window_averager.begin (window_size, window_step, signal.n_frames());
+        volume_smear = volume_wobble = stream_last_avg = stream_window_count = 0.0;
+      }
+  }
+
+  void stream_value (uint pass, std::complex<double> sig)
+  {
+    double v = std::abs (sig);
+    if (pass == 0)
+      {
+        volume += v;
+        stream_n_values++;
+      }
+    else
+      window_averager.feed (v, [&] (double avg_volume) {
+        volume_smear += fabs (avg_volume - volume);
+        volume_wobble += fabs (stream_last_avg - avg_volume);
+        stream_window_count += 1.0;
+        stream_last_avg = avg_volume;
+      });
+  }
+
+  void stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    hilbert_stream.feed (values, n_values, [&] (std::complex<double> sig) { stream_value (pass, sig); });
+  }
+
+  void stream_end (const FeAudioSignal &signal, uint pass)
+  {
+    hilbert_stream.finish (signal.n_frames(), [&] (std::complex<double> sig) { stream_value (pass, sig); });
+    if (pass == 0)
+      {
+        if (stream_n_values)
+          volume /= stream_n_values;
+      }
+    else if (stream_window_count > 0.0)
+      {
+	volume_smear /= stream_window_count;
+	volume_wobble /= stream_window_count;
+      }
+  }
 };
 
 struct VolumeSmear : public Feature
@@ -1065,6 +1763,11 @@ struct VolumeSmear : public Feature
   {
     print_value ("volume_smear", volume_feature->volume_smear);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return volume_feature;
+  }
 };
 
 struct VolumeWobble : public Feature
@@ -1088,9 +1791,14 @@ struct VolumeWobble : public Feature
   {
     print_value ("volume_wobble", volume_feature->volume_wobble);
   }
+
+  FeStreamConsumer* stream_consumer()
+  {
+    return volume_feature;
+  }
 };
 
-struct TimingSlices
+struct TimingSlices : public FeStreamConsumer
 {
   enum SpectralFluxType
   {
@@ -1098,19 +1806,21 @@ struct TimingSlices
     SPECTRAL_FLUX_NEGATIVE
   };
   vector< vector<double> > slices;
+  FeSlidingWindow          sliding_window;
+  uint                     stream_fft_size;
 
   vector<double>
-  build_frequency_vector (GslLong size,
-			  double *samples)
+  build_frequency_vector (GslLong       size,
+			  const double *samples)
   {
     vector<double> fvector;
-    double in[size], c[size + 2], *im;
+    float in[size], c[size + 2], *im;
     gint i;
 
     for (i = 0; i < size; i++)
       in[i] = bse_window_blackman (2.0 * i / size - 1.0) * samples[i]; /* the bse blackman window is defined in range [-1, 1] */
 
-    gsl_power2_fftar (size, in, c);
+    FFTPlan::real_plan (size)->fftar (in, c);
     c[size] = c[1];
     c[size + 1] = 0;
     c[1] = 0;
@@ -1125,13 +1835,9 @@ struct TimingSlices
     return fvector;
   }
 
-  void
-  compute (const FeAudioSignal& signal)
+  uint
+  fft_size (const FeAudioSignal& signal)
   {
-    if (slices.size()) /* don't compute the same feature twice */
-      return;
-
-    double file_size_ms = signal.time_ms (signal.length());
     uint fft_size_samples = 2;
 
     while (fft_size_samples / signal.mix_freq() * 1000 < options.timing_window_size_ms)
@@ -1147,6 +1853,17 @@ struct TimingSlices
 	  float (options.timing_window_stepping_ms),
 	  uint (options.timing_window_stepping_ms * signal.mix_freq() / 1000));
       }
+    return fft_size_samples;
+  }
+
+  void
+  compute (const FeAudioSignal& signal)
+  {
+    if (slices.size()) /* don't compute the same feature twice */
+      return;
+
+    double file_size_ms = signal.time_ms (signal.length());
+    const uint fft_size_samples = fft_size (signal);
 
     for (double offset_ms = 0; offset_ms < file_size_ms; offset_ms += options.timing_window_stepping_ms)
       {
@@ -1171,6 +1888,21 @@ struct TimingSlices
       }
   }
 
+  void
+  stream_begin (const FeAudioSignal &signal, uint pass)
+  {
+    stream_fft_size = fft_size (signal);
+    sliding_window.begin (signal, stream_fft_size, options.timing_window_stepping_ms);
+  }
+
+  void
+  stream_block (const FeAudioSignal &signal, uint pass, GslLong frame, const float *values, uint n_values)
+  {
+    sliding_window.feed (frame, values, n_values, [&] (const double *samples) {
+      slices.push_back (build_frequency_vector (stream_fft_size, samples));
+    });
+  }
+
   int
   n_slices()
   {
@@ -1215,7 +1947,18 @@ struct AttackTimes : public Feature
   compute (const FeAudioSignal &signal)
   {
     timing_slices->compute (signal);
+    stream_finish();
+  }
+
+  FeStreamConsumer*
+  stream_consumer()
+  {
+    return timing_slices;
+  }
 
+  void
+  stream_finish()
+  {
     for (int i = 0; i < timing_slices->n_slices(); i++)
       attack_times.push_back (timing_slices->spectral_flux (i - 1, i, TimingSlices::SPECTRAL_FLUX_POSITIVE));
   }
@@ -1244,7 +1987,18 @@ struct ReleaseTimes : public Feature
   compute (const FeAudioSignal &signal)
   {
     timing_slices->compute (signal);
+    stream_finish();
+  }
+
+  FeStreamConsumer*
+  stream_consumer()
+  {
+    return timing_slices;
+  }
 
+  void
+  stream_finish()
+  {
     for (int i = 0; i < timing_slices->n_slices(); i++)
       release_times.push_back (timing_slices->spectral_flux (i - 1, i, TimingSlices::SPECTRAL_FLUX_NEGATIVE));
   }
@@ -1264,6 +2018,7 @@ FExtractOptions::FExtractOptions () :
   program_name = "bsetool fextract";
   channel = 0;
   verbose = false;
+  streaming = false;
   cut_zeros_head = false;
   cut_zeros_tail = false;
   silence_threshold = 0.0;
@@ -1307,9 +2062,10 @@ print_header (const String &src)
   fprintf (options.output_file, "#\n");
 }
 
-static ArgDescription fextract_options[32] = {
+static ArgDescription fextract_options[33] = {
   { "<audiofile>", "",                  "Audio file to extract features from", "", },
   { "--verbose", "",                    "Verbose feature extraction", "" },
+  { "--streaming", "",                  "stream the input blockwise, extract features in parallel threads", "" },
   { "--channel", "<channel>",           "select channel (0: left, 1: right)", "" },
   { "--cut-zeros", "",                  "cut zero samples at start/end of the signal", "" },
   { "--cut-zeros-head", "",             "cut zero samples at start of the signal", "" },
@@ -1327,7 +2083,7 @@ static ArgDescription fextract_options[32] = {
 static const char*
 fextract_blurb (const char *blurb)
 { // slight hack to finish up fextract_options before calling CommandRegistry::CommandRegistry()
-  const int NOPTS = 14;
+  const int NOPTS = 15;
   assert_return (fextract_options[NOPTS - 1].arg_name != NULL, NULL);
   assert_return (fextract_options[NOPTS].arg_name == NULL, NULL); // call *once* only
   /* supported features */
@@ -1370,6 +2126,7 @@ FExtractOptions::assign_options (const ArgParser &ap)
 {
   // assign options
   verbose = ap["verbose"] == "1";
+  streaming = ap["streaming"] == "1";
   if (ap["cut-zeros"] == "1")
     cut_zeros_head = cut_zeros_tail = true;
   if (ap["cut-zeros-head"] == "1")
@@ -1447,7 +2204,7 @@ fextract_run (const ArgParser &ap)
     }
 
   /* extract features */
-  FeAudioSignal signal (dhandle);
+  FeAudioSignal signal (dhandle, options.streaming);
 
   if (options.channel >= signal.n_channels())
     {
@@ -1456,9 +2213,27 @@ fextract_run (const ArgParser &ap)
       _exit (1);
     }
 
-  for (list<Feature*>::const_iterator fi = feature_list.begin(); fi != feature_list.end(); fi++)
-    if ((*fi)->extract_feature)
-      (*fi)->compute (signal);
+  if (options.streaming)
+    {
+      /* each stream consumer runs once, even if several features depend on it */
+      vector<FeStreamConsumer*> consumers;
+      for (list<Feature*>::const_iterator fi = feature_list.begin(); fi != feature_list.end(); fi++)
+        if ((*fi)->extract_feature)
+          {
+            FeStreamConsumer *consumer = (*fi)->stream_consumer();
+            if (std::find (consumers.begin(), consumers.end(), consumer) == consumers.end())
+              consumers.push_back (consumer);
+          }
+      FeBlockStream block_stream (signal);
+      block_stream.run (consumers);
+      for (list<Feature*>::const_iterator fi = feature_list.begin(); fi != feature_list.end(); fi++)
+        if ((*fi)->extract_feature)
+          (*fi)->stream_finish();
+    }
+  else
+    for (list<Feature*>::const_iterator fi = feature_list.begin(); fi != feature_list.end(); fi++)
+      if ((*fi)->extract_feature)
+        (*fi)->compute (signal);
 
   /* print results */
   print_header (audiofile);
@@ -308,6 +308,50 @@ render2wav (const ArgParser &ap)
 static CommandRegistry render2wav_cmd (render2wav_options, render2wav, "render2wav", "Render audio from a .bse file into a WAV file");
 
 
+// == render-offline ==
+static ArgDescription render_offline_options[] = {
+  { "-s, --start",   "<tick>",    "Song tick to start rendering at", "0" },
+  { "-e, --end",     "<tick>",    "Song tick to stop rendering at, defaults to the song end", "0" },
+  { "-t, --tail",    "<seconds>", "Number of seconds to render past the end, e.g. for reverb tails", "2" },
+  { "<bse-file>",    "",          "The BSE file for audio rendering", "" },
+  { "<wav-file>",    "",          "The WAV file to use for audio output", "" },
+};
+
+static String
+render_offline (const ArgParser &ap)
+{
+  const String bsefile = ap["bse-file"];
+  const String wavfile = ap["wav-file"];
+  const int start_tick = string_to_int (ap["start"]);
+  const int end_tick = string_to_int (ap["end"]);
+  const double tail_seconds = string_to_double (ap["tail"]);
+  auto project = BSE_SERVER.create_project (bsefile);
+  project->auto_deactivate (0);
+  auto err = project->restore_from_file (bsefile);
+  if (err != 0)
+    return bse_error_blurb (err);
+  const uint64 start_time = timestamp_realtime();
+  err = project->render_offline (wavfile, start_tick, end_tick, tail_seconds);
+  if (err != 0)
+    return string_format ("%s: rendering failed: %s", bsefile, bse_error_blurb (err));
+  printq ("Rendering %s to %s...\n", bsefile, wavfile);
+  while (project->is_playing())
+    if (g_main_context_pending (bse_main_context))
+      g_main_context_iteration (bse_main_context, false);
+    else
+      usleep (1000);
+  // deactivation closes the devices and finishes the WAV file
+  project->deactivate();
+  while (g_main_context_pending (bse_main_context))
+    g_main_context_iteration (bse_main_context, false);
+  printq ("Done in %.3f seconds\n", (timestamp_realtime() - start_time) * 0.000001);
+  return "";
+}
+
+static CommandRegistry render_offline_cmd (render_offline_options, render_offline, "render-offline",
+                                           "Render a song range from a .bse file into a WAV file, faster than realtime");
+
+
 // == check-load ==
 static ArgDescription check_load_options[] = {
   { "<bse-file>",    "",          "The BSE file to load and check for validity", "" },
@@ -18,6 +18,10 @@
 #include <vector>
 #include <map>
 #include <algorithm>
+#include <functional>
+#include <atomic>
+#include <thread>
+#include <mutex>
 
 template<class ...Args> void
 app_error (const char *format, const Args &...args)
@@ -39,6 +43,7 @@ static void     wavetool_print_blurb    (bool    bshort);
 /* --- variables --- */
 static bool   skip_errors = false;
 static bool   silent_infos = false;
+static guint  n_jobs = 1;
 static string command_name;
 static string input_file;
 static string output_file;
@@ -60,6 +65,214 @@ Command::blurb (bool bshort)
     return;
 }
 
+/* --- parallel chunk processing --- */
+/* Chunk processing is split into a compute phase, which may run on up to
+ * n_jobs threads and must only touch the chunk's own data handles, and an
+ * apply phase which commits the results to the Wave in chunk order. That way
+ * the written bsewave file does not depend on the number of jobs.
+ */
+static void
+run_chunk_jobs (size_t                             n_chunks,
+                const std::function<void (size_t)> &compute)
+{
+  const size_t n_threads = std::min<size_t> (n_jobs, n_chunks);
+  if (n_threads <= 1)
+    {
+      for (size_t nth = 0; nth < n_chunks; nth++)
+        compute (nth);
+      return;
+    }
+  std::atomic<size_t> next_chunk { 0 };
+  auto worker = [&] () {
+    for (size_t nth = next_chunk++; nth < n_chunks; nth = next_chunk++)
+      compute (nth);
+  };
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < n_threads; i++)
+    threads.push_back (std::thread (worker));
+  worker();
+  for (auto &thread : threads)
+    thread.join();
+}
+
+/* Progress output for run_chunk_jobs(), summarizes all chunks in one line. */
+class ChunkProgress {
+  std::mutex          mutex_;
+  std::vector<double> done_;
+  const char         *what_;
+  double              last_percent_;
+public:
+  ChunkProgress (const char *what, size_t n_chunks) :
+    done_ (n_chunks, 0.0), what_ (what), last_percent_ (-1)
+  {}
+  void
+  update (size_t nth, double fraction)
+  {
+    if (silent_infos)
+      return;
+    std::lock_guard<std::mutex> locker (mutex_);
+    done_[nth] = CLAMP (fraction, 0.0, 1.0);
+    double sum = 0;
+    for (auto d : done_)
+      sum += d;
+    const double percent = sum * 99.999999 / MAX (done_.size(), size_t (1));
+    if (percent - last_percent_ < 0.1 && fraction < 1.0)
+      return;
+    last_percent_ = percent;
+    printerr ("%s: %u chunks, %u jobs, processed %0.1f%%       \r", what_, done_.size(), MIN (n_jobs, done_.size()), percent);
+  }
+  void
+  done ()
+  {
+    if (!silent_infos && !done_.empty())
+      printerr ("\n");
+  }
+};
+
+/* Adapts GslProgressFunc notifications of a single chunk to ChunkProgress. */
+struct LoopProgress {
+  ChunkProgress *progress;
+  size_t         nth;
+  static guint
+  notify (gpointer data, gfloat pval, const gchar *detail, GslProgressState *pstate)
+  {
+    LoopProgress *self = (LoopProgress*) data;
+    if (pval >= 0)
+      self->progress->update (self->nth, pval / 100.0);
+    return 0;
+  }
+};
+
+/* Evaluate a lazily computing handle (filter, resampler, ...) into a temporary
+ * file. Used by the compute phase, so the expensive signal processing happens
+ * on the job threads instead of serially when the wave is stored. The values are
+ * streamed to disk block by block, so memory use does not grow with the number
+ * or length of the chunks processed in parallel.
+ */
+struct RenderedHandle {
+  gchar         *temp_file = NULL;
+  gint           tmpfd = -1;
+  GslDataHandle *dhandle = NULL;
+  gchar        **xinfos = NULL;
+  Bse::Error     error = Bse::Error::NONE;
+};
+
+static void
+render_dhandle (GslDataHandle  *dhandle,
+                RenderedHandle &result,
+                ChunkProgress  &progress,
+                size_t          nth)
+{
+  result.error = gsl_data_handle_open (dhandle);
+  if (result.error != 0)
+    {
+      close (result.tmpfd);
+      return;
+    }
+  const int64 l = gsl_data_handle_length (dhandle);
+  const guint n_channels = gsl_data_handle_n_channels (dhandle);
+  if (l < n_channels)   /* nothing worth rendering */
+    {
+      gsl_data_handle_close (dhandle);
+      close (result.tmpfd);
+      result.dhandle = gsl_data_handle_ref (dhandle);
+      return;
+    }
+  const int64 RENDER_BLOCK = 16 * 1024;
+  gfloat values[RENDER_BLOCK];
+  int64 n = 0;
+  while (n < l && result.error == 0)
+    {
+      const int64 r = gsl_data_handle_read (dhandle, n, MIN (l - n, RENDER_BLOCK), values);
+      if (r <= 0)
+        {
+          result.error = Bse::Error::FILE_READ_FAILED;
+          break;
+        }
+      const char *bytes = (const char*) values;
+      for (ssize_t w, left = r * sizeof (values[0]); left > 0 && result.error == 0; bytes += w, left -= w)
+        {
+          do
+            w = write (result.tmpfd, bytes, left);
+          while (w < 0 && errno == EINTR);
+          if (w < 0)
+            result.error = bse_error_from_errno (errno, Bse::Error::FILE_WRITE_FAILED);
+        }
+      n += r;
+      progress.update (nth, n / double (l));
+    }
+  if (close (result.tmpfd) < 0 && result.error == 0)
+    result.error = bse_error_from_errno (errno, Bse::Error::FILE_WRITE_FAILED);
+  if (result.error == 0)
+    {
+      result.dhandle = gsl_wave_handle_new (result.temp_file, n_channels, GSL_WAVE_FORMAT_FLOAT, G_BYTE_ORDER,
+                                            gsl_data_handle_mix_freq (dhandle), gsl_data_handle_osc_freq (dhandle),
+                                            0, l, NULL);
+      if (!result.dhandle)
+        result.error = Bse::Error::IO;
+      result.xinfos = bse_xinfos_dup_consolidated (dhandle->setup.xinfos, FALSE);
+    }
+  gsl_data_handle_close (dhandle);
+}
+
+/* Replace the data handles of chunks by the (lazily computing) xhandles,
+ * one reference of each xhandle is adopted. With more than one job, the
+ * xhandles are rendered in parallel first, see render_dhandle().
+ */
+static void
+change_chunk_dhandles (const char                   *what,
+                       const vector<WaveChunk*>     &chunks,
+                       const vector<GslDataHandle*> &xhandles)
+{
+  vector<RenderedHandle> rendered (chunks.size());
+  if (n_jobs > 1)
+    {
+      /* tmp files are assigned in chunk order */
+      for (size_t nth = 0; nth < chunks.size(); nth++)
+        {
+          RenderedHandle &result = rendered[nth];
+          result.temp_file = g_strdup_format ("%s/bsewavetool-pid%u-chunk%04X.tmp%06xyXXXXXX", g_get_tmp_dir(), getpid(), 0x1000 + guint (nth), rand() & 0xfffffd);
+          result.tmpfd = mkstemp (result.temp_file);
+          if (result.tmpfd < 0)
+            {
+              app_error ("chunk % 7.2f/%.0f: failed to open tmp file \"%s\": %s",
+                         gsl_data_handle_osc_freq (chunks[nth]->dhandle), gsl_data_handle_mix_freq (chunks[nth]->dhandle),
+                         result.temp_file, g_strerror (errno));
+              _exit (1);
+            }
+          unlink_file_list.push_back (result.temp_file);
+        }
+      ChunkProgress progress (what, chunks.size());
+      run_chunk_jobs (chunks.size(), [&] (size_t nth) {
+          render_dhandle (xhandles[nth], rendered[nth], progress, nth);
+        });
+      progress.done();
+    }
+  for (size_t nth = 0; nth < chunks.size(); nth++)
+    {
+      WaveChunk *chunk = chunks[nth];
+      Bse::Error error;
+      if (n_jobs > 1)
+        {
+          gsl_data_handle_unref (xhandles[nth]);
+          error = rendered[nth].error;
+          if (error == 0)
+            error = chunk->change_dhandle (rendered[nth].dhandle, 0, rendered[nth].xinfos);
+          g_strfreev (rendered[nth].xinfos);
+          g_free (rendered[nth].temp_file);
+        }
+      else
+        error = chunk->change_dhandle (xhandles[nth], 0, 0);
+      if (error != 0)
+        {
+          app_error ("chunk % 7.2f/%.0f: %s",
+                     gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
+                     bse_error_blurb (error));
+          _exit (1);
+        }
+    }
+}
+
 /* --- main program --- */
 extern "C" int
 main (int   argc,
@@ -229,6 +442,9 @@ wavetool_print_blurb (bool bshort)
   printout ("Tool options:\n");
   printout ("  -o <output.bsewave>   name of the destination file (default: <file.bsewave>)\n");
   printout ("  --silent              suppress extra processing information\n");
+  printout ("  --jobs <N>            process up to N chunks in parallel, 0 uses all CPUs\n");
+  printout ("                        (supported by oggenc, normalize, loop, highpass,\n");
+  printout ("                        lowpass, upsample2 and downsample2)\n");
   printout ("  --skip-errors         skip errors (may overwrite bsewave files after load\n");
   printout ("                        errors occoured for part of its contents)\n");
   printout ("  -h, --help            show elaborated help message with command documentation\n");
@@ -564,6 +780,12 @@ wavetool_parse_args (int    *argc_p,
         skip_errors = true;
       else if (parse_bool_option (argv, i, "--silent"))
         silent_infos = true;
+      else if (parse_str_option (argv, i, "--jobs", &str, argc))
+        {
+          n_jobs = g_ascii_strtoull (str, NULL, 10);
+          if (n_jobs == 0)
+            n_jobs = MAX (1, Bse::this_thread_online_cpus());
+        }
       else if (parse_bool_option (argv, i, "--unit-test"))
         {
           WaveChunkKey::unit_test();
@@ -750,31 +972,121 @@ public:
       gsl_vorbis1_handle_destroy (vhandle);
     return vhandle != NULL;
   }
+  struct EncodeJob {
+    WaveChunk     *chunk;
+    GslDataHandle *dhandle;
+    guint          n_channels;
+    guint          serialno;
+    gchar         *temp_file;
+    gint           tmpfd;
+    SfiNum         n, v, l;
+  };
+  void
+  write_ogg (EncodeJob &job, const guint8 *buf, SfiNum r)
+  {
+    SfiNum j;
+    do
+      j = write (job.tmpfd, buf, r);
+    while (j < 0 && errno == EINTR);
+    if (j < 0)
+      {
+        app_error ("chunk % 7.2f/%.0f: failed to write to tmp file: %s",
+                   gsl_data_handle_osc_freq (job.dhandle), gsl_data_handle_mix_freq (job.dhandle),
+                   g_strerror (errno));
+        _exit (1);
+      }
+  }
+  /* compute phase, may run concurrently for different chunks */
+  void
+  encode_chunk (EncodeJob &job, ChunkProgress &progress, size_t nth)
+  {
+    GslDataHandle *dhandle = job.dhandle;
+    GslVorbisEncoder *enc = gsl_vorbis_encoder_new ();
+    gsl_vorbis_encoder_set_quality (enc, quality);
+    gsl_vorbis_encoder_set_n_channels (enc, job.n_channels);
+    gsl_vorbis_encoder_set_sample_freq (enc, guint (gsl_data_handle_mix_freq (dhandle)));
+    Bse::Error error = gsl_vorbis_encoder_setup_stream (enc, job.serialno);
+    const guint ENCODER_BUFFER = 16 * 1024;
+    if (error == 0)     /* overlap data handle reads with encoding, queue at most 256k values */
+      error = gsl_vorbis_encoder_start_thread (enc, 16 * ENCODER_BUFFER);
+    if (error != 0)
+      {
+        app_error ("chunk % 7.2f/%.0f: failed to encode: %s",
+                   gsl_data_handle_osc_freq (dhandle), gsl_data_handle_mix_freq (dhandle),
+                   bse_error_blurb (error));
+        _exit (1);
+      }
+    Bse::info ("ENCODING: chunk % 7.2f/%.0f", gsl_data_handle_osc_freq (dhandle), gsl_data_handle_mix_freq (dhandle));
+    SfiNum &n = job.n, &v = job.v, &l = job.l;
+    n = 0, v = 0, l = gsl_data_handle_length (dhandle);
+    while (n < l)
+      {
+        gfloat buffer[ENCODER_BUFFER];
+        SfiNum r = gsl_data_handle_read (dhandle, n, ENCODER_BUFFER, buffer);
+        if (r > 0)
+          {
+            n += r;
+            gsl_vorbis_encoder_write_pcm (enc, r, buffer);
+            guint8 *buf = reinterpret_cast<guint8*> (buffer);
+            r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
+            v += MAX (r, 0);
+            while (r > 0)
+              {
+                write_ogg (job, buf, r);
+                r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
+                v += MAX (r, 0);
+              }
+          }
+        if (n_jobs > 1)
+          progress.update (nth, n / double (l));
+        else if (!silent_infos)
+          printerr ("chunk % 7.2f/%.0f, processed %0.1f%%       \r",
+                    gsl_data_handle_osc_freq (dhandle), gsl_data_handle_mix_freq (dhandle),
+                    n * 99.999999 / l);
+      }
+    gsl_vorbis_encoder_pcm_done (enc);
+    while (!gsl_vorbis_encoder_ogg_eos (enc))
+      {
+        guint8 buf[ENCODER_BUFFER];
+        SfiNum r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
+        v += MAX (r, 0);
+        if (r > 0)
+          write_ogg (job, buf, r);
+      }
+    gsl_vorbis_encoder_destroy (enc);
+    if (close (job.tmpfd) < 0)
+      {
+        app_error ("chunk % 7.2f/%.0f: failed to write to tmp file: %s",
+                   gsl_data_handle_osc_freq (dhandle), gsl_data_handle_mix_freq (dhandle),
+                   g_strerror (errno));
+        _exit (1);
+      }
+    if (n_jobs <= 1)
+      print_reduction (job);
+  }
+  void
+  print_reduction (const EncodeJob &job)
+  {
+    guint n_bytes = (gsl_data_handle_bit_depth (job.dhandle) + 7) / 8;
+    if (!silent_infos)
+      printerr ("chunk % 7.2f/%.0f, processed %0.1f%% (reduced to: %5.2f%%)      \n",
+                gsl_data_handle_osc_freq (job.dhandle), gsl_data_handle_mix_freq (job.dhandle),
+                job.n * 100.0 / job.l, job.v * 100.0 / (job.l * MAX (1, n_bytes)));
+  }
   bool
   exec (Wave *wave)
   {
     /* get the wave into storage order */
     wave->sort();
-    /* ogg encoder */
+    /* setup encoding jobs, serial numbers and tmp files are assigned in chunk order */
+    vector<EncodeJob> jobs;
     guint nth = 1;
     for (list<WaveChunk>::iterator it = wave->chunks.begin(); it != wave->chunks.end(); it++, nth++)
       {
         WaveChunk *chunk = &*it;
-        GslVorbisEncoder *enc = gsl_vorbis_encoder_new ();
         GslDataHandle *dhandle = chunk->dhandle;
         if (is_ogg_vorbis_dhandle (dhandle))
           continue;
-        gsl_vorbis_encoder_set_quality (enc, quality);
-        gsl_vorbis_encoder_set_n_channels (enc, wave->n_channels);
-        gsl_vorbis_encoder_set_sample_freq (enc, guint (gsl_data_handle_mix_freq (dhandle)));
-        Bse::Error error = gsl_vorbis_encoder_setup_stream (enc, gsl_vorbis_make_serialno());
-        if (error != 0)
-          {
-            app_error ("chunk % 7.2f/%.0f: failed to encode: %s",
-                       gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                       bse_error_blurb (error));
-            _exit (1);
-          }
         gchar *temp_file = g_strdup_format ("%s/bsewavetool-pid%u-oggchunk%04X.tmp%06xyXXXXXX", g_get_tmp_dir(), getpid(), 0x1000 + nth, rand() & 0xfffffd);
         gint tmpfd = mkstemp (temp_file);
         if (tmpfd < 0)
@@ -785,83 +1097,29 @@ public:
             _exit (1);
           }
         unlink_file_list.push_back (temp_file);
-        const guint ENCODER_BUFFER = 16 * 1024;
-        Bse::info ("ENCODING: chunk % 7.2f/%.0f", gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle));
-        SfiNum n = 0, v = 0, l = gsl_data_handle_length (dhandle);
-        while (n < l)
-          {
-            gfloat buffer[ENCODER_BUFFER];
-            SfiNum j, r = gsl_data_handle_read (dhandle, n, ENCODER_BUFFER, buffer);
-            if (r > 0)
-              {
-                n += r;
-                gsl_vorbis_encoder_write_pcm (enc, r, buffer);
-                guint8 *buf = reinterpret_cast<guint8*> (buffer);
-                r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
-                v += MAX (r, 0);
-                while (r > 0)
-                  {
-                    do
-                      j = write (tmpfd, buf, r);
-                    while (j < 0 && errno == EINTR);
-                    if (j < 0)
-                      {
-                        app_error ("chunk % 7.2f/%.0f: failed to write to tmp file: %s",
-                                   gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                                   g_strerror (errno));
-                        _exit (1);
-                      }
-                    r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
-                    v += MAX (r, 0);
-                  }
-              }
-            if (!silent_infos)
-              printerr ("chunk % 7.2f/%.0f, processed %0.1f%%       \r",
-                          gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                          n * 99.999999 / l);
-          }
-        gsl_vorbis_encoder_pcm_done (enc);
-        while (!gsl_vorbis_encoder_ogg_eos (enc))
-          {
-            guint8 buf[ENCODER_BUFFER];
-            SfiNum j, r = gsl_vorbis_encoder_read_ogg (enc, ENCODER_BUFFER, buf);
-            v += MAX (r, 0);
-            if (r > 0)
-              {
-                do
-                  j = write (tmpfd, buf, r);
-                while (j < 0 && errno == EINTR);
-                if (j < 0)
-                  {
-                    app_error ("chunk % 7.2f/%.0f: failed to write to tmp file: %s",
-                               gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                               g_strerror (errno));
-                    _exit (1);
-                  }
-              }
-          }
-        gsl_vorbis_encoder_destroy (enc);
-        guint n_bytes = (gsl_data_handle_bit_depth (dhandle) + 7) / 8;
-        if (!silent_infos)
-          printerr ("chunk % 7.2f/%.0f, processed %0.1f%% (reduced to: %5.2f%%)      \n",
-                      gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                  n * 100.0 / l, v * 100.0 / (l * MAX (1, n_bytes)));
-        if (close (tmpfd) < 0)
-          {
-            app_error ("chunk % 7.2f/%.0f: failed to write to tmp file: %s",
-                       gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                       g_strerror (errno));
-            _exit (1);
-          }
-        error = chunk->set_dhandle_from_file (temp_file, gsl_data_handle_osc_freq (dhandle), dhandle->setup.xinfos);
+        jobs.push_back (EncodeJob { chunk, dhandle, wave->n_channels, gsl_vorbis_make_serialno(), temp_file, tmpfd, 0, 0, 0 });
+      }
+    /* ogg encoder */
+    ChunkProgress progress ("ENCODING", jobs.size());
+    run_chunk_jobs (jobs.size(), [&] (size_t i) { encode_chunk (jobs[i], progress, i); });
+    if (n_jobs > 1)
+      progress.done();
+    /* apply phase */
+    for (EncodeJob &job : jobs)
+      {
+        WaveChunk *chunk = job.chunk;
+        GslDataHandle *dhandle = job.dhandle;
+        if (n_jobs > 1)
+          print_reduction (job);
+        Bse::Error error = chunk->set_dhandle_from_file (job.temp_file, gsl_data_handle_osc_freq (dhandle), dhandle->setup.xinfos);
         if (error != 0)
           {
             app_error ("chunk % 7.2f/%.0f: failed to read wave \"%s\": %s",
                        gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                       temp_file, bse_error_blurb (error));
+                       job.temp_file, bse_error_blurb (error));
             _exit (1);
           }
-        g_free (temp_file);
+        g_free (job.temp_file);
       }
     return true;
   }
@@ -1958,37 +2216,53 @@ public:
     sort (freq_list.begin(), freq_list.end());
     verify_chunk_selection (freq_list, wave);
 
-    /* normalization */
+    vector<WaveChunk*> selected;
     for (list<WaveChunk>::iterator it = wave->chunks.begin(); it != wave->chunks.end(); it++)
       if (all_chunks || wave->match (*it, freq_list))
-        {
-          WaveChunk *chunk = &*it;
-          const double osc_freq = gsl_data_handle_osc_freq (chunk->dhandle);
+        selected.push_back (&*it);
+    /* peak search */
+    vector<double> absmaxs (selected.size());
+    ChunkProgress progress ("NORMALIZE", selected.size());
+    run_chunk_jobs (selected.size(), [&] (size_t nth) {
+        if (n_jobs <= 1)
+          Bse::info ("NORMALIZE: chunk %f", gsl_data_handle_osc_freq (selected[nth]->dhandle));
+        absmaxs[nth] = gsl_data_find_min_max (selected[nth]->dhandle, NULL, NULL);
+        if (n_jobs > 1)
+          progress.update (nth, 1.0);
+      });
+    if (n_jobs > 1)
+      progress.done();
+    /* normalization */
+    for (size_t nth = 0; nth < selected.size(); nth++)
+      {
+        WaveChunk *chunk = selected[nth];
+        const double osc_freq = gsl_data_handle_osc_freq (chunk->dhandle);
+        if (n_jobs > 1)
           Bse::info ("NORMALIZE: chunk %f", osc_freq);
-          double absmax = gsl_data_find_min_max (chunk->dhandle, NULL, NULL);
-          gchar **xinfos = bse_xinfos_dup_consolidated (chunk->dhandle->setup.xinfos, FALSE);
-          Bse::Error error = Bse::Error::NONE;
-          if (absmax > 4.6566e-10) /* 32bit threshold */
-            {
-              if (use_volume_xinfo)
-                {
-                  gchar buffer[G_ASCII_DTOSTR_BUF_SIZE * 2 + 1024];
-                  g_ascii_dtostr (buffer, sizeof (buffer), 1. / absmax);
-                  wave->set_chunk_xinfo (osc_freq, "volume", buffer);
-                }
-              else
-                {
-                  GslDataHandle *shandle = gsl_data_handle_new_scale (chunk->dhandle, 1. / absmax);
-                  error = chunk->change_dhandle (shandle, gsl_data_handle_osc_freq (chunk->dhandle), xinfos);
-                  if (error != 0)
-                    app_error ("level normalizing failed: %s", bse_error_blurb (error));
-                  gsl_data_handle_unref (shandle);
-                }
-            }
-          g_strfreev (xinfos);
-          if (error != 0 && !skip_errors)
-            _exit (1);
-        }
+        const double absmax = absmaxs[nth];
+        gchar **xinfos = bse_xinfos_dup_consolidated (chunk->dhandle->setup.xinfos, FALSE);
+        Bse::Error error = Bse::Error::NONE;
+        if (absmax > 4.6566e-10) /* 32bit threshold */
+          {
+            if (use_volume_xinfo)
+              {
+                gchar buffer[G_ASCII_DTOSTR_BUF_SIZE * 2 + 1024];
+                g_ascii_dtostr (buffer, sizeof (buffer), 1. / absmax);
+                wave->set_chunk_xinfo (osc_freq, "volume", buffer);
+              }
+            else
+              {
+                GslDataHandle *shandle = gsl_data_handle_new_scale (chunk->dhandle, 1. / absmax);
+                error = chunk->change_dhandle (shandle, gsl_data_handle_osc_freq (chunk->dhandle), xinfos);
+                if (error != 0)
+                  app_error ("level normalizing failed: %s", bse_error_blurb (error));
+                gsl_data_handle_unref (shandle);
+              }
+          }
+        g_strfreev (xinfos);
+        if (error != 0 && !skip_errors)
+          _exit (1);
+      }
     return true;
   }
 } cmd_normalize ("normalize");
@@ -2039,47 +2313,68 @@ public:
     sort (freq_list.begin(), freq_list.end());
     verify_chunk_selection (freq_list, wave);
 
-    vector<list<WaveChunk>::iterator> deleted;
-    /* level clipping */
+    vector<WaveChunk*> selected;
     for (list<WaveChunk>::reverse_iterator it = wave->chunks.rbegin(); it != wave->chunks.rend(); it++)
       if (all_chunks || wave->match (*it, freq_list))
-        {
-          WaveChunk *chunk = &*it;
-	  GslDataHandle *dhandle = chunk->dhandle;
+        selected.push_back (&*it);
+    /* loop search */
+    vector<GslDataLoopConfig> lconfigs (selected.size());
+    vector<gboolean> found_loops (selected.size());
+    ChunkProgress progress ("LOOP", selected.size());
+    run_chunk_jobs (selected.size(), [&] (size_t nth) {
+        GslDataHandle *dhandle = selected[nth]->dhandle;
+        if (n_jobs <= 1)
           Bse::info ("LOOP: chunk %f", gsl_data_handle_osc_freq (dhandle));
-	  gdouble mix_freq = gsl_data_handle_mix_freq (dhandle);
-	  GslDataLoopConfig lconfig;
-	  lconfig.block_start = (GslLong) mix_freq;  /* skip first second */
-	  lconfig.block_length = -1; 	             /* to end */
-	  lconfig.analysis_points = 7;
-	  lconfig.repetitions = 2;
-	  lconfig.min_loop = (GslLong) MAX (mix_freq / 10, /* at least 100ms */
-			                    8820 /* FIXME: hardcoded values in gsl_data_loop*() -> 200ms */);
-
-	  gboolean found_loop = gsl_data_find_loop5 (dhandle, &lconfig, NULL, gsl_progress_printerr);
-	  const char *loop_algorithm =       "loop5";
-	  if (found_loop)
-	    {
-	      /* FIXME: assumes n_channels == 1 */
-              gchar **xinfos = bse_xinfos_dup_consolidated (dhandle->setup.xinfos, FALSE);
-	      xinfos = bse_xinfos_add_num (xinfos, "loop-count", 1000000);
-	      xinfos = bse_xinfos_add_num (xinfos, "loop-start", lconfig.loop_start);
-	      xinfos = bse_xinfos_add_num (xinfos, "loop-end", lconfig.loop_start + lconfig.loop_length);
-	      xinfos = bse_xinfos_add_value (xinfos, "loop-type", gsl_wave_loop_type_to_string (GSL_WAVE_LOOP_JUMP));
-	      xinfos = bse_xinfos_add_float (xinfos, "loop-score", lconfig.score);
-	      if (lconfig.n_details > 0)
-		xinfos = bse_xinfos_add_float (xinfos, "loop-score-detail1", lconfig.detail_scores[0]);
-	      if (lconfig.n_details > 1)
-		xinfos = bse_xinfos_add_float (xinfos, "loop-score-detail2", lconfig.detail_scores[1]);
-	      xinfos = bse_xinfos_add_value (xinfos, "loop-algorithm", loop_algorithm);
-
-	      gsl_data_handle_ref (dhandle);
-	      Bse::Error error = chunk->change_dhandle (dhandle, gsl_data_handle_osc_freq (dhandle), xinfos);
-	      if (error != 0)
-		app_error ("looping failed: %s", bse_error_blurb (error));
-	      g_strfreev (xinfos);
-	    }
-        }
+        gdouble mix_freq = gsl_data_handle_mix_freq (dhandle);
+        GslDataLoopConfig &lconfig = lconfigs[nth];
+        lconfig.block_start = (GslLong) mix_freq;  /* skip first second */
+        lconfig.block_length = -1;                 /* to end */
+        lconfig.analysis_points = 7;
+        lconfig.repetitions = 2;
+        lconfig.min_loop = (GslLong) MAX (mix_freq / 10, /* at least 100ms */
+                                          8820 /* FIXME: hardcoded values in gsl_data_loop*() -> 200ms */);
+        if (n_jobs <= 1)
+          found_loops[nth] = gsl_data_find_loop5 (dhandle, &lconfig, NULL, gsl_progress_printerr);
+        else
+          {
+            LoopProgress lprogress = { &progress, nth };
+            found_loops[nth] = gsl_data_find_loop5 (dhandle, &lconfig, &lprogress, LoopProgress::notify);
+            progress.update (nth, 1.0);
+          }
+      });
+    if (n_jobs > 1)
+      progress.done();
+    /* apply loops */
+    for (size_t nth = 0; nth < selected.size(); nth++)
+      {
+        WaveChunk *chunk = selected[nth];
+        GslDataHandle *dhandle = chunk->dhandle;
+        GslDataLoopConfig &lconfig = lconfigs[nth];
+        if (n_jobs > 1)
+          Bse::info ("LOOP: chunk %f", gsl_data_handle_osc_freq (dhandle));
+        const char *loop_algorithm =       "loop5";
+        if (found_loops[nth])
+          {
+            /* FIXME: assumes n_channels == 1 */
+            gchar **xinfos = bse_xinfos_dup_consolidated (dhandle->setup.xinfos, FALSE);
+            xinfos = bse_xinfos_add_num (xinfos, "loop-count", 1000000);
+            xinfos = bse_xinfos_add_num (xinfos, "loop-start", lconfig.loop_start);
+            xinfos = bse_xinfos_add_num (xinfos, "loop-end", lconfig.loop_start + lconfig.loop_length);
+            xinfos = bse_xinfos_add_value (xinfos, "loop-type", gsl_wave_loop_type_to_string (GSL_WAVE_LOOP_JUMP));
+            xinfos = bse_xinfos_add_float (xinfos, "loop-score", lconfig.score);
+            if (lconfig.n_details > 0)
+              xinfos = bse_xinfos_add_float (xinfos, "loop-score-detail1", lconfig.detail_scores[0]);
+            if (lconfig.n_details > 1)
+              xinfos = bse_xinfos_add_float (xinfos, "loop-score-detail2", lconfig.detail_scores[1]);
+            xinfos = bse_xinfos_add_value (xinfos, "loop-algorithm", loop_algorithm);
+
+            gsl_data_handle_ref (dhandle);
+            Bse::Error error = chunk->change_dhandle (dhandle, gsl_data_handle_osc_freq (dhandle), xinfos);
+            if (error != 0)
+              app_error ("looping failed: %s", bse_error_blurb (error));
+            g_strfreev (xinfos);
+          }
+      }
     return true;
   }
 } cmd_loop ("loop");
@@ -2532,6 +2827,8 @@ public:
   {
     /* get the wave into storage order */
     wave->sort();
+    vector<WaveChunk*> chunks;
+    vector<GslDataHandle*> fir_handles;
     for (list<WaveChunk>::iterator it = wave->chunks.begin(); it != wave->chunks.end(); it++)
       {
         WaveChunk *chunk = &*it;
@@ -2549,9 +2846,6 @@ public:
 	    GslDataHandle *fir_handle = create_fir_handle (dhandle);
 
 	    Bse::Error error = print_effective_stopband_start (fir_handle);
-	    if (error == 0)
-	      error = chunk->change_dhandle (fir_handle, 0, 0);
-
 	    if (error != 0)
 	      {
 		app_error ("chunk % 7.2f/%.0f: %s",
@@ -2559,8 +2853,11 @@ public:
 			   bse_error_blurb (error));
 		_exit (1);
 	      }
+            chunks.push_back (chunk);
+            fir_handles.push_back (fir_handle);
 	  }
       }
+    change_chunk_dhandles (string_toupper (name).c_str(), chunks, fir_handles);
     return true;
   }
 };
@@ -2644,6 +2941,8 @@ public:
   {
     /* get the wave into storage order */
     wave->sort();
+    vector<WaveChunk*> chunks;
+    vector<GslDataHandle*> resampled_handles;
     for (list<WaveChunk>::iterator it = wave->chunks.begin(); it != wave->chunks.end(); it++)
       if (m_all_chunks || wave->match (*it, m_freq_list))
         {
@@ -2656,15 +2955,10 @@ public:
           Bse::info ("  using resampler precision: %s\n",
                      bse_resampler2_precision_name (bse_resampler2_find_precision_for_bits (m_precision_bits)));
 
-          Bse::Error error = chunk->change_dhandle (bse_data_handle_new_upsample2 (dhandle, m_precision_bits), 0, 0);
-          if (error != 0)
-            {
-              app_error ("chunk % 7.2f/%.0f: %s",
-                         gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                         bse_error_blurb (error));
-              _exit (1);
-            }
+          chunks.push_back (chunk);
+          resampled_handles.push_back (bse_data_handle_new_upsample2 (dhandle, m_precision_bits));
         }
+    change_chunk_dhandles ("UPSAMPLE2", chunks, resampled_handles);
     return true;
   }
 } cmd_upsample2 ("upsample2");
@@ -2720,6 +3014,8 @@ public:
   {
     /* get the wave into storage order */
     wave->sort();
+    vector<WaveChunk*> chunks;
+    vector<GslDataHandle*> resampled_handles;
     for (list<WaveChunk>::iterator it = wave->chunks.begin(); it != wave->chunks.end(); it++)
       if (m_all_chunks || wave->match (*it, m_freq_list))
         {
@@ -2732,15 +3028,10 @@ public:
           Bse::info ("  using resampler precision: %s\n",
                      bse_resampler2_precision_name (bse_resampler2_find_precision_for_bits (m_precision_bits)));
 
-          Bse::Error error = chunk->change_dhandle (bse_data_handle_new_downsample2 (dhandle, 24), 0, 0);
-          if (error != 0)
-            {
-              app_error ("chunk % 7.2f/%.0f: %s",
-                         gsl_data_handle_osc_freq (chunk->dhandle), gsl_data_handle_mix_freq (chunk->dhandle),
-                         bse_error_blurb (error));
-              _exit (1);
-            }
+          chunks.push_back (chunk);
+          resampled_handles.push_back (bse_data_handle_new_downsample2 (dhandle, 24));
         }
+    change_chunk_dhandles ("DOWNSAMPLE2", chunks, resampled_handles);
     return true;
   }
 } cmd_downsample2 ("downsample2");